@@ -111,6 +111,52 @@ declare namespace engine {
      */
     function getDefaultParameter(group: string, name: string): number;
 
+    /**
+     * Resolves a control once and returns a handle for the *ByHandle functions
+     *
+     * Accessing a control by its handle skips the lookup of the group and name,
+     * which is noticeable for mappings that access many controls on every incoming message.
+     * Requesting the handle of the same control again returns the same handle.
+     *
+     * @param group Group of the control e.g. "[Channel1]"
+     * @param name Name of the control e.g. "play_indicator"
+     * @returns Handle of the control, or -1 if the control does not exist
+     */
+    function getControlHandle(group: string, name: string): number;
+
+    /**
+     * Gets the value of a control by its handle
+     *
+     * @param handle Handle of the control returned by {@link getControlHandle}
+     * @returns Value of the control, or 0 if the handle is invalid
+     */
+    function getValueByHandle(handle: number): number;
+
+    /**
+     * Sets the value of a control by its handle
+     *
+     * @param handle Handle of the control returned by {@link getControlHandle}
+     * @param newValue Value to be set (within it's range according Mixxx Controls manual page:
+     *                 https://manual.mixxx.org/latest/chapters/appendix/mixxx_controls.html)
+     */
+    function setValueByHandle(handle: number, newValue: number): void;
+
+    /**
+     * Gets the value of a control by its handle, normalized to a range of 0..1
+     *
+     * @param handle Handle of the control returned by {@link getControlHandle}
+     * @returns Value of the control normalized to range of 0..1, or 0 if the handle is invalid
+     */
+    function getParameterByHandle(handle: number): number;
+
+    /**
+     * Sets the value of a control by its handle, specified with normalized range of 0..1
+     *
+     * @param handle Handle of the control returned by {@link getControlHandle}
+     * @param newParameter Value to be set, normalized to a range of 0..1
+     */
+    function setParameterByHandle(handle: number, newParameter: number): void;
+
     type CoCallback = (value: number, group: string, name: string) => void
 
     /**
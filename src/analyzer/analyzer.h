@@ -4,6 +4,8 @@
 #include "audio/signalinfo.h"
 #include "audio/types.h"
 #include "util/assert.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
 #include "util/types.h"
 
 /*
@@ -49,9 +51,11 @@ typedef std::unique_ptr<Analyzer> AnalyzerPtr;
 
 class AnalyzerWithState final {
   public:
-    explicit AnalyzerWithState(AnalyzerPtr analyzer)
+    explicit AnalyzerWithState(AnalyzerPtr analyzer, QString name = QString())
             : m_analyzer(std::move(analyzer)),
-              m_active(false) {
+              m_name(std::move(name)),
+              m_active(false),
+              m_processedSamples(0) {
         DEBUG_ASSERT(m_analyzer);
     }
     AnalyzerWithState(const AnalyzerWithState&) = delete;
@@ -66,16 +70,37 @@ class AnalyzerWithState final {
         return m_active;
     }
 
+    /// A human readable name for reporting, e.g. "Key"
+    const QString& name() const {
+        return m_name;
+    }
+
+    /// The number of samples processed since initialize()
+    SINT processedSamples() const {
+        return m_processedSamples;
+    }
+
+    /// The time spent in processSamples() and finish() since initialize()
+    mixxx::Duration processingDuration() const {
+        return m_processingDuration;
+    }
+
     bool initialize(const AnalyzerTrack& track,
             mixxx::audio::SampleRate sampleRate,
             SINT frameLength) {
         DEBUG_ASSERT(!m_active);
+        m_processedSamples = 0;
+        m_processingDuration = mixxx::Duration::empty();
         return m_active = m_analyzer->initialize(track, sampleRate, frameLength);
     }
 
     void processSamples(const CSAMPLE* pIn, const int count) {
         if (m_active) {
+            PerformanceTimer timer;
+            timer.start();
             m_active = m_analyzer->processSamples(pIn, count);
+            m_processedSamples += count;
+            m_processingDuration += timer.elapsed();
             if (!m_active) {
                 // Ensure that cleanup() is invoked after processing
                 // failed and the analyzer became inactive!
@@ -86,8 +111,11 @@ class AnalyzerWithState final {
 
     void finish(const AnalyzerTrack& track) {
         if (m_active) {
+            PerformanceTimer timer;
+            timer.start();
             m_analyzer->storeResults(track.getTrack());
             m_analyzer->cleanup();
+            m_processingDuration += timer.elapsed();
             m_active = false;
         }
     }
@@ -101,5 +129,8 @@ class AnalyzerWithState final {
 
   private:
     AnalyzerPtr m_analyzer;
+    QString m_name;
     bool m_active;
+    SINT m_processedSamples;
+    mixxx::Duration m_processingDuration;
 };
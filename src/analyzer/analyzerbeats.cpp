@@ -37,7 +37,8 @@ AnalyzerBeats::AnalyzerBeats(UserSettingsPointer pConfig, bool enforceBpmDetecti
           m_bPreferencesFixedTempo(true),
           m_bPreferencesFastAnalysis(false),
           m_maxFramesToProcess(0),
-          m_currentFrame(0) {
+          m_currentFrame(0),
+          m_maxProvisionalFramesToProcess(0) {
 }
 
 bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
@@ -101,16 +102,7 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
 
     DEBUG_ASSERT(!m_pPlugin);
     if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
-        } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
-        } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
-        }
-
+        m_pPlugin = createPlugin();
         if (m_pPlugin) {
             if (m_pPlugin->initialize(m_sampleRate)) {
                 qDebug() << "Beat calculation started with plugin" << m_pluginId;
@@ -123,9 +115,40 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
             bShouldAnalyze = false;
         }
     }
+
+    // In progressive mode, detect provisional beats from the beginning
+    // of the track with a second instance of the plugin. Existing beats
+    // are not replaced by provisional beats, unless they are provisional.
+    DEBUG_ASSERT(!m_pProvisionalPlugin);
+    m_maxProvisionalFramesToProcess =
+            mixxx::kProvisionalAnalysisSecondsToAnalyze * m_sampleRate;
+    const mixxx::BeatsPointer pBeats = track.getTrack()->getBeats();
+    if (bShouldAnalyze &&
+            track.getOptions().progressive &&
+            (!pBeats || BeatFactory::isProvisionalSubVersion(pBeats->getSubVersion())) &&
+            m_maxFramesToProcess > m_maxProvisionalFramesToProcess) {
+        m_pProvisionalPlugin = createPlugin();
+        if (m_pProvisionalPlugin && m_pProvisionalPlugin->initialize(m_sampleRate)) {
+            m_pProvisionalTrack = track.getTrack();
+        } else {
+            m_pProvisionalPlugin.reset();
+        }
+    }
     return bShouldAnalyze;
 }
 
+std::unique_ptr<mixxx::AnalyzerBeatsPlugin> AnalyzerBeats::createPlugin() const {
+    if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
+        return std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
+    } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
+        return std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
+    }
+    // This must not happen, because we have already verified
+    // that the PlugInId is valid
+    DEBUG_ASSERT(false);
+    return nullptr;
+}
+
 bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     bool bpmLock = pTrack->isBpmLocked();
     if (bpmLock) {
@@ -144,6 +167,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     if (!pBeats) {
         return true;
     }
+    if (BeatFactory::isProvisionalSubVersion(pBeats->getSubVersion())) {
+        // The analysis has been interrupted after storing provisional
+        // beats in progressive mode.
+        return true;
+    }
     if (!pBeats->getBpmInRange(mixxx::audio::kStartFramePos,
                        mixxx::audio::FramePos{
                                pTrack->getDuration() * pBeats->getSampleRate()})
@@ -200,6 +228,16 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
     }
 
     m_currentFrame += count / mixxx::kAnalysisChannels;
+
+    if (m_pProvisionalPlugin) {
+        if (!m_pProvisionalPlugin->processSamples(pIn, count)) {
+            m_pProvisionalPlugin.reset();
+            m_pProvisionalTrack.reset();
+        } else if (m_currentFrame >= m_maxProvisionalFramesToProcess) {
+            storeProvisionalResults();
+        }
+    }
+
     if (m_currentFrame > m_maxFramesToProcess) {
         return true; // silently ignore all remaining samples
     }
@@ -209,6 +247,25 @@ bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
 
 void AnalyzerBeats::cleanup() {
     m_pPlugin.reset();
+    m_pProvisionalPlugin.reset();
+    m_pProvisionalTrack.reset();
+}
+
+void AnalyzerBeats::storeProvisionalResults() {
+    DEBUG_ASSERT(m_pProvisionalPlugin);
+    DEBUG_ASSERT(m_pProvisionalTrack);
+    if (m_pProvisionalPlugin->finalize()) {
+        const auto pBeats = finalizeBeats(
+                m_pProvisionalPlugin.get(), m_pProvisionalTrack, true);
+        if (pBeats) {
+            // Enables sync and quantize until the whole track has been analyzed
+            m_pProvisionalTrack->trySetBeats(pBeats);
+        }
+    } else {
+        qWarning() << "Provisional beat/BPM analysis failed";
+    }
+    m_pProvisionalPlugin.reset();
+    m_pProvisionalTrack.reset();
 }
 
 void AnalyzerBeats::storeResults(TrackPointer pTrack) {
@@ -221,18 +278,27 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
         return;
     }
 
+    // Replaces provisional beats
+    pTrack->trySetBeats(finalizeBeats(m_pPlugin.get(), pTrack, false));
+}
+
+mixxx::BeatsPointer AnalyzerBeats::finalizeBeats(
+        mixxx::AnalyzerBeatsPlugin* pPlugin,
+        const TrackPointer& pTrack,
+        bool provisional) const {
     mixxx::BeatsPointer pBeats;
-    if (m_pPlugin->supportsBeatTracking()) {
-        QVector<mixxx::audio::FramePos> beats = m_pPlugin->getBeats();
-        QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
-                m_pluginId, m_bPreferencesFastAnalysis);
+    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
+            m_pluginId, m_bPreferencesFastAnalysis, provisional);
+    if (pPlugin->supportsBeatTracking()) {
+        QVector<mixxx::audio::FramePos> beats = pPlugin->getBeats();
         pBeats = BeatFactory::makePreferredBeats(
                 beats,
                 extraVersionInfo,
                 m_bPreferencesFixedTempo,
                 m_sampleRate);
         qDebug() << "AnalyzerBeats plugin detected" << beats.size()
-                 << "beats. Predominant BPM:"
+                 << (provisional ? "provisional beats." : "beats.")
+                 << "Predominant BPM:"
                  << (pBeats ? pBeats->getBpmInRange(
                                       mixxx::audio::kStartFramePos,
                                       mixxx::audio::FramePos{
@@ -240,21 +306,29 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
                                               pBeats->getSampleRate()})
                             : mixxx::Bpm());
     } else {
-        mixxx::Bpm bpm = m_pPlugin->getBpm();
-        qDebug() << "AnalyzerBeats plugin detected constant BPM: " << bpm;
-        pBeats = mixxx::Beats::fromConstTempo(m_sampleRate, mixxx::audio::kStartFramePos, bpm);
+        mixxx::Bpm bpm = pPlugin->getBpm();
+        qDebug() << "AnalyzerBeats plugin detected constant BPM: " << bpm
+                 << (provisional ? "(provisional)" : "");
+        // Only provisional beats need a sub-version for marking them
+        pBeats = mixxx::Beats::fromConstTempo(m_sampleRate,
+                mixxx::audio::kStartFramePos,
+                bpm,
+                provisional ? BeatFactory::getPreferredSubVersion(extraVersionInfo)
+                            : QString());
     }
-
-    pTrack->trySetBeats(pBeats);
+    return pBeats;
 }
 
 // static
 QHash<QString, QString> AnalyzerBeats::getExtraVersionInfo(
-        const QString& pluginId, bool bPreferencesFastAnalysis) {
+        const QString& pluginId, bool bPreferencesFastAnalysis, bool provisional) {
     QHash<QString, QString> extraVersionInfo;
     extraVersionInfo["vamp_plugin_id"] = pluginId;
     if (bPreferencesFastAnalysis) {
         extraVersionInfo["fast_analysis"] = "1";
     }
+    if (provisional) {
+        BeatFactory::setProvisional(&extraVersionInfo);
+    }
     return extraVersionInfo;
 }
@@ -8,6 +8,8 @@
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/beatdetectionsettings.h"
 #include "preferences/usersettings.h"
+#include "track/beats.h"
+#include "track/track_decl.h"
 
 class AnalyzerBeats : public Analyzer {
   public:
@@ -28,8 +30,16 @@ class AnalyzerBeats : public Analyzer {
 
   private:
     bool shouldAnalyze(TrackPointer pTrack) const;
+    std::unique_ptr<mixxx::AnalyzerBeatsPlugin> createPlugin() const;
+    mixxx::BeatsPointer finalizeBeats(
+            mixxx::AnalyzerBeatsPlugin* pPlugin,
+            const TrackPointer& pTrack,
+            bool provisional) const;
+    void storeProvisionalResults();
     static QHash<QString, QString> getExtraVersionInfo(
-            const QString& pluginId, bool bPreferencesFastAnalysis);
+            const QString& pluginId,
+            bool bPreferencesFastAnalysis,
+            bool provisional = false);
 
     BeatDetectionSettings m_bpmSettings;
     std::unique_ptr<mixxx::AnalyzerBeatsPlugin> m_pPlugin;
@@ -43,4 +53,9 @@ class AnalyzerBeats : public Analyzer {
     mixxx::audio::SampleRate m_sampleRate;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
+
+    // Only in progressive mode until the provisional beats are stored
+    std::unique_ptr<mixxx::AnalyzerBeatsPlugin> m_pProvisionalPlugin;
+    TrackPointer m_pProvisionalTrack;
+    SINT m_maxProvisionalFramesToProcess;
 };
@@ -38,7 +38,8 @@ AnalyzerKey::AnalyzerKey(const KeyDetectionSettings& keySettings)
           m_currentFrame(0),
           m_bPreferencesKeyDetectionEnabled(true),
           m_bPreferencesFastAnalysisEnabled(false),
-          m_bPreferencesReanalyzeEnabled(false) {
+          m_bPreferencesReanalyzeEnabled(false),
+          m_maxProvisionalFramesToProcess(0) {
 }
 
 bool AnalyzerKey::initialize(const AnalyzerTrack& track,
@@ -90,18 +91,7 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
 
     DEBUG_ASSERT(!m_pPlugin);
     if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryKey::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryKey>();
-#if defined __KEYFINDER__
-        } else if (m_pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerKeyFinder>();
-#endif
-        } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
-        }
-
+        m_pPlugin = createPlugin();
         if (m_pPlugin) {
             if (m_pPlugin->initialize(mixxx::audio::SampleRate(m_sampleRate))) {
                 qDebug() << "Key calculation started with plugin" << m_pluginId;
@@ -114,9 +104,44 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
             bShouldAnalyze = false;
         }
     }
+
+    // In progressive mode, detect a provisional key from the beginning
+    // of the track with a second instance of the plugin. An existing key
+    // is not replaced by a provisional key, unless it is provisional.
+    DEBUG_ASSERT(!m_pProvisionalPlugin);
+    m_maxProvisionalFramesToProcess =
+            mixxx::kProvisionalAnalysisSecondsToAnalyze * m_sampleRate;
+    const Keys keys = track.getTrack()->getKeys();
+    if (bShouldAnalyze &&
+            track.getOptions().progressive &&
+            (keys.getGlobalKey() == mixxx::track::io::key::INVALID ||
+                    KeyFactory::isProvisionalSubVersion(keys.getSubVersion())) &&
+            m_maxFramesToProcess > m_maxProvisionalFramesToProcess) {
+        m_pProvisionalPlugin = createPlugin();
+        if (m_pProvisionalPlugin &&
+                m_pProvisionalPlugin->initialize(mixxx::audio::SampleRate(m_sampleRate))) {
+            m_pProvisionalTrack = track.getTrack();
+        } else {
+            m_pProvisionalPlugin.reset();
+        }
+    }
     return bShouldAnalyze;
 }
 
+std::unique_ptr<mixxx::AnalyzerKeyPlugin> AnalyzerKey::createPlugin() const {
+    if (m_pluginId == mixxx::AnalyzerQueenMaryKey::pluginInfo().id()) {
+        return std::make_unique<mixxx::AnalyzerQueenMaryKey>();
+#if defined __KEYFINDER__
+    } else if (m_pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
+        return std::make_unique<mixxx::AnalyzerKeyFinder>();
+#endif
+    }
+    // This must not happen, because we have already verified
+    // that the PlugInId is valid
+    DEBUG_ASSERT(false);
+    return nullptr;
+}
+
 bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
     bool bPreferencesFastAnalysisEnabled = m_keySettings.getFastAnalysis();
     QString pluginID = m_keySettings.getKeyPluginId();
@@ -125,6 +150,11 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
     }
 
     const Keys keys = pTrack->getKeys();
+    if (KeyFactory::isProvisionalSubVersion(keys.getSubVersion())) {
+        // The analysis has been interrupted after storing a provisional
+        // key in progressive mode.
+        return true;
+    }
     if (keys.getGlobalKey() != mixxx::track::io::key::INVALID) {
         QString version = keys.getVersion();
         QString subVersion = keys.getSubVersion();
@@ -156,6 +186,16 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
     }
 
     m_currentFrame += count / mixxx::kAnalysisChannels;
+
+    if (m_pProvisionalPlugin) {
+        if (!m_pProvisionalPlugin->processSamples(pIn, count)) {
+            m_pProvisionalPlugin.reset();
+            m_pProvisionalTrack.reset();
+        } else if (m_currentFrame >= m_maxProvisionalFramesToProcess) {
+            storeProvisionalResults();
+        }
+    }
+
     if (m_currentFrame > m_maxFramesToProcess) {
         return true; // silently ignore remaining samples
     }
@@ -165,6 +205,20 @@ bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
 
 void AnalyzerKey::cleanup() {
     m_pPlugin.reset();
+    m_pProvisionalPlugin.reset();
+    m_pProvisionalTrack.reset();
+}
+
+void AnalyzerKey::storeProvisionalResults() {
+    DEBUG_ASSERT(m_pProvisionalPlugin);
+    DEBUG_ASSERT(m_pProvisionalTrack);
+    if (m_pProvisionalPlugin->finalize()) {
+        m_pProvisionalTrack->setKeys(finalizeKeys(m_pProvisionalPlugin.get(), true));
+    } else {
+        qWarning() << "Provisional key detection failed";
+    }
+    m_pProvisionalPlugin.reset();
+    m_pProvisionalTrack.reset();
 }
 
 void AnalyzerKey::storeResults(TrackPointer tio) {
@@ -177,21 +231,28 @@ void AnalyzerKey::storeResults(TrackPointer tio) {
         return;
     }
 
-    KeyChangeList key_changes = m_pPlugin->getKeyChanges();
+    // Replaces a provisional key
+    tio->setKeys(finalizeKeys(m_pPlugin.get(), false));
+}
+
+Keys AnalyzerKey::finalizeKeys(mixxx::AnalyzerKeyPlugin* pPlugin, bool provisional) const {
+    KeyChangeList key_changes = pPlugin->getKeyChanges();
     QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
-            m_pluginId, m_bPreferencesFastAnalysisEnabled);
-    Keys track_keys = KeyFactory::makePreferredKeys(
+            m_pluginId, m_bPreferencesFastAnalysisEnabled, provisional);
+    return KeyFactory::makePreferredKeys(
             key_changes, extraVersionInfo, m_sampleRate, m_totalFrames);
-    tio->setKeys(track_keys);
 }
 
 // static
 QHash<QString, QString> AnalyzerKey::getExtraVersionInfo(
-        const QString& pluginId, bool bPreferencesFastAnalysis) {
+        const QString& pluginId, bool bPreferencesFastAnalysis, bool provisional) {
     QHash<QString, QString> extraVersionInfo;
     extraVersionInfo["vamp_plugin_id"] = pluginId;
     if (bPreferencesFastAnalysis) {
         extraVersionInfo["fast_analysis"] = "1";
     }
+    if (provisional) {
+        KeyFactory::setProvisional(&extraVersionInfo);
+    }
     return extraVersionInfo;
 }
@@ -8,6 +8,7 @@
 #include "analyzer/analyzer.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/keydetectionsettings.h"
+#include "track/keys.h"
 #include "track/track_decl.h"
 
 class AnalyzerKey : public Analyzer {
@@ -27,9 +28,14 @@ class AnalyzerKey : public Analyzer {
 
   private:
     static QHash<QString, QString> getExtraVersionInfo(
-            const QString& pluginId, bool bPreferencesFastAnalysis);
+            const QString& pluginId,
+            bool bPreferencesFastAnalysis,
+            bool provisional = false);
 
     bool shouldAnalyze(TrackPointer tio) const;
+    std::unique_ptr<mixxx::AnalyzerKeyPlugin> createPlugin() const;
+    Keys finalizeKeys(mixxx::AnalyzerKeyPlugin* pPlugin, bool provisional) const;
+    void storeProvisionalResults();
 
     KeyDetectionSettings m_keySettings;
     std::unique_ptr<mixxx::AnalyzerKeyPlugin> m_pPlugin;
@@ -42,4 +48,9 @@ class AnalyzerKey : public Analyzer {
     bool m_bPreferencesKeyDetectionEnabled;
     bool m_bPreferencesFastAnalysisEnabled;
     bool m_bPreferencesReanalyzeEnabled;
+
+    // Only in progressive mode until the provisional keys are stored
+    std::unique_ptr<mixxx::AnalyzerKeyPlugin> m_pProvisionalPlugin;
+    TrackPointer m_pProvisionalTrack;
+    SINT m_maxProvisionalFramesToProcess;
 };
@@ -0,0 +1,134 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <cstring>
+
+#include "analyzer/constants.h"
+#include "rigtorp/SPSCQueue.h"
+#include "util/assert.h"
+
+class AnalyzerPipeline::Stage : public QThread {
+  public:
+    Stage(AnalyzerPipeline* pPipeline, AnalyzerWithState* pAnalyzer)
+            : m_pPipeline(pPipeline),
+              m_pAnalyzer(pAnalyzer),
+              // A chunk is queued for every stage until all stages have
+              // processed it, so the queue never overflows
+              m_queue(kNumChunks),
+              m_quit(false) {
+    }
+
+    void push(Chunk* pChunk) {
+        const bool pushed = m_queue.try_push(pChunk);
+        DEBUG_ASSERT(pushed);
+        m_queuedChunks.release();
+    }
+
+    void quit() {
+        m_quit.store(true, std::memory_order_relaxed);
+        m_queuedChunks.release();
+    }
+
+  protected:
+    void run() override {
+        while (true) {
+            m_queuedChunks.acquire();
+            Chunk** ppChunk = m_queue.front();
+            if (!ppChunk) {
+                // Only woken up for quitting
+                DEBUG_ASSERT(m_quit.load(std::memory_order_relaxed));
+                return;
+            }
+            Chunk* pChunk = *ppChunk;
+            m_queue.pop();
+            // Stops processing, if the analyzer has failed
+            m_pAnalyzer->processSamples(pChunk->buffer.data(), pChunk->numSamples);
+            m_pPipeline->chunkProcessed(pChunk);
+        }
+    }
+
+  private:
+    AnalyzerPipeline* const m_pPipeline;
+    AnalyzerWithState* const m_pAnalyzer;
+    rigtorp::SPSCQueue<Chunk*> m_queue;
+    QSemaphore m_queuedChunks;
+    std::atomic<bool> m_quit;
+};
+
+AnalyzerPipeline::AnalyzerPipeline(
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        QThread::Priority priority)
+        : m_freeChunks(kNumChunks),
+          m_nextChunk(0),
+          m_nextChunkAcquired(false) {
+    m_chunks.reserve(kNumChunks);
+    for (int i = 0; i < kNumChunks; ++i) {
+        m_chunks.push_back(std::make_unique<Chunk>(mixxx::kAnalysisSamplesPerChunk));
+    }
+    m_stages.reserve(pAnalyzers->size());
+    for (auto& analyzer : *pAnalyzers) {
+        m_stages.push_back(std::make_unique<Stage>(this, &analyzer));
+        m_stages.back()->setObjectName(QStringLiteral("AnalyzerPipeline %1")
+                                               .arg(m_stages.size()));
+        m_stages.back()->start(priority);
+    }
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    waitUntilIdle();
+    for (const auto& pStage : m_stages) {
+        pStage->quit();
+    }
+    for (const auto& pStage : m_stages) {
+        pStage->wait();
+    }
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::nextChunk() {
+    if (!m_nextChunkAcquired) {
+        // The chunks are processed in order by all stages, so the buffer
+        // that has been submitted first is free once any buffer is free.
+        m_freeChunks.acquire();
+        m_nextChunkAcquired = true;
+    }
+    return mixxx::SampleBuffer::WritableSlice(m_chunks[m_nextChunk]->buffer);
+}
+
+void AnalyzerPipeline::submitChunk(const CSAMPLE* pSamples, SINT numSamples) {
+    Chunk* pChunk = m_chunks[m_nextChunk].get();
+    DEBUG_ASSERT(m_nextChunkAcquired);
+    VERIFY_OR_DEBUG_ASSERT(numSamples <= pChunk->buffer.size()) {
+        numSamples = pChunk->buffer.size();
+    }
+    if (pSamples != pChunk->buffer.data()) {
+        // The samples may have been decoded into the buffer at an offset,
+        // so the ranges can overlap
+        std::memmove(pChunk->buffer.data(), pSamples, numSamples * sizeof(CSAMPLE));
+    }
+    pChunk->numSamples = numSamples;
+    if (m_stages.empty()) {
+        return;
+    }
+    pChunk->pendingStages.store(static_cast<int>(m_stages.size()),
+            std::memory_order_relaxed);
+    // Pushing to the queues publishes the chunk to the stages
+    for (const auto& pStage : m_stages) {
+        pStage->push(pChunk);
+    }
+    m_nextChunk = (m_nextChunk + 1) % kNumChunks;
+    m_nextChunkAcquired = false;
+}
+
+void AnalyzerPipeline::waitUntilIdle() {
+    if (m_nextChunkAcquired) {
+        m_freeChunks.release();
+        m_nextChunkAcquired = false;
+    }
+    m_freeChunks.acquire(kNumChunks);
+    m_freeChunks.release(kNumChunks);
+}
+
+void AnalyzerPipeline::chunkProcessed(Chunk* pChunk) {
+    if (pChunk->pendingStages.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        m_freeChunks.release();
+    }
+}
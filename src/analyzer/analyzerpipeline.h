@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/class.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// AnalyzerPipeline runs each analyzer of an AnalyzerThread on its own
+/// thread, so the decoding and the analysis of a single track use several
+/// CPU cores at once.
+///
+/// The decoded chunks are stored in a ring of buffers that are shared
+/// read-only by all stages. Every stage receives the chunks in order through
+/// its own bounded SPSC queue. A buffer is reused once all stages have
+/// processed its chunk, so the decoder never runs more than kNumChunks
+/// ahead of the slowest analyzer.
+///
+/// All methods must be called from the thread that owns the analyzers.
+class AnalyzerPipeline final {
+  public:
+    static constexpr int kNumChunks = 8;
+
+    /// Spawns one stage thread per analyzer. The analyzers must outlive
+    /// the pipeline and must not be added or removed while it exists.
+    AnalyzerPipeline(std::vector<AnalyzerWithState>* pAnalyzers,
+            QThread::Priority priority);
+    ~AnalyzerPipeline();
+
+    /// Returns the buffer for the next chunk. Blocks while all buffers
+    /// are in use by the stages. The same buffer is returned until it
+    /// has been submitted.
+    mixxx::SampleBuffer::WritableSlice nextChunk();
+
+    /// Passes the next chunk to all analyzers. The samples are copied into
+    /// the buffer returned by nextChunk() unless they are already stored there.
+    void submitChunk(const CSAMPLE* pSamples, SINT numSamples);
+
+    /// Blocks until all stages have processed all submitted chunks.
+    /// Afterwards the analyzers may be used by the calling thread again,
+    /// e.g. to store the results or to cancel the analysis.
+    void waitUntilIdle();
+
+  private:
+    struct Chunk {
+        explicit Chunk(SINT size)
+                : buffer(size),
+                  numSamples(0),
+                  pendingStages(0) {
+        }
+
+        mixxx::SampleBuffer buffer;
+        SINT numSamples;
+        std::atomic<int> pendingStages;
+    };
+
+    class Stage;
+
+    void chunkProcessed(Chunk* pChunk);
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    std::vector<std::unique_ptr<Stage>> m_stages;
+
+    // Counts the buffers that are not in use by any stage
+    QSemaphore m_freeChunks;
+    int m_nextChunk;
+    bool m_nextChunkAcquired;
+
+    DISALLOW_COPY_AND_ASSIGN(AnalyzerPipeline);
+};
@@ -6,8 +6,25 @@
 /// A track to be scheduled for analysis with additional options.
 class AnalyzerScheduledTrack {
   public:
+    /// The urgency of the analysis, ordered from lowest to highest.
+    /// Tracks with a higher priority are analyzed first and may preempt
+    /// the analysis of tracks with a lower priority.
+    enum class Priority {
+        /// Batch analysis of many tracks, e.g. a whole crate
+        Bulk,
+        /// Tracks that are currently displayed as search results
+        SearchResults,
+        /// Tracks loaded into a preview deck
+        PreviewDeck,
+        /// Tracks at the head of the Auto DJ queue
+        AutoDJ,
+        /// Tracks loaded into a deck or sampler
+        Deck,
+    };
+
     AnalyzerScheduledTrack(TrackId trackId,
-            AnalyzerTrack::Options options = AnalyzerTrack::Options());
+            AnalyzerTrack::Options options = AnalyzerTrack::Options(),
+            Priority priority = Priority::Bulk);
 
     /// Fetches the id of the track to be analyzed.
     const TrackId& getTrackId() const;
@@ -15,11 +32,16 @@ class AnalyzerScheduledTrack {
     /// Fetches the additional options.
     const AnalyzerTrack::Options& getOptions() const;
 
+    /// Fetches the priority.
+    Priority getPriority() const;
+
   private:
     /// The id of the track to be analyzed.
     TrackId m_trackId;
     /// The additional options.
     AnalyzerTrack::Options m_options;
+    /// The priority.
+    Priority m_priority;
 };
 
 Q_DECLARE_TYPEINFO(AnalyzerScheduledTrack, Q_MOVABLE_TYPE);
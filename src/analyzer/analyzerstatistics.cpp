@@ -0,0 +1,36 @@
+#include "analyzer/analyzerstatistics.h"
+
+#include "util/compatibility/qmutex.h"
+
+double AnalyzerStatistics::Entry::realtimeFactor() const {
+    if (processingDuration.toIntegerNanos() <= 0) {
+        return 0;
+    }
+    return audioDuration.toDoubleSeconds() / processingDuration.toDoubleSeconds();
+}
+
+void AnalyzerStatistics::addTrack(
+        const QString& analyzerName,
+        mixxx::Duration audioDuration,
+        mixxx::Duration processingDuration) {
+    const auto locker = lockMutex(&m_mutex);
+    for (auto& entry : m_entries) {
+        if (entry.analyzerName == analyzerName) {
+            ++entry.trackCount;
+            entry.audioDuration += audioDuration;
+            entry.processingDuration += processingDuration;
+            return;
+        }
+    }
+    Entry entry;
+    entry.analyzerName = analyzerName;
+    entry.trackCount = 1;
+    entry.audioDuration = audioDuration;
+    entry.processingDuration = processingDuration;
+    m_entries.append(std::move(entry));
+}
+
+QList<AnalyzerStatistics::Entry> AnalyzerStatistics::entries() const {
+    const auto locker = lockMutex(&m_mutex);
+    return m_entries;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "util/duration.h"
+
+/// Accumulates how long each analyzer took for how much audio, across
+/// all tracks and all worker threads of a TrackAnalysisScheduler.
+///
+/// Thread-safe, but not intended to be used from real-time threads.
+class AnalyzerStatistics final {
+  public:
+    struct Entry {
+        QString analyzerName;
+        int trackCount = 0;
+        mixxx::Duration audioDuration;
+        mixxx::Duration processingDuration;
+
+        /// How many seconds of audio were analyzed per second of
+        /// processing time, or 0 if unknown.
+        double realtimeFactor() const;
+    };
+
+    /// Adds the analysis of a single track by a single analyzer.
+    void addTrack(
+            const QString& analyzerName,
+            mixxx::Duration audioDuration,
+            mixxx::Duration processingDuration);
+
+    /// Returns a snapshot of all entries, in the order of their first
+    /// occurrence.
+    QList<Entry> entries() const;
+
+  private:
+    mutable QMutex m_mutex;
+    QList<Entry> m_entries;
+};
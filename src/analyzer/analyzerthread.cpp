@@ -60,12 +60,14 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalyzerStatistics> pStatistics) {
     return Pointer(new AnalyzerThread(
                            id,
                            dbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           std::move(pStatistics)),
             deleteAnalyzerThread);
 }
 
@@ -73,7 +75,8 @@ AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
         UserSettingsPointer pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalyzerStatistics> pStatistics)
         : WorkerThread(
             QString("AnalyzerThread %1").arg(id),
             (modeFlags & AnalyzerModeFlags::LowPriority ? QThread::LowPriority : QThread::InheritPriority)),
@@ -81,7 +84,9 @@ AnalyzerThread::AnalyzerThread(
           m_dbConnectionPool(std::move(dbConnectionPool)),
           m_pConfig(pConfig),
           m_modeFlags(modeFlags),
+          m_pStatistics(std::move(pStatistics)),
           m_nextTrack(2), // minimum capacity
+          m_preemptCurrentTrack(false),
           m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk),
           m_emittedState(AnalyzerThreadState::Void) {
     std::call_once(registerMetaTypesOnceFlag, registerMetaTypesOnce);
@@ -101,23 +106,39 @@ void AnalyzerThread::doRun() {
             return;
         }
         QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_dbConnectionPool);
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection)));
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<AnalyzerWaveform>(m_pConfig, dbConnection),
+                QStringLiteral("Waveform")));
     }
     if (AnalyzerGain::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerGain>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<AnalyzerGain>(m_pConfig),
+                QStringLiteral("ReplayGain")));
     }
     if (AnalyzerEbur128::isEnabled(ReplayGainSettings(m_pConfig))) {
-        m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerEbur128>(m_pConfig)));
+        m_analyzers.push_back(AnalyzerWithState(
+                std::make_unique<AnalyzerEbur128>(m_pConfig),
+                QStringLiteral("ReplayGain 2.0")));
     }
     // BPM detection might be disabled in the config, but can be overridden
     // and enabled by explicitly setting the mode flag.
     const bool enforceBpmDetection = (m_modeFlags & AnalyzerModeFlags::WithBeats) != 0;
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerKey>(m_pConfig)));
-    m_analyzers.push_back(AnalyzerWithState(std::make_unique<AnalyzerSilence>(m_pConfig)));
+    m_analyzers.push_back(AnalyzerWithState(
+            std::make_unique<AnalyzerBeats>(m_pConfig, enforceBpmDetection),
+            QStringLiteral("Beats")));
+    m_analyzers.push_back(AnalyzerWithState(
+            std::make_unique<AnalyzerKey>(m_pConfig),
+            QStringLiteral("Key")));
+    m_analyzers.push_back(AnalyzerWithState(
+            std::make_unique<AnalyzerSilence>(m_pConfig),
+            QStringLiteral("Silence")));
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+        kLogger.debug() << "Analyzing in a pipeline with one thread per analyzer";
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -150,8 +171,21 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
+            if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+                // The stage threads only exist while a track is analyzed,
+                // an idle analyzer thread doesn't keep them alive
+                m_pPipeline = std::make_unique<AnalyzerPipeline>(&m_analyzers,
+                        m_modeFlags & AnalyzerModeFlags::LowPriority
+                                ? QThread::LowPriority
+                                : QThread::InheritPriority);
+            }
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
+            if (m_pPipeline) {
+                // Waits until the analyzers have processed the last chunks
+                // and joins the stage threads
+                m_pPipeline.reset();
+            }
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
@@ -164,6 +198,7 @@ void AnalyzerThread::doRun() {
                 for (auto&& analyzer : m_analyzers) {
                     analyzer.finish(*m_currentTrack);
                 }
+                addStatistics(audioSource->getSignalInfo().getSampleRate());
                 emitDoneProgress(kAnalyzerProgressDone);
             } else {
                 for (auto&& analyzer : m_analyzers) {
@@ -179,6 +214,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    DEBUG_ASSERT(!m_pPipeline);
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -200,12 +236,18 @@ bool AnalyzerThread::submitNextTrack(const AnalyzerTrack& nextTrack) {
     return false;
 }
 
+void AnalyzerThread::preemptCurrentTrack() {
+    kLogger.debug() << "Preempting current track";
+    m_preemptCurrentTrack.store(true);
+}
+
 WorkerThread::TryFetchWorkItemsResult AnalyzerThread::tryFetchWorkItems() {
     DEBUG_ASSERT(!m_currentTrack.has_value());
     AnalyzerTrack* pFront = m_nextTrack.front();
     if (pFront) {
         m_currentTrack = *pFront;
         m_nextTrack.pop();
+        m_preemptCurrentTrack.store(false);
         kLogger.debug()
                 << "Dequeued next track"
                 << m_currentTrack->getTrack()->getId();
@@ -233,7 +275,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
     while (!remainingFrameRange.empty()) {
         sleepWhileSuspended();
-        if (isStopping()) {
+        if (isCancelled()) {
             return AnalysisResult::Cancelled;
         }
 
@@ -245,12 +287,16 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
+        // Request the next chunk of audio data. In a pipeline it is decoded
+        // into a buffer that is shared with the analyzer threads.
         const auto readableSampleFrames =
                 audioSourceProxy.readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                m_pPipeline
+                                        ? m_pPipeline->nextChunk()
+                                        : mixxx::SampleBuffer::WritableSlice(
+                                                  m_sampleBuffer)));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -289,16 +335,22 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
         }
 
         sleepWhileSuspended();
-        if (isStopping()) {
+        if (isCancelled()) {
             return AnalysisResult::Cancelled;
         }
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            if (m_pPipeline) {
+                m_pPipeline->submitChunk(
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+            } else {
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength());
+                }
             }
         }
 
@@ -327,6 +379,25 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     return AnalysisResult::Finished;
 }
 
+void AnalyzerThread::addStatistics(mixxx::audio::SampleRate sampleRate) {
+    if (!m_pStatistics || !sampleRate.isValid()) {
+        return;
+    }
+    for (const auto& analyzer : m_analyzers) {
+        if (analyzer.processedSamples() <= 0) {
+            // Skipped, e.g. because the results were already available
+            continue;
+        }
+        const auto audioDuration = mixxx::Duration::fromSeconds(
+                static_cast<double>(analyzer.processedSamples()) /
+                (mixxx::kAnalysisChannels * sampleRate.toDouble()));
+        m_pStatistics->addTrack(
+                analyzer.name(),
+                audioDuration,
+                analyzer.processingDuration());
+    }
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
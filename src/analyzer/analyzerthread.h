@@ -1,11 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
+#include "analyzer/analyzerstatistics.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
 #include "rigtorp/SPSCQueue.h"
@@ -22,6 +25,8 @@ enum AnalyzerModeFlags {
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Runs every analyzer on its own thread, see AnalyzerPipeline
+    Pipelined = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -59,13 +64,15 @@ class AnalyzerThread : public WorkerThread {
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalyzerStatistics> pStatistics);
 
     /*private*/ AnalyzerThread(
             int id,
             mixxx::DbConnectionPoolPtr dbConnectionPool,
             UserSettingsPointer pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalyzerStatistics> pStatistics);
     ~AnalyzerThread() override = default;
 
     int id() const {
@@ -79,6 +86,13 @@ class AnalyzerThread : public WorkerThread {
     // worker thread, yet.
     bool submitNextTrack(const AnalyzerTrack& nextTrack);
 
+    // Aborts the analysis of the current track without blocking, e.g.
+    // to make room for a track with a higher priority. The track is
+    // reported as Done with an unknown progress. Must only be invoked
+    // after a progress() signal with state Busy has been received for
+    // the current track, otherwise the request might get lost.
+    void preemptCurrentTrack();
+
   signals:
     // Use a single signal for progress updates to ensure that all signals
     // are queued and received in the same order as emitted from the internal
@@ -100,6 +114,8 @@ class AnalyzerThread : public WorkerThread {
     const mixxx::DbConnectionPoolPtr m_dbConnectionPool;
     const UserSettingsPointer m_pConfig;
     const AnalyzerModeFlags m_modeFlags;
+    // Optional, shared by all threads of a TrackAnalysisScheduler
+    const std::shared_ptr<AnalyzerStatistics> m_pStatistics;
 
     /////////////////////////////////////////////////////////////////////////
     // Thread-safe atomic values
@@ -112,12 +128,18 @@ class AnalyzerThread : public WorkerThread {
     // for this purpose, which will become available in C++20.
     rigtorp::SPSCQueue<AnalyzerTrack> m_nextTrack;
 
+    // Reset by the worker thread when starting with the next track
+    std::atomic<bool> m_preemptCurrentTrack;
+
     /////////////////////////////////////////////////////////////////////////
     // Thread local: Only used in the constructor/destructor and within
     // run() by the worker thread.
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    // Only while a track is analyzed with AnalyzerModeFlags::Pipelined
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     mixxx::SampleBuffer m_sampleBuffer;
 
     std::optional<AnalyzerTrack> m_currentTrack;
@@ -131,9 +153,15 @@ class AnalyzerThread : public WorkerThread {
         Finished,
         Cancelled,
     };
+    bool isCancelled() const {
+        return isStopping() || m_preemptCurrentTrack.load();
+    }
+
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
 
+    void addStatistics(mixxx::audio::SampleRate sampleRate);
+
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
 
@@ -10,6 +10,10 @@ class AnalyzerTrack {
     struct Options {
         /// If set, overrides whether the analysis should assume constant BPM.
         std::optional<bool> useFixedTempo;
+        /// If set, provisional beats and keys are stored after analyzing
+        /// only the beginning of a track that has none yet. They are
+        /// replaced when the whole track has been analyzed.
+        bool progressive = false;
     };
 
     explicit AnalyzerTrack(TrackPointer track, Options options = Options());
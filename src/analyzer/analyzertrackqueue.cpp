@@ -0,0 +1,81 @@
+#include "analyzer/analyzertrackqueue.h"
+
+#include <algorithm>
+
+#include "util/assert.h"
+
+AnalyzerTrackQueue::AnalyzerTrackQueue()
+        : m_nextSequenceNumber(0) {
+}
+
+bool AnalyzerTrackQueue::enqueue(
+        const AnalyzerScheduledTrack& track,
+        Clock::time_point now) {
+    DEBUG_ASSERT(track.getTrackId().isValid());
+    const auto i = m_entriesByTrackId.find(track.getTrackId());
+    if (i != m_entriesByTrackId.end()) {
+        if (track.getPriority() > i->second->priority) {
+            // The more urgent request also determines the options
+            auto node = m_entries.extract(i->second);
+            node.value().track = track;
+            node.value().priority = track.getPriority();
+            i->second = m_entries.insert(std::move(node)).position;
+        }
+        return false;
+    }
+    insert(Entry{track, track.getPriority(), m_nextSequenceNumber++, now});
+    return true;
+}
+
+void AnalyzerTrackQueue::requeue(Entry entry) {
+    DEBUG_ASSERT(entry.sequenceNumber < m_nextSequenceNumber);
+    const auto i = m_entriesByTrackId.find(entry.trackId());
+    if (i != m_entriesByTrackId.end()) {
+        // Enqueued again in the meantime, merge both entries
+        Entry queuedEntry = *i->second;
+        m_entries.erase(i->second);
+        m_entriesByTrackId.erase(i);
+        entry.priority = std::max(entry.priority, queuedEntry.priority);
+        entry.sequenceNumber = std::min(entry.sequenceNumber, queuedEntry.sequenceNumber);
+        entry.enqueuedAt = std::min(entry.enqueuedAt, queuedEntry.enqueuedAt);
+    }
+    insert(std::move(entry));
+}
+
+bool AnalyzerTrackQueue::setPriority(TrackId trackId, Priority priority) {
+    const auto i = m_entriesByTrackId.find(trackId);
+    if (i == m_entriesByTrackId.end()) {
+        return false;
+    }
+    if (i->second->priority == priority) {
+        return true;
+    }
+    auto node = m_entries.extract(i->second);
+    node.value().priority = priority;
+    i->second = m_entries.insert(std::move(node)).position;
+    return true;
+}
+
+const AnalyzerTrackQueue::Entry& AnalyzerTrackQueue::front() const {
+    DEBUG_ASSERT(!empty());
+    return *m_entries.begin();
+}
+
+AnalyzerTrackQueue::Entry AnalyzerTrackQueue::dequeue() {
+    DEBUG_ASSERT(!empty());
+    Entry entry = std::move(m_entries.extract(m_entries.begin()).value());
+    m_entriesByTrackId.erase(entry.trackId());
+    return entry;
+}
+
+void AnalyzerTrackQueue::clear() {
+    m_entries.clear();
+    m_entriesByTrackId.clear();
+}
+
+void AnalyzerTrackQueue::insert(Entry entry) {
+    const TrackId trackId = entry.trackId();
+    const auto inserted = m_entries.insert(std::move(entry));
+    DEBUG_ASSERT(inserted.second);
+    m_entriesByTrackId.emplace(trackId, inserted.first);
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QtGlobal>
+#include <chrono>
+#include <map>
+#include <set>
+
+#include "analyzer/analyzerscheduledtrack.h"
+#include "track/trackid.h"
+
+/// Tracks waiting for their analysis, ordered by priority and then
+/// by the order in which they have been enqueued.
+///
+/// Each track is contained at most once. Enqueuing a track that is
+/// already queued only has an effect if its priority is higher, then
+/// both the priority and the options are replaced.
+///
+/// Not thread-safe, it is only accessed by the TrackAnalysisScheduler.
+class AnalyzerTrackQueue final {
+  public:
+    typedef std::chrono::steady_clock Clock;
+    typedef AnalyzerScheduledTrack::Priority Priority;
+
+    struct Entry {
+        AnalyzerScheduledTrack track;
+        // The current priority, which may differ from the initial
+        // priority of the track
+        Priority priority;
+        // Preserves the order of tracks with the same priority
+        quint64 sequenceNumber;
+        // When the track has been enqueued for the first time
+        Clock::time_point enqueuedAt;
+
+        TrackId trackId() const {
+            return track.getTrackId();
+        }
+
+        // Highest priority first
+        bool operator<(const Entry& other) const {
+            if (priority != other.priority) {
+                return priority > other.priority;
+            }
+            return sequenceNumber < other.sequenceNumber;
+        }
+    };
+
+    typedef std::set<Entry>::const_iterator const_iterator;
+
+    AnalyzerTrackQueue();
+
+    /// Returns false if the track has already been queued.
+    bool enqueue(const AnalyzerScheduledTrack& track,
+            Clock::time_point now = Clock::now());
+
+    /// Puts back a track that has been dequeued before at its
+    /// original position, e.g. after its analysis has been preempted.
+    void requeue(Entry entry);
+
+    /// Returns false if the track is not queued.
+    bool setPriority(TrackId trackId, Priority priority);
+
+    bool contains(TrackId trackId) const {
+        return m_entriesByTrackId.find(trackId) != m_entriesByTrackId.end();
+    }
+
+    bool empty() const {
+        return m_entries.empty();
+    }
+
+    int size() const {
+        return static_cast<int>(m_entries.size());
+    }
+
+    const_iterator begin() const {
+        return m_entries.begin();
+    }
+
+    const_iterator end() const {
+        return m_entries.end();
+    }
+
+    const Entry& front() const;
+
+    Entry dequeue();
+
+    void clear();
+
+  private:
+    void insert(Entry entry);
+
+    std::set<Entry> m_entries;
+    std::map<TrackId, std::set<Entry>::const_iterator> m_entriesByTrackId;
+    quint64 m_nextSequenceNumber;
+};
@@ -16,4 +16,8 @@ constexpr SINT kAnalysisSamplesPerChunk =
 // Only analyze the first minute in fast-analysis mode.
 constexpr SINT kFastAnalysisSecondsToAnalyze = 60;
 
+// Provisional beats and keys are detected from the first seconds
+// in progressive mode, see AnalyzerTrack::Options.
+constexpr SINT kProvisionalAnalysisSecondsToAnalyze = 20;
+
 }  // namespace mixxx
@@ -3,8 +3,10 @@
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
+#include "track/track.h"
 #include "track/trackid.h"
 #include "util/logger.h"
+#include "util/stat.h"
 
 namespace {
 
@@ -15,6 +17,42 @@ constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
+QString priorityName(AnalyzerScheduledTrack::Priority priority) {
+    switch (priority) {
+    case AnalyzerScheduledTrack::Priority::Bulk:
+        return QStringLiteral("Bulk");
+    case AnalyzerScheduledTrack::Priority::SearchResults:
+        return QStringLiteral("SearchResults");
+    case AnalyzerScheduledTrack::Priority::PreviewDeck:
+        return QStringLiteral("PreviewDeck");
+    case AnalyzerScheduledTrack::Priority::AutoDJ:
+        return QStringLiteral("AutoDJ");
+    case AnalyzerScheduledTrack::Priority::Deck:
+        return QStringLiteral("Deck");
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return QString();
+}
+
+void trackTimeSinceEnqueued(const QString& tag,
+        AnalyzerScheduledTrack::Priority priority,
+        AnalyzerTrackQueue::Clock::time_point enqueuedAt) {
+    const auto latency = AnalyzerTrackQueue::Clock::now() - enqueuedAt;
+    Stat::track(QStringLiteral("TrackAnalysisScheduler ") + tag + priorityName(priority),
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+            static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(latency)
+                            .count()));
+}
+
+// Reports how long a track had to wait from being scheduled, e.g. when
+// loading it into a deck, until all results including the beat grid
+// became available.
+void trackLatency(const AnalyzerTrackQueue::Entry& entry) {
+    trackTimeSinceEnqueued(QStringLiteral("latency "), entry.priority, entry.enqueuedAt);
+}
+
 void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
     if (plainPtr) {
         // Trigger stop
@@ -36,13 +74,15 @@ TrackAnalysisScheduler::Pointer TrackAnalysisScheduler::createInstance(
         int numWorkerThreads,
         const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
         const UserSettingsPointer& pConfig,
-        AnalyzerModeFlags modeFlags) {
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalyzerStatistics> pStatistics) {
     return Pointer(new TrackAnalysisScheduler(
                            std::move(pEnvironment),
                            numWorkerThreads,
                            pDbConnectionPool,
                            pConfig,
-                           modeFlags),
+                           modeFlags,
+                           std::move(pStatistics)),
             deleteTrackAnalysisScheduler);
 }
 
@@ -51,11 +91,15 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
         int numWorkerThreads,
         const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
         const UserSettingsPointer& pConfig,
-        AnalyzerModeFlags modeFlags)
+        AnalyzerModeFlags modeFlags,
+        std::shared_ptr<AnalyzerStatistics> pStatistics)
         : m_pEnvironment(std::move(pEnvironment)),
           m_currentTrackProgress(kAnalyzerProgressUnknown),
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
+          // The worker threads are started suspended
+          m_suspended(true),
+          m_yielding(false),
           // The first signal should always be emitted
           m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration) {
     DEBUG_ASSERT(m_pEnvironment);
@@ -77,7 +121,8 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
                 threadId,
                 pDbConnectionPool,
                 pConfig,
-                modeFlags));
+                modeFlags,
+                pStatistics));
         connect(m_workers.back().thread(),
                 &AnalyzerThread::progress,
                 this,
@@ -112,10 +157,10 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
     }
     m_lastProgressEmittedAt = now;
 
-    DEBUG_ASSERT(m_pendingTrackIds.size() <=
+    DEBUG_ASSERT(m_pendingTracks.size() <=
             static_cast<size_t>(m_dequeuedTracksCount));
     const int finishedTracksCount =
-            m_dequeuedTracksCount - static_cast<int>(m_pendingTrackIds.size());
+            m_dequeuedTracksCount - static_cast<int>(m_pendingTracks.size());
 
     AnalyzerProgress workerProgressSum = 0;
     int workerProgressCount = 0;
@@ -170,7 +215,7 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
         }
     }
     const int totalTracksCount =
-            m_dequeuedTracksCount + static_cast<int>(m_queuedTracks.size());
+            m_dequeuedTracksCount + m_queuedTracks.size();
     DEBUG_ASSERT(m_currentTrackNumber <= m_dequeuedTracksCount);
     DEBUG_ASSERT(m_dequeuedTracksCount <= totalTracksCount);
     emit progress(
@@ -206,24 +251,38 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
     case AnalyzerThreadState::Busy:
         DEBUG_ASSERT(trackId.isValid());
         // Ignore delayed signals for tracks that are no longer pending
-        if (m_pendingTrackIds.find(trackId) != m_pendingTrackIds.end()) {
+        if (m_pendingTracks.find(trackId) != m_pendingTracks.end()) {
             DEBUG_ASSERT(analyzerProgress != kAnalyzerProgressUnknown);
             DEBUG_ASSERT(analyzerProgress < kAnalyzerProgressDone);
             worker.onAnalyzerProgress(analyzerProgress);
             emit trackProgress(trackId, analyzerProgress);
         }
         break;
-    case AnalyzerThreadState::Done:
+    case AnalyzerThreadState::Done: {
         DEBUG_ASSERT(trackId.isValid());
+        DEBUG_ASSERT(trackId == worker.trackId());
+        const bool preempted = worker.isPreempted();
+        worker.onTrackDone();
         // Ignore delayed signals for tracks that are no longer pending
-        if (m_pendingTrackIds.find(trackId) != m_pendingTrackIds.end()) {
+        const auto pendingTrack = m_pendingTracks.find(trackId);
+        if (pendingTrack != m_pendingTracks.end()) {
             DEBUG_ASSERT((analyzerProgress == kAnalyzerProgressDone) // success
                     || (analyzerProgress == kAnalyzerProgressUnknown)); // failure
-            m_pendingTrackIds.erase(trackId);
+            AnalyzerTrackQueue::Entry entry = std::move(pendingTrack->second);
+            m_pendingTracks.erase(pendingTrack);
             worker.onAnalyzerProgress(analyzerProgress);
-            emit trackProgress(trackId, analyzerProgress);
+            if (preempted && analyzerProgress == kAnalyzerProgressUnknown) {
+                requeuePreemptedTrack(std::move(entry));
+            } else {
+                stopAwaitingBeats(trackId);
+                if (analyzerProgress == kAnalyzerProgressDone) {
+                    trackLatency(entry);
+                }
+                emit trackProgress(trackId, analyzerProgress);
+            }
         }
         break;
+    }
     case AnalyzerThreadState::Exit:
         DEBUG_ASSERT(!trackId.isValid());
         DEBUG_ASSERT(analyzerProgress == kAnalyzerProgressUnknown);
@@ -243,7 +302,15 @@ bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    const auto pendingTrack = m_pendingTracks.find(track.getTrackId());
+    if (pendingTrack != m_pendingTracks.end()) {
+        // This track is currently analyzed by one of the workers
+        if (pendingTrack->second.priority < track.getPriority()) {
+            pendingTrack->second.priority = track.getPriority();
+        }
+        return true;
+    }
+    m_queuedTracks.enqueue(track);
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
@@ -261,8 +328,32 @@ int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>&
     return scheduledCount;
 }
 
+bool TrackAnalysisScheduler::setTrackPriority(
+        TrackId trackId,
+        AnalyzerScheduledTrack::Priority priority) {
+    if (!m_queuedTracks.setPriority(trackId, priority)) {
+        const auto pendingTrack = m_pendingTracks.find(trackId);
+        if (pendingTrack == m_pendingTracks.end()) {
+            return false;
+        }
+        pendingTrack->second.priority = priority;
+    }
+    preemptLowerPriorityTracks();
+    return true;
+}
+
+bool TrackAnalysisScheduler::isStopped() const {
+    for (const auto& worker : m_workers) {
+        if (worker) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
+    m_suspended = true;
     for (auto& worker: m_workers) {
         worker.suspendThread();
     }
@@ -270,31 +361,57 @@ void TrackAnalysisScheduler::suspend() {
 
 void TrackAnalysisScheduler::resume() {
     kLogger.debug() << "Resuming";
+    preemptLowerPriorityTracks();
+    m_suspended = false;
+    if (m_yielding) {
+        kLogger.debug() << "Worker threads stay suspended while yielding";
+        return;
+    }
     for (auto& worker: m_workers) {
         worker.resumeThread();
     }
 }
 
+void TrackAnalysisScheduler::setYielding(bool yielding) {
+    if (m_yielding == yielding) {
+        return;
+    }
+    m_yielding = yielding;
+    if (yielding) {
+        kLogger.debug() << "Yielding";
+        for (auto& worker : m_workers) {
+            worker.suspendThread();
+        }
+    } else if (!m_suspended) {
+        kLogger.debug() << "Continuing after yielding";
+        for (auto& worker : m_workers) {
+            worker.resumeThread();
+        }
+    }
+}
+
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
     while (!m_queuedTracks.empty()) {
-        AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
-        TrackId nextTrackId = nextScheduledTrack.getTrackId();
+        const AnalyzerTrackQueue::Entry& nextEntry = m_queuedTracks.front();
+        TrackId nextTrackId = nextEntry.trackId();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
             TrackPointer nextTrackPtr =
                     m_pEnvironment->loadTrackById(nextTrackId);
             if (nextTrackPtr) {
-                AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
-                if (m_pendingTrackIds.insert(nextTrackId).second) {
-                    if (worker->submitNextTrack(std::move(nextTrack))) {
-                        m_queuedTracks.pop_front();
+                AnalyzerTrack nextTrack(nextTrackPtr, nextEntry.track.getOptions());
+                if (m_pendingTracks.find(nextTrackId) == m_pendingTracks.end()) {
+                    if (worker->submitNextTrack(nextTrackId, std::move(nextTrack))) {
+                        if (nextEntry.track.getOptions().progressive) {
+                            awaitBeats(nextTrackPtr, nextEntry);
+                        }
+                        m_pendingTracks.emplace(nextTrackId, m_queuedTracks.dequeue());
                         ++m_dequeuedTracksCount;
                         return true;
                     } else {
                         // The worker may already have been assigned new tasks
                         // in the mean time, nothing to worry about.
-                        m_pendingTrackIds.erase(nextTrackId);
                         kLogger.debug()
                                 << "Failed to submit next track - worker thread"
                                 << worker->thread()->id()
@@ -319,12 +436,99 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                     << nextTrackId;
         }
         // Skip this track
-        m_queuedTracks.pop_front();
+        m_queuedTracks.dequeue();
         ++m_dequeuedTracksCount;
     }
     return false;
 }
 
+void TrackAnalysisScheduler::awaitBeats(
+        const TrackPointer& pTrack,
+        const AnalyzerTrackQueue::Entry& entry) {
+    const TrackId trackId = entry.trackId();
+    if (pTrack->getBeats() || m_beatsConnections.count(trackId) > 0) {
+        // Sync already works or the track has been preempted before
+        return;
+    }
+    const auto priority = entry.priority;
+    const auto enqueuedAt = entry.enqueuedAt;
+    m_beatsConnections[trackId] = connect(pTrack.get(),
+            &Track::beatsUpdated,
+            this,
+            [this, trackId, priority, enqueuedAt]() {
+                // Usually provisional beats from a progressive analysis
+                trackTimeSinceEnqueued(QStringLiteral("time to beats "), priority, enqueuedAt);
+                stopAwaitingBeats(trackId);
+            });
+}
+
+void TrackAnalysisScheduler::stopAwaitingBeats(TrackId trackId) {
+    const auto connection = m_beatsConnections.find(trackId);
+    if (connection == m_beatsConnections.end()) {
+        return;
+    }
+    disconnect(connection->second);
+    m_beatsConnections.erase(connection);
+}
+
+void TrackAnalysisScheduler::preemptLowerPriorityTracks() {
+    // Workers that will request the next track soon
+    int availableWorkers = 0;
+    for (const auto& worker : m_workers) {
+        if (worker && (!worker.trackId().isValid() || worker.isPreempted())) {
+            ++availableWorkers;
+        }
+    }
+    for (const auto& queuedEntry : m_queuedTracks) {
+        if (availableWorkers > 0) {
+            --availableWorkers;
+            continue;
+        }
+        // Preempt the worker with the least urgent track
+        Worker* pPreemptedWorker = nullptr;
+        auto preemptedPriority = queuedEntry.priority;
+        for (auto& worker : m_workers) {
+            if (!worker.isPreemptable()) {
+                continue;
+            }
+            const auto pendingTrack = m_pendingTracks.find(worker.trackId());
+            if (pendingTrack == m_pendingTracks.end()) {
+                continue;
+            }
+            if (pendingTrack->second.priority < preemptedPriority) {
+                preemptedPriority = pendingTrack->second.priority;
+                pPreemptedWorker = &worker;
+            }
+        }
+        if (!pPreemptedWorker) {
+            // All remaining queued tracks have the same or a lower priority
+            break;
+        }
+        kLogger.debug()
+                << "Preempting analysis of track"
+                << pPreemptedWorker->trackId()
+                << "with priority"
+                << priorityName(preemptedPriority)
+                << "in favor of track"
+                << queuedEntry.trackId()
+                << "with priority"
+                << priorityName(queuedEntry.priority);
+        pPreemptedWorker->preemptTrack();
+    }
+}
+
+void TrackAnalysisScheduler::requeuePreemptedTrack(AnalyzerTrackQueue::Entry entry) {
+    kLogger.debug()
+            << "Requeuing preempted track"
+            << entry.trackId();
+    m_queuedTracks.requeue(std::move(entry));
+    // The track has not been finished and is counted again
+    // when dequeued the next time.
+    DEBUG_ASSERT(m_dequeuedTracksCount > 0);
+    --m_dequeuedTracksCount;
+    m_currentTrackNumber = math_min(m_currentTrackNumber, m_dequeuedTracksCount);
+}
+
 void TrackAnalysisScheduler::stop() {
     kLogger.debug() << "Stopping";
     for (auto& worker: m_workers) {
@@ -333,6 +537,10 @@ void TrackAnalysisScheduler::stop() {
     // The worker threads are still running at this point
     // and m_workers must not be modified!
     m_queuedTracks.clear();
-    m_pendingTrackIds.clear();
+    m_pendingTracks.clear();
+    for (const auto& connection : m_beatsConnections) {
+        disconnect(connection.second);
+    }
+    m_beatsConnections.clear();
     DEBUG_ASSERT((allTracksFinished()));
 }
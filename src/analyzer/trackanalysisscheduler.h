@@ -1,13 +1,13 @@
 #pragma once
 
 #include <QList>
-#include <deque>
+#include <map>
 #include <memory>
-#include <set>
 #include <vector>
 
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzerthread.h"
+#include "analyzer/analyzertrackqueue.h"
 #include "util/db/dbconnectionpool.h"
 
 /// Callbacks for triggering side-effects in the outer context of
@@ -38,21 +38,43 @@ class TrackAnalysisScheduler : public QObject {
             int numWorkerThreads,
             const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
             const UserSettingsPointer& pConfig,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalyzerStatistics> pStatistics = nullptr);
 
     /*private*/ TrackAnalysisScheduler(
             std::unique_ptr<const TrackAnalysisSchedulerEnvironment> pEnvironment,
             int numWorkerThreads,
             const mixxx::DbConnectionPoolPtr& pDbConnectionPool,
             const UserSettingsPointer& pUserSettings,
-            AnalyzerModeFlags modeFlags);
+            AnalyzerModeFlags modeFlags,
+            std::shared_ptr<AnalyzerStatistics> pStatistics);
     ~TrackAnalysisScheduler() override;
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
     // the caller must invoke resume() once.
+    //
+    // Tracks are analyzed in order of their priority. Scheduling a track
+    // that is already queued or analyzed only raises its priority. When
+    // resuming, the analysis of tracks with a lower priority is preempted
+    // if no worker is available for queued tracks with a higher priority.
+    // Preempted tracks are analyzed again later.
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
+    // Raises or lowers the priority of a queued or currently analyzed
+    // track. Returns false if the track has not been scheduled.
+    bool setTrackPriority(TrackId trackId, AnalyzerScheduledTrack::Priority priority);
+
+    // All worker threads have exited after stop(). A finished() signal
+    // is emitted whenever a worker thread exits.
+    bool isStopped() const;
+
+    // While yielding, e.g. to the analysis of tracks that have been loaded
+    // into decks by another scheduler, the worker threads stay suspended
+    // even if resume() is invoked. The analysis continues where it has
+    // been suspended when no longer yielding.
+    void setYielding(bool yielding);
+
   public slots:
     void suspend();
 
@@ -82,7 +104,8 @@ class TrackAnalysisScheduler : public QObject {
       public:
         explicit Worker(AnalyzerThread::Pointer thread = AnalyzerThread::NullPointer())
             : m_thread(std::move(thread)),
-              m_analyzerProgress(kAnalyzerProgressUnknown) {
+              m_analyzerProgress(kAnalyzerProgressUnknown),
+              m_preempted(false) {
         }
         Worker(const Worker&) = delete;
         Worker(Worker&&) = default;
@@ -100,9 +123,39 @@ class TrackAnalysisScheduler : public QObject {
             return m_analyzerProgress;
         }
 
-        bool submitNextTrack(const AnalyzerTrack& track) {
+        // The track that has been submitted most recently and
+        // not yet reported back as done.
+        TrackId trackId() const {
+            return m_trackId;
+        }
+
+        bool isPreempted() const {
+            return m_preempted;
+        }
+
+        // Preemption is only possible while decoding and analyzing
+        // the audio data of the current track, not while finalizing.
+        bool isPreemptable() const {
+            return m_thread &&
+                    m_trackId.isValid() &&
+                    !m_preempted &&
+                    m_analyzerProgress >= kAnalyzerProgressNone &&
+                    m_analyzerProgress < kAnalyzerProgressFinalizing;
+        }
+
+        bool submitNextTrack(TrackId trackId, const AnalyzerTrack& track) {
             DEBUG_ASSERT(m_thread);
-            return m_thread->submitNextTrack(std::move(track));
+            if (!m_thread->submitNextTrack(std::move(track))) {
+                return false;
+            }
+            m_trackId = trackId;
+            return true;
+        }
+
+        void preemptTrack() {
+            DEBUG_ASSERT(isPreemptable());
+            m_thread->preemptCurrentTrack();
+            m_preempted = true;
         }
 
         void suspendThread() {
@@ -128,34 +181,54 @@ class TrackAnalysisScheduler : public QObject {
             m_analyzerProgress = analyzerProgress;
         }
 
+        void onTrackDone() {
+            DEBUG_ASSERT(m_thread);
+            m_trackId = TrackId();
+            m_preempted = false;
+        }
+
         void onThreadExit() {
             DEBUG_ASSERT(m_thread);
             m_thread.reset();
             m_analyzerProgress = kAnalyzerProgressUnknown;
+            m_trackId = TrackId();
+            m_preempted = false;
         }
 
       private:
         AnalyzerThread::Pointer m_thread;
         AnalyzerProgress m_analyzerProgress;
+        TrackId m_trackId;
+        bool m_preempted;
     };
 
     bool submitNextTrack(Worker* worker);
+    // Reports the time until the first beats of a track without beats
+    // have been stored, i.e. until sync and quantize work for a track that
+    // has just been loaded into a deck, see AnalyzerTrack::Options.
+    void awaitBeats(const TrackPointer& pTrack, const AnalyzerTrackQueue::Entry& entry);
+    void stopAwaitingBeats(TrackId trackId);
+    void preemptLowerPriorityTracks();
+    void requeuePreemptedTrack(AnalyzerTrackQueue::Entry entry);
     void emitProgressOrFinished();
 
     bool allTracksFinished() const {
         return m_queuedTracks.empty() &&
-                m_pendingTrackIds.empty();
+                m_pendingTracks.empty();
     }
 
     const std::unique_ptr<const TrackAnalysisSchedulerEnvironment> m_pEnvironment;
 
     std::vector<Worker> m_workers;
 
-    std::deque<AnalyzerScheduledTrack> m_queuedTracks;
+    AnalyzerTrackQueue m_queuedTracks;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
-    std::set<TrackId> m_pendingTrackIds;
+    std::map<TrackId, AnalyzerTrackQueue::Entry> m_pendingTracks;
+
+    // Tracks that are analyzed progressively and have no beats yet
+    std::map<TrackId, QMetaObject::Connection> m_beatsConnections;
 
     AnalyzerProgress m_currentTrackProgress;
 
@@ -163,6 +236,10 @@ class TrackAnalysisScheduler : public QObject {
 
     int m_dequeuedTracksCount;
 
-    typedef std::chrono::steady_clock Clock;
+    // Set by suspend() and reset by resume()
+    bool m_suspended;
+    bool m_yielding;
+
+    typedef AnalyzerTrackQueue::Clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
 };
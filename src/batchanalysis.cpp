@@ -0,0 +1,482 @@
+#include "batchanalysis.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QTextStream>
+#include <QThread>
+#include <QUrl>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+#include "database/mixxxdb.h"
+#include "library/dao/playlistdao.h"
+#include "library/dao/trackschema.h"
+#include "library/queryutil.h"
+#include "library/trackcollection.h"
+#include "library/trackcollectionmanager.h"
+#include "moc_batchanalysis.cpp"
+#include "sources/soundsourceproxy.h"
+#include "util/cmdlineargs.h"
+#include "util/db/dbconnectionpooled.h"
+#include "util/logger.h"
+#include "util/logging.h"
+#include "util/math.h"
+#include "util/sandbox.h"
+
+namespace {
+
+const mixxx::Logger kLogger("BatchAnalysis");
+
+// Same as for a failed startup of the GUI
+constexpr int kFatalErrorExitCode = 1;
+
+const QString kJournalFileName = QStringLiteral("analysis.journal");
+// The first line of the journal identifies the tracks to be analyzed
+const QString kJournalScopePrefix = QStringLiteral("# ");
+
+constexpr int kPollIntervalMillis = 200;
+constexpr qint64 kReportIntervalMillis = 10000;
+
+std::atomic<bool> s_interruptRequested(false);
+
+void onInterruptSignal(int) {
+    // Only async-signal-safe operations are allowed here
+    s_interruptRequested.store(true);
+}
+
+void print(const QString& line) {
+    kLogger.info() << line;
+    fputs(qPrintable(line + QChar('\n')), stdout);
+    fflush(stdout);
+}
+
+void printError(const QString& line) {
+    kLogger.warning() << line;
+    fputs(qPrintable(line + QChar('\n')), stderr);
+}
+
+AnalyzerModeFlags analyzerModeFlags(const UserSettingsPointer& pConfig) {
+    // Like the Analyze view, but at normal priority, because there is
+    // nothing else running that needs to stay responsive.
+    int modeFlags = AnalyzerModeFlags::WithBeats;
+    if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
+        modeFlags |= AnalyzerModeFlags::WithWaveform;
+    }
+    return static_cast<AnalyzerModeFlags>(modeFlags);
+}
+
+class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TrackAnalysisSchedulerEnvironmentImpl(
+            const TrackCollectionManager* pTrackCollectionManager)
+            : m_pTrackCollectionManager(pTrackCollectionManager) {
+        DEBUG_ASSERT(m_pTrackCollectionManager);
+    }
+    ~TrackAnalysisSchedulerEnvironmentImpl() final = default;
+
+    TrackPointer loadTrackById(TrackId trackId) const final {
+        return m_pTrackCollectionManager->getTrackById(trackId);
+    }
+
+  private:
+    const TrackCollectionManager* const m_pTrackCollectionManager;
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+BatchAnalysis::BatchAnalysis(const CmdlineArgs& args, QCoreApplication* pApp)
+        : m_cmdlineArgs(args),
+          m_pApp(pApp),
+          m_pStatistics(std::make_shared<AnalyzerStatistics>()),
+          m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_scheduledTracksCount(0),
+          m_analyzedTracksCount(0),
+          m_failedTracksCount(0),
+          m_stopping(false),
+          m_interrupted(false) {
+    m_pollTimer.setInterval(kPollIntervalMillis);
+    connect(&m_pollTimer,
+            &QTimer::timeout,
+            this,
+            &BatchAnalysis::slotPoll);
+}
+
+BatchAnalysis::~BatchAnalysis() {
+    DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
+    DEBUG_ASSERT(!m_pTrackCollectionManager);
+}
+
+bool BatchAnalysis::initialize() {
+    m_pSettingsManager = std::make_shared<SettingsManager>(m_cmdlineArgs.getSettingsPath());
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+
+    LogFlags logFlags = LogFlag::LogToFile;
+    if (m_cmdlineArgs.getDebugAssertBreak()) {
+        logFlags.setFlag(LogFlag::DebugAssertBreak);
+    }
+    Logging::initialize(
+            pConfig->getSettingsPath(),
+            m_cmdlineArgs.getLogLevel(),
+            m_cmdlineArgs.getLogFlushLevel(),
+            logFlags);
+
+    if (!SoundSourceProxy::registerProviders()) {
+        printError(QStringLiteral("Failed to register any SoundSource providers"));
+        return false;
+    }
+
+    Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
+
+    m_pDbConnectionPool = MixxxDb(pConfig).connectionPool();
+    if (!m_pDbConnectionPool) {
+        printError(QStringLiteral("Failed to create the database connection pool"));
+        return false;
+    }
+    // Create a connection for the main thread
+    m_pDbConnectionPool->createThreadLocalConnection();
+    const QSqlDatabase dbConnection = DbConnectionPooled(m_pDbConnectionPool);
+    if (!dbConnection.isOpen()) {
+        printError(QStringLiteral("Unable to establish a database connection"));
+        return false;
+    }
+    if (!MixxxDb::initDatabaseSchema(dbConnection)) {
+        printError(QStringLiteral("Failed to initialize or upgrade the database schema"));
+        return false;
+    }
+
+    m_pTrackCollectionManager = std::make_unique<TrackCollectionManager>(
+            nullptr,
+            pConfig,
+            m_pDbConnectionPool);
+    return true;
+}
+
+void BatchAnalysis::shutdown() {
+    // Delete the worker threads that have finished, which still
+    // reference the track collection.
+    DEBUG_ASSERT(!m_pTrackAnalysisScheduler || m_pTrackAnalysisScheduler->isStopped());
+    m_pTrackAnalysisScheduler.reset();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    if (m_journal.isOpen()) {
+        m_journal.close();
+    }
+
+    m_pTrackCollectionManager.reset();
+    // Tracks that have been evicted by the worker threads are deleted later
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    if (m_pDbConnectionPool) {
+        m_pDbConnectionPool->destroyThreadLocalConnection();
+        m_pDbConnectionPool.reset();
+    }
+
+    Sandbox::shutdown();
+
+    if (m_pSettingsManager) {
+        m_pSettingsManager->save();
+        m_pSettingsManager.reset();
+    }
+}
+
+int BatchAnalysis::exec() {
+    if (!initialize()) {
+        shutdown();
+        return kFatalErrorExitCode;
+    }
+
+    QList<TrackId> trackIds;
+    if (!resolveTrackIds(&trackIds)) {
+        shutdown();
+        return kFatalErrorExitCode;
+    }
+
+    openJournal();
+    if (!m_journal.isOpen()) {
+        shutdown();
+        return kFatalErrorExitCode;
+    }
+
+    QList<AnalyzerScheduledTrack> tracks;
+    tracks.reserve(trackIds.size());
+    for (const auto& trackId : std::as_const(trackIds)) {
+        if (!m_journaledTrackIds.contains(trackId)) {
+            tracks.append(AnalyzerScheduledTrack(trackId));
+        }
+    }
+    const int numWorkerThreads = m_cmdlineArgs.getAnalyzeThreads() > 0
+            ? m_cmdlineArgs.getAnalyzeThreads()
+            : math_max(1, QThread::idealThreadCount());
+    print(QStringLiteral("Analyzing %1 of %2 tracks using %3 threads")
+                    .arg(QString::number(tracks.size()),
+                            QString::number(trackIds.size()),
+                            QString::number(numWorkerThreads)));
+    if (tracks.size() < trackIds.size()) {
+        print(QStringLiteral("Skipping %1 tracks that have been analyzed before "
+                             "the previous run was interrupted")
+                        .arg(trackIds.size() - tracks.size()));
+    }
+
+    m_elapsedTimer.start();
+    m_lastReportTimer.start();
+    if (!tracks.isEmpty()) {
+        m_pTrackAnalysisScheduler = TrackAnalysisScheduler::createInstance(
+                std::make_unique<const TrackAnalysisSchedulerEnvironmentImpl>(
+                        m_pTrackCollectionManager.get()),
+                numWorkerThreads,
+                m_pDbConnectionPool,
+                m_pSettingsManager->settings(),
+                analyzerModeFlags(m_pSettingsManager->settings()),
+                m_pStatistics);
+        connect(m_pTrackAnalysisScheduler.get(),
+                &TrackAnalysisScheduler::trackProgress,
+                this,
+                &BatchAnalysis::slotTrackProgress);
+        connect(m_pTrackAnalysisScheduler.get(),
+                &TrackAnalysisScheduler::finished,
+                this,
+                &BatchAnalysis::slotFinished);
+        m_scheduledTracksCount = m_pTrackAnalysisScheduler->scheduleTracks(tracks);
+
+        // Stop gracefully, so the analysis can be resumed later
+        s_interruptRequested.store(false);
+        std::signal(SIGINT, onInterruptSignal);
+        std::signal(SIGTERM, onInterruptSignal);
+        m_pollTimer.start();
+        m_pTrackAnalysisScheduler->resume();
+
+        m_pApp->exec();
+
+        m_pollTimer.stop();
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+    }
+
+    int exitCode = EXIT_SUCCESS;
+    if (m_interrupted) {
+        print(QStringLiteral("Interrupted, run again with the same arguments to resume"));
+        exitCode = kInterruptedExitCode;
+    } else {
+        // Tracks that could not be loaded are skipped without any notification
+        m_failedTracksCount = m_scheduledTracksCount - m_analyzedTracksCount;
+        if (m_failedTracksCount > 0) {
+            exitCode = kTracksFailedExitCode;
+        }
+        // Completed, the next run should start from scratch
+        m_journal.remove();
+    }
+    reportResults();
+
+    shutdown();
+    return exitCode;
+}
+
+bool BatchAnalysis::resolveTrackIds(QList<TrackId>* pTrackIds) const {
+    DEBUG_ASSERT(pTrackIds);
+    const QList<QString>& files = m_cmdlineArgs.getMusicFiles();
+    const QStringList& playlists = m_cmdlineArgs.getAnalyzePlaylists();
+
+    if (!files.isEmpty()) {
+        QList<QUrl> urls;
+        urls.reserve(files.size());
+        for (const auto& file : files) {
+            if (!QFileInfo::exists(file)) {
+                printError(QStringLiteral("File or folder not found: %1").arg(file));
+                return false;
+            }
+            urls.append(QUrl::fromLocalFile(QFileInfo(file).absoluteFilePath()));
+        }
+        // Folders are added recursively, playlist files are resolved
+        *pTrackIds += m_pTrackCollectionManager->resolveTrackIdsFromUrls(urls, true);
+    }
+
+    PlaylistDAO& playlistDao = m_pTrackCollectionManager->internalCollection()->getPlaylistDAO();
+    for (const auto& playlist : playlists) {
+        const int playlistId = playlistDao.getPlaylistIdFromName(playlist);
+        if (playlistId == PlaylistDAO::kInvalidPlaylistId) {
+            printError(QStringLiteral("Playlist not found: %1").arg(playlist));
+            return false;
+        }
+        *pTrackIds += playlistDao.getTrackIds(playlistId);
+    }
+
+    if (files.isEmpty() && playlists.isEmpty()) {
+        const QSqlDatabase dbConnection = DbConnectionPooled(m_pDbConnectionPool);
+        QSqlQuery query(dbConnection);
+        query.setForwardOnly(true);
+        query.prepare(QStringLiteral("SELECT %1 FROM %2 WHERE %3=0")
+                              .arg(LIBRARYTABLE_ID,
+                                      LIBRARY_TABLE,
+                                      LIBRARYTABLE_MIXXXDELETED));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            printError(QStringLiteral("Failed to query the tracks of the library"));
+            return false;
+        }
+        const int idColumn = query.record().indexOf(LIBRARYTABLE_ID);
+        while (query.next()) {
+            pTrackIds->append(TrackId(query.value(idColumn)));
+        }
+    }
+
+    // Remove duplicates, but keep the order
+    QSet<TrackId> uniqueTrackIds;
+    uniqueTrackIds.reserve(pTrackIds->size());
+    pTrackIds->erase(std::remove_if(pTrackIds->begin(),
+                             pTrackIds->end(),
+                             [&uniqueTrackIds](const TrackId& trackId) {
+                                 if (uniqueTrackIds.contains(trackId)) {
+                                     return true;
+                                 }
+                                 uniqueTrackIds.insert(trackId);
+                                 return false;
+                             }),
+            pTrackIds->end());
+    return true;
+}
+
+QString BatchAnalysis::journalScope() const {
+    QStringList scope;
+    for (const auto& file : m_cmdlineArgs.getMusicFiles()) {
+        scope.append(QStringLiteral("file:") + QFileInfo(file).absoluteFilePath());
+    }
+    for (const auto& playlist : m_cmdlineArgs.getAnalyzePlaylists()) {
+        scope.append(QStringLiteral("playlist:") + playlist);
+    }
+    if (scope.isEmpty()) {
+        scope.append(QStringLiteral("library"));
+    }
+    return scope.join(QChar('|'));
+}
+
+void BatchAnalysis::openJournal() {
+    const QString scope = journalScope();
+    m_journal.setFileName(QDir(m_pSettingsManager->settings()->getSettingsPath())
+                                  .filePath(kJournalFileName));
+    if (!m_cmdlineArgs.getAnalyzeRestart() &&
+            m_journal.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream journal(&m_journal);
+        if (journal.readLine() == kJournalScopePrefix + scope) {
+            while (!journal.atEnd()) {
+                const TrackId trackId(QVariant(journal.readLine()));
+                if (trackId.isValid()) {
+                    m_journaledTrackIds.insert(trackId);
+                }
+            }
+        } else {
+            kLogger.info() << "Discarding the journal of an analysis with different arguments";
+        }
+        m_journal.close();
+    }
+
+    if (m_journaledTrackIds.isEmpty()) {
+        if (m_journal.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            m_journal.write((kJournalScopePrefix + scope + QChar('\n')).toUtf8());
+            m_journal.flush();
+        }
+    } else {
+        m_journal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+    }
+    if (!m_journal.isOpen()) {
+        printError(QStringLiteral("Failed to open %1: %2")
+                           .arg(m_journal.fileName(), m_journal.errorString()));
+    }
+}
+
+void BatchAnalysis::slotTrackProgress(TrackId trackId, AnalyzerProgress analyzerProgress) {
+    if (analyzerProgress == kAnalyzerProgressDone) {
+        ++m_analyzedTracksCount;
+        m_journal.write(trackId.toString().toUtf8() + '\n');
+        m_journal.flush();
+    } else if (analyzerProgress == kAnalyzerProgressUnknown) {
+        printError(QStringLiteral("Failed to analyze %1")
+                           .arg(m_pTrackCollectionManager->internalCollection()
+                                           ->getTrackDAO()
+                                           .getTrackLocation(trackId)));
+    }
+}
+
+void BatchAnalysis::slotFinished() {
+    // Also emitted when the worker threads exit after stopping
+    if (!m_stopping) {
+        stop();
+    }
+    if (m_pTrackAnalysisScheduler->isStopped()) {
+        m_pApp->exit();
+    }
+}
+
+void BatchAnalysis::slotPoll() {
+    if (s_interruptRequested.load() && !m_stopping) {
+        print(QStringLiteral("Stopping the analysis..."));
+        m_interrupted = true;
+        stop();
+    }
+    if (m_lastReportTimer.elapsed() >= kReportIntervalMillis) {
+        m_lastReportTimer.restart();
+        reportProgress();
+    }
+}
+
+void BatchAnalysis::stop() {
+    DEBUG_ASSERT(!m_stopping);
+    m_stopping = true;
+    // The event loop is exited after the worker threads have exited
+    m_pTrackAnalysisScheduler->stop();
+}
+
+void BatchAnalysis::reportProgress() const {
+    const double elapsedMinutes = m_elapsedTimer.elapsed() / 60000.0;
+    const double tracksPerMinute =
+            elapsedMinutes > 0 ? m_analyzedTracksCount / elapsedMinutes : 0;
+    QString line = QStringLiteral("%1 of %2 tracks analyzed, %3 tracks/min")
+                           .arg(QString::number(m_analyzedTracksCount),
+                                   QString::number(m_scheduledTracksCount),
+                                   QString::number(tracksPerMinute, 'f', 1));
+    if (tracksPerMinute > 0) {
+        const int remainingMinutes = static_cast<int>(std::ceil(
+                (m_scheduledTracksCount - m_analyzedTracksCount) / tracksPerMinute));
+        line += QStringLiteral(", %1:%2 h remaining")
+                        .arg(QString::number(remainingMinutes / 60),
+                                QString::number(remainingMinutes % 60)
+                                        .rightJustified(2, QChar('0')));
+    }
+    print(line);
+}
+
+void BatchAnalysis::reportResults() const {
+    reportProgress();
+    if (m_failedTracksCount > 0) {
+        print(QStringLiteral("%1 tracks failed").arg(m_failedTracksCount));
+    }
+    // Realtime factor = seconds of audio analyzed per second of processing
+    // time on a single core. Skipped analyzers, e.g. if the results already
+    // existed, are not counted.
+    const auto entries = m_pStatistics->entries();
+    if (entries.isEmpty()) {
+        return;
+    }
+    print(QStringLiteral("%1 %2 %3 %4")
+                    .arg(QStringLiteral("Analyzer"), -16)
+                    .arg(QStringLiteral("Tracks"), 8)
+                    .arg(QStringLiteral("Audio [h]"), 10)
+                    .arg(QStringLiteral("Realtime factor"), 16));
+    for (const auto& entry : entries) {
+        print(QStringLiteral("%1 %2 %3 %4")
+                        .arg(entry.analyzerName, -16)
+                        .arg(entry.trackCount, 8)
+                        .arg(entry.audioDuration.toDoubleSeconds() / 3600, 10, 'f', 1)
+                        .arg(entry.realtimeFactor(), 16, 'f', 1));
+    }
+}
+
+} // namespace mixxx
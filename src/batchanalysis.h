@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+#include <memory>
+
+#include "analyzer/analyzerprogress.h"
+#include "analyzer/analyzerstatistics.h"
+#include "analyzer/trackanalysisscheduler.h"
+#include "preferences/settingsmanager.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+class CmdlineArgs;
+class QCoreApplication;
+class TrackCollectionManager;
+
+namespace mixxx {
+
+/// Analyzes tracks without the GUI, e.g. for preparing a large library
+/// on a build server, see `mixxx --analyze`.
+///
+/// Only the settings, the database and the library are initialized, no
+/// audio engine, controllers or skins. The tracks are analyzed by a
+/// TrackAnalysisScheduler exactly as in the Analyze view.
+///
+/// The ids of all analyzed tracks are appended to a journal in the
+/// settings directory, so an interrupted analysis resumes with the
+/// remaining tracks when restarted with the same arguments. The journal
+/// is deleted after the analysis has been completed.
+class BatchAnalysis : public QObject {
+    Q_OBJECT
+
+  public:
+    // Exit codes in addition to those of main()
+    static constexpr int kTracksFailedExitCode = 3;
+    static constexpr int kInterruptedExitCode = 4;
+
+    BatchAnalysis(const CmdlineArgs& args, QCoreApplication* pApp);
+    ~BatchAnalysis() override;
+
+    /// Analyzes all tracks and returns the exit code of Mixxx
+    int exec();
+
+  private slots:
+    void slotTrackProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
+    void slotFinished();
+    void slotPoll();
+
+  private:
+    bool initialize();
+    void shutdown();
+
+    bool resolveTrackIds(QList<TrackId>* pTrackIds) const;
+    QString journalScope() const;
+    void openJournal();
+    void stop();
+    void reportProgress() const;
+    void reportResults() const;
+
+    const CmdlineArgs& m_cmdlineArgs;
+    QCoreApplication* const m_pApp;
+
+    std::shared_ptr<SettingsManager> m_pSettingsManager;
+    DbConnectionPoolPtr m_pDbConnectionPool;
+    std::unique_ptr<TrackCollectionManager> m_pTrackCollectionManager;
+    const std::shared_ptr<AnalyzerStatistics> m_pStatistics;
+    TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+
+    QFile m_journal;
+    // Tracks of an interrupted run that don't need to be analyzed again
+    QSet<TrackId> m_journaledTrackIds;
+
+    int m_scheduledTracksCount;
+    int m_analyzedTracksCount;
+    int m_failedTracksCount;
+    bool m_stopping;
+    bool m_interrupted;
+    QElapsedTimer m_elapsedTimer;
+    QElapsedTimer m_lastReportTimer;
+    QTimer m_pollTimer;
+};
+
+} // namespace mixxx
@@ -1,5 +1,8 @@
 #include "control/control.h"
 
+#include <array>
+
+#include "control/controlchangejournal.h"
 #include "control/controlobject.h"
 #include "moc_control.cpp"
 #include "util/stat.h"
@@ -13,17 +16,35 @@ namespace {
 /// configuration object would be arduous.
 UserSettingsPointer s_pUserConfig;
 
-/// Mutex guarding access to s_qCOHash and s_qCOAliasHash.
-MMutex s_qCOHashMutex;
+/// The registry of ControlDoublePrivate instantiations is split into shards
+/// by the hash of the key. Each shard is guarded by its own read-write lock.
+/// Looking up a control only takes the shared lock of a single shard, so
+/// controllers, skins and scripts resolving controls concurrently do not
+/// contend for a global mutex.
+constexpr std::size_t kNumShards = 16;
+
+struct Shard {
+    MReadWriteLock lock;
+    QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> controls
+            GUARDED_BY(lock);
+};
 
-/// Hash of ControlDoublePrivate instantiations.
-QHash<ConfigKey, QWeakPointer<ControlDoublePrivate>> s_qCOHash
-        GUARDED_BY(s_qCOHashMutex);
+std::array<Shard, kNumShards> s_shards;
+
+Shard& shardForKey(const ConfigKey& key) {
+    return s_shards[qHash(key) % kNumShards];
+}
+
+/// Mutex guarding access to s_qCOAliasHash.
+MMutex s_qCOAliasHashMutex;
 
 /// Hash of aliases between ConfigKeys. Solely used for looking up the first
 /// alias associated with a key.
 QHash<ConfigKey, ConfigKey> s_qCOAliasHash
-        GUARDED_BY(s_qCOHashMutex);
+        GUARDED_BY(s_qCOAliasHashMutex);
+
+/// Mutex guarding the creation of s_pDefaultCO.
+MMutex s_defaultCOMutex;
 
 /// is used instead of a nullptr, helps to omit null checks everywhere
 QWeakPointer<ControlDoublePrivate> s_pDefaultCO;
@@ -38,7 +59,8 @@ ControlDoublePrivate::ControlDoublePrivate()
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           // default CO is read only
           m_confirmRequired(true),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_journalIndex(-1) {
     m_value.setValue(0.0);
 }
 
@@ -58,7 +80,8 @@ ControlDoublePrivate::ControlDoublePrivate(
           m_trackFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE |
                   Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
           m_confirmRequired(false),
-          m_kbdRepeatable(false) {
+          m_kbdRepeatable(false),
+          m_journalIndex(-1) {
     initialize(defaultValue);
 }
 
@@ -87,10 +110,12 @@ void ControlDoublePrivate::initialize(double defaultValue) {
 }
 
 ControlDoublePrivate::~ControlDoublePrivate() {
-    s_qCOHashMutex.lock();
-    //qDebug() << "ControlDoublePrivate::s_qCOHash.remove(" << m_key.group << "," << m_key.item << ")";
-    s_qCOHash.remove(m_key);
-    s_qCOHashMutex.unlock();
+    {
+        Shard& shard = shardForKey(m_key);
+        const MWriteLocker locker(&shard.lock);
+        //qDebug() << "ControlDoublePrivate::s_shards.remove(" << m_key.group << "," << m_key.item << ")";
+        shard.controls.remove(m_key);
+    }
 
     if (m_bPersistInConfiguration) {
         UserSettingsPointer pConfig = s_pUserConfig;
@@ -109,26 +134,34 @@ void ControlDoublePrivate::setUserConfig(const UserSettingsPointer& pConfig) {
 
 // static
 void ControlDoublePrivate::insertAlias(const ConfigKey& alias, const ConfigKey& key) {
-    MMutexLocker locker(&s_qCOHashMutex);
     VERIFY_OR_DEBUG_ASSERT(alias != key) {
         qWarning() << "cannot create alias with identical key" << key;
         return;
     }
 
-    auto it = s_qCOHash.constFind(key);
-    VERIFY_OR_DEBUG_ASSERT(it != s_qCOHash.constEnd()) {
-        qWarning() << "cannot create alias for null control" << key;
-        return;
+    QSharedPointer<ControlDoublePrivate> pControl;
+    {
+        Shard& shard = shardForKey(key);
+        const MReadLocker locker(&shard.lock);
+        auto it = shard.controls.constFind(key);
+        VERIFY_OR_DEBUG_ASSERT(it != shard.controls.constEnd()) {
+            qWarning() << "cannot create alias for null control" << key;
+            return;
+        }
+        pControl = it.value();
     }
-
-    QSharedPointer<ControlDoublePrivate> pControl = it.value();
     VERIFY_OR_DEBUG_ASSERT(!pControl.isNull()) {
         qWarning() << "cannot create alias for expired control" << key;
         return;
     }
 
-    s_qCOAliasHash.insert(key, alias);
-    s_qCOHash.insert(alias, pControl);
+    {
+        const MMutexLocker locker(&s_qCOAliasHashMutex);
+        s_qCOAliasHash.insert(key, alias);
+    }
+    Shard& aliasShard = shardForKey(alias);
+    const MWriteLocker locker(&aliasShard.lock);
+    aliasShard.controls.insert(alias, pControl);
 }
 
 // static
@@ -149,11 +182,14 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
         return nullptr;
     }
 
-    // Scope for MMutexLocker.
+    Shard& shard = shardForKey(key);
+    // Scope for MReadLocker.
     {
-        const MMutexLocker locker(&s_qCOHashMutex);
-        const auto it = s_qCOHash.constFind(key);
-        if (it != s_qCOHash.constEnd()) {
+        const MReadLocker locker(&shard.lock);
+        const auto it = shard.controls.constFind(key);
+        if (it != shard.controls.constEnd()) {
+            // An expired weak pointer is replaced when the control is
+            // created again, or cleaned up by getAllInstances().
             auto pControl = it.value().lock();
             if (pControl) {
                 auto actualKey = pControl->getKey();
@@ -176,9 +212,6 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                     return nullptr;
                 }
                 return pControl;
-            } else {
-                // The weak pointer has become invalid and can be cleaned up
-                s_qCOHash.erase(it);
             }
         }
     }
@@ -191,9 +224,9 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getControl(
                         bTrack,
                         bPersist,
                         defaultValue));
-        const MMutexLocker locker(&s_qCOHashMutex);
-        //qDebug() << "ControlDoublePrivate::s_qCOHash.insert(" << key.group << "," << key.item << ")";
-        s_qCOHash.insert(key, pControl);
+        const MWriteLocker locker(&shard.lock);
+        //qDebug() << "ControlDoublePrivate::s_shards.insert(" << key.group << "," << key.item << ")";
+        shard.controls.insert(key, pControl);
         return pControl;
     }
 
@@ -212,7 +245,7 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
         // Try again with the mutex locked to protect against creating two
         // ControlDoublePrivateConst objects. Access to s_defaultCO itself is
         // thread save.
-        MMutexLocker locker(&s_qCOHashMutex);
+        MMutexLocker locker(&s_defaultCOMutex);
         defaultCO = s_pDefaultCO.lock();
         if (!defaultCO) {
             defaultCO = QSharedPointer<ControlDoublePrivate>(new ControlDoublePrivateConst());
@@ -225,15 +258,18 @@ QSharedPointer<ControlDoublePrivate> ControlDoublePrivate::getDefaultControl() {
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstances() {
     QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.constBegin(); it != s_qCOHash.constEnd(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
-        } else {
-            // The weak pointer has become invalid and can be cleaned up
-            s_qCOHash.erase(it);
+    for (auto& shard : s_shards) {
+        const MWriteLocker locker(&shard.lock);
+        result.reserve(result.size() + shard.controls.size());
+        for (auto it = shard.controls.begin(); it != shard.controls.end();) {
+            auto pControl = it.value().lock();
+            if (pControl) {
+                result.append(std::move(pControl));
+                ++it;
+            } else {
+                // The weak pointer has become invalid and can be cleaned up
+                it = shard.controls.erase(it);
+            }
         }
     }
     return result;
@@ -242,21 +278,23 @@ QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::getAllInstance
 // static
 QList<QSharedPointer<ControlDoublePrivate>> ControlDoublePrivate::takeAllInstances() {
     QList<QSharedPointer<ControlDoublePrivate>> result;
-    MMutexLocker locker(&s_qCOHashMutex);
-    result.reserve(s_qCOHash.size());
-    for (auto it = s_qCOHash.begin(); it != s_qCOHash.end(); ++it) {
-        auto pControl = it.value().lock();
-        if (pControl) {
-            result.append(std::move(pControl));
+    for (auto& shard : s_shards) {
+        const MWriteLocker locker(&shard.lock);
+        result.reserve(result.size() + shard.controls.size());
+        for (auto it = shard.controls.begin(); it != shard.controls.end(); ++it) {
+            auto pControl = it.value().lock();
+            if (pControl) {
+                result.append(std::move(pControl));
+            }
         }
+        shard.controls.clear();
     }
-    s_qCOHash.clear();
     return result;
 }
 
 //static
 QHash<ConfigKey, ConfigKey> ControlDoublePrivate::getControlAliases() {
-    MMutexLocker locker(&s_qCOHashMutex);
+    MMutexLocker locker(&s_qCOAliasHashMutex);
     // lock thread-unsafe copy constructors of QHash
     return s_qCOAliasHash;
 }
@@ -297,6 +335,11 @@ void ControlDoublePrivate::setInner(double value, QObject* pSender) {
     m_value.setValue(value);
     emit valueChanged(value, pSender);
 
+    const int journalIndex = m_journalIndex.loadRelaxed();
+    if (journalIndex >= 0) {
+        ControlChangeJournal::markDirty(journalIndex);
+    }
+
     if (m_bTrack) {
         Stat::track(m_trackKey, static_cast<Stat::StatType>(m_trackType),
                     static_cast<Stat::ComputeFlags>(m_trackFlags), value);
@@ -141,6 +141,14 @@ class ControlDoublePrivate : public QObject {
         return m_key;
     }
 
+    /// The slot in the ControlChangeJournal, or -1 if no one subscribed
+    int journalIndex() const {
+        return m_journalIndex.loadRelaxed();
+    }
+    void setJournalIndex(int index) {
+        m_journalIndex.storeRelaxed(index);
+    }
+
     // Connects a slot to the ValueChange request for CO validation. All change
     // requests issued by set are routed though the connected slot. This can
     // decide with its own thread safe solution if the requested value can be
@@ -215,6 +223,8 @@ class ControlDoublePrivate : public QObject {
     ControlValueAtomic<double> m_defaultValue;
 
     QSharedPointer<ControlNumericBehavior> m_pBehavior;
+
+    QAtomicInt m_journalIndex;
 };
 
 /// The constant ControlDoublePrivate version is used as dummy for default
@@ -0,0 +1,116 @@
+#include "control/controlchangejournal.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <QVarLengthArray>
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#include "control/control.h"
+#include "control/controlproxy.h"
+#include "util/assert.h"
+#include "util/counter.h"
+
+namespace {
+
+struct Entry {
+    // Kept alive by the subscribed proxies
+    ControlDoublePrivate* pControl = nullptr;
+    QVarLengthArray<ControlProxy*, 2> subscribers;
+};
+
+// Only accessed from the GUI thread
+std::vector<Entry> s_entries;
+std::vector<int> s_freeIndices;
+
+bool isGuiThread() {
+    const auto* pApp = QCoreApplication::instance();
+    return !pApp || QThread::currentThread() == pApp->thread();
+}
+
+} // namespace
+
+std::atomic<bool> ControlChangeJournal::s_enabled(false);
+std::array<std::atomic<std::uint64_t>, ControlChangeJournal::kCapacity / 64>
+        ControlChangeJournal::s_dirty{};
+
+// static
+void ControlChangeJournal::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+// static
+bool ControlChangeJournal::subscribe(ControlProxy* pProxy,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    DEBUG_ASSERT(pProxy);
+    DEBUG_ASSERT(isGuiThread());
+    if (!isEnabled() || !pControl) {
+        return false;
+    }
+    int index = pControl->journalIndex();
+    if (index < 0) {
+        if (!s_freeIndices.empty()) {
+            index = s_freeIndices.back();
+            s_freeIndices.pop_back();
+        } else if (s_entries.size() < static_cast<std::size_t>(kCapacity)) {
+            index = static_cast<int>(s_entries.size());
+            s_entries.emplace_back();
+        } else {
+            Counter("ControlChangeJournal: No free slot")++;
+            return false;
+        }
+        s_entries[index].pControl = pControl.data();
+        pControl->setJournalIndex(index);
+    }
+    DEBUG_ASSERT(s_entries[index].pControl == pControl.data());
+    s_entries[index].subscribers.append(pProxy);
+    return true;
+}
+
+// static
+void ControlChangeJournal::unsubscribe(ControlProxy* pProxy,
+        const QSharedPointer<ControlDoublePrivate>& pControl) {
+    DEBUG_ASSERT(isGuiThread());
+    const int index = pControl->journalIndex();
+    VERIFY_OR_DEBUG_ASSERT(index >= 0) {
+        return;
+    }
+    Entry& entry = s_entries[index];
+    entry.subscribers.erase(
+            std::remove(entry.subscribers.begin(), entry.subscribers.end(), pProxy),
+            entry.subscribers.end());
+    if (entry.subscribers.isEmpty()) {
+        // A change that is marked concurrently with the release is
+        // delivered to the next control using the slot, which is harmless.
+        pControl->setJournalIndex(-1);
+        entry.pControl = nullptr;
+        s_freeIndices.push_back(index);
+    }
+}
+
+// static
+int ControlChangeJournal::drain() {
+    DEBUG_ASSERT(isGuiThread());
+    int notified = 0;
+    const int numWords = static_cast<int>((s_entries.size() + 63) / 64);
+    for (int word = 0; word < numWords; ++word) {
+        std::uint64_t bits = s_dirty[word].exchange(0, std::memory_order_acquire);
+        while (bits != 0) {
+            const int index = word * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+            if (!s_entries[index].pControl) {
+                continue;
+            }
+            // The slots may subscribe or unsubscribe other proxies
+            const auto subscribers = s_entries[index].subscribers;
+            for (ControlProxy* pProxy : subscribers) {
+                if (s_entries[index].subscribers.contains(pProxy)) {
+                    pProxy->emitValueChanged();
+                }
+            }
+            ++notified;
+        }
+    }
+    return notified;
+}
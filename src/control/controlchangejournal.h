@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QSharedPointer>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+class ControlDoublePrivate;
+class ControlProxy;
+
+/// ControlChangeJournal coalesces the value changes of controls for the GUI.
+///
+/// The engine sets many controls in every callback. Delivering each change
+/// to the widgets by a queued signal posts one event per change and
+/// receiver, most of which are outdated before the GUI thread gets to them.
+/// Instead, subscribed controls only set their dirty bit in a fixed-size
+/// bitmap when they change. This is wait-free and does not allocate, so it
+/// is safe in the audio callback. GuiTick drains the bitmap once per frame
+/// and each subscriber is notified at most once per frame, with the
+/// latest value.
+///
+/// Subscribing, unsubscribing and draining must happen in the GUI thread.
+/// The journal is enabled while a GuiTick exists. Otherwise, e.g. in tests
+/// without a GUI, subscribing fails and the caller falls back to regular
+/// signal connections.
+class ControlChangeJournal {
+  public:
+    static constexpr int kCapacity = 16384;
+
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enabled);
+
+    /// Notifies pProxy->emitValueChanged() once per tick in which the
+    /// control has changed. Returns false if the journal is disabled or full.
+    static bool subscribe(ControlProxy* pProxy,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+    static void unsubscribe(ControlProxy* pProxy,
+            const QSharedPointer<ControlDoublePrivate>& pControl);
+
+    /// Called by ControlDoublePrivate on every value change of a subscribed
+    /// control, from any thread.
+    static void markDirty(int index) {
+        s_dirty[index / 64].fetch_or(std::uint64_t{1} << (index % 64),
+                std::memory_order_release);
+    }
+
+    /// Delivers the pending changes. Returns the number of notified
+    /// controls.
+    static int drain();
+
+  private:
+    static std::atomic<bool> s_enabled;
+    static std::array<std::atomic<std::uint64_t>, kCapacity / 64> s_dirty;
+};
@@ -26,6 +26,13 @@ class ControlObjectScript : public ControlProxy {
             return m_scriptConnections.first(); };
     void disconnectAllConnectionsToFunction(const QJSValue& function);
 
+    /// The ControlObject that owns the connected control, if it still exists.
+    /// Equivalent to ControlObject::getControl(getKey()), but without looking
+    /// up the key in the registry.
+    ControlObject* getCreatorCO() const {
+        return m_pControl->getCreatorCO();
+    }
+
     // Called from update();
     void emitValueChanged() override {
         emit trigger(get(), this);
@@ -19,6 +19,9 @@ ControlProxy::ControlProxy(const ConfigKey& key, QObject* pParent, ControlFlags
 
 ControlProxy::~ControlProxy() {
     //qDebug() << "ControlProxy::~ControlProxy()";
+    if (m_bJournaled) {
+        ControlChangeJournal::unsubscribe(this, m_pControl);
+    }
 }
 
 const ConfigKey& ControlProxy::getKey() const {
@@ -5,6 +5,7 @@
 #include <QString>
 
 #include "control/control.h"
+#include "control/controlchangejournal.h"
 #include "preferences/usersettings.h"
 
 //// This class is the successor of ControlObjectThread. It should be used for
@@ -99,6 +100,25 @@ class ControlProxy : public QObject {
         return true;
     }
 
+    /// Like connectValueChanged() with a queued connection, but the GUI
+    /// thread is notified at most once per GUI tick with the latest value,
+    /// instead of one queued event per change. Falls back to
+    /// connectValueChanged() if the ControlChangeJournal is not enabled.
+    /// Must be called from the GUI thread.
+    template<typename Receiver, typename Slot>
+    bool connectValueChangedCoalesced(Receiver receiver, Slot func) {
+        if (!valid()) {
+            return false;
+        }
+        if (!m_bJournaled) {
+            m_bJournaled = ControlChangeJournal::subscribe(this, m_pControl);
+        }
+        if (!m_bJournaled) {
+            return connectValueChanged(receiver, func);
+        }
+        return connect(this, &ControlProxy::valueChanged, receiver, func, Qt::DirectConnection);
+    }
+
     /// Called from update();
     virtual void emitValueChanged() {
         emit valueChanged(get());
@@ -185,4 +205,7 @@ class ControlProxy : public QObject {
   protected:
     /// Pointer to connected control.
     QSharedPointer<ControlDoublePrivate> m_pControl;
+
+  private:
+    bool m_bJournaled = false;
 };
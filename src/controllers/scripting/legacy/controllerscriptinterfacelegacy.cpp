@@ -88,6 +88,8 @@ ControllerScriptInterfaceLegacy::~ControllerScriptInterfaceLegacy() {
             // Advance iterator
             it = constErase(&m_controlCache, it);
         }
+        m_controlHandles.clear();
+        m_controlHandleIndices.clear();
     }
 }
 
@@ -152,15 +154,20 @@ void ControllerScriptInterfaceLegacy::setValue(
     }
 
     ControlObjectScript* coScript = getControlObjectScript(group, name);
-
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl &&
-                !m_st.ignore(
-                        pControl, coScript->getParameterForValue(newValue))) {
-            coScript->set(newValue);
-        }
+        setValueInternal(coScript, newValue);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setValueInternal(
+        ControlObjectScript* coScript, double newValue) {
+    // The control is already resolved, so there is no need to look it
+    // up by its key again.
+    ControlObject* pControl = coScript->getCreatorCO();
+    if (pControl &&
+            !m_st.ignore(
+                    pControl, coScript->getParameterForValue(newValue))) {
+        coScript->set(newValue);
     }
 }
 
@@ -185,13 +192,16 @@ void ControllerScriptInterfaceLegacy::setParameter(
     }
 
     ControlObjectScript* coScript = getControlObjectScript(group, name);
-
     if (coScript != nullptr) {
-        ControlObject* pControl = ControlObject::getControl(
-                coScript->getKey(), ControlFlag::AllowMissingOrInvalid);
-        if (pControl && !m_st.ignore(pControl, newParameter)) {
-            coScript->setParameter(newParameter);
-        }
+        setParameterInternal(coScript, newParameter);
+    }
+}
+
+void ControllerScriptInterfaceLegacy::setParameterInternal(
+        ControlObjectScript* coScript, double newParameter) {
+    ControlObject* pControl = coScript->getCreatorCO();
+    if (pControl && !m_st.ignore(pControl, newParameter)) {
+        coScript->setParameter(newParameter);
     }
 }
 
@@ -250,6 +260,82 @@ double ControllerScriptInterfaceLegacy::getDefaultParameter(
     return coScript->getParameterForValue(coScript->getDefault());
 }
 
+int ControllerScriptInterfaceLegacy::getControlHandle(
+        const QString& group, const QString& name) {
+    ControlObjectScript* coScript = getControlObjectScript(group, name);
+    if (coScript == nullptr) {
+        m_pScriptEngineLegacy->logOrThrowError(
+                QStringLiteral("Unknown control (%1, %2) returning -1")
+                        .arg(group, name));
+        return -1;
+    }
+    const ConfigKey key = coScript->getKey();
+    const auto it = m_controlHandleIndices.constFind(key);
+    if (it != m_controlHandleIndices.constEnd()) {
+        return it.value();
+    }
+    const int handle = static_cast<int>(m_controlHandles.size());
+    m_controlHandles.push_back(coScript);
+    m_controlHandleIndices.insert(key, handle);
+    return handle;
+}
+
+ControlObjectScript* ControllerScriptInterfaceLegacy::getControlObjectScriptByHandle(
+        int handle) {
+    if (handle < 0 || handle >= static_cast<int>(m_controlHandles.size())) {
+        m_pScriptEngineLegacy->logOrThrowError(
+                QStringLiteral("Invalid control handle %1").arg(handle));
+        return nullptr;
+    }
+    return m_controlHandles[handle];
+}
+
+double ControllerScriptInterfaceLegacy::getValueByHandle(int handle) {
+    ControlObjectScript* coScript = getControlObjectScriptByHandle(handle);
+    if (coScript == nullptr) {
+        return 0.0;
+    }
+    return coScript->get();
+}
+
+void ControllerScriptInterfaceLegacy::setValueByHandle(int handle, double newValue) {
+    ControlObjectScript* coScript = getControlObjectScriptByHandle(handle);
+    if (coScript == nullptr) {
+        return;
+    }
+    if (util_isnan(newValue)) {
+        m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                "Script tried setting (%1, %2) to NotANumber (NaN)")
+                                                       .arg(coScript->getKey().group,
+                                                               coScript->getKey().item));
+        return;
+    }
+    setValueInternal(coScript, newValue);
+}
+
+double ControllerScriptInterfaceLegacy::getParameterByHandle(int handle) {
+    ControlObjectScript* coScript = getControlObjectScriptByHandle(handle);
+    if (coScript == nullptr) {
+        return 0.0;
+    }
+    return coScript->getParameter();
+}
+
+void ControllerScriptInterfaceLegacy::setParameterByHandle(int handle, double newParameter) {
+    ControlObjectScript* coScript = getControlObjectScriptByHandle(handle);
+    if (coScript == nullptr) {
+        return;
+    }
+    if (util_isnan(newParameter)) {
+        m_pScriptEngineLegacy->logOrThrowError(QStringLiteral(
+                "Script tried setting (%1, %2) to NotANumber (NaN)")
+                                                       .arg(coScript->getKey().group,
+                                                               coScript->getKey().item));
+        return;
+    }
+    setParameterInternal(coScript, newParameter);
+}
+
 QJSValue ControllerScriptInterfaceLegacy::makeConnection(
         const QString& group, const QString& name, const QJSValue& callback) {
     return ControllerScriptInterfaceLegacy::makeConnectionInternal(group, name, callback, false);
@@ -2,6 +2,7 @@
 
 #include <QJSValue>
 #include <QObject>
+#include <vector>
 
 #include "controllers/softtakeover.h"
 #include "util/alphabetafilter.h"
@@ -32,6 +33,16 @@ class ControllerScriptInterfaceLegacy : public QObject {
     Q_INVOKABLE void reset(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultValue(const QString& group, const QString& name);
     Q_INVOKABLE double getDefaultParameter(const QString& group, const QString& name);
+    /// Resolves a control once and returns a handle for the *ByHandle()
+    /// functions below, or -1 if the control does not exist. Accessing a
+    /// control by its handle skips the lookup of the group and item strings,
+    /// which is noticeable for mappings that read many controls on every
+    /// incoming message.
+    Q_INVOKABLE int getControlHandle(const QString& group, const QString& name);
+    Q_INVOKABLE double getValueByHandle(int handle);
+    Q_INVOKABLE void setValueByHandle(int handle, double newValue);
+    Q_INVOKABLE double getParameterByHandle(int handle);
+    Q_INVOKABLE void setParameterByHandle(int handle, double newParameter);
     Q_INVOKABLE QJSValue makeConnection(const QString& group,
             const QString& name,
             const QJSValue& callback);
@@ -84,6 +95,14 @@ class ControllerScriptInterfaceLegacy : public QObject {
             bool skipSuperseded = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    /// Indexed by the control handles, owned by m_controlCache
+    std::vector<ControlObjectScript*> m_controlHandles;
+    /// Maps the controls to their handles, i.e. indices in m_controlHandles
+    QHash<ConfigKey, int> m_controlHandleIndices;
+    ControlObjectScript* getControlObjectScriptByHandle(int handle);
+
+    void setValueInternal(ControlObjectScript* coScript, double newValue);
+    void setParameterInternal(ControlObjectScript* coScript, double newParameter);
 
     SoftTakeoverCtrl m_st;
 
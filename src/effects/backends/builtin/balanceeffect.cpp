@@ -26,6 +26,7 @@ EffectManifestPointer BalanceEffect::getManifest() {
             "Adjust the left/right balance and stereo width"));
     pManifest->setEffectRampsFromDry(true);
     pManifest->setMetaknobDefault(0.5);
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer balance = pManifest->addParameter();
     balance->setId("balance");
@@ -67,6 +67,7 @@ EffectManifestPointer BiquadFullKillEQEffect::getManifest() {
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setEffectRampsFromDry(true);
     pManifest->setIsMixingEQ(true);
+    pManifest->setTailLengthSeconds(0.1);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
     return pManifest;
@@ -20,6 +20,7 @@ EffectManifestPointer BitCrusherEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Adds noise by the reducing the bit depth and sample rate"));
     pManifest->setEffectRampsFromDry(true);
+    pManifest->setTailLengthSeconds(0.0);
 
     EffectManifestParameterPointer depth = pManifest->addParameter();
     depth->setId("bit_depth");
@@ -35,6 +35,7 @@ EffectManifestPointer CompressorEffect::getManifest() {
     pManifest->setDescription("A single-band compressor effect");
     pManifest->setEffectRampsFromDry(true);
     pManifest->setMetaknobDefault(0.0);
+    pManifest->setTailLengthSeconds(0.0);
 
     EffectManifestParameterPointer autoMakeUp = pManifest->addParameter();
     autoMakeUp->setId("automakeup");
@@ -27,6 +27,7 @@ EffectManifestPointer DistortionEffect::getManifest() {
             "clipping.");
     pManifest->setEffectRampsFromDry(true);
     pManifest->setMetaknobDefault(0.0);
+    pManifest->setTailLengthSeconds(0.0);
 
     EffectManifestParameterPointer mode = pManifest->addParameter();
     mode->setId("mode");
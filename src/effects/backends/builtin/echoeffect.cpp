@@ -39,6 +39,7 @@ EffectManifestPointer EchoEffect::getManifest() {
     pManifest->setVersion("1.0");
     pManifest->setDescription(QObject::tr(
             "Stores the input signal in a temporary buffer and outputs it after a short time"));
+    pManifest->setTailLengthSeconds(EchoGroupState::kMaxDelaySeconds);
 
     EffectManifestParameterPointer delay = pManifest->addParameter();
     delay->setId("delay_time");
@@ -27,6 +27,7 @@ EffectManifestPointer FilterEffect::getManifest() {
             "Allows only high or low frequencies to play."));
     pManifest->setEffectRampsFromDry(true);
     pManifest->setMetaknobDefault(0.5);
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer lpf = pManifest->addParameter();
     lpf->setId("lpf");
@@ -26,6 +26,7 @@ EffectManifestPointer GraphicEQEffect::getManifest() {
             "An 8-band graphic equalizer based on biquad filters"));
     pManifest->setEffectRampsFromDry(true);
     pManifest->setIsMainEQ(true);
+    pManifest->setTailLengthSeconds(0.1);
 
     // Display rounded center frequencies for each filter
     float centerFrequencies[8] = {45, 100, 220, 500, 1100, 2500, 5500, 12000};
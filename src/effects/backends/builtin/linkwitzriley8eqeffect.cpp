@@ -31,6 +31,7 @@ EffectManifestPointer LinkwitzRiley8EQEffect::getManifest() {
                         "dB/octave).") +
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setIsMixingEQ(true);
+    pManifest->setTailLengthSeconds(0.1);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), false);
     return pManifest;
@@ -35,6 +35,7 @@ EffectManifestPointer LoudnessContourEffect::getManifest() {
             "for reduced sensitivity of the human ear."));
     pManifest->setEffectRampsFromDry(true);
     pManifest->setMetaknobDefault(1.0);
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer loudness = pManifest->addParameter();
     loudness->setId("loudness");
@@ -25,6 +25,7 @@ EffectManifestPointer MoogLadder4FilterEffect::getManifest() {
                         "Houvilainen's non linear digital implementation"));
     pManifest->setEffectRampsFromDry(true);
     pManifest->setMetaknobDefault(0.5);
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer lpf = pManifest->addParameter();
     lpf->setId("lpf");
@@ -27,6 +27,7 @@ EffectManifestPointer ParametricEQEffect::getManifest() {
             "It is designed as a complement to the steep mixing equalizers."));
     pManifest->setEffectRampsFromDry(true);
     pManifest->setIsMainEQ(true);
+    pManifest->setTailLengthSeconds(0.1);
 
     EffectManifestParameterPointer gain1 = pManifest->addParameter();
     gain1->setId("gain1");
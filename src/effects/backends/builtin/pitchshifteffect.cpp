@@ -69,6 +69,7 @@ EffectManifestPointer PitchShiftEffect::getManifest() {
     pManifest->setDescription(QObject::tr(
             "Raises or lowers the original pitch of a sound."));
     pManifest->setMetaknobDefault(0.5);
+    pManifest->setTailLengthSeconds(0.5);
 
     EffectManifestParameterPointer pitch = pManifest->addParameter();
     pitch->setId(kPitchParameterId);
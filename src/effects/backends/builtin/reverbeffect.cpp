@@ -21,6 +21,7 @@ EffectManifestPointer ReverbEffect::getManifest() {
     pManifest->setVersion("1.0");
     pManifest->setDescription(QObject::tr(
             "Emulates the sound of the signal bouncing off the walls of a room"));
+    pManifest->setTailLengthSeconds(0.5);
 
     EffectManifestParameterPointer decay = pManifest->addParameter();
     decay->setId("decay");
@@ -64,6 +64,7 @@ EffectManifestPointer ThreeBandBiquadEQEffect::getManifest() {
             " " + EqualizerUtil::adjustFrequencyShelvesTip());
     pManifest->setEffectRampsFromDry(true);
     pManifest->setIsMixingEQ(true);
+    pManifest->setTailLengthSeconds(0.1);
 
     EqualizerUtil::createCommonParameters(pManifest.data(), true);
     return pManifest;
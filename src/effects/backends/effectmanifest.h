@@ -29,7 +29,8 @@ class EffectManifest {
               m_isMainEQ(false),
               m_effectRampsFromDry(false),
               m_bAddDryToWet(false),
-              m_metaknobDefault(0.0) {
+              m_metaknobDefault(0.0),
+              m_tailLengthSeconds(kUnknownTailLength) {
     }
 
     /// Hack to store unique IDs in QComboBox models
@@ -154,6 +155,23 @@ class EffectManifest {
         m_metaknobDefault = metaknobDefault;
     }
 
+    /// The longest time the output of the effect may stay silent after the
+    /// input became silent while the effect still holds a signal that becomes
+    /// audible later, e.g. the delay time of an echo. After the input and the
+    /// output have been silent for this time, the effect is put to sleep until
+    /// the input is no longer silent. Effects that produce a signal on their
+    /// own keep the default kUnknownTailLength and are never put to sleep.
+    static constexpr double kUnknownTailLength = -1.0;
+    double tailLengthSeconds() const {
+        return m_tailLengthSeconds;
+    }
+    void setTailLengthSeconds(double tailLengthSeconds) {
+        m_tailLengthSeconds = tailLengthSeconds;
+    }
+    bool hasKnownTailLength() const {
+        return m_tailLengthSeconds >= 0;
+    }
+
     bool operator==(const EffectManifest& other) const {
         return other.id() == m_id && other.backendType() == m_backendType;
     }
@@ -187,4 +205,5 @@ class EffectManifest {
     bool m_effectRampsFromDry;
     bool m_bAddDryToWet;
     double m_metaknobDefault;
+    double m_tailLengthSeconds;
 };
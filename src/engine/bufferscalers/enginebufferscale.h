@@ -52,6 +52,13 @@ class EngineBufferScale : public QObject {
 
     // Called from EngineBuffer when seeking, to ensure the buffers are flushed */
     virtual void clear() = 0;
+
+    // Whether the scaler has processed input far ahead of the output with
+    // the current parameters. EngineBuffer then calls clear() before changing
+    // the parameters, so that the change becomes audible right away.
+    virtual bool hasLookahead() const {
+        return false;
+    }
     // Scale buffer
     // Returns the number of frames that have bean read from the unscaled
     // input buffer The number of frames copied to the output buffer is always
@@ -1,7 +1,10 @@
 #include "engine/bufferscalers/enginebufferscalerubberband.h"
 
 #include <QtDebug>
+#include <utility>
 
+#include "engine/bufferscalers/rubberbandbatch.h"
+#include "engine/engineworker.h"
 #include "engine/readaheadmanager.h"
 #include "moc_enginebufferscalerubberband.cpp"
 #include "util/counter.h"
@@ -15,22 +18,116 @@ using RubberBand::RubberBandStretcher;
 
 #define RUBBERBANDV3 (RUBBERBAND_API_MAJOR_VERSION >= 2 && RUBBERBAND_API_MINOR_VERSION >= 7)
 
+namespace {
+
+// The capacity of the lookahead FIFOs, a bit more than a second at 48 kHz
+constexpr SINT kLookaheadCapacityFrames = 65536;
+// The input that the worker processes at once. The engine thread gets the
+// time stretcher back from the worker after at most one chunk.
+constexpr SINT kLookaheadChunkFrames = 1024;
+// The number of callbacks with constant parameters before the lookahead
+// worker takes over
+constexpr int kLookaheadStableCallbacks = 32;
+// Bounds the input that is read ahead per callback
+constexpr SINT kLookaheadMaxFeedBuffers = 4;
+
+} // namespace
+
+class EngineBufferScaleRubberBand::LookaheadWorker : public EngineWorker {
+  public:
+    explicit LookaheadWorker(EngineBufferScaleRubberBand* pScaler)
+            : m_pScaler(pScaler),
+              m_stop(false) {
+    }
+
+    void run() override {
+        QThread::currentThread()->setObjectName(QStringLiteral("RubberBandLookahead"));
+        while (true) {
+            m_semaRun.acquire();
+            if (m_stop.load(std::memory_order_acquire)) {
+                return;
+            }
+            reportWakeupLatency();
+            m_pScaler->processLookahead();
+        }
+    }
+
+    void quitWait() {
+        m_stop.store(true, std::memory_order_release);
+        m_semaRun.release();
+        wait();
+    }
+
+  private:
+    EngineBufferScaleRubberBand* const m_pScaler;
+    std::atomic<bool> m_stop;
+};
+
+EngineBufferScaleRubberBand::Stretcher::Stretcher()
+        : buffers{mixxx::SampleBuffer(MAX_BUFFER_LEN), mixxx::SampleBuffer(MAX_BUFFER_LEN)},
+          bufferPtrs{buffers[0].data(), buffers[1].data()} {
+}
+
 EngineBufferScaleRubberBand::EngineBufferScaleRubberBand(
         ReadAheadManager* pReadAheadManager)
         : m_pReadAheadManager(pReadAheadManager),
-          m_buffers{mixxx::SampleBuffer(MAX_BUFFER_LEN), mixxx::SampleBuffer(MAX_BUFFER_LEN)},
-          m_bufferPtrs{m_buffers[0].data(), m_buffers[1].data()},
+          m_pStretcher(std::make_unique<Stretcher>()),
           m_interleavedReadBuffer(MAX_BUFFER_LEN),
+          m_pBatch(nullptr),
+          m_batchBuffers{mixxx::SampleBuffer(MAX_BUFFER_LEN),
+                  mixxx::SampleBuffer(MAX_BUFFER_LEN)},
+          m_batchBufferPtrs{m_batchBuffers[0].data(), m_batchBuffers[1].data()},
           m_bBackwards(false),
-          m_useEngineFiner(false) {
+          m_useEngineFiner(false),
+          m_lookaheadMillis(0),
+          m_lookaheadActive(false),
+          m_lookaheadWorkerBusy(false),
+          m_pLookaheadStretcher(nullptr),
+          m_lookaheadReleasing(false),
+          m_lookaheadFlushPending(false),
+          m_spareSetupPending(false),
+          m_scaleParametersPending(false),
+          m_lookaheadDraining(false),
+          m_lookaheadRate(0.0),
+          m_stableCallbacks(0) {
     // Initialize the internal buffers to prevent re-allocations
     // in the real-time thread.
     onSampleRateChanged();
 }
 
+EngineBufferScaleRubberBand::~EngineBufferScaleRubberBand() {
+    if (m_pLookaheadWorker) {
+        // The worker finishes its current chunk before it quits
+        releaseLookahead();
+        m_pLookaheadWorker->quitWait();
+    }
+}
+
+void EngineBufferScaleRubberBand::setScheduler(EngineWorkerScheduler* pScheduler) {
+    if (m_lookaheadMillis <= 0 || m_pLookaheadWorker) {
+        return;
+    }
+    m_pLookaheadInput = std::make_unique<FIFO<CSAMPLE>>(
+            kLookaheadCapacityFrames * mixxx::kEngineChannelCount);
+    m_pLookaheadOutput = std::make_unique<FIFO<CSAMPLE>>(
+            kLookaheadCapacityFrames * mixxx::kEngineChannelCount);
+    mixxx::SampleBuffer(kLookaheadChunkFrames * mixxx::kEngineChannelCount)
+            .swap(m_lookaheadBuffer);
+    m_pSpareStretcher = std::make_unique<Stretcher>();
+    setupStretcher(m_pSpareStretcher.get());
+    m_pLookaheadWorker = std::make_unique<LookaheadWorker>(this);
+    m_pLookaheadWorker->setScheduler(pScheduler);
+    m_pLookaheadWorker->start(QThread::HighPriority);
+}
+
 void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
                                                      double* pTempoRatio,
                                                      double* pPitchRatio) {
+    // The output that has already been stretched is played with the old
+    // parameters. EngineBuffer avoids that by calling clear() first.
+    const bool ownsRubberBand = stopLookahead();
+    m_stableCallbacks = 0;
+
     // Negative speed means we are going backwards. pitch does not affect
     // the playback direction.
     m_bBackwards = *pTempoRatio < 0;
@@ -51,52 +148,78 @@ void EngineBufferScaleRubberBand::setScaleParameters(double base_rate,
             speed_abs = *pTempoRatio = 0;
         }
     }
+    // Used by other methods so we need to keep them up to date.
+    m_dBaseRate = base_rate;
+    m_dTempoRatio = speed_abs;
+    m_dPitchRatio = *pPitchRatio;
+
+    if (!ownsRubberBand) {
+        // Applied when the lookahead worker has handed the time stretcher
+        // back
+        m_scaleParametersPending = true;
+        return;
+    }
+    applyScaleParameters();
+    if (m_dTempoRatio != speed_abs) {
+        *pTempoRatio = m_bBackwards ? -m_dTempoRatio : m_dTempoRatio;
+    }
+}
+
+void EngineBufferScaleRubberBand::applyScaleParameters() {
     // RubberBand handles checking for whether the change in pitchScale is a
     // no-op.
-    double pitchScale = fabs(base_rate * *pPitchRatio);
+    double pitchScale = fabs(m_dBaseRate * m_dPitchRatio);
 
     if (pitchScale > 0) {
         //qDebug() << "EngineBufferScaleRubberBand setPitchScale" << *pitch << pitchScale;
-        m_rubberBand.setPitchScale(pitchScale);
+        m_pStretcher->rubberBand.setPitchScale(pitchScale);
     }
 
     // RubberBand handles checking for whether the change in timeRatio is a
     // no-op. Time ratio is the ratio of stretched to unstretched duration. So 1
     // second in real duration is 0.5 seconds in stretched duration if tempo is
     // 2.
-    double timeRatioInverse = base_rate * speed_abs;
+    double timeRatioInverse = m_dBaseRate * m_dTempoRatio;
     if (timeRatioInverse > 0) {
         //qDebug() << "EngineBufferScaleRubberBand setTimeRatio" << 1 / timeRatioInverse;
-        m_rubberBand.setTimeRatio(1.0 / timeRatioInverse);
+        m_pStretcher->rubberBand.setTimeRatio(1.0 / timeRatioInverse);
     }
 
     if (runningEngineVersion() == 2) {
-        if (m_rubberBand.getInputIncrement() == 0) {
+        if (m_pStretcher->rubberBand.getInputIncrement() == 0) {
             qWarning() << "EngineBufferScaleRubberBand inputIncrement is 0."
                        << "On RubberBand <=1.8.1 a SIGFPE is imminent despite"
                        << "our workaround. Taking evasive action."
                        << "Please file an issue on https://github.com/mixxxdj/mixxx/issues";
 
             // This is much slower than the minimum seek speed workaround above.
-            while (m_rubberBand.getInputIncrement() == 0) {
+            while (m_pStretcher->rubberBand.getInputIncrement() == 0) {
                 timeRatioInverse += 0.001;
-                m_rubberBand.setTimeRatio(1.0 / timeRatioInverse);
+                m_pStretcher->rubberBand.setTimeRatio(1.0 / timeRatioInverse);
             }
-            speed_abs = timeRatioInverse / base_rate;
-            *pTempoRatio = m_bBackwards ? -speed_abs : speed_abs;
+            m_dTempoRatio = timeRatioInverse / m_dBaseRate;
         }
     }
-    // Used by other methods so we need to keep them up to date.
-    m_dBaseRate = base_rate;
-    m_dTempoRatio = speed_abs;
-    m_dPitchRatio = *pPitchRatio;
 }
 
 void EngineBufferScaleRubberBand::onSampleRateChanged() {
     // TODO: Resetting the sample rate will cause internal
     // memory allocations that may block the real-time thread.
     // When is this function actually invoked??
-    m_rubberBand.clear();
+    discardLookahead();
+    setupStretcher(m_pStretcher.get());
+    if (m_pSpareStretcher) {
+        if (m_pLookaheadStretcher == m_pSpareStretcher.get()) {
+            // Set up when the worker has handed it back
+            m_spareSetupPending = true;
+        } else {
+            setupStretcher(m_pSpareStretcher.get());
+        }
+    }
+}
+
+void EngineBufferScaleRubberBand::setupStretcher(Stretcher* pStretcher) {
+    pStretcher->rubberBand.clear();
     if (!getOutputSignal().isValid()) {
         return;
     }
@@ -112,28 +235,31 @@ void EngineBufferScaleRubberBand::onSampleRateChanged() {
     }
 #endif
 
-    m_rubberBand.setup(
+    pStretcher->rubberBand.setup(
             getOutputSignal().getSampleRate(),
             getOutputSignal().getChannelCount(),
             rubberbandOptions);
     // Setting the time ratio to a very high value will cause RubberBand
     // to preallocate buffers large enough to (almost certainly)
     // avoid memory reallocations during playback.
-    m_rubberBand.setTimeRatio(2.0);
-    m_rubberBand.setTimeRatio(1.0);
+    pStretcher->rubberBand.setTimeRatio(2.0);
+    pStretcher->rubberBand.setTimeRatio(1.0);
 }
 
 void EngineBufferScaleRubberBand::clear() {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pStretcher->rubberBand.isValid()) {
         return;
     }
+    m_stableCallbacks = 0;
+    discardLookahead();
     reset();
 }
 
 SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
+        Stretcher* pStretcher,
         CSAMPLE* pBuffer,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(pStretcher->rubberBand.isValid()) {
         return 0;
     }
     // NOTE: If we still need to throw away padding, then we can also
@@ -142,48 +268,67 @@ SINT EngineBufferScaleRubberBand::retrieveAndDeinterleave(
     SINT received_frames;
     {
         ScopedTimer t(QStringLiteral("RubberBand::retrieve"));
-        received_frames = static_cast<SINT>(m_rubberBand.retrieve(
-                m_bufferPtrs.data(), frames + m_remainingPaddingInOutput, m_buffers[0].size()));
+        received_frames = static_cast<SINT>(pStretcher->rubberBand.retrieve(
+                pStretcher->bufferPtrs.data(),
+                frames + pStretcher->remainingPaddingInOutput,
+                pStretcher->buffers[0].size()));
     }
     SINT frame_offset = 0;
 
     // As explained below in `reset()`, the first time this is called we need to
     // drop the silence we fed into the time stretcher as padding from the
     // output
-    if (m_remainingPaddingInOutput > 0) {
-        const SINT drop_num_frames = std::min(received_frames, m_remainingPaddingInOutput);
+    if (pStretcher->remainingPaddingInOutput > 0) {
+        const SINT drop_num_frames = std::min(
+                received_frames, pStretcher->remainingPaddingInOutput);
 
-        m_remainingPaddingInOutput -= drop_num_frames;
+        pStretcher->remainingPaddingInOutput -= drop_num_frames;
         received_frames -= drop_num_frames;
         frame_offset += drop_num_frames;
     }
 
     DEBUG_ASSERT(received_frames <= frames);
     SampleUtil::interleaveBuffer(pBuffer,
-            m_buffers[0].data(frame_offset),
-            m_buffers[1].data(frame_offset),
+            pStretcher->buffers[0].data(frame_offset),
+            pStretcher->buffers[1].data(frame_offset),
             received_frames);
 
     return received_frames;
 }
 
+SINT EngineBufferScaleRubberBand::readInput(
+        double rate, CSAMPLE* pBuffer, SINT samples) {
+    // Only the input that is needed for the current call is taken from the
+    // lookahead FIFO, so stopping the lookahead does not process all of it
+    // at once. Input the worker may still read after discardLookahead() is
+    // dropped with the next handback.
+    if (m_pLookaheadInput && !m_lookaheadFlushPending) {
+        const SINT queued_samples = m_pLookaheadInput->read(pBuffer, samples);
+        if (queued_samples > 0) {
+            return queued_samples;
+        }
+    }
+    return m_pReadAheadManager->getNextSamples(rate, pBuffer, samples);
+}
+
 void EngineBufferScaleRubberBand::deinterleaveAndProcess(
+        Stretcher* pStretcher,
         const CSAMPLE* pBuffer,
         SINT frames) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(pStretcher->rubberBand.isValid()) {
         return;
     }
-    DEBUG_ASSERT(frames <= static_cast<SINT>(m_buffers[0].size()));
+    DEBUG_ASSERT(frames <= static_cast<SINT>(pStretcher->buffers[0].size()));
 
     SampleUtil::deinterleaveBuffer(
-            m_buffers[0].data(),
-            m_buffers[1].data(),
+            pStretcher->buffers[0].data(),
+            pStretcher->buffers[1].data(),
             pBuffer,
             frames);
 
     {
         ScopedTimer t(QStringLiteral("RubberBand::process"));
-        m_rubberBand.process(m_bufferPtrs.data(),
+        pStretcher->rubberBand.process(pStretcher->bufferPtrs.data(),
                 frames,
                 false);
     }
@@ -192,7 +337,7 @@ void EngineBufferScaleRubberBand::deinterleaveAndProcess(
 double EngineBufferScaleRubberBand::scaleBuffer(
         CSAMPLE* pOutputBuffer,
         SINT iOutputBufferSize) {
-    VERIFY_OR_DEBUG_ASSERT(m_rubberBand.isValid()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pStretcher->rubberBand.isValid()) {
         return 0.0;
     }
     ScopedTimer t(QStringLiteral("EngineBufferScaleRubberBand::scaleBuffer"));
@@ -203,30 +348,73 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         return 0.0;
     }
 
+    const bool batched = m_pBatch && m_pBatch->isEnabled();
     double readFramesProcessed = 0;
-    SINT remaining_frames = getOutputSignal().samples2frames(iOutputBufferSize);
+    const SINT output_frames = getOutputSignal().samples2frames(iOutputBufferSize);
+    SINT remaining_frames = output_frames;
     CSAMPLE* read = pOutputBuffer;
     bool last_read_failed = false;
+    bool processed_inline = false;
+
+    if (m_pLookaheadWorker && m_lookaheadFlushPending) {
+        // The worker may hand the discarded time stretcher back, meanwhile
+        // the spare one stretches on this thread
+        finishLookaheadRelease();
+    }
+    if (m_pLookaheadWorker && !m_lookaheadFlushPending) {
+        // This also plays the output that is left after the lookahead has
+        // been stopped
+        SINT lookahead_frames = readLookahead(read, remaining_frames);
+        if (lookahead_frames < remaining_frames && hasLookahead()) {
+            if (!m_lookaheadDraining) {
+                Counter counter("EngineBufferScaleRubberBand lookahead underflow");
+                counter.increment();
+            }
+            stopLookahead();
+            lookahead_frames += readLookahead(
+                    read + getOutputSignal().frames2samples(lookahead_frames),
+                    remaining_frames - lookahead_frames);
+        }
+        remaining_frames -= lookahead_frames;
+        readFramesProcessed += m_lookaheadRate * lookahead_frames;
+        read += getOutputSignal().frames2samples(lookahead_frames);
+        if (remaining_frames == 0 && hasLookahead()) {
+            feedLookahead(output_frames);
+            return readFramesProcessed;
+        }
+        if (!finishLookaheadRelease()) {
+            // Play what the worker has produced and try again with the next
+            // call, rather than waiting for the worker in the audio callback
+            if (remaining_frames > 0) {
+                SampleUtil::clear(read, getOutputSignal().frames2samples(remaining_frames));
+                Counter counter(QStringLiteral(
+                        "EngineBufferScaleRubberBand lookahead release underflow"));
+                counter.increment();
+            }
+            return readFramesProcessed;
+        }
+    }
+
     while (remaining_frames > 0) {
         // ReadAheadManager will eventually read the requested frames with
         // enough calls to retrieveAndDeinterleave because CachingReader returns
         // zeros for reads that are not in cache. So it's safe to loop here
         // without any checks for failure in retrieveAndDeinterleave.
         // If the time stretcher has just been reset then this will throw away
-        // the first `m_remainingPaddingInOutput` samples of silence padding
+        // the first `remainingPaddingInOutput` samples of silence padding
         // from the output.
         SINT received_frames = retrieveAndDeinterleave(
-                read, remaining_frames);
+                m_pStretcher.get(), read, remaining_frames);
         remaining_frames -= received_frames;
         readFramesProcessed += m_effectiveRate * received_frames;
         read += getOutputSignal().frames2samples(received_frames);
 
         const SINT next_block_frames_required =
-                static_cast<SINT>(m_rubberBand.getSamplesRequired());
+                static_cast<SINT>(m_pStretcher->rubberBand.getSamplesRequired());
         if (remaining_frames > 0 && next_block_frames_required > 0) {
             // The requested setting becomes effective after all previous frames have been processed
             m_effectiveRate = m_dBaseRate * m_dTempoRatio;
-            const SINT available_samples = m_pReadAheadManager->getNextSamples(
+            const SINT available_samples = readInput(
                     // The value doesn't matter here. All that matters is we
                     // are going forward or backward.
                     (m_bBackwards ? -1.0 : 1.0) * m_dBaseRate * m_dTempoRatio,
@@ -236,7 +424,10 @@ double EngineBufferScaleRubberBand::scaleBuffer(
 
             if (available_frames > 0) {
                 last_read_failed = false;
-                deinterleaveAndProcess(m_interleavedReadBuffer.data(), available_frames);
+                processed_inline = true;
+                deinterleaveAndProcess(m_pStretcher.get(),
+                        m_interleavedReadBuffer.data(),
+                        available_frames);
             } else {
                 // We may get 0 samples once if we just hit a loop trigger, e.g.
                 // when reloop_toggle jumps back to loop_in, or when moving a
@@ -250,7 +441,8 @@ double EngineBufferScaleRubberBand::scaleBuffer(
                     SampleUtil::clear(
                             m_interleavedReadBuffer.data(),
                             getOutputSignal().frames2samples(next_block_frames_required));
-                    deinterleaveAndProcess(m_interleavedReadBuffer.data(),
+                    deinterleaveAndProcess(m_pStretcher.get(),
+                            m_interleavedReadBuffer.data(),
                             next_block_frames_required);
                 }
                 last_read_failed = true;
@@ -264,12 +456,235 @@ double EngineBufferScaleRubberBand::scaleBuffer(
         counter.increment();
     }
 
+    if (m_pLookaheadWorker) {
+        maybeStartLookahead(output_frames);
+    }
+
+    if (batched && !hasLookahead()) {
+        if (processed_inline) {
+            // The output of the last batch was not sufficient
+            Counter counter("EngineBufferScaleRubberBand::getScaled batch underflow");
+            counter.increment();
+        }
+        submitToBatch(output_frames);
+    }
+
     // readFramesProcessed is interpreted as the total number of frames
     // consumed to produce the scaled buffer. Due to this, we do not take into
     // account directionality or starting point.
     return readFramesProcessed;
 }
 
+void EngineBufferScaleRubberBand::submitToBatch(SINT outputFrames) {
+    const SINT buffered_frames =
+            m_pStretcher->rubberBand.available() - m_pStretcher->remainingPaddingInOutput;
+    if (buffered_frames >= outputFrames) {
+        return;
+    }
+    m_effectiveRate = m_dBaseRate * m_dTempoRatio;
+    const SINT max_frames = std::min(
+            static_cast<SINT>(m_batchBuffers[0].size()),
+            getOutputSignal().samples2frames(m_interleavedReadBuffer.size()));
+    const SINT frames = math_min(max_frames,
+            math_max(static_cast<SINT>(std::ceil(
+                             (outputFrames - buffered_frames) * m_effectiveRate)),
+                    static_cast<SINT>(m_pStretcher->rubberBand.getSamplesRequired())));
+    const SINT available_samples = readInput(
+            (m_bBackwards ? -1.0 : 1.0) * m_effectiveRate,
+            m_interleavedReadBuffer.data(),
+            getOutputSignal().frames2samples(frames));
+    const SINT available_frames = getOutputSignal().samples2frames(available_samples);
+    if (available_frames <= 0) {
+        // Loop jumps and the end of the track are handled by the next
+        // scaleBuffer() call
+        return;
+    }
+    SampleUtil::deinterleaveBuffer(
+            m_batchBuffers[0].data(),
+            m_batchBuffers[1].data(),
+            m_interleavedReadBuffer.data(),
+            available_frames);
+    m_pStretcher->rubberBand.submit(m_batchBufferPtrs.data(), available_frames, m_pBatch);
+}
+
+SINT EngineBufferScaleRubberBand::readLookahead(CSAMPLE* pBuffer, SINT frames) {
+    const SINT samples = math_min(getOutputSignal().frames2samples(frames),
+            static_cast<SINT>(m_pLookaheadOutput->readAvailable()));
+    if (samples <= 0) {
+        return 0;
+    }
+    return getOutputSignal().samples2frames(m_pLookaheadOutput->read(pBuffer, samples));
+}
+
+void EngineBufferScaleRubberBand::maybeStartLookahead(SINT outputFrames) {
+    // Not before the worker has handed back the time stretcher of the last
+    // lookahead, which still uses the FIFOs
+    if (hasLookahead() || m_lookaheadReleasing ||
+            ++m_stableCallbacks < kLookaheadStableCallbacks) {
+        return;
+    }
+    m_lookaheadRate = m_dBaseRate * m_dTempoRatio;
+    m_lookaheadDraining = false;
+    m_pLookaheadStretcher = m_pStretcher.get();
+    m_lookaheadActive.store(true, std::memory_order_seq_cst);
+    feedLookahead(outputFrames);
+}
+
+void EngineBufferScaleRubberBand::feedLookahead(SINT outputFrames) {
+    if (m_lookaheadDraining) {
+        return;
+    }
+    const SINT lookahead_frames = static_cast<SINT>(
+            getOutputSignal().getSampleRate().value() * m_lookaheadMillis / 1000);
+    const SINT queued_frames =
+            getOutputSignal().samples2frames(m_pLookaheadOutput->readAvailable()) +
+            static_cast<SINT>(getOutputSignal().samples2frames(
+                                      m_pLookaheadInput->readAvailable()) /
+                    m_lookaheadRate);
+    const SINT missing_frames = math_min(
+            math_min(lookahead_frames, kLookaheadCapacityFrames / 2) - queued_frames,
+            kLookaheadMaxFeedBuffers * outputFrames);
+    const SINT input_frames = math_min(
+            static_cast<SINT>(std::ceil(missing_frames * m_lookaheadRate)),
+            math_min(getOutputSignal().samples2frames(m_pLookaheadInput->writeAvailable()),
+                    getOutputSignal().samples2frames(m_interleavedReadBuffer.size())));
+    if (input_frames <= 0) {
+        return;
+    }
+
+    const double position_before = m_pReadAheadManager->getPlaypos();
+    const SINT available_samples = m_pReadAheadManager->getNextSamples(
+            (m_bBackwards ? -1.0 : 1.0) * m_lookaheadRate,
+            m_interleavedReadBuffer.data(),
+            getOutputSignal().frames2samples(input_frames));
+    if (available_samples > 0) {
+        m_pLookaheadInput->write(m_interleavedReadBuffer.data(), available_samples);
+        m_pLookaheadWorker->workReady();
+    }
+    // Stop reading ahead at a loop or a jump, so the output after it is
+    // not stretched before the loop or jump may have changed
+    if (available_samples == 0 ||
+            std::abs(m_pReadAheadManager->getPlaypos() - position_before) !=
+                    available_samples) {
+        m_lookaheadDraining = true;
+    }
+}
+
+bool EngineBufferScaleRubberBand::releaseLookahead() {
+    if (hasLookahead()) {
+        m_lookaheadActive.store(false, std::memory_order_seq_cst);
+        m_lookaheadReleasing = true;
+    }
+    return finishLookaheadRelease();
+}
+
+bool EngineBufferScaleRubberBand::finishLookaheadRelease() {
+    if (!m_lookaheadReleasing) {
+        return !hasLookahead();
+    }
+    // The worker sets m_lookaheadWorkerBusy before checking
+    // m_lookaheadActive, so it does not touch the time stretcher anymore
+    // once it is not busy
+    if (m_lookaheadWorkerBusy.load(std::memory_order_seq_cst)) {
+        return m_pLookaheadStretcher != m_pStretcher.get();
+    }
+    m_lookaheadReleasing = false;
+    m_pLookaheadStretcher = nullptr;
+    if (m_lookaheadFlushPending) {
+        m_lookaheadFlushPending = false;
+        m_pLookaheadInput->flushReadData(m_pLookaheadInput->readAvailable());
+        m_pLookaheadOutput->flushReadData(m_pLookaheadOutput->readAvailable());
+    }
+    if (m_spareSetupPending) {
+        // Only after onSampleRateChanged(), which allocates as well
+        m_spareSetupPending = false;
+        setupStretcher(m_pSpareStretcher.get());
+    }
+    if (m_scaleParametersPending) {
+        m_scaleParametersPending = false;
+        applyScaleParameters();
+    }
+    return true;
+}
+
+void EngineBufferScaleRubberBand::waitUntilLookaheadProcessed() const {
+    if (!m_pLookaheadWorker) {
+        return;
+    }
+    // The worker sets m_lookaheadWorkerBusy before it reads the input and
+    // resets it after it has written the output
+    while (hasLookahead() &&
+            (m_pLookaheadInput->readAvailable() > 0 ||
+                    m_lookaheadWorkerBusy.load(std::memory_order_seq_cst))) {
+        QThread::yieldCurrentThread();
+    }
+}
+
+bool EngineBufferScaleRubberBand::stopLookahead() {
+    if (hasLookahead()) {
+        m_stableCallbacks = 0;
+        m_lookaheadDraining = false;
+    }
+    return releaseLookahead();
+}
+
+void EngineBufferScaleRubberBand::discardLookahead() {
+    if (!m_pLookaheadWorker) {
+        return;
+    }
+    m_lookaheadDraining = false;
+    if (!releaseLookahead()) {
+        // Stretch on this thread rather than playing silence until the
+        // worker has finished its chunk, it may have been preempted
+        std::swap(m_pStretcher, m_pSpareStretcher);
+        m_scaleParametersPending = false;
+        applyScaleParameters();
+        Counter counter(QStringLiteral(
+                "EngineBufferScaleRubberBand lookahead release with spare"));
+        counter.increment();
+    }
+    if (m_lookaheadReleasing) {
+        // The worker may still read input and write output
+        m_lookaheadFlushPending = true;
+        return;
+    }
+    m_pLookaheadInput->flushReadData(m_pLookaheadInput->readAvailable());
+    m_pLookaheadOutput->flushReadData(m_pLookaheadOutput->readAvailable());
+}
+
+void EngineBufferScaleRubberBand::processLookahead() {
+    while (true) {
+        m_lookaheadWorkerBusy.store(true, std::memory_order_seq_cst);
+        if (!m_lookaheadActive.load(std::memory_order_seq_cst)) {
+            break;
+        }
+        Stretcher* const pStretcher = m_pLookaheadStretcher;
+        const SINT samples = m_pLookaheadInput->read(
+                m_lookaheadBuffer.data(), static_cast<int>(m_lookaheadBuffer.size()));
+        if (samples <= 0) {
+            break;
+        }
+        deinterleaveAndProcess(pStretcher,
+                m_lookaheadBuffer.data(),
+                getOutputSignal().samples2frames(samples));
+
+        SINT output_frames;
+        while ((output_frames = math_min(
+                        static_cast<SINT>(pStretcher->rubberBand.available()),
+                        math_min(getOutputSignal().samples2frames(
+                                         m_pLookaheadOutput->writeAvailable()),
+                                getOutputSignal().samples2frames(
+                                        m_lookaheadBuffer.size())))) > 0) {
+            const SINT received_frames = retrieveAndDeinterleave(
+                    pStretcher, m_lookaheadBuffer.data(), output_frames);
+            m_pLookaheadOutput->write(m_lookaheadBuffer.data(),
+                    getOutputSignal().frames2samples(received_frames));
+        }
+        m_lookaheadWorkerBusy.store(false, std::memory_order_seq_cst);
+    }
+    m_lookaheadWorkerBusy.store(false, std::memory_order_seq_cst);
+}
+
 // static
 bool EngineBufferScaleRubberBand::isEngineFinerAvailable() {
     return RUBBERBANDV3;
@@ -283,19 +698,19 @@ void EngineBufferScaleRubberBand::useEngineFiner(bool enable) {
 }
 
 size_t EngineBufferScaleRubberBand::getPreferredStartPad() const {
-    return m_rubberBand.getPreferredStartPad();
+    return m_pStretcher->rubberBand.getPreferredStartPad();
 }
 
 size_t EngineBufferScaleRubberBand::getStartDelay() const {
-    return m_rubberBand.getStartDelay();
+    return m_pStretcher->rubberBand.getStartDelay();
 }
 
 int EngineBufferScaleRubberBand::runningEngineVersion() {
-    return m_rubberBand.getEngineVersion();
+    return m_pStretcher->rubberBand.getEngineVersion();
 }
 
 void EngineBufferScaleRubberBand::reset() {
-    m_rubberBand.reset();
+    m_pStretcher->rubberBand.reset();
 
     // As mentioned in the docs (https://breakfastquay.com/rubberband/code-doc/)
     // and FAQ (https://breakfastquay.com/rubberband/integration.html#faqs), you
@@ -306,14 +721,16 @@ void EngineBufferScaleRubberBand::reset() {
     // See https://github.com/mixxxdj/mixxx/pull/11120#discussion_r1050011104
     // for more information.
     size_t remaining_padding = getPreferredStartPad();
-    const size_t block_size = std::min<size_t>(remaining_padding, m_buffers[0].size());
-    std::fill_n(m_buffers[0].span().begin(), block_size, 0.0f);
-    std::fill_n(m_buffers[1].span().begin(), block_size, 0.0f);
+    const size_t block_size =
+            std::min<size_t>(remaining_padding, m_pStretcher->buffers[0].size());
+    std::fill_n(m_pStretcher->buffers[0].span().begin(), block_size, 0.0f);
+    std::fill_n(m_pStretcher->buffers[1].span().begin(), block_size, 0.0f);
     while (remaining_padding > 0) {
         const size_t pad_samples = std::min<size_t>(remaining_padding, block_size);
         {
             ScopedTimer t(QStringLiteral("RubberBand::process"));
-            m_rubberBand.process(m_bufferPtrs.data(), pad_samples, false);
+            m_pStretcher->rubberBand.process(
+                    m_pStretcher->bufferPtrs.data(), pad_samples, false);
         }
 
         remaining_padding -= pad_samples;
@@ -323,5 +740,5 @@ void EngineBufferScaleRubberBand::reset() {
     // https://github.com/mixxxdj/mixxx/pull/11120#discussion_r1050011104). This
     // silence should be dropped from the result when the `retrieve()` in
     // `retrieveAndDeinterleave()` first starts producing audio.
-    m_remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
+    m_pStretcher->remainingPaddingInOutput = static_cast<SINT>(getStartDelay());
 }
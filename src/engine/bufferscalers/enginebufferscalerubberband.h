@@ -3,13 +3,17 @@
 #include <rubberband/RubberBandStretcher.h>
 
 #include <array>
+#include <atomic>
 #include <memory>
 
 #include "engine/bufferscalers/enginebufferscale.h"
 #include "engine/bufferscalers/rubberbandwrapper.h"
+#include "util/fifo.h"
 #include "util/samplebuffer.h"
 
+class EngineWorkerScheduler;
 class ReadAheadManager;
+class RubberBandBatch;
 
 // Uses librubberband to scale audio.  This class is not thread safe.
 class EngineBufferScaleRubberBand final : public EngineBufferScale {
@@ -17,6 +21,7 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
   public:
     explicit EngineBufferScaleRubberBand(
             ReadAheadManager* pReadAheadManager);
+    ~EngineBufferScaleRubberBand() override;
 
     EngineBufferScaleRubberBand(const EngineBufferScaleRubberBand&) = delete;
     EngineBufferScaleRubberBand& operator=(const EngineBufferScaleRubberBand&) = delete;
@@ -30,6 +35,36 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     // Enable engine v3 if available
     void useEngineFiner(bool enable);
 
+    /// While pBatch is enabled, the input for the next scaleBuffer() call is
+    /// queued in pBatch instead of being processed right away. It must be
+    /// processed before that call, otherwise it is processed by that call.
+    void setBatch(RubberBandBatch* pBatch) {
+        m_pBatch = pBatch;
+    }
+
+    /// While the tempo and pitch are constant, time stretch up to
+    /// lookaheadMillis ahead of the output on a worker thread, so that
+    /// scaleBuffer() only needs to copy the output. Changing the parameters,
+    /// clear(), an underflow and a jump of the ReadAheadManager, e.g. at the
+    /// end of a loop, return to processing in scaleBuffer(). Only takes
+    /// effect with the following setScheduler() call, which also creates a
+    /// spare time stretcher for continuing while the worker is busy after
+    /// clear().
+    void setLookahead(int lookaheadMillis) {
+        m_lookaheadMillis = lookaheadMillis;
+    }
+    /// Starts the lookahead worker if a lookahead is set.
+    void setScheduler(EngineWorkerScheduler* pScheduler);
+
+    bool hasLookahead() const override {
+        return m_lookaheadActive.load(std::memory_order_relaxed);
+    }
+    /// Blocks until the worker has processed all input that has been read
+    /// ahead for it. Must be called after the scheduler has run the
+    /// workers. Not realtime safe, allows tests to synchronize with the
+    /// worker.
+    void waitUntilLookaheadProcessed() const;
+
     void setScaleParameters(double base_rate,
                             double* pTempoRatio,
                             double* pPitchRatio) override;
@@ -42,47 +77,141 @@ class EngineBufferScaleRubberBand final : public EngineBufferScale {
     void clear() override;
 
   private:
+    class LookaheadWorker;
+
+    /// A time stretcher and the buffers for exchanging audio with it
+    struct Stretcher {
+        Stretcher();
+
+        RubberBandWrapper rubberBand;
+        /// The audio buffers samples used to send audio to Rubber Band and
+        /// to receive processed audio from Rubber Band. This is needed
+        /// because Mixxx uses interleaved buffers in most other places.
+        std::array<mixxx::SampleBuffer, 2> buffers;
+        /// These point to the buffers in `buffers`. They can be defined here
+        /// since Stretcher is only allocated on the heap and never moved.
+        std::array<float*, 2> bufferPtrs;
+        /// The amount of silence padding that still needs to be dropped from
+        /// the retrieve samples in `retrieveAndDeinterleave()`. See the
+        /// `reset()` function for an explanation.
+        SINT remainingPaddingInOutput = 0;
+    };
+
     // Reset RubberBand library with new audio signal
     void onSampleRateChanged() override;
 
-    /// Calls `m_pRubberBand->getPreferredStartPad()`, with backwards
+    /// Sets pStretcher up for the current output signal
+    void setupStretcher(Stretcher* pStretcher);
+
+    /// Calls `getPreferredStartPad()` of the time stretcher, with backwards
     /// compatibility for older librubberband versions.
     size_t getPreferredStartPad() const;
-    /// Calls `m_pRubberBand->getStartDelay()`, with backwards compatibility for
-    /// older librubberband versions.
+    /// Calls `getStartDelay()` of the time stretcher, with backwards
+    /// compatibility for older librubberband versions.
     size_t getStartDelay() const;
     int runningEngineVersion();
     /// Reset the rubberband instance and run the prerequisite amount of padding
     /// through it. This should be used instead of calling
-    /// `m_pRubberBand->reset()` directly.
+    /// `reset()` of the time stretcher directly.
     void reset();
 
-    void deinterleaveAndProcess(const CSAMPLE* pBuffer, SINT frames);
-    SINT retrieveAndDeinterleave(CSAMPLE* pBuffer, SINT frames);
+    /// Applies `m_dBaseRate`, `m_dTempoRatio` and `m_dPitchRatio` to the
+    /// time stretcher.
+    void applyScaleParameters();
+
+    /// Reads the input for processing on the engine thread. Input that has
+    /// been read ahead for the worker, but not been processed by it, comes
+    /// first.
+    SINT readInput(double rate, CSAMPLE* pBuffer, SINT samples);
+    void deinterleaveAndProcess(Stretcher* pStretcher, const CSAMPLE* pBuffer, SINT frames);
+    SINT retrieveAndDeinterleave(Stretcher* pStretcher, CSAMPLE* pBuffer, SINT frames);
+    /// Reads the input for the next scaleBuffer() call and queues it in
+    /// `m_pBatch`, assuming the next call is for outputFrames at the current
+    /// rate.
+    void submitToBatch(SINT outputFrames);
+
+    /// Copies up to frames from `m_pLookaheadOutput`, returns the number of
+    /// frames copied.
+    SINT readLookahead(CSAMPLE* pBuffer, SINT frames);
+    /// Hands the time stretcher over to the worker after the parameters
+    /// have been constant for a while.
+    void maybeStartLookahead(SINT outputFrames);
+    /// Reads input for the worker, so that it can stay the lookahead ahead
+    /// of the output.
+    void feedLookahead(SINT outputFrames);
+    /// Asks the worker to hand the time stretcher back without waiting for
+    /// it. Returns true if the engine thread owns `m_pStretcher`.
+    bool releaseLookahead();
+    /// Completes releaseLookahead() once the worker has finished its current
+    /// chunk and applies the changes that have been deferred until then.
+    /// Returns true if the engine thread owns `m_pStretcher`, which is also
+    /// the case while the worker still holds the spare time stretcher after
+    /// discardLookahead().
+    bool finishLookaheadRelease();
+    /// Takes the time stretcher back from the worker. The input the worker
+    /// has not processed yet is processed on demand by scaleBuffer().
+    /// Returns true if the engine thread owns the time stretcher again.
+    bool stopLookahead();
+    /// Takes the time stretcher back from the worker and drops all input and
+    /// output that has not been played. If the worker is busy with a chunk,
+    /// the engine thread continues with the spare time stretcher instead of
+    /// waiting for it, and the worker keeps the old one until it is done.
+    /// The caller resets `m_pStretcher` afterwards.
+    void discardLookahead();
+    /// Runs on the worker thread.
+    void processLookahead();
 
     // The read-ahead manager that we use to fetch samples
     ReadAheadManager* m_pReadAheadManager;
 
-    RubberBandWrapper m_rubberBand;
-
-    /// The audio buffers samples used to send audio to Rubber Band and to
-    /// receive processed audio from Rubber Band. This is needed because Mixxx
-    /// uses interleaved buffers in most other places.
-    std::array<mixxx::SampleBuffer, 2> m_buffers;
-    /// These point to the buffers in `m_buffers`. They can be defined here
-    /// since this object cannot be moved or copied.
-    std::array<float*, 2> m_bufferPtrs;
+    /// The time stretcher of the engine thread, see `m_pLookaheadStretcher`
+    std::unique_ptr<Stretcher> m_pStretcher;
+    /// Swapped with `m_pStretcher` when the worker is busy with it in
+    /// discardLookahead(). Only exists with a lookahead.
+    std::unique_ptr<Stretcher> m_pSpareStretcher;
 
     /// Contains interleaved samples read from `m_pReadAheadManager`. These need
     /// to be deinterleaved before they can be passed to Rubber Band.
     mixxx::SampleBuffer m_interleavedReadBuffer;
 
+    RubberBandBatch* m_pBatch;
+    /// The deinterleaved input that is queued in `m_pBatch`. Separate from
+    /// `Stretcher::buffers`, because it must remain valid until the batch
+    /// is processed.
+    std::array<mixxx::SampleBuffer, 2> m_batchBuffers;
+    std::array<float*, 2> m_batchBufferPtrs;
+
     // Holds the playback direction
     bool m_bBackwards;
-    /// The amount of silence padding that still needs to be dropped from the
-    /// retrieve samples in `retrieveAndDeinterleave()`. See the `reset()`
-    /// function for an explanation.
-    SINT m_remainingPaddingInOutput = 0;
 
     bool m_useEngineFiner;
+
+    int m_lookaheadMillis;
+    std::unique_ptr<LookaheadWorker> m_pLookaheadWorker;
+    /// Interleaved input from the engine thread to the worker and output
+    /// from the worker to the engine thread.
+    std::unique_ptr<FIFO<CSAMPLE>> m_pLookaheadInput;
+    std::unique_ptr<FIFO<CSAMPLE>> m_pLookaheadOutput;
+    /// The worker owns `m_pLookaheadStretcher` while this is set.
+    std::atomic<bool> m_lookaheadActive;
+    std::atomic<bool> m_lookaheadWorkerBusy;
+    /// The time stretcher of the worker, set before `m_lookaheadActive`.
+    /// The engine thread owns `m_pStretcher` unless this points to it.
+    Stretcher* m_pLookaheadStretcher;
+    /// The worker has been asked to hand the time stretcher back, but it was
+    /// busy with a chunk. The engine thread checks again with the next call
+    /// instead of waiting for the worker, which may have been preempted.
+    bool m_lookaheadReleasing;
+    /// Deferred until the worker has handed the time stretcher back
+    bool m_lookaheadFlushPending;
+    bool m_spareSetupPending;
+    bool m_scaleParametersPending;
+    /// The worker's buffer for reading from `m_pLookaheadInput` and writing
+    /// to `m_pLookaheadOutput`.
+    mixxx::SampleBuffer m_lookaheadBuffer;
+    /// The ReadAheadManager jumped, no more input is read ahead.
+    bool m_lookaheadDraining;
+    /// The rate of the output in `m_pLookaheadOutput`.
+    double m_lookaheadRate;
+    int m_stableCallbacks;
 };
@@ -0,0 +1,518 @@
+#include "engine/bufferscalers/enginebufferscalesinc.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "engine/engine.h"
+#include "engine/readaheadmanager.h"
+#include "moc_enginebufferscalesinc.cpp"
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/platform.h"
+#include "util/sample.h"
+
+namespace {
+
+// The filter of the highest quality needs this many frames before and
+// after the current position. The history always covers it, so the quality
+// can be changed while playing.
+constexpr int kMaxHalfTaps = 32;
+
+// Number of tabulated phases between two input frames. The coefficients
+// in between are interpolated linearly.
+constexpr int kPhases = 128;
+
+// Playing faster than the original speed requires a lower cutoff frequency
+// to avoid aliasing. The coefficients are tabulated for rates up to two
+// octaves in steps of two semitones. Even faster rates only occur while
+// seeking or scratching and use the lowest cutoff.
+constexpr int kNumBands = 13;
+constexpr double kBandsPerOctave = 6.0;
+
+constexpr SINT kReadFrames = 4096;
+constexpr SINT kHistoryFrames = kReadFrames + 4 * kMaxHalfTaps;
+
+struct QualityParameters {
+    int taps;
+    // Relative to the Nyquist frequency. Limits the aliasing of the frequencies
+    // in the transition band of the shorter filters.
+    double cutoff;
+    double kaiserBeta;
+};
+
+QualityParameters qualityParameters(EngineBufferScaleSinc::Quality quality) {
+    switch (quality) {
+    case EngineBufferScaleSinc::Quality::Short:
+        return {16, 0.85, 6.0};
+    case EngineBufferScaleSinc::Quality::Medium:
+        return {32, 0.91, 7.5};
+    case EngineBufferScaleSinc::Quality::Long:
+        return {2 * kMaxHalfTaps, 0.95, 9.0};
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return {32, 0.91, 7.5};
+}
+
+// Zeroth order modified Bessel function of the first kind
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    const double halfX = x / 2;
+    for (int k = 1; term > sum * 1e-12; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+    }
+    return sum;
+}
+
+double kaiserWindow(double x, double beta) {
+    return besselI0(beta * std::sqrt(std::max(1.0 - x * x, 0.0))) / besselI0(beta);
+}
+
+double sinc(double x) {
+    if (x == 0.0) {
+        return 1.0;
+    }
+    return std::sin(M_PI * x) / (M_PI * x);
+}
+
+#if defined(__GNUC__)
+#define SINC_KERNEL inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define SINC_KERNEL __forceinline
+#else
+#define SINC_KERNEL inline
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+        !defined(__EMSCRIPTEN__)
+#define SINC_X86_DISPATCH
+#endif
+
+// The taps are accumulated in independent lanes, so the loop is vectorized
+// without reordering the floating point additions. The number of taps must
+// be a multiple of kLanes.
+constexpr int kLanes = 8;
+
+SINC_KERNEL void convolveFrameKernel(CSAMPLE* M_RESTRICT pOutput,
+        const CSAMPLE* M_RESTRICT pLeft,
+        const CSAMPLE* M_RESTRICT pRight,
+        const float* M_RESTRICT pCoefficients0,
+        const float* M_RESTRICT pCoefficients1,
+        float phaseFraction,
+        int taps) {
+    CSAMPLE left[kLanes] = {};
+    CSAMPLE right[kLanes] = {};
+    for (int i = 0; i < taps; i += kLanes) {
+        // note: LOOP VECTORIZED.
+        for (int lane = 0; lane < kLanes; ++lane) {
+            const float coefficient = pCoefficients0[i + lane] +
+                    phaseFraction * (pCoefficients1[i + lane] - pCoefficients0[i + lane]);
+            left[lane] += coefficient * pLeft[i + lane];
+            right[lane] += coefficient * pRight[i + lane];
+        }
+    }
+    CSAMPLE sumLeft = CSAMPLE_ZERO;
+    CSAMPLE sumRight = CSAMPLE_ZERO;
+    for (int lane = 0; lane < kLanes; ++lane) {
+        sumLeft += left[lane];
+        sumRight += right[lane];
+    }
+    pOutput[0] = sumLeft;
+    pOutput[1] = sumRight;
+}
+
+using ConvolveFrameFunction = void (*)(CSAMPLE*,
+        const CSAMPLE*,
+        const CSAMPLE*,
+        const float*,
+        const float*,
+        float,
+        int);
+
+void convolveFrameBaseline(CSAMPLE* pOutput,
+        const CSAMPLE* pLeft,
+        const CSAMPLE* pRight,
+        const float* pCoefficients0,
+        const float* pCoefficients1,
+        float phaseFraction,
+        int taps) {
+    convolveFrameKernel(pOutput, pLeft, pRight, pCoefficients0, pCoefficients1, phaseFraction, taps);
+}
+
+#ifdef SINC_X86_DISPATCH
+__attribute__((target("avx2,fma"))) void convolveFrameAvx2(CSAMPLE* pOutput,
+        const CSAMPLE* pLeft,
+        const CSAMPLE* pRight,
+        const float* pCoefficients0,
+        const float* pCoefficients1,
+        float phaseFraction,
+        int taps) {
+    convolveFrameKernel(pOutput, pLeft, pRight, pCoefficients0, pCoefficients1, phaseFraction, taps);
+}
+
+__attribute__((target("avx512f"))) void convolveFrameAvx512(CSAMPLE* pOutput,
+        const CSAMPLE* pLeft,
+        const CSAMPLE* pRight,
+        const float* pCoefficients0,
+        const float* pCoefficients1,
+        float phaseFraction,
+        int taps) {
+    convolveFrameKernel(pOutput, pLeft, pRight, pCoefficients0, pCoefficients1, phaseFraction, taps);
+}
+#endif
+
+// Follows the instruction set that has been selected for SampleUtil
+ConvolveFrameFunction convolveFrameFunction() {
+    switch (SampleUtil::instructionSet()) {
+#ifdef SINC_X86_DISPATCH
+    case SampleUtil::InstructionSet::Avx2:
+        return &convolveFrameAvx2;
+    case SampleUtil::InstructionSet::Avx512:
+        return &convolveFrameAvx512;
+#endif
+    default:
+        return &convolveFrameBaseline;
+    }
+}
+
+} // anonymous namespace
+
+class EngineBufferScaleSinc::FilterBank {
+  public:
+    explicit FilterBank(const QualityParameters& parameters)
+            : m_taps(parameters.taps),
+              m_coefficients(static_cast<std::size_t>(kNumBands) *
+                      (kPhases + 1) * parameters.taps) {
+        DEBUG_ASSERT(m_taps % kLanes == 0);
+        DEBUG_ASSERT(m_taps <= 2 * kMaxHalfTaps);
+        const int halfTaps = m_taps / 2;
+        for (int band = 0; band < kNumBands; ++band) {
+            m_bandRates[band] = std::pow(2.0, band / kBandsPerOctave);
+            const double cutoff = parameters.cutoff / m_bandRates[band];
+            for (int phase = 0; phase <= kPhases; ++phase) {
+                const double fraction = static_cast<double>(phase) / kPhases;
+                float* pCoefficients = coefficients(band, phase);
+                double sum = 0.0;
+                for (int tap = 0; tap < m_taps; ++tap) {
+                    // The distance of the tap from the output position
+                    const double distance = fraction + halfTaps - 1 - tap;
+                    const double coefficient = cutoff * sinc(cutoff * distance) *
+                            kaiserWindow(distance / halfTaps, parameters.kaiserBeta);
+                    pCoefficients[tap] = static_cast<float>(coefficient);
+                    sum += coefficient;
+                }
+                // Unity gain for DC at every phase, otherwise the ripple of
+                // the gain would modulate the signal with the phase.
+                for (int tap = 0; tap < m_taps; ++tap) {
+                    pCoefficients[tap] = static_cast<float>(pCoefficients[tap] / sum);
+                }
+            }
+        }
+    }
+
+    int taps() const {
+        return m_taps;
+    }
+
+    int bandForRate(double rate) const {
+        for (int band = 0; band < kNumBands - 1; ++band) {
+            if (rate <= m_bandRates[band] * (1.0 + 1e-9)) {
+                return band;
+            }
+        }
+        return kNumBands - 1;
+    }
+
+    const float* coefficients(int band, int phase) const {
+        return &m_coefficients[(static_cast<std::size_t>(band) * (kPhases + 1) + phase) * m_taps];
+    }
+
+  private:
+    float* coefficients(int band, int phase) {
+        return &m_coefficients[(static_cast<std::size_t>(band) * (kPhases + 1) + phase) * m_taps];
+    }
+
+    const int m_taps;
+    std::array<double, kNumBands> m_bandRates;
+    std::vector<float> m_coefficients;
+};
+
+// static
+const EngineBufferScaleSinc::FilterBank* EngineBufferScaleSinc::filterBankForQuality(
+        Quality quality) {
+    // The filter banks are shared by all decks
+    switch (quality) {
+    case Quality::Short: {
+        static const FilterBank s_filterBank(qualityParameters(Quality::Short));
+        return &s_filterBank;
+    }
+    case Quality::Long: {
+        static const FilterBank s_filterBank(qualityParameters(Quality::Long));
+        return &s_filterBank;
+    }
+    case Quality::Medium:
+    default: {
+        static const FilterBank s_filterBank(qualityParameters(Quality::Medium));
+        return &s_filterBank;
+    }
+    }
+}
+
+EngineBufferScaleSinc::EngineBufferScaleSinc(
+        ReadAheadManager* pReadAheadManager, Quality quality)
+        : m_pReadAheadManager(pReadAheadManager),
+          m_quality(quality),
+          m_pRequestedFilterBank(filterBankForQuality(quality)),
+          m_pFilterBank(m_pRequestedFilterBank.load()),
+          m_readBuffer(kReadFrames * mixxx::kEngineChannelCount),
+          m_historyLeft(kHistoryFrames),
+          m_historyRight(kHistoryFrames),
+          m_historyFrames(0),
+          m_position(0.0),
+          m_bClear(false),
+          m_dRate(1.0),
+          m_dOldRate(1.0) {
+    resetHistory();
+}
+
+EngineBufferScaleSinc::~EngineBufferScaleSinc() {
+}
+
+void EngineBufferScaleSinc::setQuality(Quality quality) {
+    m_quality.store(quality, std::memory_order_relaxed);
+    m_pRequestedFilterBank.store(filterBankForQuality(quality), std::memory_order_release);
+}
+
+void EngineBufferScaleSinc::setScaleParameters(double base_rate,
+        double* pTempoRatio,
+        double* pPitchRatio) {
+    Q_UNUSED(pPitchRatio);
+
+    m_dOldRate = m_dRate;
+    m_dRate = base_rate * *pTempoRatio;
+}
+
+void EngineBufferScaleSinc::clear() {
+    m_bClear = true;
+    resetHistory();
+}
+
+void EngineBufferScaleSinc::resetHistory() {
+    // Silence before the first frame
+    m_historyFrames = kMaxHalfTaps - 1;
+    SampleUtil::clear(m_historyLeft.data(), m_historyFrames);
+    SampleUtil::clear(m_historyRight.data(), m_historyFrames);
+    m_position = m_historyFrames;
+}
+
+double EngineBufferScaleSinc::scaleBuffer(
+        CSAMPLE* pOutputBuffer,
+        SINT iOutputBufferSize) {
+    if (iOutputBufferSize == 0) {
+        return 0.0;
+    }
+    DEBUG_ASSERT(getOutputSignal().getChannelCount() == mixxx::kEngineChannelCount);
+
+    m_pFilterBank = m_pRequestedFilterBank.load(std::memory_order_acquire);
+
+    if (m_bClear) {
+        m_dOldRate = m_dRate; // If cleared, don't interpolate rate.
+        m_bClear = false;
+    }
+    // Smoothly interpolate to new playback rate
+    const double rateOld = m_dOldRate;
+    const double rateNew = m_dRate;
+    m_dOldRate = m_dRate;
+
+    const SINT numFrames = getOutputSignal().samples2frames(iOutputBufferSize);
+    if (rateOld * rateNew < 0) {
+        // Direction has changed! Ramp down to zero in the first half of the
+        // buffer and up to the new rate in the other direction in the second
+        // half.
+        const SINT firstHalfFrames = numFrames / 2;
+        double framesRead = scale(pOutputBuffer, firstHalfFrames, rateOld, 0.0);
+        framesRead += reverseDirection(rateNew);
+        framesRead += scale(
+                pOutputBuffer + getOutputSignal().frames2samples(firstHalfFrames),
+                numFrames - firstHalfFrames,
+                0.0,
+                rateNew);
+        return framesRead;
+    }
+    return scale(pOutputBuffer, numFrames, rateOld, rateNew);
+}
+
+double EngineBufferScaleSinc::scale(
+        CSAMPLE* pOutput, SINT numFrames, double rateFrom, double rateTo) {
+    DEBUG_ASSERT(rateFrom * rateTo >= 0);
+    if (numFrames <= 0) {
+        return 0.0;
+    }
+    // Special case -- no scaling needed!
+    if (rateFrom == rateTo && std::abs(rateTo) == 1.0 &&
+            m_position == std::floor(m_position)) {
+        return copy(pOutput, numFrames, rateTo);
+    }
+
+    // The sign tells the RAMAN the direction
+    const double readRate = rateTo == 0 ? rateFrom : rateTo;
+    double rate = std::abs(rateFrom);
+    // Smooth any changes in the playback rate over the buffer
+    const double rateDelta = (std::abs(rateTo) - rate) / numFrames;
+    const double maxRate = math_max(rate, std::abs(rateTo));
+
+    const FilterBank& filterBank = *m_pFilterBank;
+    const int band = filterBank.bandForRate(maxRate);
+    const int taps = filterBank.taps();
+    const int halfTaps = taps / 2;
+    const ConvolveFrameFunction convolveFrame = convolveFrameFunction();
+
+    const double startPosition = m_position;
+    double droppedFrames = 0.0;
+    for (SINT i = 0; i < numFrames; ++i) {
+        SINT index = static_cast<SINT>(m_position);
+        if (index + halfTaps >= m_historyFrames) {
+            droppedFrames += dropHistory();
+            index = static_cast<SINT>(m_position);
+            // Read the remaining frames of the buffer in one go, if possible
+            const SINT expectedFrames = static_cast<SINT>(
+                    std::ceil((numFrames - i) * maxRate));
+            fillHistory(index + halfTaps, index + halfTaps + expectedFrames, readRate);
+        }
+        const double phasePosition = (m_position - index) * kPhases;
+        const int phase = static_cast<int>(phasePosition);
+        const SINT firstFrame = index - halfTaps + 1;
+        convolveFrame(&pOutput[getOutputSignal().frames2samples(i)],
+                m_historyLeft.data(firstFrame),
+                m_historyRight.data(firstFrame),
+                filterBank.coefficients(band, phase),
+                filterBank.coefficients(band, phase + 1),
+                static_cast<float>(phasePosition - phase),
+                taps);
+        m_position += rate;
+        rate += rateDelta;
+    }
+    return m_position + droppedFrames - startPosition;
+}
+
+double EngineBufferScaleSinc::copy(CSAMPLE* pOutput, SINT numFrames, double rate) {
+    const double startPosition = m_position;
+    double droppedFrames = 0.0;
+    SINT framesCopied = 0;
+    while (framesCopied < numFrames) {
+        SINT index = static_cast<SINT>(m_position);
+        if (index >= m_historyFrames) {
+            droppedFrames += dropHistory();
+            index = static_cast<SINT>(m_position);
+            fillHistory(index, index + numFrames - framesCopied - 1, rate);
+        }
+        const SINT frames = math_min(numFrames - framesCopied, m_historyFrames - index);
+        SampleUtil::interleaveBuffer(
+                &pOutput[getOutputSignal().frames2samples(framesCopied)],
+                m_historyLeft.data(index),
+                m_historyRight.data(index),
+                frames);
+        framesCopied += frames;
+        m_position += frames;
+    }
+    return m_position + droppedFrames - startPosition;
+}
+
+SINT EngineBufferScaleSinc::dropHistory() {
+    // Keep the history of the longest filter, so the quality can be changed
+    // at any time.
+    const SINT firstFrame = math_min(
+            static_cast<SINT>(m_position) - kMaxHalfTaps + 1, m_historyFrames);
+    if (firstFrame <= 0) {
+        return 0;
+    }
+    const SINT remainingFrames = m_historyFrames - firstFrame;
+    std::memmove(m_historyLeft.data(),
+            m_historyLeft.data(firstFrame),
+            remainingFrames * sizeof(CSAMPLE));
+    std::memmove(m_historyRight.data(),
+            m_historyRight.data(firstFrame),
+            remainingFrames * sizeof(CSAMPLE));
+    m_historyFrames = remainingFrames;
+    m_position -= firstFrame;
+    return firstFrame;
+}
+
+void EngineBufferScaleSinc::fillHistory(
+        SINT lastFrame, SINT expectedLastFrame, double rate) {
+    // Protection against infinite read loops when (for example) we are
+    // reading from a broken file.
+    int readFailedCount = 0;
+    while (m_historyFrames <= lastFrame) {
+        const SINT framesToRead = math_min(
+                math_min(kReadFrames, kHistoryFrames - m_historyFrames),
+                math_max(expectedLastFrame, lastFrame) + 1 - m_historyFrames);
+        VERIFY_OR_DEBUG_ASSERT(framesToRead > 0) {
+            break;
+        }
+        SINT framesRead = getOutputSignal().samples2frames(
+                m_pReadAheadManager->getNextSamples(rate,
+                        m_readBuffer.data(),
+                        getOutputSignal().frames2samples(framesToRead)));
+        if (framesRead == 0) {
+            // Note we may get 0 samples once if we just hit a loop trigger,
+            // e.g. when reloop_toggle jumps back to loop_in, or when
+            // moving a loop causes the play position to be moved along.
+            if (++readFailedCount <= 1) {
+                continue;
+            }
+            SampleUtil::clear(m_readBuffer.data(),
+                    getOutputSignal().frames2samples(framesToRead));
+            framesRead = framesToRead;
+        }
+        SampleUtil::deinterleaveBuffer(m_historyLeft.data(m_historyFrames),
+                m_historyRight.data(m_historyFrames),
+                m_readBuffer.data(),
+                framesRead);
+        m_historyFrames += framesRead;
+    }
+}
+
+double EngineBufferScaleSinc::reverseDirection(double newRate) {
+    // The frames after the current position have been read from the RAMAN
+    // but not played yet. Read them again in the new direction, so that the
+    // RAMAN continues right before the current position. In the new
+    // direction they are the history of the filter.
+    const SINT index = static_cast<SINT>(m_position);
+    const double fraction = m_position - index;
+    const SINT lookaheadFrames = math_max<SINT>(m_historyFrames - index - 1, 0);
+
+    SINT framesToRewind = lookaheadFrames;
+    int readFailedCount = 0;
+    while (framesToRewind > 0) {
+        const SINT framesRead = getOutputSignal().samples2frames(
+                m_pReadAheadManager->getNextSamples(newRate,
+                        m_readBuffer.data(),
+                        getOutputSignal().frames2samples(
+                                math_min(framesToRewind, kReadFrames))));
+        if (framesRead == 0 && ++readFailedCount > 1) {
+            break;
+        }
+        framesToRewind -= framesRead;
+    }
+
+    const SINT paddingFrames = math_max<SINT>(kMaxHalfTaps - lookaheadFrames, 0);
+    for (auto* pHistory : {&m_historyLeft, &m_historyRight}) {
+        CSAMPLE* pFrames = pHistory->data();
+        std::memmove(pFrames + paddingFrames,
+                pFrames + index + 1,
+                lookaheadFrames * sizeof(CSAMPLE));
+        std::reverse(pFrames + paddingFrames, pFrames + paddingFrames + lookaheadFrames);
+        SampleUtil::clear(pFrames, paddingFrames);
+    }
+    m_historyFrames = paddingFrames + lookaheadFrames;
+    m_position = m_historyFrames - fraction;
+
+    // The play position follows the read log of the RAMAN: first to the end
+    // of the frames that have been read ahead and back again.
+    return 2 * (lookaheadFrames + 1 - fraction);
+}
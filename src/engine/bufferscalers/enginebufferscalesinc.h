@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+
+#include "engine/bufferscalers/enginebufferscale.h"
+#include "util/samplebuffer.h"
+
+class ReadAheadManager;
+
+/// Varispeed scaler like EngineBufferScaleLinear, i.e. the pitch follows the
+/// tempo, that resamples with a windowed-sinc polyphase filter instead of
+/// linear interpolation. This avoids the aliasing of linear interpolation
+/// when the rate is changed, at a fraction of the CPU load of SoundTouch or
+/// RubberBand.
+///
+/// The filter coefficients are precomputed for a set of cutoff frequencies,
+/// so the anti-aliasing filter follows the rate when playing faster than
+/// the original speed. The coefficients between two of the tabulated phases
+/// are interpolated linearly.
+class EngineBufferScaleSinc : public EngineBufferScale {
+    Q_OBJECT
+  public:
+    enum class Quality {
+        Short,  // 16 taps
+        Medium, // 32 taps
+        Long,   // 64 taps
+    };
+
+    explicit EngineBufferScaleSinc(
+            ReadAheadManager* pReadAheadManager,
+            Quality quality = Quality::Medium);
+    ~EngineBufferScaleSinc() override;
+
+    /// Thread-safe, the new filter is used from the next scaleBuffer() call.
+    /// The coefficients are calculated on the first use of a quality, so
+    /// this must not be called from the engine thread.
+    void setQuality(Quality quality);
+    Quality quality() const {
+        return m_quality.load(std::memory_order_relaxed);
+    }
+
+    double scaleBuffer(
+            CSAMPLE* pOutputBuffer,
+            SINT iOutputBufferSize) override;
+    void clear() override;
+
+    void setScaleParameters(double base_rate,
+            double* pTempoRatio,
+            double* pPitchRatio) override;
+
+  private:
+    class FilterBank;
+    static const FilterBank* filterBankForQuality(Quality quality);
+
+    void onSampleRateChanged() override {
+    }
+
+    // Scales with a rate that is linearly ramped from rateFrom to rateTo.
+    // Both rates must have the same sign or be zero.
+    double scale(CSAMPLE* pOutput, SINT numFrames, double rateFrom, double rateTo);
+    // Copies the input if the rate is 1.0 and the position is an integer
+    double copy(CSAMPLE* pOutput, SINT numFrames, double rate);
+    // Drops the frames that are no longer needed from the history and
+    // returns their number
+    SINT dropHistory();
+    // Reads the frames up to lastFrame into the history. Reads ahead up
+    // to expectedLastFrame if possible to save calls to the RAMAN.
+    void fillHistory(SINT lastFrame, SINT expectedLastFrame, double rate);
+    // Reads back the frames after the current position in the new direction,
+    // so that the RAMAN continues at the current position. Returns the number
+    // of frames that need to be reported as consumed for this.
+    double reverseDirection(double newRate);
+
+    void resetHistory();
+
+    // The read-ahead manager that we use to fetch samples
+    ReadAheadManager* m_pReadAheadManager;
+
+    std::atomic<Quality> m_quality;
+    std::atomic<const FilterBank*> m_pRequestedFilterBank;
+    const FilterBank* m_pFilterBank;
+
+    // Interleaved buffer for the calls to ReadAheadManager
+    mixxx::SampleBuffer m_readBuffer;
+    // The deinterleaved input around the current position
+    mixxx::SampleBuffer m_historyLeft;
+    mixxx::SampleBuffer m_historyRight;
+    SINT m_historyFrames;
+    // The position of the next output frame in m_history
+    double m_position;
+
+    bool m_bClear;
+    double m_dRate;
+    double m_dOldRate;
+};
@@ -0,0 +1,95 @@
+#include "engine/bufferscalers/rubberbandbatch.h"
+
+#include <algorithm>
+
+#include "engine/bufferscalers/rubberbandtask.h"
+#include "engine/realtimeworkerpool.h"
+#include "util/assert.h"
+#include "util/counter.h"
+#include "util/performancetimer.h"
+#include "util/stat.h"
+#include "util/timer.h"
+
+RubberBandBatch::RubberBandBatch()
+        : m_enabled(false),
+          m_jobs{},
+          m_numJobs(0),
+          m_pCallbackTimer(nullptr),
+          m_deadlineNanos(0),
+          m_jobDoneNanos{},
+          m_missedDeadlines(0) {
+}
+
+bool RubberBandBatch::submit(RubberBandTask* pTask) {
+    DEBUG_ASSERT(pTask->isPending());
+    const int index = m_numJobs.fetch_add(1, std::memory_order_acq_rel);
+    if (index >= kMaxJobs) {
+        // Leave m_numJobs beyond kMaxJobs, it is reset by process()
+        Counter(QStringLiteral("RubberBandBatch overflow"))++;
+        return false;
+    }
+    m_jobs[index] = pTask;
+    return true;
+}
+
+void RubberBandBatch::process(RealtimeWorkerPool* pPool,
+        const PerformanceTimer& callbackTimer,
+        mixxx::Duration deadline) {
+    const int numJobs = this->numJobs();
+    if (numJobs == 0) {
+        return;
+    }
+    ScopedTimer t(QStringLiteral("RubberBandBatch::process"));
+
+    // Longest processing time first
+    std::sort(m_jobs.begin(),
+            m_jobs.begin() + numJobs,
+            [](const RubberBandTask* pLeft, const RubberBandTask* pRight) {
+                return pLeft->lastPendingDurationNanos() >
+                        pRight->lastPendingDurationNanos();
+            });
+
+    m_pCallbackTimer = &callbackTimer;
+    m_deadlineNanos = deadline.toIntegerNanos();
+    if (pPool && numJobs > 1) {
+        auto processJob = [this](int index) {
+            this->processJob(index);
+        };
+        pPool->parallelFor(numJobs, processJob);
+    } else {
+        for (int i = 0; i < numJobs; ++i) {
+            processJob(i);
+        }
+    }
+    m_pCallbackTimer = nullptr;
+
+    // Report from the engine thread only, the workers must not allocate the
+    // thread local pipes of the StatsManager.
+    int missedDeadlines = 0;
+    for (int i = 0; i < numJobs; ++i) {
+        Stat::track(QStringLiteral("RubberBandBatch job duration"),
+                Stat::DURATION_NANOSEC,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE |
+                        Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
+                static_cast<double>(m_jobs[i]->lastPendingDurationNanos()));
+        Stat::track(QStringLiteral("RubberBandBatch job slack"),
+                Stat::DURATION_NANOSEC,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE |
+                        Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
+                static_cast<double>(m_deadlineNanos - m_jobDoneNanos[i]));
+        if (m_jobDoneNanos[i] > m_deadlineNanos) {
+            ++missedDeadlines;
+        }
+    }
+    if (missedDeadlines > 0) {
+        m_missedDeadlines.fetch_add(missedDeadlines, std::memory_order_relaxed);
+        Counter(QStringLiteral("RubberBandBatch missed deadlines")) += missedDeadlines;
+    }
+
+    m_numJobs.store(0, std::memory_order_release);
+}
+
+void RubberBandBatch::processJob(int index) {
+    m_jobs[index]->runPending();
+    m_jobDoneNanos[index] = m_pCallbackTimer->elapsed().toIntegerNanos();
+}
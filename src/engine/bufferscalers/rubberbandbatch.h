@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "util/duration.h"
+
+class PerformanceTimer;
+class RealtimeWorkerPool;
+class RubberBandTask;
+
+/// Collects the time stretching jobs of all keylocked decks during an engine
+/// callback, so that EngineMixer can process them together once all channels
+/// have been processed, instead of one deck after the other while processing
+/// each channel.
+///
+/// The scalers submit the input for the next callback and retrieve the output
+/// of the jobs that were processed in the previous callback, see
+/// EngineBufferScaleRubberBand::setBatch(). This adds the duration of one
+/// callback to the latency of the keylocked decks.
+class RubberBandBatch {
+  public:
+    static constexpr int kMaxJobs = 64;
+
+    RubberBandBatch();
+
+    /// Thread-safe, the scalers pick up the change with their next
+    /// scaleBuffer() call.
+    void setEnabled(bool enabled) {
+        m_enabled.store(enabled, std::memory_order_relaxed);
+    }
+    bool isEnabled() const {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /// Queues the pending input of pTask. Lock-free, so channels that are
+    /// processed in parallel can submit concurrently. Returns false if the
+    /// batch is full, the caller needs to process the input itself then.
+    bool submit(RubberBandTask* pTask);
+
+    int numJobs() const {
+        return std::min(m_numJobs.load(std::memory_order_acquire), kMaxJobs);
+    }
+
+    /// Processes all queued jobs on pPool and the calling thread, or only on
+    /// the calling thread if pPool is null, and returns when all of them are
+    /// done. The jobs that are expected to take longest, judging by the
+    /// previous job of the same task, are started first and each thread picks
+    /// the next job as soon as it is done with the last one, so no thread is
+    /// left with a long job at the end while the others are idle.
+    ///
+    /// A job that is not done after deadline, measured by callbackTimer, is
+    /// counted as a missed deadline. Must be called from the engine thread
+    /// while no jobs are submitted.
+    void process(RealtimeWorkerPool* pPool,
+            const PerformanceTimer& callbackTimer,
+            mixxx::Duration deadline);
+
+    /// The number of jobs that missed their deadline since the last call.
+    int takeMissedDeadlines() {
+        return m_missedDeadlines.exchange(0, std::memory_order_relaxed);
+    }
+
+  private:
+    void processJob(int index);
+
+    std::atomic<bool> m_enabled;
+
+    std::array<RubberBandTask*, kMaxJobs> m_jobs;
+    std::atomic<int> m_numJobs;
+
+    // Only valid during process()
+    const PerformanceTimer* m_pCallbackTimer;
+    qint64 m_deadlineNanos;
+    std::array<qint64, kMaxJobs> m_jobDoneNanos;
+
+    std::atomic<int> m_missedDeadlines;
+};
@@ -3,6 +3,7 @@
 #include "engine/engine.h"
 #include "util/assert.h"
 #include "util/compatibility/qmutex.h"
+#include "util/performancetimer.h"
 
 RubberBandTask::RubberBandTask(
         size_t sampleRate, size_t channels, Options options)
@@ -11,7 +12,9 @@ RubberBandTask::RubberBandTask(
           m_completedSema(0),
           m_input(nullptr),
           m_samples(0),
-          m_isFinal(false) {
+          m_isFinal(false),
+          m_pending(false),
+          m_lastPendingDurationNanos(0) {
     setAutoDelete(false);
 }
 
@@ -40,3 +43,19 @@ void RubberBandTask::run() {
             m_isFinal);
     m_completedSema.release();
 }
+
+bool RubberBandTask::runPending() {
+    if (!m_pending.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_input && m_samples) {
+        return false;
+    };
+    PerformanceTimer timer;
+    timer.start();
+    process(m_input,
+            m_samples,
+            m_isFinal);
+    m_lastPendingDurationNanos = timer.elapsed().toIntegerNanos();
+    return true;
+}
@@ -31,6 +31,28 @@ class RubberBandTask : public RubberBandStretcher, public QRunnable {
 
     void run();
 
+    /// Defers the processing of the input of the last set() call, e.g. to a
+    /// RubberBandBatch, until runPending() is called.
+    void setPending() {
+        m_pending.store(true, std::memory_order_release);
+    }
+    bool isPending() const {
+        return m_pending.load(std::memory_order_acquire);
+    }
+    /// Processes the deferred input, if any. Returns false if there was
+    /// nothing to process.
+    bool runPending();
+    /// Drops the deferred input without processing it.
+    void discardPending() {
+        m_pending.store(false, std::memory_order_release);
+    }
+
+    /// The processing time of the last runPending() call, used to estimate
+    /// the duration of the next one.
+    qint64 lastPendingDurationNanos() const {
+        return m_lastPendingDurationNanos;
+    }
+
   private:
     // Whether or not the scheduled job as completed
     QSemaphore m_completedSema;
@@ -38,4 +60,7 @@ class RubberBandTask : public RubberBandStretcher, public QRunnable {
     const float* const* m_input;
     size_t m_samples;
     bool m_isFinal;
+
+    std::atomic<bool> m_pending;
+    qint64 m_lastPendingDurationNanos;
 };
@@ -1,8 +1,11 @@
 #include "engine/bufferscalers/rubberbandwrapper.h"
 
+#include "engine/bufferscalers/rubberbandbatch.h"
 #include "engine/bufferscalers/rubberbandworkerpool.h"
 #include "engine/engine.h"
 #include "util/assert.h"
+#include "util/counter.h"
+#include "util/realtimesafety.h"
 #include "util/sample.h"
 
 using RubberBand::RubberBandStretcher;
@@ -28,11 +31,13 @@ int RubberBandWrapper::getEngineVersion() const {
 #endif
 }
 void RubberBandWrapper::setTimeRatio(double ratio) {
+    runPending();
     for (auto& stretcher : m_pInstances) {
         stretcher->setTimeRatio(ratio);
     }
 }
 size_t RubberBandWrapper::getSamplesRequired() const {
+    runPending();
     size_t require = 0;
     for (const auto& stretcher : m_pInstances) {
         require = qMax(require, stretcher->getSamplesRequired());
@@ -40,6 +45,7 @@ size_t RubberBandWrapper::getSamplesRequired() const {
     return require;
 }
 int RubberBandWrapper::available() const {
+    runPending();
     int available = std::numeric_limits<int>::max();
     for (const auto& stretcher : m_pInstances) {
         available = qMin(available, stretcher->available());
@@ -127,29 +133,60 @@ size_t RubberBandWrapper::getStartDelay() const {
 #endif
 }
 void RubberBandWrapper::process(const float* const* input, size_t samples, bool isFinal) {
+    runPending();
     if (m_pInstances.size() == 1) {
         return m_pInstances[0]->process(input, samples, isFinal);
     } else {
         RubberBandWorkerPool* pPool = RubberBandWorkerPool::instance();
+        bool startedWorkers = false;
         for (auto& pInstance : m_pInstances) {
             pInstance->set(input, samples, isFinal);
             // We try to get the stretching job ran by the RBPool if there is a
             // worker slot available
-            if (!pPool->tryStart(pInstance.get())) {
+            if (pPool->tryStart(pInstance.get())) {
+                startedWorkers = true;
+            } else {
                 // Otherwise, it means the main thread should take care of the stretching
                 pInstance->run();
             }
             input += pPool->channelPerWorker();
         }
+        if (startedWorkers) {
+            // Joining the workers blocks the audio callback. This is a
+            // known realtime safety violation that is counted separately
+            // from the waits it consists of.
+            Counter(QStringLiteral("RubberBandWrapper: joined workers in the audio callback"))++;
+            RealtimeSafety::checkCall("RubberBandWrapper joining workers");
+        }
         // We always perform a wait, even for task that were ran in the main
-        // thread, so it resets the semaphore
+        // thread, so it resets the semaphore.
         for (auto& pInstance : m_pInstances) {
             pInstance->waitReady();
         }
     }
 }
+void RubberBandWrapper::submit(const float* const* input,
+        size_t samples,
+        RubberBandBatch* pBatch) {
+    runPending();
+    for (auto& pInstance : m_pInstances) {
+        pInstance->set(input, samples, false);
+        pInstance->setPending();
+        if (!pBatch->submit(pInstance.get())) {
+            pInstance->runPending();
+        }
+        input += pInstance->getChannelCount();
+    }
+}
+void RubberBandWrapper::runPending() const {
+    for (const auto& pInstance : m_pInstances) {
+        pInstance->runPending();
+    }
+}
 void RubberBandWrapper::reset() {
     for (auto& stretcher : m_pInstances) {
+        // The queued input belongs to the signal before the reset
+        stretcher->discardPending();
         stretcher->reset();
     }
 }
@@ -185,6 +222,7 @@ void RubberBandWrapper::setup(mixxx::audio::SampleRate sampleRate,
     }
 }
 void RubberBandWrapper::setPitchScale(double scale) {
+    runPending();
     for (auto& stretcher : m_pInstances) {
         stretcher->setPitchScale(scale);
     }
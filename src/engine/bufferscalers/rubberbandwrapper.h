@@ -3,6 +3,8 @@
 #include "audio/types.h"
 #include "engine/bufferscalers/rubberbandtask.h"
 
+class RubberBandBatch;
+
 /// RubberBandWrapper is a wrapper around RubberBand::RubberBandStretcher which
 /// allows to distribute signal stretching over multiple instance, but interface
 /// with it like if it was a single instance
@@ -19,6 +21,12 @@ class RubberBandWrapper {
     size_t getPreferredStartPad() const;
     size_t getStartDelay() const;
     void process(const float* const* input, size_t samples, bool final);
+    /// Like process(), but the input is only queued in pBatch and processed
+    /// when the batch is processed. The input must remain valid until then.
+    /// All other calls that depend on the processed input, like available()
+    /// and retrieve(), process the queued input first if the batch has not
+    /// been processed yet.
+    void submit(const float* const* input, size_t samples, RubberBandBatch* pBatch);
     void setPitchScale(double scale);
     void reset();
 
@@ -30,6 +38,8 @@ class RubberBandWrapper {
     bool isValid() const;
 
   private:
+    void runPending() const;
+
     // copy constructor of RubberBand::RubberBandStretcher is implicitly deleted.
     std::vector<std::unique_ptr<RubberBandTask>> m_pInstances;
 };
@@ -1,11 +1,14 @@
 #include "engine/cachingreader/cachingreader.h"
 
 #include <QtDebug>
+#include <algorithm>
 
+#include "control/controlobject.h"
+#include "control/controlpushbutton.h"
+#include "engine/cachingreader/cachingreaderworkerpool.h"
 #include "moc_cachingreader.cpp"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
-#include "util/counter.h"
 #include "util/logger.h"
 #include "util/sample.h"
 
@@ -30,16 +33,133 @@ constexpr SINT kDefaultHintFrames = 1024;
 // the total amount!
 //
 // NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
+// ([CachingReader],deck_chunks = 1, 2, 3, ...) for testing purposes
 // to verify that the MRU/LRU cache works as expected. Even though
 // massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+constexpr int kDefaultNumberOfCachedChunksInMemory = 80;
+
+// Adaptive mode: Upper limits for a single reader (40 MB) and for all
+// readers together (512 MB).
+constexpr int kDefaultMaxChunks = 640;
+constexpr int kDefaultMaxTotalChunks = 8192;
+
+// Adaptive mode: The cache grows by kGrowthChunks if at least
+// kGrowthMissThreshold hinted chunks required to evict another chunk
+// within kGrowthWindowHints calls of hintAndMaybeWake(). During normal
+// playback a new chunk is needed only every 10 to 20 callbacks, so this
+// only triggers when many hinted positions compete for too few chunks.
+constexpr SINT kGrowthChunks = 16;
+constexpr int kGrowthWindowHints = 128;
+constexpr int kGrowthMissThreshold = 32;
+
+// Tracks exceeding this size are not loaded into RAM. 1 GB corresponds to
+// roughly 50 minutes of stereo audio at 44.1 kHz.
+constexpr int kDefaultMaxRamTrackMegabytes = 1024;
+
+// The number of threads of the decoding pool shared by all readers. 0 runs
+// a dedicated thread per reader. By default the pool is sized from the
+// number of cores, but does not grow beyond kMaxDefaultDecodeThreads,
+// because most of the time the readers are idle.
+constexpr int kDecodeThreadsAuto = -1;
+constexpr int kMaxDefaultDecodeThreads = 4;
+
+const QString kConfigGroup = QStringLiteral("[CachingReader]");
+
+SINT configuredChunks(const UserSettingsPointer& pConfig,
+        CachingReader::PlayerType playerType) {
+    if (!pConfig) {
+        return kDefaultNumberOfCachedChunksInMemory;
+    }
+    QString key;
+    switch (playerType) {
+    case CachingReader::PlayerType::Sampler:
+        key = QStringLiteral("sampler_chunks");
+        break;
+    case CachingReader::PlayerType::PreviewDeck:
+        key = QStringLiteral("preview_chunks");
+        break;
+    case CachingReader::PlayerType::Deck:
+        key = QStringLiteral("deck_chunks");
+        break;
+    }
+    return std::max(1,
+            pConfig->getValue(ConfigKey(kConfigGroup, key),
+                    kDefaultNumberOfCachedChunksInMemory));
+}
+
+bool configuredAdaptive(const UserSettingsPointer& pConfig) {
+    return pConfig &&
+            pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("adaptive")),
+                    false);
+}
+
+SINT configuredMaxChunks(const UserSettingsPointer& pConfig, SINT initialChunks) {
+    if (!configuredAdaptive(pConfig)) {
+        return initialChunks;
+    }
+    return std::max<SINT>(initialChunks,
+            pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("max_chunks")),
+                    kDefaultMaxChunks));
+}
+
+bool configuredLoadIntoRam(const UserSettingsPointer& pConfig,
+        CachingReader::PlayerType playerType) {
+    // Only decks are loaded into RAM by default. The other players need to
+    // enable it explicitly with the [Group],load_into_ram control.
+    return pConfig && playerType == CachingReader::PlayerType::Deck &&
+            pConfig->getValue(ConfigKey(kConfigGroup, QStringLiteral("load_into_ram")),
+                    false);
+}
+
+SINT configuredMaxTrackBufferSamples(const UserSettingsPointer& pConfig) {
+    const SINT megabytes = pConfig
+            ? pConfig->getValue(
+                      ConfigKey(kConfigGroup, QStringLiteral("max_ram_track_mb")),
+                      kDefaultMaxRamTrackMegabytes)
+            : kDefaultMaxRamTrackMegabytes;
+    return megabytes * 1024 * 1024 / static_cast<SINT>(sizeof(CSAMPLE));
+}
+
+int configuredDecodeThreads(const UserSettingsPointer& pConfig) {
+    const int decodeThreads = pConfig
+            ? pConfig->getValue(
+                      ConfigKey(kConfigGroup, QStringLiteral("decode_threads")),
+                      kDecodeThreadsAuto)
+            : kDecodeThreadsAuto;
+    if (decodeThreads >= 0) {
+        return decodeThreads;
+    }
+    return std::clamp(QThread::idealThreadCount() / 2, 1, kMaxDefaultDecodeThreads);
+}
+
+void setIfChanged(ControlObject* pControl, double value) {
+    if (pControl->get() != value) {
+        pControl->set(value);
+    }
+}
+
+SINT configuredMaxTotalChunks(const UserSettingsPointer& pConfig) {
+    if (!pConfig) {
+        return kDefaultMaxTotalChunks;
+    }
+    return pConfig->getValue(
+            ConfigKey(kConfigGroup, QStringLiteral("max_total_chunks")),
+            kDefaultMaxTotalChunks);
+}
 
 } // anonymous namespace
 
+// static
+std::atomic<SINT> CachingReader::s_totalChunks(0);
+
 CachingReader::CachingReader(const QString& group,
-        UserSettingsPointer config)
+        UserSettingsPointer config,
+        PlayerType playerType)
         : m_pConfig(config),
+          m_initialChunks(configuredChunks(config, playerType)),
+          m_maxChunks(configuredMaxChunks(config, m_initialChunks)),
+          m_maxTotalChunks(configuredMaxTotalChunks(config)),
+          m_adaptive(m_maxChunks > m_initialChunks),
           // Limit the number of in-flight requests to the worker. This should
           // prevent to overload the worker when it is not able to fetch those
           // requests from the FIFO timely. Otherwise outdated requests pile up
@@ -49,29 +169,91 @@ CachingReader::CachingReader(const QString& group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
+          m_chunkReadRequestFIFO(std::max<SINT>(m_initialChunks / 4, 1)),
           // The capacity of the back channel must be equal to the number of
           // allocated chunks, because the worker use writeBlocking(). Otherwise
           // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_readerStatusUpdateFIFO(m_maxChunks),
+          // At most a single slab is requested at a time
+          m_chunkSlabFIFO(1),
+          // The reader releases at most one whole-track buffer per status
+          // update, and the worker empties this FIFO before each task. So
+          // between two tasks the reader releases at most the buffers of
+          // all updates that fit into m_readerStatusUpdateFIFO, those of
+          // the task that has just finished and its current buffer. Even
+          // a fast series of track loads can't overflow this FIFO, which
+          // would leak the buffer.
+          m_trackBufferReleaseFIFO(m_maxChunks + 2),
+          // Same as for the whole-track buffers
+          m_chunkTableReleaseFIFO(m_maxChunks + 2),
           m_state(STATE_IDLE),
+          m_reservedChunks(m_initialChunks),
+          m_chunkSlabPending(false),
+          m_growthWindowHints(0),
+          m_growthWindowMisses(0),
+          m_readHits(0),
+          m_readMisses(0),
+          m_lateReads(0),
+          m_pChunkCount(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cache_chunk_count")))),
+          m_pReadHits(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cache_read_hits")))),
+          m_pReadMisses(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cache_read_misses")))),
+          m_pHitRate(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cache_hit_rate")))),
+          m_pLateReads(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cache_late_reads")))),
+          m_pParallelReads(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cache_parallel_reads")))),
+          m_pLoadIntoRam(std::make_unique<ControlPushButton>(
+                  ConfigKey(group, QStringLiteral("load_into_ram")))),
+          m_pRamBufferProgress(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("ram_buffer_progress")))),
+          m_pRamBuffered(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("ram_buffered")))),
+          m_pFreeChunks(nullptr),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
-          m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kSamples * i,
-                                CachingReaderChunk::kSamples));
-        m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
+          m_worker(group,
+                  &m_chunkReadRequestFIFO,
+                  &m_readerStatusUpdateFIFO,
+                  &m_chunkSlabFIFO,
+                  &m_trackBufferReleaseFIFO,
+                  &m_chunkTableReleaseFIFO) {
+    m_pChunkCount->setReadOnly();
+    m_pReadHits->setReadOnly();
+    m_pReadMisses->setReadOnly();
+    m_pHitRate->setReadOnly();
+    m_pLateReads->setReadOnly();
+    m_pParallelReads->setReadOnly();
+    m_pRamBufferProgress->setReadOnly();
+    m_pRamBuffered->setReadOnly();
+
+    m_pLoadIntoRam->setButtonMode(ControlPushButton::TOGGLE);
+    m_pLoadIntoRam->set(configuredLoadIntoRam(config, playerType) ? 1.0 : 0.0);
+    m_worker.setLoadIntoRam(m_pLoadIntoRam->toBool());
+    m_worker.setMaxTrackBufferSamples(configuredMaxTrackBufferSamples(config));
+    connect(m_pLoadIntoRam.get(),
+            &ControlObject::valueChanged,
+            this,
+            [this](double value) {
+                m_worker.setLoadIntoRam(value > 0);
+                m_worker.workReady();
+            });
+
+    s_totalChunks.fetch_add(m_initialChunks);
+    // Reserve all containers for the maximum number of chunks, so growing
+    // the cache in the engine thread does not allocate memory.
+    m_chunkSlabs.reserve(
+            1 + (m_maxChunks - m_initialChunks + kGrowthChunks - 1) / kGrowthChunks);
+    m_chunks.reserve(m_maxChunks);
+    addChunkSlab(std::make_unique<CachingReaderChunkSlab>(m_initialChunks));
+    if (m_adaptive) {
+        kLogger.debug()
+                << group
+                << "Adaptive cache with" << m_initialChunks
+                << "to" << m_maxChunks << "chunks";
     }
 
     // Forward signals from worker
@@ -85,12 +267,113 @@ CachingReader::CachingReader(const QString& group,
             this, &CachingReader::trackLoadFailed,
             Qt::DirectConnection);
 
-    m_worker.start(QThread::HighPriority);
+    const int decodeThreads = configuredDecodeThreads(config);
+    if (decodeThreads > 0) {
+        m_worker.startOnPool(CachingReaderWorkerPool::shared(decodeThreads));
+    } else {
+        m_worker.start(QThread::HighPriority);
+    }
 }
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
-    qDeleteAll(m_chunks);
+    // Delete a slab that has been allocated, but not received
+    CachingReaderChunkSlab* pSlab;
+    while (m_chunkSlabFIFO.read(&pSlab, 1) == 1) {
+        delete pSlab;
+    }
+    s_totalChunks.fetch_sub(m_reservedChunks);
+    // Delete all whole-track buffers and chunk tables that are still in transit
+    ReaderStatusUpdate update;
+    while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
+        delete update.takeTrackBuffer();
+        delete update.takeChunkTable();
+    }
+    CachingReaderTrackBuffer* pTrackBuffer;
+    while (m_trackBufferReleaseFIFO.read(&pTrackBuffer, 1) == 1) {
+        delete pTrackBuffer;
+    }
+    CachingReaderChunkTable* pChunkTable;
+    while (m_chunkTableReleaseFIFO.read(&pChunkTable, 1) == 1) {
+        delete pChunkTable;
+    }
+}
+
+void CachingReader::releaseTrackBuffer(CachingReaderTrackBuffer* pTrackBuffer) {
+    if (!pTrackBuffer) {
+        return;
+    }
+    // Memory must not be freed in the engine thread, so the worker
+    // deletes the buffer.
+    VERIFY_OR_DEBUG_ASSERT(m_trackBufferReleaseFIFO.write(&pTrackBuffer, 1) == 1) {
+        kLogger.warning() << "Failed to release whole-track buffer";
+        return;
+    }
+    m_worker.workReady();
+}
+
+void CachingReader::releaseChunkTable(CachingReaderChunkTable* pChunkTable) {
+    if (!pChunkTable) {
+        return;
+    }
+    VERIFY_OR_DEBUG_ASSERT(m_chunkTableReleaseFIFO.write(&pChunkTable, 1) == 1) {
+        kLogger.warning() << "Failed to release chunk table";
+        return;
+    }
+    m_worker.workReady();
+}
+
+void CachingReader::addChunkSlab(std::unique_ptr<CachingReaderChunkSlab> pSlab) {
+    DEBUG_ASSERT(m_chunkSlabs.size() < m_chunkSlabs.capacity());
+    DEBUG_ASSERT(m_chunks.size() + pSlab->size() <= m_maxChunks);
+    // The chunks are linked into the intrusive free list and m_chunks has
+    // been reserved for m_maxChunks, so nothing is allocated here.
+    DEBUG_ASSERT(m_chunks.size() + pSlab->size() <= m_chunks.capacity());
+    for (SINT i = 0; i < pSlab->size(); ++i) {
+        CachingReaderChunkForOwner* c = pSlab->chunk(i);
+        m_chunks.push_back(c);
+        c->pushOntoFreeList(&m_pFreeChunks);
+    }
+    m_chunkSlabs.push_back(std::move(pSlab));
+    m_chunkSlabPending = false;
+    m_pChunkCount->set(m_chunks.size());
+}
+
+void CachingReader::maybeGrow(int evictingMisses) {
+    m_growthWindowMisses += evictingMisses;
+    if (++m_growthWindowHints < kGrowthWindowHints) {
+        return;
+    }
+    const bool shouldGrow = m_growthWindowMisses >= kGrowthMissThreshold;
+    m_growthWindowHints = 0;
+    m_growthWindowMisses = 0;
+    if (!shouldGrow || m_chunkSlabPending) {
+        return;
+    }
+    const SINT numChunks = std::min(kGrowthChunks, m_maxChunks - m_reservedChunks);
+    if (numChunks <= 0) {
+        return;
+    }
+    // Reserve the chunks from the budget shared by all readers
+    if (s_totalChunks.fetch_add(numChunks) + numChunks > m_maxTotalChunks) {
+        s_totalChunks.fetch_sub(numChunks);
+        return;
+    }
+    m_reservedChunks += numChunks;
+    m_chunkSlabPending = true;
+    m_worker.requestChunkSlab(numChunks);
+}
+
+void CachingReader::updateMetrics() {
+    setIfChanged(m_pReadHits.get(), static_cast<double>(m_readHits));
+    setIfChanged(m_pReadMisses.get(), static_cast<double>(m_readMisses));
+    const quint64 lookups = m_readHits + m_readMisses;
+    setIfChanged(m_pHitRate.get(),
+            lookups > 0 ? static_cast<double>(m_readHits) / lookups : 0.0);
+    setIfChanged(m_pLateReads.get(), static_cast<double>(m_lateReads));
+    setIfChanged(m_pParallelReads.get(), static_cast<double>(m_worker.parallelReads()));
+    setIfChanged(m_pRamBufferProgress.get(), m_worker.trackBufferProgress());
+    setIfChanged(m_pRamBuffered.get(), m_pTrackBuffer ? 1.0 : 0.0);
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
@@ -98,50 +381,60 @@ void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
     pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    pChunk->pushOntoFreeList(&m_pFreeChunks);
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
     DEBUG_ASSERT(pChunk);
     DEBUG_ASSERT(pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING);
 
-    const int removed = m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
-    Q_UNUSED(removed); // only used in DEBUG_ASSERT
-    // We'll tolerate not being in allocatedCachingReaderChunks,
-    // because sometime you free a chunk right after you allocated it.
-    DEBUG_ASSERT(removed <= 1);
+    // We'll tolerate not being in the chunk table, because sometimes
+    // you free a chunk right after you allocated it or the table has
+    // been replaced after loading a new track.
+    if (m_pChunkTable) {
+        m_pChunkTable->remove(pChunk->getIndex(), pChunk);
+    }
 
     freeChunkFromList(pChunk);
 }
 
 void CachingReader::freeAllChunks() {
     for (const auto& pChunk : std::as_const(m_chunks)) {
-        // We will receive CHUNK_READ_INVALID for all pending chunk reads
-        // which should free the chunks individually.
-        if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+        if (pChunk->getState() == CachingReaderChunkForOwner::FREE) {
             continue;
         }
-
-        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
+        // Only the allocated chunks need to be removed from the table,
+        // which is much cheaper than clearing the whole table.
+        if (m_pChunkTable) {
+            m_pChunkTable->remove(pChunk->getIndex(), pChunk);
+        }
+        // We will receive CHUNK_READ_INVALID for all pending chunk reads
+        // which should free the chunks individually.
+        if (pChunk->getState() != CachingReaderChunkForOwner::READ_PENDING) {
             freeChunkFromList(pChunk);
         }
     }
     DEBUG_ASSERT(!m_mruCachingReaderChunk);
     DEBUG_ASSERT(!m_lruCachingReaderChunk);
-
-    m_allocatedCachingReaderChunks.clear();
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
+    VERIFY_OR_DEBUG_ASSERT(m_pChunkTable) {
+        return nullptr;
+    }
+    CachingReaderChunkForOwner* pChunk =
+            CachingReaderChunkForOwner::popFromFreeList(&m_pFreeChunks);
+    if (!pChunk) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
 
     pChunk->init(chunkIndex);
 
-    m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
+    if (!m_pChunkTable->insert(chunkIndex, pChunk)) {
+        pChunk->free();
+        pChunk->pushOntoFreeList(&m_pFreeChunks);
+        return nullptr;
+    }
 
     return pChunk;
 }
@@ -163,8 +456,10 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
 }
 
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
-    // Defaults to nullptr if it's not in the hash.
-    auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
+    if (!m_pChunkTable) {
+        return nullptr;
+    }
+    auto* pChunk = m_pChunkTable->lookup(chunkIndex);
     DEBUG_ASSERT(!pChunk || pChunk->getIndex() == chunkIndex);
     return pChunk;
 }
@@ -220,6 +515,11 @@ void CachingReader::newTrack(TrackPointer pTrack) {
 
 // Called from the engine thread
 void CachingReader::process() {
+    CachingReaderChunkSlab* pSlab;
+    while (m_chunkSlabFIFO.read(&pSlab, 1) == 1) {
+        addChunkSlab(std::unique_ptr<CachingReaderChunkSlab>(pSlab));
+    }
+
     ReaderStatusUpdate update;
     while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
         auto* pChunk = update.takeFromWorker();
@@ -252,8 +552,22 @@ void CachingReader::process() {
                         m_readableFrameIndexRange,
                         update.readableFrameIndexRange());
             }
+        } else if (update.status == TRACK_BUFFERED) {
+            // The whole track has been decoded into RAM
+            CachingReaderTrackBuffer* pTrackBuffer = update.takeTrackBuffer();
+            if (m_state.loadAcquire() == STATE_TRACK_LOADED) {
+                releaseTrackBuffer(m_pTrackBuffer.release());
+                m_pTrackBuffer.reset(pTrackBuffer);
+                m_readableFrameIndexRange = intersect(
+                        m_readableFrameIndexRange,
+                        update.readableFrameIndexRange());
+            } else {
+                // Outdated buffer of the previous track
+                releaseTrackBuffer(pTrackBuffer);
+            }
         } else {
             // State update (without a chunk)
+            releaseTrackBuffer(m_pTrackBuffer.release());
             if (update.status == TRACK_LOADED) {
                 // We have a new Track ready to go.
                 // Assert that we either have had STATE_TRACK_LOADING before and all
@@ -269,8 +583,18 @@ void CachingReader::process() {
                     DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADING);
                     freeAllChunks();
                 }
+                // The worker only sends a new table if the current one
+                // is too small for the new track
+                CachingReaderChunkTable* pChunkTable = update.takeChunkTable();
+                if (pChunkTable) {
+                    releaseChunkTable(m_pChunkTable.release());
+                    m_pChunkTable.reset(pChunkTable);
+                }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_readHits = 0;
+                m_readMisses = 0;
+                m_lateReads = 0;
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
@@ -430,8 +754,31 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
-                if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                const CachingReaderChunkForOwner* const pChunk =
+                        m_pTrackBuffer ? nullptr : lookupChunkAndFreshen(chunkIndex);
+                if (m_pTrackBuffer) {
+                    // The whole track is in RAM, so this is always a cache hit.
+                    // Read the same range as from a chunk to keep the logic of
+                    // this loop.
+                    const auto chunkFrameIndexRange = intersect(
+                            remainingFrameIndexRange,
+                            mixxx::IndexRange::forward(
+                                    chunkIndex * CachingReaderChunk::kFrames,
+                                    CachingReaderChunk::kFrames));
+                    ++m_readHits;
+                    if (reverse) {
+                        bufferedFrameIndexRange =
+                                m_pTrackBuffer->readBufferedSampleFramesReverse(
+                                        &buffer[samplesRemaining],
+                                        chunkFrameIndexRange);
+                    } else {
+                        bufferedFrameIndexRange =
+                                m_pTrackBuffer->readBufferedSampleFrames(
+                                        buffer,
+                                        chunkFrameIndexRange);
+                    }
+                } else if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    ++m_readHits;
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -449,7 +796,12 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     // pending.
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
-                    Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    ++m_readMisses;
+                    if (pChunk) {
+                        // The chunk has been requested, but the worker did
+                        // not serve it in time
+                        ++m_lateReads;
+                    }
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -516,85 +868,112 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
 }
 
 void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
+    updateMetrics();
+
     // If no file is loaded, skip.
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
         return;
     }
 
+    // All chunks are available if the whole track has been loaded into RAM
+    if (m_pTrackBuffer) {
+        return;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
-
-    for (const auto& hint: hintList) {
-        SINT hintFrame = hint.frame;
-        SINT hintFrameCount = hint.frameCount;
-
-        // Handle some special length values
-        if (hintFrameCount == Hint::kFrameCountForward) {
-        	hintFrameCount = kDefaultHintFrames;
-        } else if (hintFrameCount == Hint::kFrameCountBackward) {
-        	hintFrame -= kDefaultHintFrames;
-        	hintFrameCount = kDefaultHintFrames;
-            if (hintFrame < 0) {
-            	hintFrameCount += hintFrame;
-                if (hintFrameCount <= 0) {
-                    continue;
+    int evictingMisses = 0;
+
+    // Submit the read requests in the order of their priority. Otherwise a
+    // burst of requests for cues could fill up the FIFO before the chunk
+    // at the playhead is requested.
+    for (int priority = 0;
+            priority < CachingReaderChunkReadRequest::kNumPriorities;
+            ++priority) {
+        const auto requestPriority =
+                static_cast<CachingReaderChunkReadRequest::Priority>(priority);
+        for (const auto& hint : hintList) {
+            if (Hint::priorityForType(hint.type) != requestPriority) {
+                continue;
+            }
+            SINT hintFrame = hint.frame;
+            SINT hintFrameCount = hint.frameCount;
+
+            // Handle some special length values
+            if (hintFrameCount == Hint::kFrameCountForward) {
+                hintFrameCount = kDefaultHintFrames;
+            } else if (hintFrameCount == Hint::kFrameCountBackward) {
+                hintFrame -= kDefaultHintFrames;
+                hintFrameCount = kDefaultHintFrames;
+                if (hintFrame < 0) {
+                    hintFrameCount += hintFrame;
+                    if (hintFrameCount <= 0) {
+                        continue;
+                    }
+                    hintFrame = 0;
                 }
-                hintFrame = 0;
             }
-        }
 
-        VERIFY_OR_DEBUG_ASSERT(hintFrameCount >= 0) {
-            kLogger.warning() << "CachingReader: Ignoring negative hint length.";
-            continue;
-        }
+            VERIFY_OR_DEBUG_ASSERT(hintFrameCount >= 0) {
+                kLogger.warning() << "CachingReader: Ignoring negative hint length.";
+                continue;
+            }
 
-        const auto readableFrameIndexRange = intersect(
-                m_readableFrameIndexRange,
-                mixxx::IndexRange::forward(hintFrame, hintFrameCount));
-        if (readableFrameIndexRange.empty()) {
-            continue;
-        }
+            const auto readableFrameIndexRange = intersect(
+                    m_readableFrameIndexRange,
+                    mixxx::IndexRange::forward(hintFrame, hintFrameCount));
+            if (readableFrameIndexRange.empty()) {
+                continue;
+            }
 
-        const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
-        const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
-        for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
-            CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
-            if (!pChunk) {
-                shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
+            const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
+            const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
+            for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+                CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
                 if (!pChunk) {
-                    kLogger.warning()
-                            << "Failed to allocate chunk"
-                            << chunkIndex
-                            << "for read request";
-                    continue;
-                }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                if (kLogger.traceEnabled()) {
-                    kLogger.trace()
-                            << "Requesting read of chunk"
-                            << request.chunk;
-                }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning()
-                            << "Failed to submit read request for chunk"
-                            << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
+                    shouldWake = true;
+                    if (!m_pFreeChunks) {
+                        ++evictingMisses;
+                    }
+                    pChunk = allocateChunkExpireLRU(chunkIndex);
+                    if (!pChunk) {
+                        kLogger.warning()
+                                << "Failed to allocate chunk"
+                                << chunkIndex
+                                << "for read request";
+                        continue;
+                    }
+                    // Do not insert the allocated chunk into the MRU/LRU list,
+                    // because it will be handed over to the worker immediately
+                    CachingReaderChunkReadRequest request;
+                    request.giveToWorker(pChunk, requestPriority);
+                    if (kLogger.traceEnabled()) {
+                        kLogger.trace()
+                                << "Requesting read of chunk"
+                                << request.chunk;
+                    }
+                    if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+                        kLogger.warning()
+                                << "Failed to submit read request for chunk"
+                                << chunkIndex;
+                        // Revoke the chunk from the worker and free it
+                        pChunk->takeFromWorker();
+                        freeChunk(pChunk);
+                    }
+                } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+                    // This will cause the chunk to be 'freshened' in the cache. The
+                    // chunk will be moved to the end of the LRU list.
+                    freshenChunk(pChunk);
                 }
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
-                // This will cause the chunk to be 'freshened' in the cache. The
-                // chunk will be moved to the end of the LRU list.
-                freshenChunk(pChunk);
             }
         }
     }
 
+    if (m_adaptive) {
+        maybeGrow(evictingMisses);
+    }
+
     // If there are chunks to be read, wake up.
     if (shouldWake) {
         m_worker.workReady();
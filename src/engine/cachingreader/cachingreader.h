@@ -1,11 +1,12 @@
 #pragma once
 
 #include <QAtomicInt>
-#include <QHash>
 #include <QList>
 #include <QVarLengthArray>
 #include <QVector>
-#include <list>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "preferences/usersettings.h"
@@ -13,31 +14,48 @@
 #include "util/fifo.h"
 #include "util/types.h"
 
+class ControlObject;
+class ControlPushButton;
+
 // A Hint is an indication to the CachingReader that a certain section of a
 // SoundSource will be used 'soon' and so it should be brought into memory by
 // the reader work thread.
 typedef struct Hint {
     enum class Type {
-        SlipPosition,     // prio 1 (so far unused Mixxx 2.3 priority for reference)
-        CurrentPosition,  // prio 1
-        LoopStartEnabled, // prio 2
-        MainCue,          // prio 10
-        HotCue,           // prio 10
-        LoopEndEnabled,   // prio 10
-        LoopStart,        // prio 10
-        FirstSound,
-        IntroStart,
-        IntroEnd,
-        OutroStart
+        SlipPosition,     // CachingReaderChunkReadRequest::Priority::Playhead
+        CurrentPosition,  // CachingReaderChunkReadRequest::Priority::Playhead
+        LoopStartEnabled, // CachingReaderChunkReadRequest::Priority::Loop
+        MainCue,          // CachingReaderChunkReadRequest::Priority::Cue
+        HotCue,           // CachingReaderChunkReadRequest::Priority::Cue
+        LoopEndEnabled,   // CachingReaderChunkReadRequest::Priority::Loop
+        LoopStart,        // CachingReaderChunkReadRequest::Priority::Loop
+        FirstSound,       // CachingReaderChunkReadRequest::Priority::Cue
+        IntroStart,       // CachingReaderChunkReadRequest::Priority::Cue
+        IntroEnd,         // CachingReaderChunkReadRequest::Priority::Cue
+        OutroStart        // CachingReaderChunkReadRequest::Priority::Cue
     };
 
+    static constexpr CachingReaderChunkReadRequest::Priority priorityForType(Type type) {
+        switch (type) {
+        case Type::SlipPosition:
+        case Type::CurrentPosition:
+            return CachingReaderChunkReadRequest::Priority::Playhead;
+        case Type::LoopStartEnabled:
+        case Type::LoopEndEnabled:
+        case Type::LoopStart:
+            return CachingReaderChunkReadRequest::Priority::Loop;
+        default:
+            return CachingReaderChunkReadRequest::Priority::Cue;
+        }
+    }
+
     // The frame to ensure is present in memory.
     SINT frame;
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others.
+    // Determines the order in which missing chunks are read by the worker,
+    // see priorityForType().
     Type type;
 
     // for the default frame count in forward direction
@@ -76,13 +94,43 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // least-recently-used list. When a chunk needs to be allocated and there are no
 // free chunks then the least recently used chunk is free'd (see
 // allocateChunkExpireLRU).
+//
+// The number of chunks is configured per deck type in the [CachingReader]
+// config group (deck_chunks, sampler_chunks, preview_chunks). In adaptive
+// mode the cache grows in steps of additional chunk slabs while the hints
+// repeatedly miss chunks that had to be evicted before, up to max_chunks per
+// reader and max_total_chunks for all readers together. The cache does not
+// shrink until the reader is destroyed.
+//
+// With [Group],load_into_ram enabled the worker additionally decodes the whole
+// track into a single buffer (see CachingReaderTrackBuffer). Once complete all
+// reads are served from this buffer and no more chunks are requested, i.e.
+// seeking and scratching never cause disk I/O. [Group],ram_buffer_progress
+// reports the decoding progress and [Group],ram_buffered is set once the
+// buffer is in use. The default for decks is configured with
+// [CachingReader],load_into_ram.
+//
+// The workers of all readers share a small pool of decoding threads (see
+// CachingReaderWorkerPool), configured by [CachingReader],decode_threads.
+// With decode_threads = 0 every reader runs its own worker thread. Idle pool
+// threads help decoding the requested chunks of a busy reader, which is
+// reported by [Group],cache_parallel_reads.
 class CachingReader : public QObject {
     Q_OBJECT
 
   public:
+    // The kind of player that owns the reader. It selects the configuration
+    // of the cache in the [CachingReader] config group.
+    enum class PlayerType {
+        Deck,
+        Sampler,
+        PreviewDeck,
+    };
+
     // Construct a CachingReader with the given group.
     CachingReader(const QString& group,
-            UserSettingsPointer _config);
+            UserSettingsPointer _config,
+            PlayerType playerType = PlayerType::Deck);
     ~CachingReader() override;
 
     void process();
@@ -128,10 +176,33 @@ class CachingReader : public QObject {
   private:
     const UserSettingsPointer m_pConfig;
 
+    // Capacity of the cache in chunks, resolved from the config
+    const SINT m_initialChunks;
+    const SINT m_maxChunks;
+    const SINT m_maxTotalChunks;
+    const bool m_adaptive;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate> m_readerStatusUpdateFIFO;
+    FIFO<CachingReaderChunkSlab*> m_chunkSlabFIFO;
+    FIFO<CachingReaderTrackBuffer*> m_trackBufferReleaseFIFO;
+    FIFO<CachingReaderChunkTable*> m_chunkTableReleaseFIFO;
+
+    // Hands the buffer back to the worker for deletion
+    void releaseTrackBuffer(CachingReaderTrackBuffer* pTrackBuffer);
+    // Hands the table back to the worker for deletion
+    void releaseChunkTable(CachingReaderChunkTable* pChunkTable);
+
+    // Takes ownership of the slab and adds its chunks to the free list.
+    void addChunkSlab(std::unique_ptr<CachingReaderChunkSlab> pSlab);
+
+    // Counts misses that required to evict a chunk and requests a new chunk
+    // slab from the worker if they pile up.
+    void maybeGrow(int evictingMisses);
+
+    void updateMetrics();
 
     // Looks for the provided chunk number in the index of in-memory chunks and
     // returns it if it is present. If not, returns nullptr. If it is present then
@@ -166,24 +237,54 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
+    // Owns the memory of all chunks. Reserved up front for the maximum
+    // number of slabs, so adding a slab does not allocate.
+    std::vector<std::unique_ptr<CachingReaderChunkSlab>> m_chunkSlabs;
+
     // Keeps track of all CachingReaderChunks we've allocated.
     QVector<CachingReaderChunkForOwner*> m_chunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // The number of chunks reserved from the global budget by this reader,
+    // including a pending slab that has not been received yet.
+    SINT m_reservedChunks;
+    bool m_chunkSlabPending;
+    int m_growthWindowHints;
+    int m_growthWindowMisses;
+
+    // Statistics of chunk lookups in read() since the last track has been loaded
+    quint64 m_readHits;
+    quint64 m_readMisses;
+    // Misses of chunks that have already been requested from the worker,
+    // i.e. the chunk at the playhead has been requested but not served in time
+    quint64 m_lateReads;
+    std::unique_ptr<ControlObject> m_pChunkCount;
+    std::unique_ptr<ControlObject> m_pReadHits;
+    std::unique_ptr<ControlObject> m_pReadMisses;
+    std::unique_ptr<ControlObject> m_pHitRate;
+    std::unique_ptr<ControlObject> m_pLateReads;
+    std::unique_ptr<ControlObject> m_pParallelReads;
+    std::unique_ptr<ControlPushButton> m_pLoadIntoRam;
+    std::unique_ptr<ControlObject> m_pRamBufferProgress;
+    std::unique_ptr<ControlObject> m_pRamBuffered;
+
+    // The whole track if it has been loaded into RAM
+    std::unique_ptr<CachingReaderTrackBuffer> m_pTrackBuffer;
+
+    // The number of chunks of all readers
+    static std::atomic<SINT> s_totalChunks;
+
+    // Head of the intrusive list of free chunks. Constant time insertions
+    // and deletions without allocating list nodes. Iteration is not necessary.
+    CachingReaderChunkForOwner* m_pFreeChunks;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
-    // chunk number they are allocated to.
-    QHash<int, CachingReaderChunkForOwner*> m_allocatedCachingReaderChunks;
+    // chunk number they are allocated to. Sized for the current track by the worker.
+    std::unique_ptr<CachingReaderChunkTable> m_pChunkTable;
 
     // The linked list of recently-used chunks.
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
-
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
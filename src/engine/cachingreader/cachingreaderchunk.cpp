@@ -110,7 +110,8 @@ CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         : CachingReaderChunk(std::move(sampleBuffer)),
           m_state(FREE),
           m_pPrev(nullptr),
-          m_pNext(nullptr) {
+          m_pNext(nullptr),
+          m_pNextFree(nullptr) {
 }
 
 void CachingReaderChunkForOwner::init(SINT index) {
@@ -234,3 +235,51 @@ void CachingReaderChunkForOwner::removeFromList(
         }
     }
 }
+
+void CachingReaderChunkForOwner::pushOntoFreeList(
+        CachingReaderChunkForOwner** ppHead) {
+    DEBUG_ASSERT(m_state == FREE);
+    DEBUG_ASSERT(ppHead);
+    // Must not be referenced in MRU/LRU list or free list
+    DEBUG_ASSERT(!m_pNext);
+    DEBUG_ASSERT(!m_pPrev);
+    DEBUG_ASSERT(!m_pNextFree);
+    DEBUG_ASSERT(this != *ppHead);
+    m_pNextFree = *ppHead;
+    *ppHead = this;
+}
+
+// static
+CachingReaderChunkForOwner* CachingReaderChunkForOwner::popFromFreeList(
+        CachingReaderChunkForOwner** ppHead) {
+    DEBUG_ASSERT(ppHead);
+    CachingReaderChunkForOwner* pChunk = *ppHead;
+    if (pChunk) {
+        DEBUG_ASSERT(pChunk->m_state == FREE);
+        *ppHead = pChunk->m_pNextFree;
+        pChunk->m_pNextFree = nullptr;
+    }
+    return pChunk;
+}
+
+CachingReaderChunkSlab::CachingReaderChunkSlab(SINT numChunks)
+        : m_sampleBuffer(CachingReaderChunk::kSamples * numChunks) {
+    DEBUG_ASSERT(numChunks > 0);
+    // Divide up the allocated raw memory buffer into chunks. Each chunk
+    // is initialized to hold nothing.
+    m_chunks.reserve(numChunks);
+    for (SINT i = 0; i < numChunks; ++i) {
+        m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                mixxx::SampleBuffer::WritableSlice(
+                        m_sampleBuffer,
+                        CachingReaderChunk::kSamples * i,
+                        CachingReaderChunk::kSamples)));
+    }
+}
+
+CachingReaderChunkTable::CachingReaderChunkTable(SINT size)
+        : m_size(size),
+          // Value-initialized, i.e. all entries are nullptr
+          m_chunks(std::make_unique<CachingReaderChunkForOwner*[]>(size)) {
+    DEBUG_ASSERT(m_size >= 0);
+}
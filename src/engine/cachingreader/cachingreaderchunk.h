@@ -1,6 +1,10 @@
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "sources/audiosource.h"
+#include "util/assert.h"
 
 // A Chunk is a memory-resident section of audio that has been cached.
 // Each chunk holds a fixed number kFrames of frames with samples for
@@ -146,9 +150,93 @@ public:
             CachingReaderChunkForOwner** ppHead,
             CachingReaderChunkForOwner** ppTail);
 
+    // Pushes a free chunk onto the intrusive single-linked list of
+    // free chunks with the given head.
+    void pushOntoFreeList(
+            CachingReaderChunkForOwner** ppHead);
+    // Pops the head from the intrusive single-linked list of free
+    // chunks. Returns nullptr if the list is empty.
+    static CachingReaderChunkForOwner* popFromFreeList(
+            CachingReaderChunkForOwner** ppHead);
+
 private:
   State m_state;
 
   CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
   CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
+  CachingReaderChunkForOwner* m_pNextFree; // next item in list of free chunks
+};
+
+// A block of chunks that share a single contiguous sample buffer. The cache
+// starts with a single slab. In adaptive mode additional slabs are allocated
+// by the worker thread to keep memory allocations off the engine thread.
+class CachingReaderChunkSlab {
+  public:
+    explicit CachingReaderChunkSlab(SINT numChunks);
+
+    SINT size() const {
+        return static_cast<SINT>(m_chunks.size());
+    }
+
+    CachingReaderChunkForOwner* chunk(SINT index) const {
+        return m_chunks[index].get();
+    }
+
+  private:
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+};
+
+// Maps chunk indices to the allocated chunks of the cache. The number of
+// chunks of a track is known when it is loaded, so a direct-indexed array
+// replaces a hash table: A lookup is a bounds check and a single load.
+// The table is allocated by the worker thread and only grows, i.e. it is
+// reused for all tracks that fit into it.
+class CachingReaderChunkTable {
+  public:
+    explicit CachingReaderChunkTable(SINT size);
+
+    // The size of a table that covers all chunks of the frame index range
+    static SINT sizeForFrameIndexRange(const mixxx::IndexRange& frameIndexRange) {
+        if (frameIndexRange.empty()) {
+            return 0;
+        }
+        return CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1) + 1;
+    }
+
+    SINT size() const {
+        return m_size;
+    }
+
+    // Returns nullptr if no chunk is allocated for the index or if the
+    // index is out of range.
+    CachingReaderChunkForOwner* lookup(SINT chunkIndex) const {
+        if (chunkIndex < 0 || chunkIndex >= m_size) {
+            return nullptr;
+        }
+        return m_chunks[chunkIndex];
+    }
+
+    // Returns false if the index is out of range.
+    bool insert(SINT chunkIndex, CachingReaderChunkForOwner* pChunk) {
+        VERIFY_OR_DEBUG_ASSERT(chunkIndex >= 0 && chunkIndex < m_size) {
+            return false;
+        }
+        DEBUG_ASSERT(!m_chunks[chunkIndex]);
+        m_chunks[chunkIndex] = pChunk;
+        return true;
+    }
+
+    // Removes the entry for the index only if it still refers to the
+    // given chunk, which might have been replaced after loading a new
+    // track.
+    void remove(SINT chunkIndex, const CachingReaderChunkForOwner* pChunk) {
+        if (chunkIndex >= 0 && chunkIndex < m_size && m_chunks[chunkIndex] == pChunk) {
+            m_chunks[chunkIndex] = nullptr;
+        }
+    }
+
+  private:
+    const SINT m_size;
+    const std::unique_ptr<CachingReaderChunkForOwner*[]> m_chunks;
 };
@@ -0,0 +1,119 @@
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "sources/audiosourcestereoproxy.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderTrackBuffer");
+
+} // anonymous namespace
+
+CachingReaderTrackBuffer::CachingReaderTrackBuffer(
+        const mixxx::IndexRange& frameIndexRange)
+        : m_frameIndexRange(frameIndexRange),
+          m_sampleBuffer(CachingReaderChunk::frames2samples(frameIndexRange.length())),
+          m_bufferedFrameIndexEnd(frameIndexRange.start()),
+          m_complete(false) {
+    DEBUG_ASSERT(!frameIndexRange.empty());
+}
+
+double CachingReaderTrackBuffer::progress() const {
+    if (m_complete) {
+        return 1.0;
+    }
+    return static_cast<double>(bufferedFrameIndexRange().length()) /
+            m_frameIndexRange.length();
+}
+
+const CSAMPLE* CachingReaderTrackBuffer::bufferedData(SINT frameIndex) const {
+    return m_sampleBuffer.data() +
+            CachingReaderChunk::frames2samples(frameIndex - m_frameIndexRange.start());
+}
+
+void CachingReaderTrackBuffer::bufferNextSampleFrames(
+        const mixxx::AudioSourcePointer& pAudioSource,
+        mixxx::SampleBuffer::WritableSlice tempOutputBuffer,
+        SINT maxFrames) {
+    VERIFY_OR_DEBUG_ASSERT(isValid() && !m_complete) {
+        return;
+    }
+    const auto requestedFrameIndexRange = intersect(
+            mixxx::IndexRange::forward(m_bufferedFrameIndexEnd, maxFrames),
+            m_frameIndexRange);
+    DEBUG_ASSERT(!requestedFrameIndexRange.empty());
+    const SINT sampleOffset = CachingReaderChunk::frames2samples(
+            requestedFrameIndexRange.start() - m_frameIndexRange.start());
+    const SINT sampleCount = CachingReaderChunk::frames2samples(
+            requestedFrameIndexRange.length());
+
+    mixxx::AudioSourceStereoProxy audioSourceProxy(
+            pAudioSource,
+            tempOutputBuffer);
+    const auto readableSampleFrames =
+            audioSourceProxy.readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            requestedFrameIndexRange,
+                            mixxx::SampleBuffer::WritableSlice(
+                                    m_sampleBuffer, sampleOffset, sampleCount)));
+    const auto readFrameIndexRange = readableSampleFrames.frameIndexRange();
+    if (readFrameIndexRange.empty() ||
+            readFrameIndexRange.start() != requestedFrameIndexRange.start()) {
+        // Keep only the contiguous range of frames that have been decoded
+        // successfully. The remaining frames are treated as unreadable.
+        kLogger.warning()
+                << "Failed to decode sample frames"
+                << requestedFrameIndexRange
+                << "- stop buffering at frame"
+                << m_bufferedFrameIndexEnd;
+        m_complete = true;
+        return;
+    }
+    CSAMPLE* const pDest = m_sampleBuffer.data() + sampleOffset;
+    if (readableSampleFrames.readableData() != pDest) {
+        SampleUtil::copy(pDest,
+                readableSampleFrames.readableData(),
+                readableSampleFrames.readableLength());
+    }
+    m_bufferedFrameIndexEnd = readFrameIndexRange.end();
+    if (m_bufferedFrameIndexEnd >= m_frameIndexRange.end() ||
+            readFrameIndexRange != requestedFrameIndexRange) {
+        m_complete = true;
+    }
+}
+
+mixxx::IndexRange CachingReaderTrackBuffer::readBufferedSampleFrames(
+        CSAMPLE* sampleBuffer,
+        const mixxx::IndexRange& frameIndexRange) const {
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, bufferedFrameIndexRange());
+    if (!copyableFrameIndexRange.empty()) {
+        const SINT dstSampleOffset = CachingReaderChunk::frames2samples(
+                copyableFrameIndexRange.start() - frameIndexRange.start());
+        SampleUtil::copy(
+                sampleBuffer + dstSampleOffset,
+                bufferedData(copyableFrameIndexRange.start()),
+                CachingReaderChunk::frames2samples(copyableFrameIndexRange.length()));
+    }
+    return copyableFrameIndexRange;
+}
+
+mixxx::IndexRange CachingReaderTrackBuffer::readBufferedSampleFramesReverse(
+        CSAMPLE* reverseSampleBuffer,
+        const mixxx::IndexRange& frameIndexRange) const {
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, bufferedFrameIndexRange());
+    if (!copyableFrameIndexRange.empty()) {
+        const SINT dstSampleOffset = CachingReaderChunk::frames2samples(
+                copyableFrameIndexRange.start() - frameIndexRange.start());
+        const SINT sampleCount =
+                CachingReaderChunk::frames2samples(copyableFrameIndexRange.length());
+        SampleUtil::copyReverse(
+                reverseSampleBuffer - dstSampleOffset - sampleCount,
+                bufferedData(copyableFrameIndexRange.start()),
+                sampleCount);
+    }
+    return copyableFrameIndexRange;
+}
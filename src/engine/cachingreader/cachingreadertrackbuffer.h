@@ -0,0 +1,61 @@
+#pragma once
+
+#include "sources/audiosource.h"
+#include "util/samplebuffer.h"
+
+// Holds the decoded audio of a whole track in a single contiguous buffer.
+//
+// The buffer is filled incrementally by the CachingReaderWorker in between
+// chunk read requests and handed over to the CachingReader once complete.
+// From then on the CachingReader serves all reads from this buffer instead
+// of the chunk cache and no more disk I/O is required during playback.
+//
+// Like CachingReaderChunk this class is not thread-safe. Only a single
+// thread owns the buffer at any time and the ownership is transferred
+// through lock-free FIFOs.
+class CachingReaderTrackBuffer {
+  public:
+    explicit CachingReaderTrackBuffer(
+            const mixxx::IndexRange& frameIndexRange);
+
+    // Returns false if the memory could not be allocated
+    bool isValid() const {
+        return m_sampleBuffer.size() > 0;
+    }
+
+    // The frames that have been decoded so far
+    mixxx::IndexRange bufferedFrameIndexRange() const {
+        return mixxx::IndexRange::between(
+                m_frameIndexRange.start(), m_bufferedFrameIndexEnd);
+    }
+
+    bool isComplete() const {
+        return m_complete;
+    }
+
+    // The ratio of decoded frames between 0.0 and 1.0
+    double progress() const;
+
+    // Decodes up to maxFrames of the next frames from the audio source.
+    // Buffering stops early if the audio source fails to decode them.
+    void bufferNextSampleFrames(
+            const mixxx::AudioSourcePointer& pAudioSource,
+            mixxx::SampleBuffer::WritableSlice tempOutputBuffer,
+            SINT maxFrames);
+
+    // Same semantics as the corresponding functions of CachingReaderChunk
+    mixxx::IndexRange readBufferedSampleFrames(
+            CSAMPLE* sampleBuffer,
+            const mixxx::IndexRange& frameIndexRange) const;
+    mixxx::IndexRange readBufferedSampleFramesReverse(
+            CSAMPLE* reverseSampleBuffer,
+            const mixxx::IndexRange& frameIndexRange) const;
+
+  private:
+    const CSAMPLE* bufferedData(SINT frameIndex) const;
+
+    const mixxx::IndexRange m_frameIndexRange;
+    mixxx::SampleBuffer m_sampleBuffer;
+    SINT m_bufferedFrameIndexEnd;
+    bool m_complete;
+};
@@ -2,12 +2,15 @@
 
 #include <QAtomicInt>
 #include <QtDebug>
+#include <algorithm>
 
 #include "analyzer/analyzersilence.h"
+#include "engine/cachingreader/cachingreaderworkerpool.h"
 #include "moc_cachingreaderworker.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/compatibility/qmutex.h"
+#include "util/counter.h"
 #include "util/event.h"
 #include "util/fifo.h"
 #include "util/logger.h"
@@ -20,43 +23,75 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// Initial capacity of the pending requests, which are limited by the
+// number of chunks of the reader
+constexpr std::size_t kInitialPendingRequestsCapacity = 128;
+
+// The number of helpers that decode chunks of the same track in parallel
+// to the worker
+constexpr int kMaxHelpers = 3;
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
         const QString& group,
         FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO)
+        FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+        FIFO<CachingReaderChunkSlab*>* pChunkSlabFIFO,
+        FIFO<CachingReaderTrackBuffer*>* pTrackBufferReleaseFIFO,
+        FIFO<CachingReaderChunkTable*>* pChunkTableReleaseFIFO)
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_pChunkSlabFIFO(pChunkSlabFIFO),
+          m_pTrackBufferReleaseFIFO(pTrackBufferReleaseFIFO),
+          m_pChunkTableReleaseFIFO(pChunkTableReleaseFIFO),
+          m_chunkTableSize(0),
+          m_requestedSlabChunks(0),
+          m_loadIntoRam(false),
+          m_maxTrackBufferSamples(0),
+          m_trackBufferDone(false),
+          m_trackBufferProgress(0.0),
+          m_queuedHelpers(0),
+          m_runningHelpers(0),
+          m_parallelDecoding(false),
+          m_activeReads(0),
+          m_parallelReads(0) {
+    m_pendingRequests.reserve(kInitialPendingRequestsCapacity);
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
-        const CachingReaderChunkReadRequest& request) {
+        const CachingReaderChunkReadRequest& request,
+        const mixxx::AudioSourcePointer& pAudioSource,
+        mixxx::SampleBuffer* pTempReadBuffer) {
     CachingReaderChunk* pChunk = request.chunk;
     DEBUG_ASSERT(pChunk);
 
     // Before trying to read any data we need to check if the audio source
     // is available and if any audio data that is needed by the chunk is
     // actually available.
-    auto chunkFrameIndexRange = pChunk->frameIndexRange(m_pAudioSource);
-    DEBUG_ASSERT(!m_pAudioSource ||
-            chunkFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
+    auto chunkFrameIndexRange = pChunk->frameIndexRange(pAudioSource);
+    DEBUG_ASSERT(!pAudioSource ||
+            chunkFrameIndexRange.isSubrangeOf(pAudioSource->frameIndexRange()));
     if (chunkFrameIndexRange.empty()) {
         ReaderStatusUpdate result;
-        result.init(CHUNK_READ_INVALID, pChunk, m_pAudioSource ? m_pAudioSource->frameIndexRange() : mixxx::IndexRange());
+        result.init(CHUNK_READ_INVALID, pChunk, pAudioSource ? pAudioSource->frameIndexRange() : mixxx::IndexRange());
         return result;
     }
 
     // Try to read the data required for the chunk from the audio source
+    if (m_activeReads.fetch_add(1, std::memory_order_relaxed) > 0) {
+        m_parallelReads.fetch_add(1, std::memory_order_relaxed);
+    }
     const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
-            m_pAudioSource,
-            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
-    DEBUG_ASSERT(!m_pAudioSource ||
-            bufferedFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
+            pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(*pTempReadBuffer));
+    m_activeReads.fetch_sub(1, std::memory_order_relaxed);
+    DEBUG_ASSERT(!pAudioSource ||
+            bufferedFrameIndexRange.isSubrangeOf(pAudioSource->frameIndexRange()));
     // The readable frame range might have changed
-    chunkFrameIndexRange = intersect(chunkFrameIndexRange, m_pAudioSource->frameIndexRange());
+    chunkFrameIndexRange = intersect(chunkFrameIndexRange, pAudioSource->frameIndexRange());
     DEBUG_ASSERT(bufferedFrameIndexRange.empty() ||
             bufferedFrameIndexRange.isSubrangeOf(chunkFrameIndexRange));
 
@@ -85,7 +120,7 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     verifyFirstSound(pChunk);
 
     ReaderStatusUpdate result;
-    result.init(status, pChunk, m_pAudioSource ? m_pAudioSource->frameIndexRange() : mixxx::IndexRange());
+    result.init(status, pChunk, pAudioSource ? pAudioSource->frameIndexRange() : mixxx::IndexRange());
     return result;
 }
 
@@ -99,6 +134,110 @@ void CachingReaderWorker::newTrack(TrackPointer pTrack) {
     workReady();
 }
 
+void CachingReaderWorker::requestChunkSlab(SINT numChunks) {
+    DEBUG_ASSERT(numChunks > 0);
+    m_requestedSlabChunks.fetch_add(numChunks, std::memory_order_release);
+    workReady();
+}
+
+void CachingReaderWorker::allocateChunkSlab(SINT numChunks) {
+    auto* pSlab = new CachingReaderChunkSlab(numChunks);
+    if (m_pChunkSlabFIFO->write(&pSlab, 1) != 1) {
+        // The owner requests at most a single slab at a time
+        DEBUG_ASSERT(!"Chunk slab FIFO overflow");
+        delete pSlab;
+        return;
+    }
+    kLogger.debug()
+            << m_group
+            << "Allocated" << numChunks << "additional chunks";
+}
+
+bool CachingReaderWorker::shouldBufferTrack() const {
+    return m_pAudioSource &&
+            !m_trackBufferDone &&
+            m_loadIntoRam.load(std::memory_order_relaxed);
+}
+
+void CachingReaderWorker::bufferTrack() {
+    if (!m_pTrackBuffer) {
+        const auto frameIndexRange = m_pAudioSource->frameIndexRange();
+        if (CachingReaderChunk::frames2samples(frameIndexRange.length()) >
+                m_maxTrackBufferSamples) {
+            kLogger.info()
+                    << m_group
+                    << "Track is too long to be loaded into RAM";
+            m_trackBufferDone = true;
+            return;
+        }
+        m_pTrackBuffer = std::make_unique<CachingReaderTrackBuffer>(frameIndexRange);
+        if (!m_pTrackBuffer->isValid()) {
+            kLogger.warning()
+                    << m_group
+                    << "Failed to allocate memory for loading the track into RAM";
+            m_pTrackBuffer.reset();
+            m_trackBufferDone = true;
+            return;
+        }
+    }
+
+    m_pTrackBuffer->bufferNextSampleFrames(
+            m_pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer),
+            CachingReaderChunk::kFrames);
+    m_trackBufferProgress.store(m_pTrackBuffer->progress(), std::memory_order_relaxed);
+    if (m_pTrackBuffer->isComplete()) {
+        // Hand over the ownership to the reader
+        const auto update = ReaderStatusUpdate::trackBuffered(m_pTrackBuffer.release());
+        writeStatusUpdate(update);
+        m_trackBufferDone = true;
+    }
+}
+
+void CachingReaderWorker::resetTrackBuffer() {
+    m_pTrackBuffer.reset();
+    m_trackBufferDone = false;
+    m_trackBufferProgress.store(0.0, std::memory_order_relaxed);
+}
+
+void CachingReaderWorker::fetchReadRequests() {
+    // Only the worker reads from the single consumer FIFO
+    CachingReaderChunkReadRequest request;
+    if (m_pChunkReadRequestFIFO->read(&request, 1) != 1) {
+        return;
+    }
+    const auto locker = lockMutex(&m_decodeMutex);
+    do {
+        m_pendingRequests.push_back(request);
+    } while (m_pChunkReadRequestFIFO->read(&request, 1) == 1);
+}
+
+bool CachingReaderWorker::takeNextReadRequest(CachingReaderChunkReadRequest* pRequest) {
+    fetchReadRequests();
+    const auto locker = lockMutex(&m_decodeMutex);
+    return takePendingReadRequest(pRequest);
+}
+
+bool CachingReaderWorker::takePendingReadRequest(CachingReaderChunkReadRequest* pRequest) {
+    if (m_pendingRequests.empty()) {
+        return false;
+    }
+    // Only a few requests are pending at any time, so a linear search
+    // is sufficient. The first match is the oldest request.
+    auto next = m_pendingRequests.begin();
+    for (auto it = next + 1; it != m_pendingRequests.end(); ++it) {
+        if (it->priority < next->priority) {
+            next = it;
+        }
+    }
+    if (next != m_pendingRequests.begin()) {
+        Counter("CachingReaderWorker: Read request served before older requests")++;
+    }
+    *pRequest = *next;
+    m_pendingRequests.erase(next);
+    return true;
+}
+
 void CachingReaderWorker::run() {
     // the id of this thread, for debugging purposes
     static auto lastId = QAtomicInt(0);
@@ -108,45 +247,223 @@ void CachingReaderWorker::run() {
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
-        // Request is initialized by reading from FIFO
-        CachingReaderChunkReadRequest request;
-        if (m_newTrackAvailable.loadAcquire()) {
-            TrackPointer pLoadTrack;
-            { // locking scope
-                const auto locker = lockMutex(&m_newTrackMutex);
-                pLoadTrack = m_pNewTrack;
-                m_pNewTrack.reset();
-                m_newTrackAvailable.storeRelease(0);
-            } // implicitly unlocks the mutex
-            if (pLoadTrack) {
-                // in this case the engine is still running with the old track
-                loadTrack(pLoadTrack);
-            } else {
-                // here, the engine is already stopped
-                unloadTrack();
-            }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
-            // Read the requested chunk and send the result
-            const ReaderStatusUpdate update = processReadRequest(request);
-            m_pReaderStatusFIFO->writeBlocking(&update, 1);
-        } else {
+        if (!runNextTask()) {
             Event::end(m_tag);
             m_semaRun.acquire();
             Event::start(m_tag);
+            reportWakeupLatency();
         }
     }
 }
 
-void CachingReaderWorker::discardAllPendingRequests() {
+void CachingReaderWorker::requestHelpers() {
+    DEBUG_ASSERT(m_pPool);
+    const auto locker = lockMutex(&m_decodeMutex);
+    if (!m_parallelDecoding) {
+        return;
+    }
+    const int wantedHelpers = std::min(
+            static_cast<int>(m_pendingRequests.size()), kMaxHelpers);
+    while (m_queuedHelpers + m_runningHelpers < wantedHelpers &&
+            m_pPool->requestHelper(this)) {
+        ++m_queuedHelpers;
+    }
+}
+
+std::unique_ptr<CachingReaderWorker::Decoder> CachingReaderWorker::openDecoder(
+        const TrackPointer& pTrack) {
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(CachingReaderChunk::kChannels);
+    auto pDecoder = std::make_unique<Decoder>();
+    pDecoder->pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    if (!pDecoder->pAudioSource) {
+        return nullptr;
+    }
+    mixxx::SampleBuffer(
+            pDecoder->pAudioSource->getSignalInfo().frames2samples(
+                    CachingReaderChunk::kFrames))
+            .swap(pDecoder->tempReadBuffer);
+    return pDecoder;
+}
+
+void CachingReaderWorker::runHelper() {
+    std::unique_ptr<Decoder> pDecoder;
+    TrackPointer pTrack;
+    mixxx::IndexRange frameIndexRange;
+    {
+        const auto locker = lockMutex(&m_decodeMutex);
+        DEBUG_ASSERT(m_queuedHelpers > 0);
+        --m_queuedHelpers;
+        if (m_stop.loadAcquire() || !m_parallelDecoding || m_pendingRequests.empty()) {
+            // The worker has already served all requests
+            return;
+        }
+        ++m_runningHelpers;
+        if (m_idleDecoders.empty()) {
+            pTrack = m_pTrack;
+            frameIndexRange = m_trackFrameIndexRange;
+        } else {
+            pDecoder = std::move(m_idleDecoders.back());
+            m_idleDecoders.pop_back();
+        }
+    }
+    if (!pDecoder) {
+        DEBUG_ASSERT(pTrack);
+        pDecoder = openDecoder(pTrack);
+        // Only decode with the same frames as the worker
+        if (pDecoder && pDecoder->pAudioSource->frameIndexRange() != frameIndexRange) {
+            pDecoder.reset();
+        }
+    }
+
+    auto locker = lockMutex(&m_decodeMutex);
+    if (!pDecoder) {
+        kLogger.info()
+                << m_group
+                << "Decoding the chunks one after another, because the "
+                   "track could not be opened again";
+        m_parallelDecoding = false;
+    } else {
+        CachingReaderChunkReadRequest request;
+        while (!m_stop.loadAcquire() && takePendingReadRequest(&request)) {
+            locker.unlock();
+            const ReaderStatusUpdate update = processReadRequest(request,
+                    pDecoder->pAudioSource,
+                    &pDecoder->tempReadBuffer);
+            writeStatusUpdate(update);
+            locker.relock();
+        }
+        m_idleDecoders.push_back(std::move(pDecoder));
+    }
+    DEBUG_ASSERT(m_runningHelpers > 0);
+    --m_runningHelpers;
+    m_helpersFinished.wakeAll();
+}
+
+void CachingReaderWorker::closeDecoders() {
+    std::vector<std::unique_ptr<Decoder>> decoders;
+    {
+        const auto locker = lockMutex(&m_decodeMutex);
+        // Helpers that are still queued find nothing to do
+        m_parallelDecoding = false;
+        while (m_runningHelpers > 0) {
+            m_helpersFinished.wait(&m_decodeMutex);
+        }
+        decoders.swap(m_idleDecoders);
+        m_pTrack.reset();
+    }
+    for (const auto& pDecoder : decoders) {
+        pDecoder->pAudioSource->close();
+    }
+}
+
+void CachingReaderWorker::writeStatusUpdate(const ReaderStatusUpdate& update) {
+    const auto locker = lockMutex(&m_statusMutex);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+}
+
+void CachingReaderWorker::startOnPool(std::shared_ptr<CachingReaderWorkerPool> pPool) {
+    DEBUG_ASSERT(pPool);
+    DEBUG_ASSERT(!m_pPool);
+    DEBUG_ASSERT(!isRunning());
+    m_pPool = std::move(pPool);
+    m_pPool->addWorker(this);
+}
+
+bool CachingReaderWorker::runTasks(int maxTasks) {
+    Event::start(m_tag);
+    reportWakeupLatency();
+    bool moreWork = true;
+    for (int i = 0; i < maxTasks; ++i) {
+        if (m_stop.loadAcquire() || !runNextTask()) {
+            moreWork = false;
+            break;
+        }
+    }
+    Event::end(m_tag);
+    return moreWork;
+}
+
+void CachingReaderWorker::wake() {
+    if (m_pPool) {
+        m_pPool->schedule(this);
+    } else {
+        EngineWorker::wake();
+    }
+}
+
+bool CachingReaderWorker::runNextTask() {
+    // Request is initialized by reading from FIFO
     CachingReaderChunkReadRequest request;
-    while (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
+    const SINT numSlabChunks =
+            m_requestedSlabChunks.exchange(0, std::memory_order_acquire);
+    if (numSlabChunks > 0) {
+        allocateChunkSlab(numSlabChunks);
+    }
+    // Delete whole-track buffers that are no longer used by the reader
+    CachingReaderTrackBuffer* pReleasedTrackBuffer;
+    while (m_pTrackBufferReleaseFIFO->read(&pReleasedTrackBuffer, 1) == 1) {
+        delete pReleasedTrackBuffer;
+    }
+    CachingReaderChunkTable* pReleasedChunkTable;
+    while (m_pChunkTableReleaseFIFO->read(&pReleasedChunkTable, 1) == 1) {
+        delete pReleasedChunkTable;
+    }
+    if (m_pTrackBuffer && !m_loadIntoRam.load(std::memory_order_relaxed)) {
+        // Loading into RAM has been disabled while buffering
+        resetTrackBuffer();
+    }
+    if (m_newTrackAvailable.loadAcquire()) {
+        TrackPointer pLoadTrack;
+        { // locking scope
+            const auto locker = lockMutex(&m_newTrackMutex);
+            pLoadTrack = m_pNewTrack;
+            m_pNewTrack.reset();
+            m_newTrackAvailable.storeRelease(0);
+        } // implicitly unlocks the mutex
+        if (pLoadTrack) {
+            // in this case the engine is still running with the old track
+            loadTrack(pLoadTrack);
+        } else {
+            // here, the engine is already stopped
+            unloadTrack();
+        }
+    } else if (takeNextReadRequest(&request)) {
+        if (m_pPool) {
+            // Let idle threads decode the other pending chunks
+            requestHelpers();
+        }
+        // Read the requested chunk and send the result
+        const ReaderStatusUpdate update = processReadRequest(
+                request, m_pAudioSource, &m_tempReadBuffer);
+        writeStatusUpdate(update);
+    } else if (shouldBufferTrack()) {
+        // Fill the whole-track buffer while there is nothing else to do
+        bufferTrack();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void CachingReaderWorker::discardAllPendingRequests() {
+    fetchReadRequests();
+    std::vector<CachingReaderChunkReadRequest> discardedRequests;
+    {
+        const auto locker = lockMutex(&m_decodeMutex);
+        discardedRequests = m_pendingRequests;
+        m_pendingRequests.clear();
+    }
+    for (const auto& request : discardedRequests) {
         const auto update = ReaderStatusUpdate::readDiscarded(request.chunk);
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
     }
 }
 
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
+    closeDecoders();
+    resetTrackBuffer();
 
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
@@ -157,13 +474,14 @@ void CachingReaderWorker::closeAudioSource() {
     // This function has to be called with the engine stopped only
     // to avoid collecting new requests for the old track
     DEBUG_ASSERT(!m_pChunkReadRequestFIFO->readAvailable());
+    DEBUG_ASSERT(m_pendingRequests.empty());
 }
 
 void CachingReaderWorker::unloadTrack() {
     closeAudioSource();
 
     const auto update = ReaderStatusUpdate::trackUnloaded();
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+    writeStatusUpdate(update);
 }
 
 void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
@@ -179,7 +497,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << "File not found"
                 << pTrack->getFileInfo();
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be found.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -195,7 +513,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << "Failed to open file"
                 << pTrack->getFileInfo();
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
@@ -212,13 +530,20 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
                 << "Failed to open empty file"
                 << pTrack->getFileInfo();
         const auto update = ReaderStatusUpdate::trackUnloaded();
-        m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        writeStatusUpdate(update);
         emit trackLoadFailed(pTrack,
                 tr("The file '%1' is empty and could not be loaded.")
                         .arg(QDir::toNativeSeparators(pTrack->getLocation())));
         return;
     }
 
+    {
+        const auto locker = lockMutex(&m_decodeMutex);
+        m_pTrack = pTrack;
+        m_trackFrameIndexRange = m_pAudioSource->frameIndexRange();
+        m_parallelDecoding = true;
+    }
+
     // Adjust the internal buffer
     const SINT tempReadBufferSize =
             m_pAudioSource->getSignalInfo().frames2samples(
@@ -227,10 +552,20 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
+    // Allocate a larger chunk table for the reader if needed
+    CachingReaderChunkTable* pChunkTable = nullptr;
+    const SINT chunkTableSize = CachingReaderChunkTable::sizeForFrameIndexRange(
+            m_pAudioSource->frameIndexRange());
+    if (chunkTableSize > m_chunkTableSize) {
+        pChunkTable = new CachingReaderChunkTable(chunkTableSize);
+        m_chunkTableSize = chunkTableSize;
+    }
+
     const auto update =
             ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
-    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+                    m_pAudioSource->frameIndexRange(),
+                    pChunkTable);
+    writeStatusUpdate(update);
 
     // Emit that the track is loaded.
     const double sampleCount =
@@ -248,6 +583,7 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
     // The engine must not request any chunks before receiving the
     // trackLoaded() signal
     DEBUG_ASSERT(!m_pChunkReadRequestFIFO->readAvailable());
+    DEBUG_ASSERT(m_pendingRequests.empty());
 
     emit trackLoaded(
             pTrack,
@@ -257,11 +593,17 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
 
 void CachingReaderWorker::quitWait() {
     m_stop = 1;
+    if (m_pPool) {
+        m_pPool->removeWorker(this);
+        return;
+    }
     m_semaRun.release();
     wait();
 }
 
 void CachingReaderWorker::verifyFirstSound(const CachingReaderChunk* pChunk) {
+    // Called by both the worker and its helpers
+    const auto locker = lockMutex(&m_decodeMutex);
     if (!m_firstSoundFrameToVerify.isValid()) {
         return;
     }
@@ -2,10 +2,16 @@
 
 #include <QMutex>
 #include <QString>
+#include <QWaitCondition>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "audio/frame.h"
 #include "audio/types.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
@@ -13,13 +19,27 @@
 template<class DataType>
 class FIFO;
 
+class CachingReaderWorkerPool;
+
 // POD with trivial ctor/dtor/copy for passing through FIFO
 typedef struct CachingReaderChunkReadRequest {
+    // The worker serves pending requests with a higher priority (lower value)
+    // first. Requests with the same priority are served in order.
+    enum class Priority {
+        Playhead = 0, // current and slip position
+        Loop = 1,     // loop boundaries
+        Cue = 2,      // all other cues
+    };
+    static constexpr int kNumPriorities = 3;
+
     CachingReaderChunk* chunk;
+    Priority priority;
 
-    void giveToWorker(CachingReaderChunkForOwner* chunkForOwner) {
+    void giveToWorker(CachingReaderChunkForOwner* chunkForOwner,
+            Priority priorityArg) {
         DEBUG_ASSERT(chunkForOwner);
         chunk = chunkForOwner;
+        priority = priorityArg;
         chunkForOwner->giveToWorker();
     }
 } CachingReaderChunkReadRequest;
@@ -31,12 +51,15 @@ enum ReaderStatus {
     CHUNK_READ_EOF,
     CHUNK_READ_INVALID,
     CHUNK_READ_DISCARDED, // response without frame index range!
+    TRACK_BUFFERED,       // response with the whole-track buffer
 };
 
 // POD with trivial ctor/dtor/copy for passing through FIFO
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    CachingReaderTrackBuffer* trackBuffer;
+    CachingReaderChunkTable* chunkTable;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -49,6 +72,8 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        trackBuffer = nullptr;
+        chunkTable = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -60,11 +85,24 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    // pChunkTable is nullptr if the current chunk table of the reader
+    // is large enough for the new track.
     static ReaderStatusUpdate trackLoaded(
-            const mixxx::IndexRange& readableFrameIndexRange) {
+            const mixxx::IndexRange& readableFrameIndexRange,
+            CachingReaderChunkTable* pChunkTable) {
         DEBUG_ASSERT(!readableFrameIndexRange.empty());
         ReaderStatusUpdate update;
         update.init(TRACK_LOADED, nullptr, readableFrameIndexRange);
+        update.chunkTable = pChunkTable;
+        return update;
+    }
+
+    static ReaderStatusUpdate trackBuffered(
+            CachingReaderTrackBuffer* pTrackBuffer) {
+        DEBUG_ASSERT(pTrackBuffer);
+        ReaderStatusUpdate update;
+        update.init(TRACK_BUFFERED, nullptr, pTrackBuffer->bufferedFrameIndexRange());
+        update.trackBuffer = pTrackBuffer;
         return update;
     }
 
@@ -85,6 +123,14 @@ typedef struct ReaderStatusUpdate {
         return pChunk;
     }
 
+    CachingReaderTrackBuffer* takeTrackBuffer() {
+        return std::exchange(trackBuffer, nullptr);
+    }
+
+    CachingReaderChunkTable* takeChunkTable() {
+        return std::exchange(chunkTable, nullptr);
+    }
+
     mixxx::IndexRange readableFrameIndexRange() const {
         return mixxx::IndexRange::between(
                 readableFrameIndexRangeStart,
@@ -99,16 +145,63 @@ class CachingReaderWorker : public EngineWorker {
     // Construct a CachingReader with the given group.
     CachingReaderWorker(const QString& group,
             FIFO<CachingReaderChunkReadRequest>* pChunkReadRequestFIFO,
-            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO);
+            FIFO<ReaderStatusUpdate>* pReaderStatusFIFO,
+            FIFO<CachingReaderChunkSlab*>* pChunkSlabFIFO,
+            FIFO<CachingReaderTrackBuffer*>* pTrackBufferReleaseFIFO,
+            FIFO<CachingReaderChunkTable*>* pChunkTableReleaseFIFO);
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
     void newTrack(TrackPointer pTrack);
 
+    // Request a new slab with the given number of chunks for growing the
+    // cache. The slab is allocated by the worker thread and handed over
+    // through the chunk slab FIFO. Called from the engine thread.
+    void requestChunkSlab(SINT numChunks);
+
+    // Enables decoding the whole track into a single buffer in the
+    // background, see CachingReaderTrackBuffer. Takes effect for the
+    // current track, if any. A completed buffer stays in use until the
+    // next track is loaded. workReady() must be called afterwards.
+    void setLoadIntoRam(bool loadIntoRam) {
+        m_loadIntoRam.store(loadIntoRam, std::memory_order_relaxed);
+    }
+
+    // Tracks exceeding this size are not loaded into RAM. Must be set
+    // before the thread is started.
+    void setMaxTrackBufferSamples(SINT maxSamples) {
+        m_maxTrackBufferSamples = maxSamples;
+    }
+
+    // The ratio of the current track that has been decoded into RAM
+    double trackBufferProgress() const {
+        return m_trackBufferProgress.load(std::memory_order_relaxed);
+    }
+
     // Run upkeep operations like loading tracks and reading from file. Run by a
     // thread pool via the EngineWorkerScheduler.
     void run() override;
 
+    // Runs the worker on the threads of the shared pool instead of its own
+    // thread. Must be called instead of start() and before the scheduler
+    // is set.
+    void startOnPool(std::shared_ptr<CachingReaderWorkerPool> pPool);
+
+    // Runs up to maxTasks tasks on the calling pool thread. Returns true
+    // if there is more work to do.
+    bool runTasks(int maxTasks);
+
+    // Decodes pending read requests with an additional audio source of the
+    // current track until none are left. Run by an idle pool thread after
+    // the worker has requested help, concurrently to runTasks().
+    void runHelper();
+
+    // The number of chunks that have been decoded while another chunk of
+    // the same track was decoded on another thread
+    quint64 parallelReads() const {
+        return m_parallelReads.load(std::memory_order_relaxed);
+    }
+
     void quitWait();
 
   signals:
@@ -117,14 +210,76 @@ class CachingReaderWorker : public EngineWorker {
     void trackLoaded(TrackPointer pTrack, mixxx::audio::SampleRate sampleRate, double numSamples);
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
+  protected:
+    void wake() override;
+
   private:
     const QString m_group;
     QString m_tag;
 
+    // The shared pool if the worker does not run its own thread
+    std::shared_ptr<CachingReaderWorkerPool> m_pPool;
+
     // Thread-safe FIFOs for communication between the engine callback and
     // reader thread.
     FIFO<CachingReaderChunkReadRequest>* m_pChunkReadRequestFIFO;
     FIFO<ReaderStatusUpdate>* m_pReaderStatusFIFO;
+    FIFO<CachingReaderChunkSlab*>* m_pChunkSlabFIFO;
+
+    FIFO<CachingReaderTrackBuffer*>* m_pTrackBufferReleaseFIFO;
+    FIFO<CachingReaderChunkTable*>* m_pChunkTableReleaseFIFO;
+
+    // The size of the chunk table that has been handed over to the reader
+    // most recently. A new table is only allocated for longer tracks.
+    SINT m_chunkTableSize;
+
+    // Requests fetched from the FIFO that have not been served yet, in the
+    // order of arrival. Refetched before serving each request, so a request
+    // with a higher priority overtakes queued requests with a lower one.
+    // Guarded by m_decodeMutex, because helpers take requests, too.
+    std::vector<CachingReaderChunkReadRequest> m_pendingRequests;
+
+    // An additional audio source of the current track that is used by
+    // helpers. The SoundSources are not thread-safe, but most of them can
+    // be opened more than once.
+    struct Decoder {
+        mixxx::AudioSourcePointer pAudioSource;
+        mixxx::SampleBuffer tempReadBuffer;
+    };
+
+    // Guards m_pendingRequests and the state of the helpers below
+    QMutex m_decodeMutex;
+    QWaitCondition m_helpersFinished;
+    // The track of m_pAudioSource for opening the decoders of helpers
+    TrackPointer m_pTrack;
+    // The frames of the track when it has been loaded. The decoders of
+    // helpers must provide the same frames.
+    mixxx::IndexRange m_trackFrameIndexRange;
+    // Decoders of the current track that are not used by a helper
+    std::vector<std::unique_ptr<Decoder>> m_idleDecoders;
+    // Helpers that have been requested, but have not started yet
+    int m_queuedHelpers;
+    int m_runningHelpers;
+    // Reset if the current track could not be opened again, i.e. its
+    // chunks can only be decoded one after another
+    bool m_parallelDecoding;
+    // Serializes the writes of the worker and its helpers into the
+    // single producer FIFO
+    QMutex m_statusMutex;
+
+    std::atomic<int> m_activeReads;
+    std::atomic<quint64> m_parallelReads;
+
+    // Number of chunks for the next slab, 0 if none has been requested
+    std::atomic<SINT> m_requestedSlabChunks;
+
+    std::atomic<bool> m_loadIntoRam;
+    SINT m_maxTrackBufferSamples;
+    // The whole-track buffer while it is being filled
+    std::unique_ptr<CachingReaderTrackBuffer> m_pTrackBuffer;
+    // Set if the buffer has been handed over or could not be created
+    bool m_trackBufferDone;
+    std::atomic<double> m_trackBufferProgress;
 
     // Queue of Tracks to load, and the corresponding lock. Must acquire the
     // lock to touch.
@@ -132,8 +287,39 @@ class CachingReaderWorker : public EngineWorker {
     QAtomicInt m_newTrackAvailable;
     TrackPointer m_pNewTrack;
 
+    // Runs the next pending task, i.e. loading a track, reading a chunk or
+    // buffering a part of the whole track. Returns false if there was
+    // nothing to do.
+    bool runNextTask();
+
+    // Moves all requests from the FIFO into m_pendingRequests
+    void fetchReadRequests();
+    // Removes the request with the highest priority from m_pendingRequests
+    bool takeNextReadRequest(CachingReaderChunkReadRequest* pRequest);
+    // Must be called with m_decodeMutex locked
+    bool takePendingReadRequest(CachingReaderChunkReadRequest* pRequest);
     void discardAllPendingRequests();
 
+    // Requests helpers from the pool for the pending requests that
+    // are not served by the worker itself
+    void requestHelpers();
+    // Returns nullptr if the track could not be opened again. Must be
+    // called with m_decodeMutex unlocked.
+    std::unique_ptr<Decoder> openDecoder(const TrackPointer& pTrack);
+    // Waits until all running helpers have finished and closes
+    // their decoders
+    void closeDecoders();
+
+    void writeStatusUpdate(const ReaderStatusUpdate& update);
+
+    void allocateChunkSlab(SINT numChunks);
+
+    bool shouldBufferTrack() const;
+    // Decodes the next part of the track into the whole-track buffer and
+    // hands it over to the reader when complete.
+    void bufferTrack();
+    void resetTrackBuffer();
+
     /// call to be prepare for new tracks
     /// Make sure engine has been stopped before
     void closeAudioSource();
@@ -146,7 +332,9 @@ class CachingReaderWorker : public EngineWorker {
     void loadTrack(const TrackPointer& pTrack);
 
     ReaderStatusUpdate processReadRequest(
-            const CachingReaderChunkReadRequest& request);
+            const CachingReaderChunkReadRequest& request,
+            const mixxx::AudioSourcePointer& pAudioSource,
+            mixxx::SampleBuffer* pTempReadBuffer);
 
     void verifyFirstSound(const CachingReaderChunk* pChunk);
 
@@ -0,0 +1,237 @@
+#include "engine/cachingreader/cachingreaderworkerpool.h"
+
+#include <algorithm>
+
+#include "engine/cachingreader/cachingreaderworker.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/counter.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderWorkerPool");
+
+// The number of tasks, i.e. chunk reads, track loads or parts of a
+// whole-track buffer, that a worker runs before other queued workers
+// get their turn.
+constexpr int kMaxTasksPerTurn = 4;
+
+QMutex s_sharedPoolMutex;
+std::weak_ptr<CachingReaderWorkerPool> s_sharedPool;
+
+} // anonymous namespace
+
+class CachingReaderWorkerPool::Thread : public QThread {
+  public:
+    Thread(CachingReaderWorkerPool* pPool, int threadIndex)
+            : m_pPool(pPool),
+              m_threadIndex(threadIndex) {
+    }
+
+  protected:
+    void run() override {
+        m_pPool->threadLoop(m_threadIndex);
+    }
+
+  private:
+    CachingReaderWorkerPool* const m_pPool;
+    const int m_threadIndex;
+};
+
+CachingReaderWorkerPool::CachingReaderWorkerPool(int numThreads)
+        : m_queues(std::max(numThreads, 1)),
+          m_idleThreads(0),
+          m_quit(false) {
+    DEBUG_ASSERT(numThreads > 0);
+    m_threads.reserve(m_queues.size());
+    for (int i = 0; i < static_cast<int>(m_queues.size()); ++i) {
+        auto pThread = std::make_unique<Thread>(this, i);
+        pThread->setObjectName(QStringLiteral("CachingReaderWorkerPool %1").arg(i + 1));
+        pThread->start(QThread::HighPriority);
+        m_threads.push_back(std::move(pThread));
+    }
+    kLogger.debug() << "Started" << m_threads.size() << "threads";
+}
+
+CachingReaderWorkerPool::~CachingReaderWorkerPool() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        // All readers must have removed their workers before
+        DEBUG_ASSERT(m_tasks.empty());
+        m_quit = true;
+        m_taskQueued.wakeAll();
+    }
+    for (const auto& pThread : m_threads) {
+        pThread->wait();
+    }
+}
+
+// static
+std::shared_ptr<CachingReaderWorkerPool> CachingReaderWorkerPool::shared(int numThreads) {
+    const auto locker = lockMutex(&s_sharedPoolMutex);
+    auto pPool = s_sharedPool.lock();
+    if (!pPool) {
+        pPool = std::make_shared<CachingReaderWorkerPool>(numThreads);
+        s_sharedPool = pPool;
+    }
+    return pPool;
+}
+
+CachingReaderWorkerPool::Task* CachingReaderWorkerPool::findTask(
+        const CachingReaderWorker* pWorker) {
+    for (const auto& pTask : m_tasks) {
+        if (pTask->pWorker == pWorker) {
+            return pTask.get();
+        }
+    }
+    return nullptr;
+}
+
+void CachingReaderWorkerPool::addWorker(CachingReaderWorker* pWorker) {
+    DEBUG_ASSERT(pWorker);
+    const auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(!findTask(pWorker));
+    // Distribute the workers evenly as initial affinity
+    const int threadIndex = static_cast<int>(m_tasks.size() % m_queues.size());
+    m_tasks.push_back(std::make_unique<Task>(
+            Task{pWorker, TaskState::Idle, threadIndex, 0}));
+}
+
+void CachingReaderWorkerPool::enqueue(Task* pTask) {
+    pTask->state = TaskState::Queued;
+    m_queues[pTask->threadIndex].push_back(pTask);
+    // Any idle thread may take the task, either from its own queue
+    // or by stealing it.
+    m_taskQueued.wakeOne();
+}
+
+void CachingReaderWorkerPool::schedule(CachingReaderWorker* pWorker) {
+    const auto locker = lockMutex(&m_mutex);
+    Task* pTask = findTask(pWorker);
+    if (!pTask) {
+        return;
+    }
+    switch (pTask->state) {
+    case TaskState::Idle:
+        enqueue(pTask);
+        break;
+    case TaskState::Running:
+        pTask->state = TaskState::RunningRescheduled;
+        break;
+    case TaskState::Queued:
+    case TaskState::RunningRescheduled:
+        break;
+    }
+}
+
+bool CachingReaderWorkerPool::requestHelper(CachingReaderWorker* pWorker) {
+    const auto locker = lockMutex(&m_mutex);
+    Task* pTask = findTask(pWorker);
+    if (!pTask) {
+        return false;
+    }
+    if (m_idleThreads <= static_cast<int>(m_helperQueue.size())) {
+        // All idle threads will already be busy with other helpers
+        return false;
+    }
+    m_helperQueue.push_back(pTask);
+    m_taskQueued.wakeOne();
+    return true;
+}
+
+void CachingReaderWorkerPool::removeWorker(CachingReaderWorker* pWorker) {
+    const auto locker = lockMutex(&m_mutex);
+    Task* pTask = findTask(pWorker);
+    if (!pTask) {
+        return;
+    }
+    m_helperQueue.erase(std::remove(m_helperQueue.begin(), m_helperQueue.end(), pTask),
+            m_helperQueue.end());
+    while (pTask->state == TaskState::Running ||
+            pTask->state == TaskState::RunningRescheduled ||
+            pTask->runningHelpers > 0) {
+        m_taskFinished.wait(&m_mutex);
+    }
+    if (pTask->state == TaskState::Queued) {
+        auto& queue = m_queues[pTask->threadIndex];
+        queue.erase(std::remove(queue.begin(), queue.end(), pTask), queue.end());
+    }
+    m_tasks.erase(std::remove_if(m_tasks.begin(),
+                          m_tasks.end(),
+                          [pTask](const auto& pOther) {
+                              return pOther.get() == pTask;
+                          }),
+            m_tasks.end());
+}
+
+CachingReaderWorkerPool::Task* CachingReaderWorkerPool::takeQueuedTask(int threadIndex) {
+    auto& ownQueue = m_queues[threadIndex];
+    if (!ownQueue.empty()) {
+        Task* pTask = ownQueue.front();
+        ownQueue.pop_front();
+        return pTask;
+    }
+    // Steal from the thread with the most queued workers
+    auto victim = std::max_element(m_queues.begin(),
+            m_queues.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.size() < rhs.size();
+            });
+    if (victim->empty()) {
+        return nullptr;
+    }
+    Task* pTask = victim->front();
+    victim->pop_front();
+    Counter("CachingReaderWorkerPool: Worker stolen by idle thread")++;
+    return pTask;
+}
+
+CachingReaderWorkerPool::Task* CachingReaderWorkerPool::takeQueuedHelper() {
+    if (m_helperQueue.empty()) {
+        return nullptr;
+    }
+    Task* pTask = m_helperQueue.front();
+    m_helperQueue.pop_front();
+    return pTask;
+}
+
+void CachingReaderWorkerPool::threadLoop(int threadIndex) {
+    auto locker = lockMutex(&m_mutex);
+    while (!m_quit) {
+        Task* pTask = takeQueuedTask(threadIndex);
+        if (!pTask) {
+            pTask = takeQueuedHelper();
+            if (pTask) {
+                ++pTask->runningHelpers;
+                locker.unlock();
+
+                pTask->pWorker->runHelper();
+
+                locker.relock();
+                --pTask->runningHelpers;
+                m_taskFinished.wakeAll();
+                continue;
+            }
+            ++m_idleThreads;
+            m_taskQueued.wait(&m_mutex);
+            --m_idleThreads;
+            continue;
+        }
+        DEBUG_ASSERT(pTask->state == TaskState::Queued);
+        pTask->state = TaskState::Running;
+        pTask->threadIndex = threadIndex;
+        locker.unlock();
+
+        const bool moreWork = pTask->pWorker->runTasks(kMaxTasksPerTurn);
+
+        locker.relock();
+        if (moreWork || pTask->state == TaskState::RunningRescheduled) {
+            // Requeue at the back to give other workers their turn
+            enqueue(pTask);
+        } else {
+            pTask->state = TaskState::Idle;
+        }
+        m_taskFinished.wakeAll();
+    }
+}
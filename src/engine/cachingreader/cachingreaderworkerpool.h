@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <deque>
+#include <memory>
+#include <vector>
+
+class CachingReaderWorker;
+
+// A bounded set of threads that runs the CachingReaderWorkers of all decks,
+// samplers and preview decks instead of a dedicated thread for each of them.
+//
+// Each worker is queued on the thread that has run it most recently, so the
+// decoder state of a track tends to stay on the same core. A thread without
+// queued workers steals the oldest worker from the longest queue of another
+// thread, so a burst of read requests for one deck does not need to wait
+// behind the requests of other decks.
+//
+// The SoundSources are not thread-safe. A worker is only ever run by a single
+// thread at a time. While a worker has more pending read requests than it can
+// serve at once it may request helpers (see requestHelper()). A helper runs
+// on an otherwise idle thread and decodes the chunks of the same track with
+// an additional SoundSource, so a burst of hinted chunks of a single deck is
+// decoded in parallel, too.
+//
+// A worker runs a limited number of tasks at a time and is requeued at the
+// back afterwards if it has more work, so all busy workers make progress.
+class CachingReaderWorkerPool {
+  public:
+    explicit CachingReaderWorkerPool(int numThreads);
+    ~CachingReaderWorkerPool();
+
+    // Returns the pool shared by all readers, creating it with the given
+    // number of threads if it does not exist. The pool is destroyed when
+    // the last reader releases it.
+    static std::shared_ptr<CachingReaderWorkerPool> shared(int numThreads);
+
+    int numThreads() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    void addWorker(CachingReaderWorker* pWorker);
+
+    // Queues the worker for running unless it is already queued. If the
+    // worker is currently running it will be run again afterwards.
+    // Workers that have not been added are ignored.
+    void schedule(CachingReaderWorker* pWorker);
+
+    // Queues CachingReaderWorker::runHelper() of the worker for an idle
+    // thread. Returns false without queueing anything if no thread is
+    // left idle. Queued workers are always run before queued helpers.
+    bool requestHelper(CachingReaderWorker* pWorker);
+
+    // Removes the worker and its helpers from the queues and waits until
+    // neither is running anymore. The worker is never run again afterwards.
+    void removeWorker(CachingReaderWorker* pWorker);
+
+  private:
+    class Thread;
+
+    enum class TaskState {
+        Idle,
+        Queued,
+        Running,
+        RunningRescheduled,
+    };
+
+    struct Task {
+        CachingReaderWorker* pWorker;
+        TaskState state;
+        // The thread that has run the worker most recently
+        int threadIndex;
+        int runningHelpers;
+    };
+
+    void threadLoop(int threadIndex);
+
+    // Must be called with m_mutex locked
+    Task* findTask(const CachingReaderWorker* pWorker);
+    Task* takeQueuedTask(int threadIndex);
+    Task* takeQueuedHelper();
+    void enqueue(Task* pTask);
+
+    std::vector<std::unique_ptr<Thread>> m_threads;
+
+    QMutex m_mutex;
+    QWaitCondition m_taskQueued;
+    QWaitCondition m_taskFinished;
+    // Stable addresses, because the queues reference the tasks
+    std::vector<std::unique_ptr<Task>> m_tasks;
+    std::vector<std::deque<Task*>> m_queues;
+    // A task is queued once for every requested helper
+    std::deque<Task*> m_helperQueue;
+    int m_idleThreads;
+    bool m_quit;
+};
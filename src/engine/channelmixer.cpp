@@ -61,38 +61,79 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
         const ChannelHandle& outputHandle,
         unsigned int iBufferSize,
         mixxx::audio::SampleRate sampleRate,
-        EngineEffectsManager* pEngineEffectsManager) {
+        EngineEffectsManager* pEngineEffectsManager,
+        RealtimeWorkerPool* pWorkerPool) {
+    applyEffectsInPlaceAndMixBuses(gainCalculator,
+            &activeChannels,
+            &pOutput,
+            1,
+            channelGainCache,
+            outputHandle,
+            iBufferSize,
+            sampleRate,
+            pEngineEffectsManager,
+            pWorkerPool);
+}
+
+// static
+void ChannelMixer::applyEffectsInPlaceAndMixBuses(
+        const EngineMixer::GainCalculator& gainCalculator,
+        const QVarLengthArray<EngineMixer::ChannelInfo*, kPreallocatedChannels>*
+                pActiveBusChannels,
+        CSAMPLE* const* pOutputs,
+        int numBuses,
+        QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>*
+                channelGainCache,
+        const ChannelHandle& outputHandle,
+        unsigned int iBufferSize,
+        mixxx::audio::SampleRate sampleRate,
+        EngineEffectsManager* pEngineEffectsManager,
+        RealtimeWorkerPool* pWorkerPool) {
     // Signal flow overview:
     // 1. Calculate gains for each channel
     // 2. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
     //    A) Applies the calculated gain to the channel buffer, modifying the original input buffer
     //    B) Applies effects to the buffer, modifying the original input buffer
-    // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
+    //    Independent channels are processed in parallel.
+    // 3. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
     ScopedTimer t(QStringLiteral("EngineMixer::applyEffectsInPlaceAndMixChannels"));
-    SampleUtil::clear(pOutput, iBufferSize);
-    for (auto* pChannelInfo : activeChannels) {
-        EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
-        CSAMPLE_GAIN oldGain = gainCache.m_gain;
-        CSAMPLE_GAIN newGain;
-        bool fadeout = gainCache.m_fadeout ||
-                (pChannelInfo->m_pChannel &&
-                        !pChannelInfo->m_pChannel->isActive());
-        if (fadeout) {
-            newGain = 0;
-            gainCache.m_fadeout = false;
-        } else {
-            newGain = gainCalculator.getGain(pChannelInfo);
+    QVarLengthArray<EngineEffectsManager::PostFaderJob, kPreallocatedChannels> jobs;
+    for (int bus = 0; bus < numBuses; ++bus) {
+        for (auto* pChannelInfo : pActiveBusChannels[bus]) {
+            EngineMixer::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
+            CSAMPLE_GAIN oldGain = gainCache.m_gain;
+            CSAMPLE_GAIN newGain;
+            bool fadeout = gainCache.m_fadeout ||
+                    (pChannelInfo->m_pChannel &&
+                            !pChannelInfo->m_pChannel->isActive());
+            if (fadeout) {
+                newGain = 0;
+                gainCache.m_fadeout = false;
+            } else {
+                newGain = gainCalculator.getGain(pChannelInfo);
+            }
+            gainCache.m_gain = newGain;
+            jobs.append(EngineEffectsManager::PostFaderJob{
+                    pChannelInfo->m_handle,
+                    pChannelInfo->m_pBuffer.data(),
+                    &pChannelInfo->m_features,
+                    oldGain,
+                    newGain,
+                    fadeout});
+        }
+    }
+    pEngineEffectsManager->processPostFaderInPlace(jobs.constData(),
+            static_cast<int>(jobs.size()),
+            outputHandle,
+            iBufferSize,
+            sampleRate,
+            pWorkerPool);
+
+    for (int bus = 0; bus < numBuses; ++bus) {
+        CSAMPLE* pOutput = pOutputs[bus];
+        SampleUtil::clear(pOutput, iBufferSize);
+        for (const auto* pChannelInfo : pActiveBusChannels[bus]) {
+            SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), iBufferSize);
         }
-        gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
-                outputHandle,
-                pChannelInfo->m_pBuffer.data(),
-                iBufferSize,
-                sampleRate,
-                pChannelInfo->m_features,
-                oldGain,
-                newGain,
-                fadeout);
-        SampleUtil::add(pOutput, pChannelInfo->m_pBuffer.data(), iBufferSize);
     }
 }
@@ -6,6 +6,8 @@
 #include "engine/enginemixer.h"
 #include "util/types.h"
 
+class RealtimeWorkerPool;
+
 class ChannelMixer {
   public:
     // This does not modify the input channel buffers. All manipulation of the input
@@ -23,6 +25,8 @@ class ChannelMixer {
             mixxx::audio::SampleRate sampleRate,
             EngineEffectsManager* pEngineEffectsManager);
     // This does modify the input channel buffers, then mixes them to make the output buffer.
+    // Channels that do not share an effect chain are processed in parallel on
+    // the pWorkerPool, if any.
     static void applyEffectsInPlaceAndMixChannels(
             const EngineMixer::GainCalculator& gainCalculator,
             const QVarLengthArray<EngineMixer::ChannelInfo*,
@@ -33,5 +37,23 @@ class ChannelMixer {
             const ChannelHandle& outputHandle,
             unsigned int iBufferSize,
             mixxx::audio::SampleRate sampleRate,
-            EngineEffectsManager* pEngineEffectsManager);
+            EngineEffectsManager* pEngineEffectsManager,
+            RealtimeWorkerPool* pWorkerPool = nullptr);
+    // Like applyEffectsInPlaceAndMixChannels() for several buses with one
+    // output buffer each, e.g. the crossfader orientation buses. The effects
+    // of the channels of all buses are processed at once, so that channels
+    // mixed into different buses are processed in parallel as well.
+    static void applyEffectsInPlaceAndMixBuses(
+            const EngineMixer::GainCalculator& gainCalculator,
+            const QVarLengthArray<EngineMixer::ChannelInfo*,
+                    kPreallocatedChannels>* pActiveBusChannels,
+            CSAMPLE* const* pOutputs,
+            int numBuses,
+            QVarLengthArray<EngineMixer::GainCache, kPreallocatedChannels>*
+                    channelGainCache,
+            const ChannelHandle& outputHandle,
+            unsigned int iBufferSize,
+            mixxx::audio::SampleRate sampleRate,
+            EngineEffectsManager* pEngineEffectsManager,
+            RealtimeWorkerPool* pWorkerPool = nullptr);
 };
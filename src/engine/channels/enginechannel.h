@@ -63,6 +63,23 @@ class EngineChannel : public EngineObject {
         m_channelIndex = channelIndex;
     }
 
+    // EngineMixer may split process() into processIndependent(), which runs
+    // on a worker thread concurrently with other channels, followed by
+    // processShared() on the engine thread in the same channel order as
+    // process() would be called. This is only done if canProcessIndependently()
+    // returned true at the beginning of the callback, and processIndependent()
+    // must not touch any state that is shared with other channels.
+    virtual bool canProcessIndependently() const {
+        return false;
+    }
+    virtual void processIndependent(CSAMPLE* pOut, const int iBufferSize) {
+        Q_UNUSED(pOut);
+        Q_UNUSED(iBufferSize);
+    }
+    virtual void processShared(CSAMPLE* pOut, const int iBufferSize) {
+        process(pOut, iBufferSize);
+    }
+
     virtual void postProcessLocalBpm() {
     }
 
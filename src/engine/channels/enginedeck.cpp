@@ -15,7 +15,8 @@ EngineDeck::EngineDeck(
         EngineMixer* pMixingEngine,
         EffectsManager* pEffectsManager,
         EngineChannel::ChannelOrientation defaultOrientation,
-        bool primaryDeck)
+        bool primaryDeck,
+        CachingReader::PlayerType playerType)
         : EngineChannel(handleGroup, defaultOrientation, pEffectsManager,
                   /*isTalkoverChannel*/ false,
                   primaryDeck),
@@ -27,6 +28,7 @@ EngineDeck::EngineDeck(
     m_pPassing->setButtonMode(ControlPushButton::POWERWINDOW);
     m_bPassthroughIsActive = false;
     m_bPassthroughWasActive = false;
+    m_bSharedProcessingPending = false;
 
     // Ensure that input is configured before enabling passthrough
     m_pPassing->connectValueChangeRequest(
@@ -35,7 +37,7 @@ EngineDeck::EngineDeck(
             Qt::DirectConnection);
 
     m_pPregain = new EnginePregain(getGroup());
-    m_pBuffer = new EngineBuffer(getGroup(), pConfig, this, pMixingEngine);
+    m_pBuffer = new EngineBuffer(getGroup(), pConfig, this, pMixingEngine, playerType);
 }
 
 EngineDeck::~EngineDeck() {
@@ -45,6 +47,27 @@ EngineDeck::~EngineDeck() {
 }
 
 void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
+    if (processSource(pOut, iBufferSize, false)) {
+        processEffectsAndVuMeter(pOut, iBufferSize);
+    }
+}
+
+bool EngineDeck::canProcessIndependently() const {
+    return m_pBuffer->canProcessIndependently();
+}
+
+void EngineDeck::processIndependent(CSAMPLE* pOut, const int iBufferSize) {
+    m_bSharedProcessingPending = processSource(pOut, iBufferSize, true);
+}
+
+void EngineDeck::processShared(CSAMPLE* pOut, const int iBufferSize) {
+    if (m_bSharedProcessingPending) {
+        m_bSharedProcessingPending = false;
+        processEffectsAndVuMeter(pOut, iBufferSize);
+    }
+}
+
+bool EngineDeck::processSource(CSAMPLE* pOut, const int iBufferSize, bool independent) {
     // Feed the incoming audio through if passthrough is active
     const CSAMPLE* sampleBuffer = m_sampleBuffer; // save pointer on stack
     if (isPassthroughActive() && sampleBuffer) {
@@ -57,18 +80,25 @@ void EngineDeck::process(CSAMPLE* pOut, const int iBufferSize) {
         if (m_bPassthroughWasActive) {
             SampleUtil::clear(pOut, iBufferSize);
             m_bPassthroughWasActive = false;
-            return;
+            return false;
         }
 
         // Process the raw audio
-        m_pBuffer->process(pOut, iBufferSize);
+        if (independent) {
+            m_pBuffer->processIndependently(pOut, iBufferSize);
+        } else {
+            m_pBuffer->process(pOut, iBufferSize);
+        }
         m_pPregain->setSpeedAndScratching(m_pBuffer->getSpeed(), m_pBuffer->getScratching());
         m_bPassthroughWasActive = false;
     }
 
     // Apply pregain
     m_pPregain->process(pOut, iBufferSize);
+    return true;
+}
 
+void EngineDeck::processEffectsAndVuMeter(CSAMPLE* pOut, const int iBufferSize) {
     EngineEffectsManager* pEngineEffectsManager = m_pEffectsManager->getEngineEffectsManager();
     if (pEngineEffectsManager != nullptr) {
         pEngineEffectsManager->processPreFaderInPlace(m_group.handle(),
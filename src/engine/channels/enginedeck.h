@@ -3,6 +3,7 @@
 #include <QScopedPointer>
 
 #include "preferences/usersettings.h"
+#include "engine/cachingreader/cachingreader.h"
 #include "engine/channels/enginechannel.h"
 #include "soundio/soundmanagerutil.h"
 
@@ -20,10 +21,14 @@ class EngineDeck : public EngineChannel, public AudioDestination {
             EngineMixer* pMixingEngine,
             EffectsManager* pEffectsManager,
             EngineChannel::ChannelOrientation defaultOrientation,
-            bool primaryDeck);
+            bool primaryDeck,
+            CachingReader::PlayerType playerType = CachingReader::PlayerType::Deck);
     ~EngineDeck() override;
 
     void process(CSAMPLE* pOutput, const int iBufferSize) override;
+    bool canProcessIndependently() const override;
+    void processIndependent(CSAMPLE* pOutput, const int iBufferSize) override;
+    void processShared(CSAMPLE* pOutput, const int iBufferSize) override;
     void collectFeatures(GroupFeatureState* pGroupFeatures) const override;
 
     // postProcessLocalBpm() is called on all decks to update the localBpm after
@@ -70,6 +75,13 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     void slotPassthroughChangeRequest(double v);
 
   private:
+    // Plays the track or passes through the input and applies the pregain.
+    // Returns false if the buffer has been cleared and the remaining
+    // processing must be skipped.
+    bool processSource(CSAMPLE* pOut, const int iBufferSize, bool independent);
+    // Applies the prefader effects and updates the VU meter.
+    void processEffectsAndVuMeter(CSAMPLE* pOut, const int iBufferSize);
+
     UserSettingsPointer m_pConfig;
     EngineBuffer* m_pBuffer;
     EnginePregain* m_pPregain;
@@ -79,4 +91,7 @@ class EngineDeck : public EngineChannel, public AudioDestination {
     ControlPushButton* m_pPassing;
     bool m_bPassthroughIsActive;
     bool m_bPassthroughWasActive;
+
+    // Result of processSource() when called from processIndependent()
+    bool m_bSharedProcessingPending;
 };
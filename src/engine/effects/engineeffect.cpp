@@ -4,6 +4,7 @@
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/engine.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 
 namespace {
@@ -11,6 +12,12 @@ namespace {
 // Used during initialization where the SoundSevice is not set up
 constexpr auto kInitalSampleRate = mixxx::audio::SampleRate(96000);
 
+// -100 dBFS, far below the noise floor of any source
+constexpr CSAMPLE kSilenceThreshold = 0.00001f;
+
+// The weight of the last buffer in the running average of the processing time
+constexpr double kProcessingTimeSmoothing = 0.05;
+
 } // namespace
 
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
@@ -20,6 +27,8 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_pManifest(pManifest),
           m_pProcessor(pBackendManager->createProcessor(pManifest)),
+          m_processingNanosPerFrame(0),
+          m_lastSavedNanos(0),
           m_parameters(pManifest->parameters().size()) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
@@ -35,6 +44,12 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
             outputChannelMap.insert(outputChannel.handle(), EffectEnableState::Disabled);
         }
         m_effectEnableStateForChannelMatrix.insert(inputChannel.handle(), outputChannelMap);
+
+        ChannelHandleMap<SINT> silentFramesMap;
+        for (const ChannelHandleAndGroup& outputChannel : registeredOutputChannels) {
+            silentFramesMap.insert(outputChannel.handle(), 0);
+        }
+        m_silentFramesForChannelMatrix.insert(inputChannel.handle(), silentFramesMap);
     }
 
     m_pProcessor->loadEngineEffectParameters(m_parametersById);
@@ -177,20 +192,70 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
     }
 
     bool processingOccured = false;
+    m_lastSavedNanos = 0;
 
     if (effectiveEffectEnableState != EffectEnableState::Disabled) {
         //TODO: refactor rest of audio engine to use mixxx::AudioParameters
         const mixxx::EngineParameters engineParameters(
                 sampleRate,
                 numSamples / mixxx::kEngineChannelCount);
+        const SINT numFrames = engineParameters.framesPerBuffer();
+
+        // Once the input and the output have been silent for longer than the
+        // tail of the effect, processing would only produce silence. The
+        // effect sleeps until the input is no longer silent. Intermediate
+        // states are always processed, so the EffectProcessor can reset.
+        SINT& silentFrames = m_silentFramesForChannelMatrix[inputHandle][outputHandle];
+        const bool mayFallAsleep = m_pManifest->hasKnownTailLength() &&
+                effectiveEffectEnableState == EffectEnableState::Enabled;
+        bool inputIsSilent = false;
+        bool sleeping = false;
+        if (mayFallAsleep) {
+            inputIsSilent = SampleUtil::maxAbsAmplitude(pInput, numSamples) <=
+                    kSilenceThreshold;
+            if (!inputIsSilent) {
+                silentFrames = 0;
+            } else if (silentFrames >
+                    m_pManifest->tailLengthSeconds() * sampleRate.value()) {
+                sleeping = true;
+            }
+        } else {
+            silentFrames = 0;
+        }
+
+        if (sleeping) {
+            SampleUtil::clear(pOutput, numSamples);
+            m_lastSavedNanos = static_cast<qint64>(
+                    m_processingNanosPerFrame * numFrames);
+        } else {
+            PerformanceTimer timer;
+            if (mayFallAsleep) {
+                timer.start();
+            }
 
-        m_pProcessor->process(inputHandle,
-                outputHandle,
-                pInput,
-                pOutput,
-                engineParameters,
-                effectiveEffectEnableState,
-                groupFeatures);
+            m_pProcessor->process(inputHandle,
+                    outputHandle,
+                    pInput,
+                    pOutput,
+                    engineParameters,
+                    effectiveEffectEnableState,
+                    groupFeatures);
+
+            if (mayFallAsleep) {
+                const double nanosPerFrame =
+                        static_cast<double>(timer.elapsed().toIntegerNanos()) /
+                        numFrames;
+                m_processingNanosPerFrame +=
+                        kProcessingTimeSmoothing * (nanosPerFrame - m_processingNanosPerFrame);
+                if (inputIsSilent &&
+                        SampleUtil::maxAbsAmplitude(pOutput, numSamples) <=
+                                kSilenceThreshold) {
+                    silentFrames += numFrames;
+                } else {
+                    silentFrames = 0;
+                }
+            }
+        }
 
         processingOccured = true;
 
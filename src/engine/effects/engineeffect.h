@@ -58,6 +58,13 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pProcessor->getGroupDelayFrames();
     }
 
+    /// The estimated processing time that has been saved in the last call of
+    /// process(), because the effect was sleeping for the channel.
+    /// Called in audio thread
+    qint64 lastSavedNanos() const {
+        return m_lastSavedNanos;
+    }
+
   private:
     QString debugString() const {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
@@ -66,7 +73,14 @@ class EngineEffect final : public EffectsRequestHandler {
     EffectManifestPointer m_pManifest;
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
+    // The number of frames the input and the output have been silent for.
+    // The effect sleeps for the channel when this exceeds the tail length.
+    ChannelHandleMap<ChannelHandleMap<SINT>> m_silentFramesForChannelMatrix;
     bool m_effectRampsFromDry;
+    // A running average of the processing time, used for the estimate of the
+    // time saved by sleeping
+    double m_processingNanosPerFrame;
+    qint64 m_lastSavedNanos;
     // Must not be modified after construction.
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
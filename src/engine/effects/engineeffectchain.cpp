@@ -3,11 +3,17 @@
 #include "engine/effects/engineeffect.h"
 #include "util/defs.h"
 #include "util/sample.h"
+#include "util/stat.h"
 
 EngineEffectChain::EngineEffectChain(const QString& group,
         const QSet<ChannelHandleAndGroup>& registeredInputChannels,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_group(group),
+          m_profileSection(EngineProfiler::registerSection(
+                  QStringLiteral("EffectChain"), group)),
+          m_savedTimeStatKey(QStringLiteral("EffectChain %1 time saved by sleeping effects")
+                          .arg(group)),
+          m_savedNanos(0),
           m_enableState(EffectEnableState::Enabled),
           m_mixMode(EffectChainMixMode::DrySlashWet),
           m_dMix(0),
@@ -171,6 +177,37 @@ bool EngineEffectChain::disableForInputChannel(ChannelHandle inputHandle) {
     return true;
 }
 
+bool EngineEffectChain::touchesSharedState(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    if (m_enableState == EffectEnableState::Enabling ||
+            m_enableState == EffectEnableState::Disabling) {
+        // process() completes the transition of the chain
+        return true;
+    }
+    if (!inputHandle.valid() || !outputHandle.valid() ||
+            inputHandle.handle() >= m_chainStatusForChannelMatrix.size()) {
+        // process() would expand the matrix or use the shared dummy entry
+        return true;
+    }
+    const auto& outputMap = m_chainStatusForChannelMatrix.at(inputHandle);
+    if (outputHandle.handle() >= outputMap.size()) {
+        return true;
+    }
+    return m_enableState != EffectEnableState::Disabled &&
+            outputMap.at(outputHandle).enableState != EffectEnableState::Disabled;
+}
+
+void EngineEffectChain::reportSavedProcessingTime() {
+    if (m_savedNanos == 0) {
+        return;
+    }
+    Stat::track(m_savedTimeStatKey,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::SUM | Stat::AVERAGE),
+            static_cast<double>(m_savedNanos));
+    m_savedNanos = 0;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -213,6 +250,11 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
 
     bool processingOccured = false;
     if (effectiveChainEnableState != EffectEnableState::Disabled) {
+        // Only recorded here, because the chain is only guaranteed to be
+        // processed by a single thread at a time if it is active for the
+        // channel, see touchesSharedState().
+        ScopedEngineProfile profile(m_profileSection);
+
         // Ramping code inside the effects need to access the original samples
         // after writing to the output buffer. This requires not to use the same buffer
         // for in and output: Also, ChannelMixer::applyEffectsAndMixChannels
@@ -239,6 +281,7 @@ bool EngineEffectChain::process(const ChannelHandle& inputHandle,
                             sampleRate,
                             effectiveChainEnableState,
                             groupFeatures)) {
+                    m_savedNanos += pEffect->lastSavedNanos();
                     if (pEffect->getManifest()->addDryToWet()) {
                         // Skip adding the dry signal to the effect's wet output
                         // when it is the first addDryToWet type effect in
@@ -7,6 +7,7 @@
 #include "engine/channelhandle.h"
 #include "engine/effects/engineeffectsdelay.h"
 #include "engine/effects/message.h"
+#include "engine/engineprofiler.h"
 #include "util/class.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
@@ -35,6 +36,15 @@ class EngineEffectChain final : public EffectsRequestHandler {
             EffectsRequest& message,
             EffectsResponsePipe* pResponsePipe) override;
 
+    /// Returns true if process() for the given channels touches the state
+    /// that is shared by all channels, i.e. the buffers of the chain and the
+    /// effects, or the enable state of the chain. Otherwise process() only
+    /// updates the state of the given channels and may run concurrently with
+    /// process() for other channels.
+    /// called from audio thread
+    bool touchesSharedState(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+
     /// called from audio thread
     bool process(const ChannelHandle& inputHandle,
             const ChannelHandle& outputHandle,
@@ -45,6 +55,11 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const GroupFeatureState& groupFeatures,
             bool fadeout);
 
+    /// Reports the estimated processing time that has been saved by sleeping
+    /// effects since the last call, see EffectManifest::tailLengthSeconds().
+    /// called from audio thread, but not from the worker threads
+    void reportSavedProcessingTime();
+
   private:
     struct ChannelStatus {
         ChannelStatus()
@@ -66,6 +81,9 @@ class EngineEffectChain final : public EffectsRequestHandler {
     bool disableForInputChannel(ChannelHandle inputHandle);
 
     QString m_group;
+    const EngineProfiler::SectionId m_profileSection;
+    const QString m_savedTimeStatKey;
+    qint64 m_savedNanos;
     EffectEnableState m_enableState;
     EffectChainMixMode::Type m_mixMode;
     CSAMPLE m_dMix;
@@ -3,15 +3,25 @@
 #include "audio/types.h"
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/realtimeworkerpool.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// More channels are processed serially
+constexpr int kMaxParallelJobs = 64;
+
+} // namespace
+
 EngineEffectsManager::EngineEffectsManager(std::unique_ptr<EffectsResponsePipe> pResponsePipe)
         : m_pResponsePipe(std::move(pResponsePipe)),
           m_buffer1(kMaxEngineSamples),
           m_buffer2(kMaxEngineSamples) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
+    m_jobGroups.reserve(kMaxParallelJobs);
+    m_groupIndices.reserve(kMaxParallelJobs);
 }
 
 void EngineEffectsManager::onCallbackStart() {
@@ -90,6 +100,14 @@ void EngineEffectsManager::onCallbackStart() {
             m_pResponsePipe->writeMessage(response);
         }
     }
+
+    // The chains may be processed by worker threads, so the time saved during
+    // the last callback is reported from here.
+    for (const auto& chains : std::as_const(m_chainsByStage)) {
+        for (EngineEffectChain* pChain : chains) {
+            pChain->reportSavedProcessingTime();
+        }
+    }
 }
 
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
@@ -133,6 +151,96 @@ void EngineEffectsManager::processPostFaderInPlace(
             fadeout);
 }
 
+void EngineEffectsManager::processPostFaderInPlace(
+        const PostFaderJob* pJobs,
+        int numJobs,
+        const ChannelHandle& outputHandle,
+        unsigned int numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        RealtimeWorkerPool* pWorkerPool) {
+    const QList<EngineEffectChain*> chains =
+            m_chainsByStage.value(SignalProcessingStage::Postfader);
+    auto processJob = [&](int index) {
+        const PostFaderJob& job = pJobs[index];
+        processInPlace(chains,
+                job.inputHandle,
+                outputHandle,
+                job.pInOut,
+                numSamples,
+                sampleRate,
+                *job.pGroupFeatures,
+                job.oldGain,
+                job.newGain,
+                job.fadeout);
+    };
+
+    const int numGroups = pWorkerPool && numJobs > 1 && numJobs <= kMaxParallelJobs
+            ? groupPostFaderJobs(pJobs, numJobs, chains, outputHandle)
+            : 1;
+    if (numGroups < 2) {
+        for (int i = 0; i < numJobs; ++i) {
+            processJob(i);
+        }
+        return;
+    }
+
+    // The jobs of a group keep their order
+    auto processGroup = [&](int group) {
+        for (int i = 0; i < numJobs; ++i) {
+            if (m_jobGroups[i] == group) {
+                processJob(i);
+            }
+        }
+    };
+    pWorkerPool->parallelFor(numGroups, processGroup);
+}
+
+int EngineEffectsManager::groupPostFaderJobs(const PostFaderJob* pJobs,
+        int numJobs,
+        const QList<EngineEffectChain*>& chains,
+        const ChannelHandle& outputHandle) {
+    DEBUG_ASSERT(numJobs <= kMaxParallelJobs);
+    // Start with one group per job, labeled by the index of the job, and
+    // merge the groups of all jobs for which a chain is active.
+    m_jobGroups.resize(numJobs);
+    for (int i = 0; i < numJobs; ++i) {
+        m_jobGroups[i] = i;
+    }
+    for (const EngineEffectChain* pChain : chains) {
+        if (!pChain) {
+            continue;
+        }
+        int label = -1;
+        for (int i = 0; i < numJobs; ++i) {
+            if (!pChain->touchesSharedState(pJobs[i].inputHandle, outputHandle)) {
+                continue;
+            }
+            const int jobLabel = m_jobGroups[i];
+            if (label < 0) {
+                label = jobLabel;
+            } else if (jobLabel != label) {
+                for (int j = 0; j < numJobs; ++j) {
+                    if (m_jobGroups[j] == jobLabel) {
+                        m_jobGroups[j] = label;
+                    }
+                }
+            }
+        }
+    }
+
+    // Number the groups consecutively
+    m_groupIndices.assign(numJobs, -1);
+    int numGroups = 0;
+    for (int i = 0; i < numJobs; ++i) {
+        int& groupIndex = m_groupIndices[m_jobGroups[i]];
+        if (groupIndex < 0) {
+            groupIndex = numGroups++;
+        }
+        m_jobGroups[i] = groupIndex;
+    }
+    return numGroups;
+}
+
 void EngineEffectsManager::processPostFaderAndMix(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
@@ -172,22 +280,16 @@ void EngineEffectsManager::processInner(
     const QList<EngineEffectChain*>& chains = m_chainsByStage.value(stage);
 
     if (pIn == pOut) {
-        // Gain and effects are applied to the buffer in place,
-        // modifying the original input buffer
-        SampleUtil::applyRampingGain(pIn, oldGain, newGain, numSamples);
-        for (EngineEffectChain* pChain : chains) {
-            if (pChain) {
-                if (pChain->process(inputHandle,
-                            outputHandle,
-                            pIn,
-                            pOut,
-                            numSamples,
-                            sampleRate,
-                            groupFeatures,
-                            fadeout)) {
-                }
-            }
-        }
+        processInPlace(chains,
+                inputHandle,
+                outputHandle,
+                pIn,
+                numSamples,
+                sampleRate,
+                groupFeatures,
+                oldGain,
+                newGain,
+                fadeout);
     } else {
         // Do not modify the input buffer.
         // 1. Copy input buffer to a temporary buffer
@@ -234,6 +336,34 @@ void EngineEffectsManager::processInner(
     }
 }
 
+void EngineEffectsManager::processInPlace(
+        const QList<EngineEffectChain*>& chains,
+        const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle,
+        CSAMPLE* pInOut,
+        unsigned int numSamples,
+        mixxx::audio::SampleRate sampleRate,
+        const GroupFeatureState& groupFeatures,
+        CSAMPLE_GAIN oldGain,
+        CSAMPLE_GAIN newGain,
+        bool fadeout) {
+    // Gain and effects are applied to the buffer in place,
+    // modifying the original input buffer
+    SampleUtil::applyRampingGain(pInOut, oldGain, newGain, numSamples);
+    for (EngineEffectChain* pChain : chains) {
+        if (pChain) {
+            pChain->process(inputHandle,
+                    outputHandle,
+                    pInOut,
+                    pInOut,
+                    numSamples,
+                    sampleRate,
+                    groupFeatures,
+                    fadeout);
+        }
+    }
+}
+
 bool EngineEffectsManager::addEffectChain(EngineEffectChain* pChain,
         SignalProcessingStage stage) {
     QList<EngineEffectChain*>& chains = m_chainsByStage[stage];
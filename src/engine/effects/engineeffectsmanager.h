@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include "audio/types.h"
 #include "engine/channelhandle.h"
 #include "engine/effects/message.h"
@@ -8,6 +10,7 @@
 
 class EngineEffectChain;
 class EngineEffect;
+class RealtimeWorkerPool;
 struct GroupFeatureState;
 
 /// EngineEffectsManager is the entry point for processing effects in the audio
@@ -47,6 +50,32 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// The buffer of a channel for processPostFaderInPlace(const PostFaderJob*, ...)
+    struct PostFaderJob {
+        ChannelHandle inputHandle;
+        CSAMPLE* pInOut;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+    };
+
+    /// Process the postfader EngineEffectChains on the buffers of several
+    /// channels in place, with the same result as calling the overload above
+    /// for each of them in order.
+    ///
+    /// Channels that have no active effect chain in common are independent
+    /// and are processed in parallel on the pWorkerPool, if any. The channels
+    /// that share a chain, e.g. two decks routed to the same effect unit,
+    /// are processed one after the other in the given order by one thread.
+    void processPostFaderInPlace(
+            const PostFaderJob* pJobs,
+            int numJobs,
+            const ChannelHandle& outputHandle,
+            unsigned int numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            RealtimeWorkerPool* pWorkerPool);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
@@ -95,10 +124,34 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    // The in-place branch of processInner(). It does not touch any member, so
+    // it can be called for several channels concurrently.
+    static void processInPlace(const QList<EngineEffectChain*>& chains,
+            const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle,
+            CSAMPLE* pInOut,
+            unsigned int numSamples,
+            mixxx::audio::SampleRate sampleRate,
+            const GroupFeatureState& groupFeatures,
+            CSAMPLE_GAIN oldGain,
+            CSAMPLE_GAIN newGain,
+            bool fadeout);
+
+    // Splits the jobs into groups of jobs that share an active chain and
+    // returns the number of groups. m_jobGroups[i] is the group of job i.
+    int groupPostFaderJobs(const PostFaderJob* pJobs,
+            int numJobs,
+            const QList<EngineEffectChain*>& chains,
+            const ChannelHandle& outputHandle);
+
     std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
     QHash<SignalProcessingStage, QList<EngineEffectChain*>> m_chainsByStage;
     QList<EngineEffect*> m_effects;
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    // Preallocated for groupPostFaderJobs()
+    std::vector<int> m_jobGroups;
+    std::vector<int> m_groupIndices;
 };
@@ -7,6 +7,7 @@
 #include "control/controlproxy.h"
 #include "control/controlpushbutton.h"
 #include "engine/bufferscalers/enginebufferscalelinear.h"
+#include "engine/bufferscalers/enginebufferscalesinc.h"
 #include "engine/bufferscalers/enginebufferscalest.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/channels/enginechannel.h"
@@ -59,8 +60,11 @@ const QString kAppGroup = QStringLiteral("[App]");
 EngineBuffer::EngineBuffer(const QString& group,
         UserSettingsPointer pConfig,
         EngineChannel* pChannel,
-        EngineMixer* pMixingEngine)
+        EngineMixer* pMixingEngine,
+        CachingReader::PlayerType playerType)
         : m_group(group),
+          m_profileSection(EngineProfiler::registerSection(
+                  QStringLiteral("EngineBuffer"), group)),
           m_pConfig(pConfig),
           m_pLoopingControl(nullptr),
           m_pSyncControl(nullptr),
@@ -102,7 +106,7 @@ EngineBuffer::EngineBuffer(const QString& group,
     // zero out crossfade buffer
     SampleUtil::clear(m_pCrossfadeBuffer, kMaxEngineSamples);
 
-    m_pReader = new CachingReader(group, pConfig);
+    m_pReader = new CachingReader(group, pConfig, playerType);
     connect(m_pReader, &CachingReader::trackLoading,
             this, &EngineBuffer::slotTrackLoading,
             Qt::DirectConnection);
@@ -256,14 +260,21 @@ EngineBuffer::EngineBuffer(const QString& group,
     m_pKeylockEngine->connectValueChanged(this,
             &EngineBuffer::slotKeylockEngineChanged,
             Qt::DirectConnection);
+    m_pVinylScaler = new ControlProxy(kAppGroup, QStringLiteral("vinyl_scaler"), this);
+    m_pVinylScaler->connectValueChanged(this,
+            &EngineBuffer::slotVinylScalerChanged,
+            Qt::DirectConnection);
     // Construct scaling objects
     m_pScaleLinear = new EngineBufferScaleLinear(m_pReadAheadManager);
+    m_pScaleSinc = new EngineBufferScaleSinc(m_pReadAheadManager);
     m_pScaleST = new EngineBufferScaleST(m_pReadAheadManager);
 #ifdef __RUBBERBAND__
     m_pScaleRB = new EngineBufferScaleRubberBand(m_pReadAheadManager);
+    m_pScaleRB->setLookahead(pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("keylock_lookahead_ms")), 0));
 #endif
     slotKeylockEngineChanged(m_pKeylockEngine->get());
-    m_pScaleVinyl = m_pScaleLinear;
+    slotVinylScalerChanged(m_pVinylScaler->get());
     m_pScale = m_pScaleVinyl;
     m_pScale->clear();
     m_bScalerChanged = true;
@@ -311,6 +322,7 @@ EngineBuffer::~EngineBuffer() {
     delete m_pTrackSampleRate;
 
     delete m_pScaleLinear;
+    delete m_pScaleSinc;
     delete m_pScaleST;
 #ifdef __RUBBERBAND__
     delete m_pScaleRB;
@@ -326,7 +338,16 @@ EngineBuffer::~EngineBuffer() {
 
 void EngineBuffer::bindWorkers(EngineWorkerScheduler* pWorkerScheduler) {
     m_pReader->setScheduler(pWorkerScheduler);
+#ifdef __RUBBERBAND__
+    m_pScaleRB->setScheduler(pWorkerScheduler);
+#endif
+}
+
+#ifdef __RUBBERBAND__
+void EngineBuffer::bindRubberBandBatch(RubberBandBatch* pBatch) {
+    m_pScaleRB->setBatch(pBatch);
 }
+#endif
 
 void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
                                                       const int iBufferSize) {
@@ -842,6 +863,31 @@ void EngineBuffer::slotKeylockEngineChanged(double dIndex) {
     }
 }
 
+void EngineBuffer::slotVinylScalerChanged(double dIndex) {
+    if (m_bScalerOverride) {
+        return;
+    }
+    const VinylScaler scaler = static_cast<VinylScaler>(dIndex);
+    switch (scaler) {
+    case VinylScaler::SincShort:
+        m_pScaleSinc->setQuality(EngineBufferScaleSinc::Quality::Short);
+        m_pScaleVinyl = m_pScaleSinc;
+        break;
+    case VinylScaler::SincMedium:
+        m_pScaleSinc->setQuality(EngineBufferScaleSinc::Quality::Medium);
+        m_pScaleVinyl = m_pScaleSinc;
+        break;
+    case VinylScaler::SincLong:
+        m_pScaleSinc->setQuality(EngineBufferScaleSinc::Quality::Long);
+        m_pScaleVinyl = m_pScaleSinc;
+        break;
+    case VinylScaler::Linear:
+    default:
+        m_pScaleVinyl = m_pScaleLinear;
+        break;
+    }
+}
+
 void EngineBuffer::processTrackLocked(
         CSAMPLE* pOutput, const int iBufferSize, mixxx::audio::SampleRate sampleRate) {
     ScopedTimer t(QStringLiteral("EngineBuffer::process_pauselock"));
@@ -1009,6 +1055,11 @@ void EngineBuffer::processTrackLocked(
             readToCrossfadeBuffer(iBufferSize);
             // Clear the scaler information
             m_pScale->clear();
+        } else if (m_pScale->hasLookahead()) {
+            // Drop the audio that has been stretched ahead with the old
+            // parameters and continue from the current position
+            readToCrossfadeBuffer(iBufferSize);
+            m_pScale->clear();
         }
 
         m_baserate_old = baseSampleRate;
@@ -1041,6 +1092,15 @@ void EngineBuffer::processTrackLocked(
         rate = m_rate_old;
     }
 
+    if (m_pScale->hasLookahead() &&
+            m_pReadAheadManager->hasReadPastLoop(rate < 0, m_playPos)) {
+        // The loop has been set behind the audio that has been stretched
+        // ahead. Drop it, so the loop is taken when reading again from the
+        // current position.
+        readToCrossfadeBuffer(iBufferSize);
+        m_pScale->clear();
+    }
+
     const mixxx::audio::FramePos playpos_old = m_playPos;
     bool bCurBufferPaused = false;
     bool atEnd = false;
@@ -1147,6 +1207,7 @@ void EngineBuffer::processTrackLocked(
 }
 
 void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
+    ScopedEngineProfile profile(m_profileSection);
     // Bail if we receive a buffer size with incomplete sample frames. Assert in debug builds.
     VERIFY_OR_DEBUG_ASSERT((iBufferSize % kSamplesPerFrame) == 0) {
         return;
@@ -1168,6 +1229,7 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     // it doesn't reallocate when the user engages keylock during playback.
     // We do this even if rubberband is not active.
     m_pScaleLinear->setSampleRate(m_sampleRate);
+    m_pScaleSinc->setSampleRate(m_sampleRate);
     m_pScaleST->setSampleRate(m_sampleRate);
 #ifdef __RUBBERBAND__
     m_pScaleRB->setSampleRate(m_sampleRate);
@@ -1214,6 +1276,31 @@ void EngineBuffer::process(CSAMPLE* pOutput, const int iBufferSize) {
     m_bCrossfadeReady = false;
 }
 
+bool EngineBuffer::canProcessIndependently() const {
+    return m_pSyncControl->getSyncMode() == SyncMode::None &&
+            !hasQueuedRequestsInvolvingOtherDecks();
+}
+
+void EngineBuffer::processIndependently(CSAMPLE* pOutput, const int iBufferSize) {
+    m_bProcessingIndependently = true;
+    process(pOutput, iBufferSize);
+    m_bProcessingIndependently = false;
+}
+
+bool EngineBuffer::hasQueuedRequestsInvolvingOtherDecks() const {
+    if (m_iEnableSyncQueued.loadAcquire() != SYNC_REQUEST_NONE ||
+            static_cast<SyncMode>(m_iSyncModeQueued.loadAcquire()) !=
+                    SyncMode::Invalid ||
+            m_iSeekPhaseQueued.loadAcquire() != 0) {
+        return true;
+    }
+    // Phase seeks need the beat distance of other decks and clone seeks
+    // their play position.
+    const SeekRequests seekType = m_queuedSeek.getValue().seekType;
+    return seekType.testFlag(SEEK_PHASE) || seekType.testFlag(SEEK_CLONE) ||
+            (seekType.testFlag(SEEK_STANDARD) && m_pQuantize->toBool());
+}
+
 void EngineBuffer::processSlip(int iBufferSize) {
     // Do a single read from m_bSlipEnabled so we don't run in to race conditions.
     bool enabled = m_pSlipButton->toBool();
@@ -1261,6 +1348,11 @@ void EngineBuffer::processSlip(int iBufferSize) {
 }
 
 void EngineBuffer::processSyncRequests() {
+    if (m_bProcessingIndependently) {
+        // Requests queued since canProcessIndependently() was checked are
+        // processed in the next callback.
+        return;
+    }
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
                     m_iEnableSyncQueued.fetchAndStoreRelease(SYNC_REQUEST_NONE));
@@ -1290,6 +1382,12 @@ void EngineBuffer::processSyncRequests() {
 void EngineBuffer::processSeek(bool paused) {
     m_previousBufferSeek = false;
 
+    if (m_bProcessingIndependently && hasQueuedRequestsInvolvingOtherDecks()) {
+        // Queued since canProcessIndependently() was checked, process it in
+        // the next callback.
+        return;
+    }
+
     const QueuedSeek queuedSeek = m_queuedSeek.getValue();
 
     SeekRequests seekType = queuedSeek.seekType;
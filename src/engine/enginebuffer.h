@@ -11,6 +11,7 @@
 #include "control/controlvalue.h"
 #include "engine/cachingreader/cachingreader.h"
 #include "engine/engineobject.h"
+#include "engine/engineprofiler.h"
 #include "engine/slipmodestate.h"
 #include "engine/sync/syncable.h"
 #include "preferences/usersettings.h"
@@ -45,6 +46,7 @@ class ControlPushButton;
 class ControlPotmeter;
 class EngineBufferScale;
 class EngineBufferScaleLinear;
+class EngineBufferScaleSinc;
 class EngineBufferScaleST;
 class EngineSync;
 class EngineWorkerScheduler;
@@ -99,13 +101,27 @@ class EngineBuffer : public EngineObject {
 #endif
     };
 
+    // The scaler that is used when keylock is off.
+    // This enum is also used in mixxx.cfg
+    // Don't remove or swap values to keep backward compatibility
+    enum class VinylScaler {
+        Linear = 0,
+        SincShort = 1,
+        SincMedium = 2,
+        SincLong = 3,
+    };
+
     EngineBuffer(const QString& group,
             UserSettingsPointer pConfig,
             EngineChannel* pChannel,
-            EngineMixer* pMixingEngine);
+            EngineMixer* pMixingEngine,
+            CachingReader::PlayerType playerType = CachingReader::PlayerType::Deck);
     virtual ~EngineBuffer();
 
     void bindWorkers(EngineWorkerScheduler* pWorkerScheduler);
+#ifdef __RUBBERBAND__
+    void bindRubberBandBatch(RubberBandBatch* pBatch);
+#endif
 
     QString getGroup() const;
     // Return the current rate (not thread-safe)
@@ -133,6 +149,15 @@ class EngineBuffer : public EngineObject {
 
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const int iBufferSize) override;
+    /// Returns true if process() will not touch any state shared with other
+    /// decks, i.e. the deck is not synchronized and no sync, phase or clone
+    /// request is queued. EngineMixer may then process this deck on a worker
+    /// thread, concurrently with other decks.
+    bool canProcessIndependently() const;
+    /// Same as process(), but requests involving other decks that have been
+    /// queued after canProcessIndependently() was checked are postponed to
+    /// the next callback.
+    void processIndependently(CSAMPLE* pOut, const int iBufferSize);
     void processSlip(int iBufferSize);
     void postProcessLocalBpm();
     void postProcess(const int iBufferSize);
@@ -229,6 +254,7 @@ class EngineBuffer : public EngineObject {
     void slotControlEnd(double);
     void slotControlSeek(double);
     void slotKeylockEngineChanged(double);
+    void slotVinylScalerChanged(double);
 
   signals:
     void trackLoaded(TrackPointer pNewTrack, TrackPointer pOldTrack);
@@ -278,6 +304,7 @@ class EngineBuffer : public EngineObject {
 
     void processSyncRequests();
     void processSeek(bool paused);
+    bool hasQueuedRequestsInvolvingOtherDecks() const;
     // For debugging / testing -- returns true if the previous buffer call resulted in a seek.
     FRIEND_TEST(EngineSyncTest, FollowerUserTweakPreservedInSyncDisable);
     bool previousBufferSeek() const {
@@ -292,6 +319,7 @@ class EngineBuffer : public EngineObject {
 
     // Holds the name of the control group
     const QString m_group;
+    const EngineProfiler::SectionId m_profileSection;
     int m_channelIndex;
 
     UserSettingsPointer m_pConfig;
@@ -394,6 +422,7 @@ class EngineBuffer : public EngineObject {
     ControlPotmeter* m_playposSlider;
     ControlProxy* m_pSampleRate;
     ControlProxy* m_pKeylockEngine;
+    ControlProxy* m_pVinylScaler;
     ControlPushButton* m_pKeylock;
     ControlProxy* m_pReplayGain;
 
@@ -420,13 +449,15 @@ class EngineBuffer : public EngineObject {
     FRIEND_TEST(EngineBufferTest, ReadFadeOut);
     FRIEND_TEST(EngineBufferTest, RateTempTest);
     FRIEND_TEST(EngineBufferTest, RatePermTest);
-    EngineBufferScale* m_pScaleVinyl;
-    // The keylock engine is configurable, so it could flip flop between
-    // ScaleST and ScaleRB during a single callback.
+    // The vinyl and keylock scalers are configurable, so they could flip
+    // flop between ScaleLinear and ScaleSinc or ScaleST and ScaleRB during
+    // a single callback.
+    EngineBufferScale* volatile m_pScaleVinyl;
     EngineBufferScale* volatile m_pScaleKeylock;
 
-    // Object used for vinyl-style interpolation scaling of the audio
+    // Objects used for vinyl-style interpolation scaling of the audio
     EngineBufferScaleLinear* m_pScaleLinear;
+    EngineBufferScaleSinc* m_pScaleSinc;
     // Objects used for pitch-indep time stretch (key lock) scaling of the audio
     EngineBufferScaleST* m_pScaleST;
 #ifdef __RUBBERBAND__
@@ -443,6 +474,8 @@ class EngineBuffer : public EngineObject {
     QAtomicInt m_iSyncModeQueued;
     ControlValueAtomic<QueuedSeek> m_queuedSeek;
     bool m_previousBufferSeek = false;
+    // Set while running from processIndependently()
+    bool m_bProcessingIndependently = false;
 
     /// Indicates that no seek is queued
     static constexpr QueuedSeek kNoQueuedSeek = {mixxx::audio::kInvalidFramePos, SEEK_NONE};
@@ -12,16 +12,23 @@
 #include "engine/enginedelay.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
+#include "engine/engineprofiler.h"
 #include "engine/engineworkerscheduler.h"
 #include "engine/enginexfader.h"
+#include "engine/realtimeworkerpool.h"
 #include "engine/sidechain/enginesidechain.h"
 #include "engine/sync/enginesync.h"
 #include "mixer/playermanager.h"
 #include "moc_enginemixer.cpp"
 #include "preferences/usersettings.h"
 #include "util/defs.h"
+#include "util/realtimesafety.h"
 #include "util/sample.h"
 
+#ifdef __RUBBERBAND__
+#include "engine/bufferscalers/rubberbandbatch.h"
+#endif
+
 namespace {
 const QString kAppGroup = QStringLiteral("[App]");
 const QString kLegacyGroup = QStringLiteral("[Master]");
@@ -36,6 +43,19 @@ EngineMixer::EngineMixer(
         bool bEnableSidechain)
         : m_pChannelHandleFactory(pChannelHandleFactory),
           m_pEngineEffectsManager(pEffectsManager->getEngineEffectsManager()),
+          m_pProfilerControls(std::make_unique<EngineProfilerControls>()),
+          m_profileProcess(EngineProfiler::registerSection(
+                  QStringLiteral("EngineMixer"))),
+          m_profileChannels(EngineProfiler::registerSection(
+                  QStringLiteral("EngineMixer_Channels"))),
+          m_profileHeadphoneMix(EngineProfiler::registerSection(
+                  QStringLiteral("ChannelMixer_Headphone"))),
+          m_profileTalkoverMix(EngineProfiler::registerSection(
+                  QStringLiteral("ChannelMixer_Talkover"))),
+          m_profileBusMix(EngineProfiler::registerSection(
+                  QStringLiteral("ChannelMixer_Bus"))),
+          m_profileSideChain(EngineProfiler::registerSection(
+                  QStringLiteral("SideChain_Write"))),
           m_mainGainOld(0.0),
           m_boothGainOld(0.0),
           m_headphoneMainGainOld(0.0),
@@ -67,6 +87,14 @@ EngineMixer::EngineMixer(
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
 
+    setChannelProcessingThreads(pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("channel_processing_threads")), 0));
+#ifdef __RUBBERBAND__
+    m_pKeylockBatch = std::make_unique<RubberBandBatch>();
+    setKeylockBatchThreads(pConfig->getValue(
+            ConfigKey(kAppGroup, QStringLiteral("keylock_batch_threads")), 0));
+#endif
+
     // Main sample rate
     m_pSampleRate = new ControlObject(
             ConfigKey(kAppGroup, QStringLiteral("samplerate")), true, true);
@@ -186,6 +214,10 @@ EngineMixer::EngineMixer(
     m_pKeylockEngine->set(static_cast<double>(
             pConfig->getValue(ConfigKey(group, "keylock_engine"),
                     EngineBuffer::defaultKeylockEngine())));
+    m_pVinylScaler = new ControlObject(ConfigKey(kAppGroup, QStringLiteral("vinyl_scaler")));
+    m_pVinylScaler->set(static_cast<double>(
+            pConfig->getValue(ConfigKey(group, "vinyl_scaler"),
+                    EngineBuffer::VinylScaler::Linear)));
 
     // TODO: Make this read only and make EngineMixer decide whether
     // processing the main mix is necessary.
@@ -210,6 +242,7 @@ EngineMixer::EngineMixer(
 EngineMixer::~EngineMixer() {
     // qDebug() << "in ~EngineMixer()";
     delete m_pKeylockEngine;
+    delete m_pVinylScaler;
     delete m_pCrossfader;
     delete m_pBalance;
     delete m_pHeadMix;
@@ -359,19 +392,10 @@ void EngineMixer::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
-        pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
-        }
+    if (m_pChannelProcessingPool) {
+        processActiveChannelsParallel(activeChannelsStartIndex, iBufferSize);
+    } else {
+        processActiveChannelsSerial(activeChannelsStartIndex, iBufferSize);
     }
 
     // Do internal sync lock post-processing before the other
@@ -399,6 +423,75 @@ void EngineMixer::processChannels(int iBufferSize) {
     }
 }
 
+void EngineMixer::processActiveChannelsSerial(int startIndex, int iBufferSize) {
+    for (int i = startIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        EngineChannel* pChannel = pChannelInfo->m_pChannel;
+        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
+        pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
+
+        // Collect metadata for effects
+        if (m_pEngineEffectsManager) {
+            GroupFeatureState features;
+            pChannel->collectFeatures(&features);
+            pChannelInfo->m_features = features;
+        }
+    }
+}
+
+void EngineMixer::processActiveChannelsParallel(int startIndex, int iBufferSize) {
+    // Decide up front which channels are independent. A sync request or seek
+    // arriving while the workers are running is postponed by the channel.
+    m_independentChannels.clear();
+    for (int i = startIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        pChannelInfo->m_bProcessIndependently =
+                pChannelInfo->m_pChannel->canProcessIndependently();
+        if (pChannelInfo->m_bProcessIndependently) {
+            m_independentChannels.append(pChannelInfo);
+        }
+    }
+
+    if (m_independentChannels.size() < 2) {
+        // Nothing to gain, fall back to the serial path.
+        for (ChannelInfo* pChannelInfo : std::as_const(m_independentChannels)) {
+            pChannelInfo->m_bProcessIndependently = false;
+        }
+        processActiveChannelsSerial(startIndex, iBufferSize);
+        return;
+    }
+
+    auto processIndependent = [this, iBufferSize](int index) {
+        ChannelInfo* pChannelInfo = m_independentChannels[index];
+        DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
+        pChannelInfo->m_pChannel->processIndependent(
+                pChannelInfo->m_pBuffer.data(), iBufferSize);
+    };
+    m_pChannelProcessingPool->parallelFor(
+            static_cast<int>(m_independentChannels.size()), processIndependent);
+
+    // All remaining work is done in the same order as in the serial path,
+    // so that the output is bit-identical.
+    for (int i = startIndex; i < m_activeChannels.size(); ++i) {
+        ChannelInfo* pChannelInfo = m_activeChannels[i];
+        EngineChannel* pChannel = pChannelInfo->m_pChannel;
+        if (pChannelInfo->m_bProcessIndependently) {
+            pChannelInfo->m_bProcessIndependently = false;
+            pChannel->processShared(pChannelInfo->m_pBuffer.data(), iBufferSize);
+        } else {
+            DEBUG_ASSERT(pChannelInfo->m_pBuffer.size() >= iBufferSize);
+            pChannel->process(pChannelInfo->m_pBuffer.data(), iBufferSize);
+        }
+
+        // Collect metadata for effects
+        if (m_pEngineEffectsManager) {
+            GroupFeatureState features;
+            pChannel->collectFeatures(&features);
+            pChannelInfo->m_features = features;
+        }
+    }
+}
+
 void EngineMixer::process(const int iBufferSize) {
     DEBUG_ASSERT(iBufferSize <= static_cast<int>(kMaxEngineSamples));
 
@@ -408,6 +501,8 @@ void EngineMixer::process(const int iBufferSize) {
         haveSetName = true;
     }
     // Trace t("EngineMixer::process");
+    ScopedRealtimeSection realtimeSection;
+    m_callbackTimer.start();
 
     bool mainEnabled = m_pMainEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
@@ -418,12 +513,34 @@ void EngineMixer::process(const int iBufferSize) {
     constexpr unsigned int kChannels = 2;
     const unsigned int iFrames = iBufferSize / kChannels;
 
+    ScopedEngineProfile profileProcess(m_profileProcess);
+    if (EngineProfiler::isEnabled() && m_sampleRate.isValid()) {
+        EngineProfiler::setCallbackBudgetNs(
+                static_cast<std::uint64_t>(iFrames) * 1000000000 / m_sampleRate.value());
+    }
+
     if (m_pEngineEffectsManager) {
         m_pEngineEffectsManager->onCallbackStart();
     }
 
     // Prepare all channels for output
-    processChannels(iBufferSize);
+    {
+        ScopedEngineProfile profile(m_profileChannels);
+        processChannels(iBufferSize);
+    }
+
+#ifdef __RUBBERBAND__
+    // Time stretch the input that the keylocked decks queued for the next
+    // callback. This must be done before the end of the callback period.
+    if (m_pKeylockBatch->numJobs() > 0) {
+        m_pKeylockBatch->process(m_pKeylockBatchPool.get(),
+                m_callbackTimer,
+                m_sampleRate.isValid()
+                        ? mixxx::Duration::fromNanos(static_cast<qint64>(iFrames) *
+                                  1000000000 / m_sampleRate.value())
+                        : mixxx::Duration::fromSeconds(1));
+    }
+#endif
 
     // Compute headphone mix
     // Head phone left/right mix
@@ -444,15 +561,18 @@ void EngineMixer::process(const int iBufferSize) {
         // Process effects and mix PFL channels together for the headphones.
         // Effects will be reprocessed post-fader for the crossfader buses
         // and main mix, so the channel input buffers cannot be modified here.
-        ChannelMixer::applyEffectsAndMixChannels(
-                m_headphoneGain,
-                m_activeHeadphoneChannels,
-                &m_channelHeadphoneGainCache,
-                m_head.data(),
-                m_headphoneHandle.handle(),
-                iBufferSize,
-                m_sampleRate,
-                m_pEngineEffectsManager);
+        {
+            ScopedEngineProfile profile(m_profileHeadphoneMix);
+            ChannelMixer::applyEffectsAndMixChannels(
+                    m_headphoneGain,
+                    m_activeHeadphoneChannels,
+                    &m_channelHeadphoneGainCache,
+                    m_head.data(),
+                    m_headphoneHandle.handle(),
+                    iBufferSize,
+                    m_sampleRate,
+                    m_pEngineEffectsManager);
+        }
 
         // Process headphone channel effects
         if (m_pEngineEffectsManager) {
@@ -478,15 +598,19 @@ void EngineMixer::process(const int iBufferSize) {
 
     // Mix all the talkover enabled channels together.
     // Effects processing is done in place to avoid unnecessary buffer copying.
-    ChannelMixer::applyEffectsInPlaceAndMixChannels(
-            m_talkoverGain,
-            m_activeTalkoverChannels,
-            &m_channelTalkoverGainCache,
-            m_talkover.data(),
-            m_mainHandle.handle(),
-            iBufferSize,
-            m_sampleRate,
-            m_pEngineEffectsManager);
+    {
+        ScopedEngineProfile profile(m_profileTalkoverMix);
+        ChannelMixer::applyEffectsInPlaceAndMixChannels(
+                m_talkoverGain,
+                m_activeTalkoverChannels,
+                &m_channelTalkoverGainCache,
+                m_talkover.data(),
+                m_mainHandle.handle(),
+                iBufferSize,
+                m_sampleRate,
+                m_pEngineEffectsManager,
+                m_pChannelProcessingPool.get());
+    }
 
     // Process effects on all microphones mixed together
     // We have no metadata for mixed effect buses, so use an empty GroupFeatureState.
@@ -537,16 +661,24 @@ void EngineMixer::process(const int iBufferSize) {
             crossfaderRightGain,
             m_pTalkoverDucking->getGain(iFrames));
 
-    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
-        ChannelMixer::applyEffectsInPlaceAndMixChannels(m_mainGain,
-                m_activeBusChannels[o],
-                &m_channelMainGainCache, // no [o] because the old gain
-                                         // follows an orientation switch
-                m_outputBusBuffers[o].data(),
+    {
+        ScopedEngineProfile profile(m_profileBusMix);
+        CSAMPLE* const outputBusBuffers[] = {
+                m_outputBusBuffers[EngineChannel::LEFT].data(),
+                m_outputBusBuffers[EngineChannel::CENTER].data(),
+                m_outputBusBuffers[EngineChannel::RIGHT].data(),
+        };
+        ChannelMixer::applyEffectsInPlaceAndMixBuses(m_mainGain,
+                m_activeBusChannels,
+                outputBusBuffers,
+                3,
+                &m_channelMainGainCache, // shared by the buses because the old
+                                         // gain follows an orientation switch
                 m_mainHandle.handle(),
                 iBufferSize,
                 m_sampleRate,
-                m_pEngineEffectsManager);
+                m_pEngineEffectsManager,
+                m_pChannelProcessingPool.get());
     }
 
     // Process crossfader orientation bus channel effects
@@ -754,6 +886,7 @@ void EngineMixer::process(const int iBufferSize) {
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
         if (m_pEngineSideChain) {
+            ScopedEngineProfile profile(m_profileSideChain);
             m_pEngineSideChain->writeSamples(m_sidechainMix.data(), iFrames);
         }
 
@@ -905,12 +1038,46 @@ void EngineMixer::addChannel(EngineChannel* pChannel) {
     m_activeBusChannels[EngineChannel::RIGHT].reserve(m_channels.size());
     m_activeHeadphoneChannels.reserve(m_channels.size());
     m_activeTalkoverChannels.reserve(m_channels.size());
+    m_independentChannels.reserve(m_channels.size());
 
     EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
     if (pBuffer != nullptr) {
         pBuffer->bindWorkers(m_pWorkerScheduler);
+#ifdef __RUBBERBAND__
+        pBuffer->bindRubberBandBatch(m_pKeylockBatch.get());
+#endif
+    }
+}
+
+void EngineMixer::setChannelProcessingThreads(int numThreads) {
+    if (numThreads <= 0) {
+        m_pChannelProcessingPool.reset();
+        return;
+    }
+    if (m_pChannelProcessingPool &&
+            m_pChannelProcessingPool->numThreads() == numThreads) {
+        return;
+    }
+    qDebug() << "EngineMixer: Processing independent channels with"
+             << numThreads << "worker threads";
+    m_pChannelProcessingPool = std::make_unique<RealtimeWorkerPool>(numThreads);
+}
+
+#ifdef __RUBBERBAND__
+void EngineMixer::setKeylockBatchThreads(int numThreads) {
+    if (numThreads <= 0) {
+        m_pKeylockBatch->setEnabled(false);
+        m_pKeylockBatchPool.reset();
+        return;
+    }
+    if (!m_pKeylockBatchPool || m_pKeylockBatchPool->numThreads() != numThreads) {
+        qDebug() << "EngineMixer: Time stretching keylocked decks with"
+                 << numThreads << "worker threads";
+        m_pKeylockBatchPool = std::make_unique<RealtimeWorkerPool>(numThreads);
     }
+    m_pKeylockBatch->setEnabled(true);
 }
+#endif
 
 EngineChannel* EngineMixer::getChannel(const QString& group) {
     for (const ChannelInfo* pChannelInfo : m_channels) {
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QVarLengthArray>
 #include <atomic>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/controlobject.h"
@@ -11,13 +12,17 @@
 #include "engine/channels/enginechannel.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/engineobject.h"
+#include "engine/engineprofiler.h"
 #include "preferences/usersettings.h"
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/performancetimer.h"
 #include "util/samplebuffer.h"
 
 class EngineWorkerScheduler;
+class RealtimeWorkerPool;
+class RubberBandBatch;
 class EngineVuMeter;
 class ControlPotmeter;
 class ControlPushButton;
@@ -70,6 +75,23 @@ class EngineMixer : public QObject, public AudioSource {
     // only call it before the engine has started mixing.
     void addChannel(EngineChannel* pChannel);
     EngineChannel* getChannel(const QString& group);
+
+    // Use numThreads worker threads in addition to the engine thread for
+    // processing channels that are independent of each other, e.g. decks that
+    // are not synchronized. With 0 threads all channels are processed serially
+    // on the engine thread. This is not thread safe -- only call it while the
+    // engine is not mixing.
+    void setChannelProcessingThreads(int numThreads);
+
+#ifdef __RUBBERBAND__
+    // Time stretch all keylocked decks that use RubberBand together once all
+    // channels have been processed, on numThreads worker threads in addition
+    // to the engine thread. This adds one buffer of latency to these decks.
+    // With 0 threads each deck is stretched while it is processed. This is
+    // not thread safe -- only call it while the engine is not mixing.
+    void setKeylockBatchThreads(int numThreads);
+#endif
+
     static inline CSAMPLE_GAIN gainForOrientation(EngineChannel::ChannelOrientation orientation,
             CSAMPLE_GAIN leftGain,
             CSAMPLE_GAIN centerGain,
@@ -110,7 +132,8 @@ class EngineMixer : public QObject, public AudioSource {
                 : m_pChannel(NULL),
                   m_pVolumeControl(NULL),
                   m_pMuteControl(NULL),
-                  m_index(index) {
+                  m_index(index),
+                  m_bProcessIndependently(false) {
         }
         ChannelHandle m_handle;
         EngineChannel* m_pChannel;
@@ -119,6 +142,9 @@ class EngineMixer : public QObject, public AudioSource {
         ControlPushButton* m_pMuteControl;
         GroupFeatureState m_features;
         int m_index;
+        // Whether the channel is processed by the RealtimeWorkerPool in the
+        // current callback.
+        bool m_bProcessIndependently;
     };
 
     struct GainCache {
@@ -257,6 +283,12 @@ class EngineMixer : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(int iBufferSize);
+    void processActiveChannelsSerial(int startIndex, int iBufferSize);
+    // Processes channels that are independent of each other concurrently on
+    // m_pChannelProcessingPool and everything else on the engine thread. The
+    // order of all operations that touch shared state, like effects and sync,
+    // is the same as in processActiveChannelsSerial().
+    void processActiveChannelsParallel(int startIndex, int iBufferSize);
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMainEffects(int bufferSize);
@@ -281,6 +313,7 @@ class EngineMixer : public QObject, public AudioSource {
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeBusChannels[3];
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeHeadphoneChannels;
     QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_activeTalkoverChannels;
+    QVarLengthArray<ChannelInfo*, kPreallocatedChannels> m_independentChannels;
 
     mixxx::audio::SampleRate m_sampleRate;
 
@@ -293,6 +326,20 @@ class EngineMixer : public QObject, public AudioSource {
     mixxx::SampleBuffer m_sidechainMix;
 
     EngineWorkerScheduler* m_pWorkerScheduler;
+    std::unique_ptr<RealtimeWorkerPool> m_pChannelProcessingPool;
+#ifdef __RUBBERBAND__
+    std::unique_ptr<RubberBandBatch> m_pKeylockBatch;
+    std::unique_ptr<RealtimeWorkerPool> m_pKeylockBatchPool;
+#endif
+    PerformanceTimer m_callbackTimer;
+
+    std::unique_ptr<EngineProfilerControls> m_pProfilerControls;
+    const EngineProfiler::SectionId m_profileProcess;
+    const EngineProfiler::SectionId m_profileChannels;
+    const EngineProfiler::SectionId m_profileHeadphoneMix;
+    const EngineProfiler::SectionId m_profileTalkoverMix;
+    const EngineProfiler::SectionId m_profileBusMix;
+    const EngineProfiler::SectionId m_profileSideChain;
     EngineSync* m_pEngineSync;
 
     ControlObject* m_pMainGain;
@@ -321,6 +368,7 @@ class EngineMixer : public QObject, public AudioSource {
     ControlPushButton* m_pXFaderReverse;
     ControlPushButton* m_pHeadSplitEnabled;
     ControlObject* m_pKeylockEngine;
+    ControlObject* m_pVinylScaler;
 
     PflGainCalculator m_headphoneGain;
     TalkoverGainCalculator m_talkoverGain;
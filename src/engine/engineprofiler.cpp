@@ -0,0 +1,297 @@
+#include "engine/engineprofiler.h"
+
+#include <QMutex>
+#include <QtDebug>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "control/controlobject.h"
+#include "control/controlpushbutton.h"
+#include "moc_engineprofiler.cpp"
+#include "util/assert.h"
+
+namespace {
+
+const QString kProfilerGroup = QStringLiteral("[EngineProfiler]");
+
+constexpr int kUpdateIntervalMillis = 500;
+
+struct Section {
+    // Written once before the section is published by s_numSections
+    QString name;
+    std::atomic<std::uint64_t> count;
+    std::atomic<std::uint64_t> totalNs;
+    std::atomic<std::uint64_t> maxNs;
+    std::atomic<std::uint64_t> lastNs;
+    std::array<std::atomic<std::uint64_t>, EngineProfiler::kHistogramBins> histogram;
+};
+
+// All slots are allocated statically, so recording never allocates
+Section s_sections[EngineProfiler::kMaxSections];
+std::atomic<int> s_numSections(0);
+QMutex s_registerMutex;
+
+int histogramBin(std::uint64_t elapsedNs) {
+    const int bin = std::bit_width(elapsedNs >> 10);
+    return std::min(bin, EngineProfiler::kHistogramBins - 1);
+}
+
+std::uint64_t histogramBinUpperBoundNs(int bin) {
+    return std::uint64_t{1024} << bin;
+}
+
+// Single writer per section, so a plain load/store is sufficient and cheaper
+// than a read-modify-write.
+inline void increment(std::atomic<std::uint64_t>* pValue, std::uint64_t delta) {
+    pValue->store(pValue->load(std::memory_order_relaxed) + delta,
+            std::memory_order_relaxed);
+}
+
+QString sanitizedName(const QString& name) {
+    QString result;
+    result.reserve(name.size());
+    for (const QChar c : name) {
+        if (c.isLetterOrNumber()) {
+            result.append(c);
+        } else if (!result.isEmpty() && !result.endsWith(QChar('_'))) {
+            result.append(QChar('_'));
+        }
+    }
+    while (result.endsWith(QChar('_'))) {
+        result.chop(1);
+    }
+    return result;
+}
+
+} // namespace
+
+std::atomic<bool> EngineProfiler::s_enabled(false);
+std::atomic<std::uint64_t> EngineProfiler::s_callbackBudgetNs(0);
+
+std::uint64_t EngineProfiler::Snapshot::percentileNs(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+    std::uint64_t histogramCount = 0;
+    for (const auto binCount : histogram) {
+        histogramCount += binCount;
+    }
+    const auto threshold = std::max(std::uint64_t{1},
+            static_cast<std::uint64_t>(std::ceil(
+                    std::clamp(percentile, 0.0, 1.0) * histogramCount)));
+    std::uint64_t accumulated = 0;
+    for (int bin = 0; bin < kHistogramBins; ++bin) {
+        accumulated += histogram[bin];
+        if (accumulated >= threshold) {
+            return std::min(histogramBinUpperBoundNs(bin), maxNs);
+        }
+    }
+    return maxNs;
+}
+
+// static
+EngineProfiler::SectionId EngineProfiler::registerSection(const QString& name) {
+    const QMutexLocker lock(&s_registerMutex);
+    const int numSections = s_numSections.load(std::memory_order_relaxed);
+    for (int i = 0; i < numSections; ++i) {
+        if (s_sections[i].name == name) {
+            return i;
+        }
+    }
+    VERIFY_OR_DEBUG_ASSERT(numSections < kMaxSections) {
+        qWarning() << "EngineProfiler: No free slot for section" << name;
+        return kInvalidSectionId;
+    }
+    s_sections[numSections].name = name;
+    s_numSections.store(numSections + 1, std::memory_order_release);
+    return numSections;
+}
+
+// static
+EngineProfiler::SectionId EngineProfiler::registerSection(
+        const QString& prefix, const QString& group) {
+    return registerSection(sanitizedName(prefix + QChar('_') + group));
+}
+
+// static
+void EngineProfiler::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+// static
+void EngineProfiler::record(SectionId id, std::uint64_t elapsedNs) {
+    if (id < 0 || id >= kMaxSections) {
+        return;
+    }
+    Section& section = s_sections[id];
+    increment(&section.count, 1);
+    increment(&section.totalNs, elapsedNs);
+    increment(&section.histogram[histogramBin(elapsedNs)], 1);
+    section.lastNs.store(elapsedNs, std::memory_order_relaxed);
+    if (elapsedNs > section.maxNs.load(std::memory_order_relaxed)) {
+        section.maxNs.store(elapsedNs, std::memory_order_relaxed);
+    }
+}
+
+// static
+int EngineProfiler::numSections() {
+    return s_numSections.load(std::memory_order_acquire);
+}
+
+// static
+EngineProfiler::Snapshot EngineProfiler::snapshot(SectionId id) {
+    Snapshot result{};
+    VERIFY_OR_DEBUG_ASSERT(id >= 0 && id < numSections()) {
+        return result;
+    }
+    const Section& section = s_sections[id];
+    result.name = section.name;
+    result.count = section.count.load(std::memory_order_relaxed);
+    result.totalNs = section.totalNs.load(std::memory_order_relaxed);
+    result.maxNs = section.maxNs.load(std::memory_order_relaxed);
+    result.lastNs = section.lastNs.load(std::memory_order_relaxed);
+    for (int bin = 0; bin < kHistogramBins; ++bin) {
+        result.histogram[bin] = section.histogram[bin].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+// static
+void EngineProfiler::reset() {
+    const int sectionCount = numSections();
+    for (int i = 0; i < sectionCount; ++i) {
+        Section& section = s_sections[i];
+        section.count.store(0, std::memory_order_relaxed);
+        section.totalNs.store(0, std::memory_order_relaxed);
+        section.maxNs.store(0, std::memory_order_relaxed);
+        section.lastNs.store(0, std::memory_order_relaxed);
+        for (auto& binCount : section.histogram) {
+            binCount.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+// static
+void EngineProfiler::dump() {
+    const double budgetUs =
+            s_callbackBudgetNs.load(std::memory_order_relaxed) / 1000.0;
+    qInfo() << "EngineProfiler: callback budget" << budgetUs << "us";
+    const int sectionCount = numSections();
+    for (int i = 0; i < sectionCount; ++i) {
+        const Snapshot stats = snapshot(i);
+        if (stats.count == 0) {
+            continue;
+        }
+        const double meanUs = stats.meanNs() / 1000.0;
+        QString histogram;
+        for (int bin = 0; bin < kHistogramBins; ++bin) {
+            if (stats.histogram[bin] > 0) {
+                histogram += QStringLiteral(" <%1us:%2")
+                                     .arg(histogramBinUpperBoundNs(bin) / 1000)
+                                     .arg(stats.histogram[bin]);
+            }
+        }
+        qInfo().noquote()
+                << QStringLiteral("EngineProfiler: %1 count %2 mean %3us "
+                                  "p99 %4us max %5us budget %6%")
+                           .arg(stats.name)
+                           .arg(stats.count)
+                           .arg(meanUs, 0, 'f', 1)
+                           .arg(stats.percentileNs(0.99) / 1000.0, 0, 'f', 1)
+                           .arg(stats.maxNs / 1000.0, 0, 'f', 1)
+                           .arg(budgetUs > 0 ? 100 * meanUs / budgetUs : 0.0,
+                                   0,
+                                   'f',
+                                   2)
+                << histogram;
+    }
+}
+
+EngineProfilerControls::EngineProfilerControls()
+        : m_pEnabled(std::make_unique<ControlPushButton>(
+                  ConfigKey(kProfilerGroup, QStringLiteral("enabled")))),
+          m_pDump(std::make_unique<ControlPushButton>(
+                  ConfigKey(kProfilerGroup, QStringLiteral("dump")))),
+          m_pReset(std::make_unique<ControlPushButton>(
+                  ConfigKey(kProfilerGroup, QStringLiteral("reset")))),
+          m_wasEnabled(EngineProfiler::isEnabled()) {
+    m_pEnabled->setButtonMode(ControlPushButton::TOGGLE);
+    m_pEnabled->set(EngineProfiler::isEnabled() ? 1.0 : 0.0);
+    connect(m_pEnabled.get(),
+            &ControlObject::valueChanged,
+            this,
+            &EngineProfilerControls::slotEnabled);
+    connect(m_pDump.get(),
+            &ControlObject::valueChanged,
+            this,
+            &EngineProfilerControls::slotDump);
+    connect(m_pReset.get(),
+            &ControlObject::valueChanged,
+            this,
+            &EngineProfilerControls::slotReset);
+
+    m_sectionControls.reserve(EngineProfiler::kMaxSections);
+    connect(&m_updateTimer,
+            &QTimer::timeout,
+            this,
+            &EngineProfilerControls::slotUpdate);
+    if (EngineProfiler::isEnabled()) {
+        m_updateTimer.start(kUpdateIntervalMillis);
+    }
+}
+
+EngineProfilerControls::~EngineProfilerControls() {
+    // Only undo what has been toggled through these controls. The engine
+    // may outlive them in tests and keeps recording if it did before.
+    EngineProfiler::setEnabled(m_wasEnabled);
+}
+
+void EngineProfilerControls::slotEnabled(double value) {
+    const bool enabled = value > 0;
+    EngineProfiler::setEnabled(enabled);
+    if (enabled) {
+        m_updateTimer.start(kUpdateIntervalMillis);
+    } else {
+        m_updateTimer.stop();
+        // Publish the final values
+        slotUpdate();
+    }
+}
+
+void EngineProfilerControls::slotDump(double value) {
+    if (value > 0) {
+        EngineProfiler::dump();
+    }
+}
+
+void EngineProfilerControls::slotReset(double value) {
+    if (value > 0) {
+        EngineProfiler::reset();
+        slotUpdate();
+    }
+}
+
+void EngineProfilerControls::slotUpdate() {
+    const int sectionCount = EngineProfiler::numSections();
+    for (int i = 0; i < sectionCount; ++i) {
+        const EngineProfiler::Snapshot stats = EngineProfiler::snapshot(i);
+        if (i >= static_cast<int>(m_sectionControls.size())) {
+            // Sections are only appended, so the indices stay in sync
+            const auto createControl = [&stats](const QString& suffix) {
+                auto pControl = std::make_unique<ControlObject>(
+                        ConfigKey(kProfilerGroup, stats.name + suffix));
+                pControl->setReadOnly();
+                return pControl;
+            };
+            m_sectionControls.push_back(SectionControls{
+                    createControl(QStringLiteral("_mean_us")),
+                    createControl(QStringLiteral("_p99_us")),
+                    createControl(QStringLiteral("_max_us"))});
+        }
+        const SectionControls& controls = m_sectionControls[i];
+        controls.pMeanUs->forceSet(stats.meanNs() / 1000.0);
+        controls.pP99Us->forceSet(stats.percentileNs(0.99) / 1000.0);
+        controls.pMaxUs->forceSet(stats.maxNs / 1000.0);
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ControlObject;
+class ControlPushButton;
+
+/// EngineProfiler records the wall time spent in the parts of the audio
+/// callback (EngineBuffer, effect chains, channel mixing, side chain, the
+/// whole device callback, ...) into fixed-size histograms.
+///
+/// Sections are registered from the main thread while the engine objects are
+/// constructed. Recording a sample from the engine thread is lock-free and
+/// does not allocate: it only touches the preallocated slot of the section.
+/// While the profiler is disabled, recording costs a single relaxed atomic
+/// load, so the scopes can stay in the code permanently.
+///
+/// Sections may nest, e.g. the post-fader effect chains are contained in the
+/// ChannelMixer sections and everything is contained in the device callback.
+class EngineProfiler {
+  public:
+    using SectionId = int;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr SectionId kInvalidSectionId = -1;
+    static constexpr int kMaxSections = 256;
+    /// Bin 0 holds samples below 1024 ns, bin i > 0 holds samples in
+    /// [2^(i-1), 2^i) * 1024 ns. The last bin collects everything above.
+    static constexpr int kHistogramBins = 24;
+
+    struct Snapshot {
+        QString name;
+        std::uint64_t count;
+        std::uint64_t totalNs;
+        std::uint64_t maxNs;
+        std::uint64_t lastNs;
+        std::array<std::uint64_t, kHistogramBins> histogram;
+
+        double meanNs() const {
+            return count > 0 ? static_cast<double>(totalNs) / count : 0.0;
+        }
+        /// Upper bound of the histogram bin containing the given percentile
+        /// (0.0 .. 1.0), limited by the measured maximum.
+        std::uint64_t percentileNs(double percentile) const;
+    };
+
+    /// Returns the id of the section with the given name, creating it if
+    /// necessary. Registering the same name twice returns the same id, so
+    /// recreating an engine object continues the existing statistics.
+    /// Returns kInvalidSectionId if all kMaxSections slots are taken.
+    /// Must not be called from the engine thread.
+    static SectionId registerSection(const QString& name);
+    /// Convenience overload for per-group objects, e.g. ("EngineBuffer",
+    /// "[Channel1]") registers "EngineBuffer_Channel1".
+    static SectionId registerSection(const QString& prefix, const QString& group);
+
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enabled);
+
+    /// Stores a single sample. A section must not be recorded concurrently
+    /// from several threads, which holds for all engine objects because each
+    /// of them is processed by one thread at a time.
+    static void record(SectionId id, std::uint64_t elapsedNs);
+
+    /// The duration of a single audio callback, used as reference in dump().
+    static void setCallbackBudgetNs(std::uint64_t budgetNs) {
+        s_callbackBudgetNs.store(budgetNs, std::memory_order_relaxed);
+    }
+
+    static int numSections();
+    static Snapshot snapshot(SectionId id);
+    /// Clears the statistics of all sections. The registered sections are
+    /// kept. Samples recorded concurrently may be partially lost.
+    static void reset();
+    /// Logs a table of all sections with recorded samples.
+    static void dump();
+
+  private:
+    static std::atomic<bool> s_enabled;
+    static std::atomic<std::uint64_t> s_callbackBudgetNs;
+};
+
+/// Records the lifetime of the scope into the given section if the profiler
+/// is enabled.
+class ScopedEngineProfile {
+  public:
+    explicit ScopedEngineProfile(EngineProfiler::SectionId id)
+            : m_id(id),
+              m_enabled(EngineProfiler::isEnabled()) {
+        if (m_enabled) {
+            m_start = EngineProfiler::Clock::now();
+        }
+    }
+    ~ScopedEngineProfile() {
+        if (m_enabled) {
+            const auto elapsed = EngineProfiler::Clock::now() - m_start;
+            EngineProfiler::record(m_id,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                            .count());
+        }
+    }
+
+    ScopedEngineProfile(const ScopedEngineProfile&) = delete;
+    ScopedEngineProfile& operator=(const ScopedEngineProfile&) = delete;
+
+  private:
+    const EngineProfiler::SectionId m_id;
+    const bool m_enabled;
+    EngineProfiler::Clock::time_point m_start;
+};
+
+/// Publishes the profiler results as read-only controls in the
+/// [EngineProfiler] group. For each section <name> the controls
+/// <name>_mean_us, <name>_p99_us and <name>_max_us are created on the
+/// first update after the section was registered. They are refreshed from
+/// the main thread while the profiler is enabled, so the engine thread never
+/// touches them.
+///
+/// [EngineProfiler],enabled toggles the profiler, [EngineProfiler],dump logs
+/// the histograms and [EngineProfiler],reset clears them. When the controls
+/// are destroyed the profiler is restored to the state it had before they
+/// were created.
+class EngineProfilerControls : public QObject {
+    Q_OBJECT
+  public:
+    EngineProfilerControls();
+    ~EngineProfilerControls() override;
+
+  private slots:
+    void slotEnabled(double value);
+    void slotDump(double value);
+    void slotReset(double value);
+    void slotUpdate();
+
+  private:
+    struct SectionControls {
+        std::unique_ptr<ControlObject> pMeanUs;
+        std::unique_ptr<ControlObject> pP99Us;
+        std::unique_ptr<ControlObject> pMaxUs;
+    };
+
+    std::unique_ptr<ControlPushButton> m_pEnabled;
+    std::unique_ptr<ControlPushButton> m_pDump;
+    std::unique_ptr<ControlPushButton> m_pReset;
+    std::vector<SectionControls> m_sectionControls;
+    QTimer m_updateTimer;
+    const bool m_wasEnabled;
+};
@@ -0,0 +1,176 @@
+#include "engine/enginerenderer.h"
+
+#include <cmath>
+
+#include "control/controlobject.h"
+#include "engine/engine.h"
+#include "engine/enginemixer.h"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/denormalsarezero.h"
+#include "util/logger.h"
+#include "util/performancetimer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("EngineRenderer");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+} // namespace
+
+double EngineRenderer::Stats::callbacksPerSecond() const {
+    const double seconds = renderDuration.toDoubleSeconds();
+    return seconds > 0 ? callbacks / seconds : 0.0;
+}
+
+double EngineRenderer::Stats::realtimeFactor() const {
+    const double seconds = renderDuration.toDoubleSeconds();
+    return seconds > 0 ? audioDuration.toDoubleSeconds() / seconds : 0.0;
+}
+
+EngineRenderer::EngineRenderer(EngineMixer* pEngineMixer,
+        mixxx::audio::SampleRate sampleRate,
+        SINT framesPerBuffer)
+        : m_pEngineMixer(pEngineMixer),
+          m_sampleRate(sampleRate),
+          m_framesPerBuffer(framesPerBuffer) {
+    DEBUG_ASSERT(m_pEngineMixer);
+    DEBUG_ASSERT(m_sampleRate.isValid());
+    DEBUG_ASSERT(m_framesPerBuffer > 0);
+    DEBUG_ASSERT(m_framesPerBuffer * mixxx::kEngineChannelCount <= static_cast<SINT>(kMaxEngineSamples));
+    // The same controls that the clock reference device publishes
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("samplerate")), m_sampleRate);
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("output_latency_ms")),
+            1000.0 * m_framesPerBuffer / m_sampleRate.toDouble());
+}
+
+EngineRenderer::~EngineRenderer() {
+    closeOutput();
+}
+
+bool EngineRenderer::openOutput(const QString& fileName,
+        const Encoder::Format& format,
+        UserSettingsPointer pConfig,
+        QString* pErrorMessage) {
+    closeOutput();
+    m_pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
+            format, pConfig, this);
+    QString errorMessage;
+    if (!m_pEncoder || m_pEncoder->initEncoder(m_sampleRate, &errorMessage) < 0) {
+        kLogger.warning() << "Failed to initialize the" << format.label
+                          << "encoder:" << errorMessage;
+        m_pEncoder.reset();
+        if (pErrorMessage) {
+            *pErrorMessage = errorMessage;
+        }
+        return false;
+    }
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        kLogger.warning() << "Failed to open" << fileName << m_file.errorString();
+        m_pEncoder.reset();
+        if (pErrorMessage) {
+            *pErrorMessage = m_file.errorString();
+        }
+        return false;
+    }
+    m_dataStream.setDevice(&m_file);
+    return true;
+}
+
+void EngineRenderer::closeOutput() {
+    if (!isOutputOpen()) {
+        return;
+    }
+    m_pEncoder->flush();
+    m_pEncoder.reset();
+    m_dataStream.setDevice(nullptr);
+    m_file.close();
+}
+
+bool EngineRenderer::isOutputOpen() const {
+    return m_pEncoder && m_file.isOpen();
+}
+
+EngineRenderer::Stats EngineRenderer::render(mixxx::Duration duration) {
+    const double callbacks = duration.toDoubleSeconds() *
+            m_sampleRate.toDouble() / m_framesPerBuffer;
+    return renderCallbacks(static_cast<int>(std::ceil(callbacks)));
+}
+
+EngineRenderer::Stats EngineRenderer::renderCallbacks(int callbacks) {
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    // Denormals are disabled in the audio threads of all sound devices,
+    // otherwise the EQs and effects become much slower.
+    const unsigned int savedCsr = _mm_getcsr();
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+
+    const int bufferSize = static_cast<int>(m_framesPerBuffer * mixxx::kEngineChannelCount);
+    PerformanceTimer timer;
+    timer.start();
+    for (int i = 0; i < callbacks; ++i) {
+        m_pEngineMixer->process(bufferSize);
+        if (m_pEncoder) {
+            m_pEncoder->encodeBuffer(m_pEngineMixer->getMainBuffer(), bufferSize);
+        }
+    }
+
+    Stats stats;
+    stats.renderDuration = timer.elapsed();
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    _mm_setcsr(savedCsr);
+#endif
+
+    stats.callbacks = callbacks;
+    stats.frames = callbacks * m_framesPerBuffer;
+    stats.audioDuration = mixxx::Duration::fromSeconds(
+            stats.frames / m_sampleRate.toDouble());
+
+    m_totalStats.callbacks += stats.callbacks;
+    m_totalStats.frames += stats.frames;
+    m_totalStats.audioDuration += stats.audioDuration;
+    m_totalStats.renderDuration += stats.renderDuration;
+
+    kLogger.info() << "Rendered" << stats.audioDuration.formatSecondsWithUnit()
+                   << "in" << stats.renderDuration.formatMillisWithUnit() << "with"
+                   << stats.callbacks << "callbacks:" << stats.callbacksPerSecond()
+                   << "callbacks/s," << stats.realtimeFactor() << "x realtime";
+    return stats;
+}
+
+void EngineRenderer::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    if (headerLen > 0) {
+        m_dataStream.writeRawData(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_dataStream.writeRawData(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+int EngineRenderer::tell() {
+    if (!m_file.isOpen()) {
+        return -1;
+    }
+    return static_cast<int>(m_file.pos());
+}
+
+void EngineRenderer::seek(int pos) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_file.seek(static_cast<qint64>(pos));
+}
+
+int EngineRenderer::filelen() {
+    if (!m_file.isOpen()) {
+        return 0;
+    }
+    return static_cast<int>(m_file.size());
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFile>
+#include <QString>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/usersettings.h"
+#include "util/duration.h"
+#include "util/types.h"
+
+class EngineMixer;
+
+/// EngineRenderer drives the engine without a sound device, like the clock
+/// reference thread of SoundDeviceNetwork does, but from a synthetic clock
+/// that runs as fast as the CPU allows instead of waiting for the next
+/// buffer deadline.
+///
+/// It is used to render mixes to a file and as a reproducible throughput
+/// benchmark of the engine. Between two calls of render() the caller may
+/// change controls, e.g. to load tracks or to start and stop decks, which
+/// takes effect at the next callback, just like in a live session.
+///
+/// The CachingReaderWorkers still decode asynchronously and may fall behind
+/// an engine that runs many times faster than realtime. Enable
+/// [CachingReader],load_into_ram and wait for [ChannelN],ram_buffered before
+/// rendering to get sample-exact results.
+class EngineRenderer : public EncoderCallback {
+  public:
+    struct Stats {
+        int callbacks = 0;
+        SINT frames = 0;
+        /// The duration of the rendered audio
+        mixxx::Duration audioDuration;
+        /// The wall time spent in the engine and the encoder
+        mixxx::Duration renderDuration;
+
+        double callbacksPerSecond() const;
+        /// How many times faster than realtime the audio has been rendered
+        double realtimeFactor() const;
+    };
+
+    EngineRenderer(EngineMixer* pEngineMixer,
+            mixxx::audio::SampleRate sampleRate,
+            SINT framesPerBuffer);
+    ~EngineRenderer() override;
+
+    /// Writes the main output to the given file with the encoder and the
+    /// recording preferences of the format. Without an output the audio is
+    /// rendered and discarded, e.g. for benchmarking.
+    bool openOutput(const QString& fileName,
+            const Encoder::Format& format,
+            UserSettingsPointer pConfig,
+            QString* pErrorMessage = nullptr);
+    /// Flushes the encoder and closes the file
+    void closeOutput();
+    bool isOutputOpen() const;
+
+    /// Runs the engine callbacks for (at least) the given audio duration
+    /// and returns the statistics of this call.
+    Stats render(mixxx::Duration duration);
+    Stats renderCallbacks(int callbacks);
+
+    /// The statistics of all calls since construction
+    const Stats& totalStats() const {
+        return m_totalStats;
+    }
+
+    mixxx::audio::SampleRate sampleRate() const {
+        return m_sampleRate;
+    }
+    SINT framesPerBuffer() const {
+        return m_framesPerBuffer;
+    }
+
+    // EncoderCallback
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    EngineMixer* const m_pEngineMixer;
+    const mixxx::audio::SampleRate m_sampleRate;
+    const SINT m_framesPerBuffer;
+
+    EncoderPointer m_pEncoder;
+    QFile m_file;
+    QDataStream m_dataStream;
+
+    Stats m_totalStats;
+};
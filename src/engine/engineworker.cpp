@@ -1,12 +1,17 @@
 #include "engine/engineworker.h"
 
+#include <algorithm>
+
 #include "engine/engineworkerscheduler.h"
 #include "moc_engineworker.cpp"
 #include "util/assert.h"
+#include "util/stat.h"
+#include "util/time.h"
 
 EngineWorker::EngineWorker()
-    : m_pScheduler(nullptr) {
-    m_notReady.test_and_set();
+        : m_pScheduler(nullptr),
+          m_schedulerIndex(-1),
+          m_readySinceNanos(0) {
 }
 
 EngineWorker::~EngineWorker() {
@@ -17,20 +22,37 @@ void EngineWorker::run() {
 
 void EngineWorker::setScheduler(EngineWorkerScheduler* pScheduler) {
     DEBUG_ASSERT(m_pScheduler == nullptr);
-    m_pScheduler = pScheduler;
-    pScheduler->addWorker(this);
+    m_schedulerIndex = pScheduler->addWorker(this);
+    if (m_schedulerIndex >= 0) {
+        m_pScheduler = pScheduler;
+    }
 }
 
 void EngineWorker::workReady() {
-    m_notReady.clear();
+    // Only the first call before the worker starts sets the timestamp.
+    // A value of 0 is reserved for "not ready".
+    qint64 notReady = 0;
+    m_readySinceNanos.compare_exchange_strong(notReady,
+            std::max<qint64>(mixxx::Time::elapsed().toIntegerNanos(), 1),
+            std::memory_order_relaxed);
     VERIFY_OR_DEBUG_ASSERT(m_pScheduler) {
-        return;     
+        return;
     }
-    m_pScheduler->workerReady();
+    m_pScheduler->workerReady(m_schedulerIndex);
 }
 
-void EngineWorker::wakeIfReady() {
-    if (!m_notReady.test_and_set()) {
-        m_semaRun.release();
+void EngineWorker::reportWakeupLatency() {
+    const qint64 readySince = m_readySinceNanos.exchange(0, std::memory_order_relaxed);
+    if (readySince == 0) {
+        return;
     }
+    Stat::track(QStringLiteral("EngineWorker wakeup latency"),
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE |
+                    Stat::SAMPLE_VARIANCE | Stat::MIN | Stat::MAX),
+            mixxx::Time::elapsed().toIntegerNanos() - readySince);
+}
+
+void EngineWorker::wake() {
+    m_semaRun.release();
 }
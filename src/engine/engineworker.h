@@ -21,13 +21,27 @@ class EngineWorker : public QThread {
     virtual void run();
 
     void setScheduler(EngineWorkerScheduler* pScheduler);
+    // Lock-free and wait-free, may be called from the audio callback
     void workReady();
-    void wakeIfReady();
 
   protected:
+    // Resumes the worker after workReady() has been called. Runs the
+    // worker's own thread by default.
+    virtual void wake();
+
+    // Must be called when the worker starts processing after being woken.
+    // Reports the time since the first workReady() call as the
+    // "EngineWorker wakeup latency" stat.
+    void reportWakeupLatency();
+
     QSemaphore m_semaRun;
 
   private:
+    friend class EngineWorkerScheduler;
+
     EngineWorkerScheduler* m_pScheduler;
-    std::atomic_flag m_notReady;
+    int m_schedulerIndex;
+    // The time of the first workReady() call that has not been followed by
+    // reportWakeupLatency() yet, or 0
+    std::atomic<qint64> m_readySinceNanos;
 };
@@ -1,59 +1,80 @@
 #include "engine/engineworkerscheduler.h"
 
+#include <bit>
+
 #include "engine/engineworker.h"
 #include "moc_engineworkerscheduler.cpp"
+#include "util/assert.h"
 #include "util/compatibility/qmutex.h"
 #include "util/event.h"
 
 EngineWorkerScheduler::EngineWorkerScheduler(QObject* pParent)
         : m_bWakeScheduler(false),
+          m_readyWorkers{},
+          m_wakeups(0),
           m_bQuit(false) {
     Q_UNUSED(pParent);
 }
 
 EngineWorkerScheduler::~EngineWorkerScheduler() {
     m_bQuit = true;
-    m_waitCondition.wakeAll();
+    m_wakeups.fetch_add(1, std::memory_order_release);
+    m_wakeups.notify_one();
     wait();
 }
 
-void EngineWorkerScheduler::workerReady() {
-    m_bWakeScheduler = true;
+void EngineWorkerScheduler::workerReady(int workerIndex) {
+    DEBUG_ASSERT(workerIndex >= 0 && workerIndex < kMaxWorkers);
+    m_readyWorkers[workerIndex / 64].fetch_or(
+            std::uint64_t{1} << (workerIndex % 64), std::memory_order_release);
+    m_bWakeScheduler.store(true, std::memory_order_relaxed);
 }
 
-void EngineWorkerScheduler::addWorker(EngineWorker* pWorker) {
+int EngineWorkerScheduler::addWorker(EngineWorker* pWorker) {
     DEBUG_ASSERT(pWorker);
     const auto locker = lockMutex(&m_mutex);
+    VERIFY_OR_DEBUG_ASSERT(m_workers.size() < static_cast<std::size_t>(kMaxWorkers)) {
+        return -1;
+    }
     m_workers.push_back(pWorker);
+    return static_cast<int>(m_workers.size()) - 1;
 }
 
 void EngineWorkerScheduler::runWorkers() {
     // Wake the scheduler if we have written a worker-ready message to the
-    // scheduler. There is no race condition in accessing this boolean because
-    // both workerReady and runWorkers are called from the callback thread.
-    if (m_bWakeScheduler) {
-        m_bWakeScheduler = false;
-        m_waitCondition.wakeAll();
+    // scheduler. workerReady is only called while the callback is processing
+    // and runWorkers at its very end, after all channel workers have joined.
+    if (m_bWakeScheduler.exchange(false, std::memory_order_relaxed)) {
+        m_wakeups.fetch_add(1, std::memory_order_release);
+        m_wakeups.notify_one();
+    }
+}
+
+void EngineWorkerScheduler::wakeReadyWorkers() {
+    const auto locker = lockMutex(&m_mutex);
+    const int numWords = static_cast<int>((m_workers.size() + 63) / 64);
+    for (int word = 0; word < numWords; ++word) {
+        std::uint64_t bits = m_readyWorkers[word].exchange(0, std::memory_order_acquire);
+        while (bits != 0) {
+            const int workerIndex = word * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+            m_workers[workerIndex]->wake();
+        }
     }
 }
 
 void EngineWorkerScheduler::run() {
     static const QString tag("EngineWorkerScheduler");
-    while (!m_bQuit) {
+    while (!m_bQuit.load()) {
+        // Read the counter before looking for ready workers, so a wakeup
+        // in between is not lost.
+        const auto wakeups = m_wakeups.load(std::memory_order_acquire);
         Event::start(tag);
-        {
-            const auto locker = lockMutex(&m_mutex);
-            for(const auto& pWorker: m_workers) {
-                pWorker->wakeIfReady();
-            }
-        }
+        wakeReadyWorkers();
         Event::end(tag);
-        {
-            const auto lock = lockMutex(&m_mutex);
-            if (!m_bQuit) {
-                // Wait for next runWorkers() call
-                m_waitCondition.wait(&m_mutex); // unlock mutex and wait
-            }
+        if (!m_bQuit.load()) {
+            // Wait for next runWorkers() call
+            m_wakeups.wait(wakeups, std::memory_order_acquire);
         }
     }
 }
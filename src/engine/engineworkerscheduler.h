@@ -2,35 +2,55 @@
 
 #include <QMutex>
 #include <QThread>
-#include <QWaitCondition>
-
-// The max engine workers that can be expected to run within a callback
-// (e.g. the max that we will schedule). Must be a power of 2.
-#define MAX_ENGINE_WORKERS 32
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 class EngineWorker;
 
+/// Wakes the EngineWorkers that have work after the audio callback.
+///
+/// The engine thread marks a worker as ready by setting its bit in a fixed
+/// bitmap and notifies the scheduler thread at the end of the callback by
+/// bumping an atomic counter that the scheduler thread waits on. Both are
+/// lock-free: on Linux std::atomic::notify_one() is a single futex wake, so
+/// the audio callback never takes a mutex and can not suffer from priority
+/// inversion. The scheduler thread then wakes only the workers whose bits
+/// are set.
 class EngineWorkerScheduler : public QThread {
     Q_OBJECT
   public:
+    static constexpr int kMaxWorkers = 1024;
+
     EngineWorkerScheduler(QObject* pParent=NULL);
     virtual ~EngineWorkerScheduler();
 
-    void addWorker(EngineWorker* pWorker);
+    /// Returns the index of the worker for workerReady()
+    int addWorker(EngineWorker* pWorker);
     void runWorkers();
-    void workerReady();
+    void workerReady(int workerIndex);
 
   protected:
     void run();
 
   private:
+    void wakeReadyWorkers();
+
     // Indicates whether workerReady has been called since the last time
-    // runWorkers was run. This should only be touched from the engine callback.
-    bool m_bWakeScheduler;
+    // runWorkers was run. This is set from the engine callback or, when
+    // channels are processed in parallel, from the RealtimeWorkerPool threads.
+    std::atomic<bool> m_bWakeScheduler;
 
-    std::vector<EngineWorker*> m_workers;
+    std::array<std::atomic<std::uint64_t>, kMaxWorkers / 64> m_readyWorkers;
+    // Incremented for every wakeup of the scheduler thread, which waits
+    // for it to change
+    std::atomic<std::uint32_t> m_wakeups;
 
-    QWaitCondition m_waitCondition;
+    // Guards m_workers against concurrent addWorker() calls, never locked
+    // by the engine thread
     QMutex m_mutex;
-    volatile bool m_bQuit;
+    std::vector<EngineWorker*> m_workers;
+
+    std::atomic<bool> m_bQuit;
 };
@@ -9,6 +9,10 @@
 #include "engine/engineobject.h"
 #include "util/sample.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 // set to 1 to print some analysis data using qDebug()
 // It prints the resulting delay after 50 % of impulse have passed
 // and the gain and phase shift at some sample frequencies
@@ -26,6 +30,108 @@ enum IIRPass {
 };
 
 
+/// The left and the right sample of a frame, processed together in the two
+/// lanes of an SSE2 register. Each lane sees the same operations in the same
+/// order as the former scalar code, so both channels are filtered exactly as
+/// before. Without SSE2 the lanes are processed one after the other.
+class IIRStereoSample {
+  public:
+    IIRStereoSample() = default;
+
+#ifdef __SSE2__
+    static IIRStereoSample zero() {
+        return IIRStereoSample(_mm_setzero_pd());
+    }
+
+    static IIRStereoSample fromFrame(const CSAMPLE* pFrame) {
+        return IIRStereoSample(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+    }
+
+    void toFrame(CSAMPLE* pFrame) const {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_value)));
+    }
+
+    /// Rounds both lanes to the precision of a CSAMPLE
+    IIRStereoSample roundedToSample() const {
+        return IIRStereoSample(_mm_cvtps_pd(_mm_cvtpd_ps(m_value)));
+    }
+
+    friend IIRStereoSample operator+(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(_mm_add_pd(a.m_value, b.m_value));
+    }
+    friend IIRStereoSample operator-(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(_mm_sub_pd(a.m_value, b.m_value));
+    }
+    friend IIRStereoSample operator-(IIRStereoSample a) {
+        // Flips the sign bits like the scalar negation
+        return IIRStereoSample(_mm_xor_pd(a.m_value, _mm_set1_pd(-0.0)));
+    }
+    friend IIRStereoSample operator*(IIRStereoSample a, double b) {
+        return IIRStereoSample(_mm_mul_pd(a.m_value, _mm_set1_pd(b)));
+    }
+#else
+    static IIRStereoSample zero() {
+        return IIRStereoSample(0.0, 0.0);
+    }
+
+    static IIRStereoSample fromFrame(const CSAMPLE* pFrame) {
+        return IIRStereoSample(pFrame[0], pFrame[1]);
+    }
+
+    void toFrame(CSAMPLE* pFrame) const {
+        pFrame[0] = static_cast<CSAMPLE>(m_left);
+        pFrame[1] = static_cast<CSAMPLE>(m_right);
+    }
+
+    /// Rounds both lanes to the precision of a CSAMPLE
+    IIRStereoSample roundedToSample() const {
+        return IIRStereoSample(static_cast<CSAMPLE>(m_left), static_cast<CSAMPLE>(m_right));
+    }
+
+    friend IIRStereoSample operator+(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(a.m_left + b.m_left, a.m_right + b.m_right);
+    }
+    friend IIRStereoSample operator-(IIRStereoSample a, IIRStereoSample b) {
+        return IIRStereoSample(a.m_left - b.m_left, a.m_right - b.m_right);
+    }
+    friend IIRStereoSample operator-(IIRStereoSample a) {
+        return IIRStereoSample(-a.m_left, -a.m_right);
+    }
+    friend IIRStereoSample operator*(IIRStereoSample a, double b) {
+        return IIRStereoSample(a.m_left * b, a.m_right * b);
+    }
+#endif
+
+    friend IIRStereoSample operator*(double a, IIRStereoSample b) {
+        return b * a;
+    }
+    IIRStereoSample& operator+=(IIRStereoSample other) {
+        return *this = *this + other;
+    }
+    IIRStereoSample& operator-=(IIRStereoSample other) {
+        return *this = *this - other;
+    }
+
+  private:
+#ifdef __SSE2__
+    explicit IIRStereoSample(__m128d value)
+            : m_value(value) {
+    }
+
+    __m128d m_value;
+#else
+    IIRStereoSample(double left, double right)
+            : m_left(left),
+              m_right(right) {
+    }
+
+    double m_left;
+    double m_right;
+#endif
+};
+
 class EngineFilterIIRBase : public EngineObjectConstIn {
   public:
     virtual void assumeSettled() = 0;
@@ -83,11 +189,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
     }
 
@@ -234,8 +338,8 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                          const int iBufferSize) {
         if (!m_doRamping) {
             for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                processSample(m_coef, m_buf, IIRStereoSample::fromFrame(&pIn[i]))
+                        .toFrame(&pOutput[i]);
             }
         } else {
             double cross_mix = 0.0;
@@ -252,31 +356,26 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
-                double old1;
-                double old2;
+                const IIRStereoSample in = IIRStereoSample::fromFrame(&pIn[i]);
+                IIRStereoSample old;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    old = processSample(m_oldCoef, m_oldBuf, in).roundedToSample();
                 } else {
                     if (m_startFromDry) {
-                        old1 = pIn[i];
-                        old2 = pIn[i + 1];
+                        old = in;
                     } else {
-                        old1 = 0;
-                        old2 = 0;
+                        old = IIRStereoSample::zero();
                     }
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const IIRStereoSample newSample =
+                        processSample(m_coef, m_buf, in).roundedToSample();
 
                 if (i < iBufferSize / 2) {
-                    pOutput[i] = static_cast<CSAMPLE>(old1);
-                    pOutput[i + 1] = static_cast<CSAMPLE>(old2);
+                    old.toFrame(&pOutput[i]);
                 } else {
-                    pOutput[i] = static_cast<CSAMPLE>(new1 * cross_mix + old1 * (1.0 - cross_mix));
-                    pOutput[i + 1] = static_cast<CSAMPLE>(
-                            new2 * cross_mix + old2 * (1.0 - cross_mix));
+                    (newSample * cross_mix + old * (1.0 - cross_mix))
+                            .toFrame(&pOutput[i]);
                     cross_mix += cross_inc;
                 }
             }
@@ -286,11 +385,13 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    // Processes one sample with the state in buf. T is either double for
+    // a single channel or IIRStereoSample for both channels.
+    template<typename T>
+    static inline T processSample(const double* coef, T* buf, T val);
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
         m_doStart = true;
     }
@@ -299,15 +400,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
-
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // The state of both channels
+    IIRStereoSample m_buf[SIZE];
+    // Old buffer needed for ramping
+    IIRStereoSample m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -318,10 +414,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -332,10 +428,10 @@ inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = -tmp;
@@ -346,10 +442,10 @@ inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -360,10 +456,10 @@ inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -379,10 +475,10 @@ inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -409,10 +505,10 @@ inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     iir= val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -428,10 +524,10 @@ inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_LP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -458,10 +554,10 @@ inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<16, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
@@ -510,10 +606,10 @@ inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<8, IIR_HP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
     buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
     iir = val * coef[0];
@@ -541,10 +637,10 @@ inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<5, IIR_BP>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0]; buf[0] = buf[1];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = coef[2] * tmp;
@@ -555,10 +651,10 @@ inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_LPMO>::processSample(
+        const double* coef, T* buf, T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= tmp;
@@ -581,10 +677,10 @@ inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<4, IIR_HPMO>::processSample(
+        const double* coef, T* buf, T val) {
+   T tmp, fir, iir;
    tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
    iir= val * coef[0];
    iir -= coef[1]*tmp; fir= -tmp;
@@ -606,10 +702,10 @@ inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
 }
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_LP2>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * coef[0];
     iir -= coef[1] * tmp; fir = tmp;
@@ -627,10 +723,10 @@ inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
+template<typename T>
+inline T EngineFilterIIR<2, IIR_HP2>::processSample(
+        const double* coef, T* buf, T val) {
+    T tmp, fir, iir;
     tmp = buf[0];
     iir = val * -coef[0]; // swap gain to be in phase with LP2
     iir -= coef[1] * tmp; fir = -tmp;
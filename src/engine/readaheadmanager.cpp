@@ -197,6 +197,26 @@ void ReadAheadManager::addRateControl(RateControl* pRateControl) {
     m_pRateControl = pRateControl;
 }
 
+bool ReadAheadManager::hasReadPastLoop(bool reverse, mixxx::audio::FramePos playPosition) {
+    if (!m_pLoopingControl || !m_pLoopingControl->isLoopingEnabled() ||
+            !playPosition.isValid()) {
+        return false;
+    }
+    // Unlike nextTrigger(), this does not act on the loop
+    const LoopingControl::LoopInfo loopInfo = m_pLoopingControl->getLoopInfo();
+    const mixxx::audio::FramePos triggerPosition =
+            reverse ? loopInfo.startPosition : loopInfo.endPosition;
+    if (!triggerPosition.isValid()) {
+        return false;
+    }
+    const double trigger = triggerPosition.toEngineSamplePos();
+    const double position = playPosition.toEngineSamplePos();
+    if (reverse) {
+        return m_currentPosition < trigger && trigger <= position;
+    }
+    return position <= trigger && trigger < m_currentPosition;
+}
+
 // Not thread-save, call from engine thread only
 void ReadAheadManager::notifySeek(double seekPosition) {
     m_currentPosition = seekPosition;
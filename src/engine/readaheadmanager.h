@@ -45,6 +45,13 @@ class ReadAheadManager {
         return m_currentPosition;
     }
 
+    /// Returns true if a loop is enabled whose trigger in the playback
+    /// direction lies between the play position and the read-ahead position,
+    /// i.e. the loop has been set after the samples beyond its trigger have
+    /// been read. The loop is only taken after a seek back to the play
+    /// position.
+    virtual bool hasReadPastLoop(bool reverse, mixxx::audio::FramePos playPosition);
+
     virtual void notifySeek(double seekPosition);
     virtual void notifySeek(mixxx::audio::FramePos position) {
         notifySeek(position.toEngineSamplePos());
@@ -0,0 +1,193 @@
+#include "engine/realtimeworkerpool.h"
+
+#include <QtDebug>
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/denormalsarezero.h"
+#include "util/realtimesafety.h"
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Each iteration takes some 10 to 150 cycles depending on the CPU, i.e. the
+// calling thread spins for some microseconds before it falls back to a
+// blocking wait. The workers usually finish within a fraction of that.
+constexpr int kJoinSpinIterations = 4096;
+
+inline void spinPause() {
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+std::uint64_t getFloatingPointControl() {
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    return _mm_getcsr();
+#elif defined(__aarch64__)
+    std::uint64_t fpcr;
+    asm volatile("mrs %[fpcr], FPCR"
+                 : [ fpcr ] "=r"(fpcr));
+    return fpcr;
+#else
+    return 0;
+#endif
+}
+
+void setFloatingPointControl(std::uint64_t fpControl) {
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    if (_mm_getcsr() != fpControl) {
+        _mm_setcsr(static_cast<unsigned int>(fpControl));
+    }
+#elif defined(__aarch64__)
+    asm volatile("msr FPCR, %[src]"
+                 :
+                 : [ src ] "r"(fpControl));
+#else
+    Q_UNUSED(fpControl);
+#endif
+}
+
+} // namespace
+
+class RealtimeWorkerPool::Thread : public QThread {
+  public:
+    Thread(RealtimeWorkerPool* pPool, int cpu)
+            : m_pPool(pPool),
+              m_cpu(cpu) {
+    }
+
+  protected:
+    void run() override {
+#ifdef __LINUX__
+        if (m_cpu >= 0) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(m_cpu, &cpuSet);
+            const int result = pthread_setaffinity_np(
+                    pthread_self(), sizeof(cpu_set_t), &cpuSet);
+            if (result != 0) {
+                qWarning() << "RealtimeWorkerPool: Failed to pin worker to CPU"
+                           << m_cpu << "error" << result;
+            }
+        }
+#endif
+        m_pPool->workerLoop();
+    }
+
+  private:
+    RealtimeWorkerPool* const m_pPool;
+    const int m_cpu;
+};
+
+RealtimeWorkerPool::RealtimeWorkerPool(int numThreads, bool pinThreads)
+        : m_pFunction(nullptr),
+          m_pContext(nullptr),
+          m_numItems(0),
+          m_nextItem(0),
+          m_fpControl(getFloatingPointControl()),
+          m_semaStart(0),
+          m_pendingWorkers(0),
+          m_quit(false) {
+    DEBUG_ASSERT(numThreads >= 0);
+    const int numCpus = QThread::idealThreadCount();
+#ifndef __LINUX__
+    // Thread affinity is not implemented for this platform.
+    pinThreads = false;
+#endif
+    m_threads.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        // Leave the first core to the engine thread, which is not pinned
+        // and participates in every job.
+        const int cpu = (pinThreads && numCpus > 1) ? (i + 1) % numCpus : -1;
+        auto pThread = std::make_unique<Thread>(this, cpu);
+        pThread->setObjectName(QStringLiteral("RealtimeWorker%1").arg(i + 1));
+        pThread->start(QThread::TimeCriticalPriority);
+        m_threads.push_back(std::move(pThread));
+    }
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool() {
+    m_quit.store(true);
+    m_semaStart.release(numThreads());
+    for (const auto& pThread : m_threads) {
+        pThread->wait();
+    }
+}
+
+void RealtimeWorkerPool::run(int numItems, ItemFunction pFunction, void* pContext) {
+    if (numItems <= 0) {
+        return;
+    }
+    const int numWorkers = std::min(numItems - 1, numThreads());
+    if (numWorkers <= 0) {
+        // Nothing to distribute, avoid the round trip through the semaphores.
+        for (int i = 0; i < numItems; ++i) {
+            pFunction(pContext, i);
+        }
+        return;
+    }
+
+    m_pFunction = pFunction;
+    m_pContext = pContext;
+    m_numItems = numItems;
+    m_fpControl = getFloatingPointControl();
+    m_nextItem.store(0, std::memory_order_release);
+    // Every woken worker reports back exactly once, even if it did not get
+    // an item because the other threads were faster.
+    m_pendingWorkers.store(numWorkers, std::memory_order_relaxed);
+
+    // Releasing the semaphore publishes the job to the woken workers
+    m_semaStart.release(numWorkers);
+    runItems();
+    join();
+
+    m_pFunction = nullptr;
+    m_pContext = nullptr;
+    m_numItems = 0;
+}
+
+void RealtimeWorkerPool::runItems() {
+    int itemIndex;
+    while ((itemIndex = m_nextItem.fetch_add(1, std::memory_order_acq_rel)) < m_numItems) {
+        m_pFunction(m_pContext, itemIndex);
+    }
+}
+
+void RealtimeWorkerPool::join() {
+    for (int i = 0; i < kJoinSpinIterations; ++i) {
+        if (m_pendingWorkers.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+        spinPause();
+    }
+    // A worker has been preempted while processing its last item. Waiting
+    // for it is unavoidable, because its results are needed for mixing.
+    ScopedRealtimeSafetySuspension suspension;
+    int pendingWorkers;
+    while ((pendingWorkers = m_pendingWorkers.load(std::memory_order_acquire)) != 0) {
+        m_pendingWorkers.wait(pendingWorkers, std::memory_order_acquire);
+    }
+}
+
+void RealtimeWorkerPool::workerLoop() {
+    while (true) {
+        m_semaStart.acquire();
+        if (m_quit.load()) {
+            break;
+        }
+        setFloatingPointControl(m_fpControl);
+        ScopedRealtimeSection realtimeSection;
+        runItems();
+        if (m_pendingWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // Only wakes the calling thread if it stopped spinning
+            m_pendingWorkers.notify_one();
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// RealtimeWorkerPool is a fork/join pool for splitting work of the audio
+/// callback across several CPU cores.
+///
+/// All threads are spawned up front and sleep on a semaphore between
+/// callbacks. Distributing work does not allocate memory: the items of a job
+/// are claimed by an atomic counter, and the calling thread always takes part
+/// in the work, so a job never waits for a worker that is not needed.
+///
+/// The calling thread joins the workers by spinning on an atomic counter.
+/// Only if a worker has been preempted for longer than the spin budget, it
+/// falls back to a futex wait, which is excluded from the RealtimeSafety
+/// checks.
+///
+/// The floating point environment (denormals-are-zero / flush-to-zero) of the
+/// calling thread is copied to the workers for every job, so the results are
+/// bit-identical to running all items on the calling thread.
+class RealtimeWorkerPool {
+  public:
+    using ItemFunction = void (*)(void* pContext, int itemIndex);
+
+    /// Spawns numThreads worker threads. With pinThreads = true each worker is
+    /// bound to its own CPU core (only supported on Linux).
+    explicit RealtimeWorkerPool(int numThreads, bool pinThreads = true);
+    ~RealtimeWorkerPool();
+
+    int numThreads() const {
+        return static_cast<int>(m_threads.size());
+    }
+
+    /// Calls pFunction(pContext, i) for all i in [0, numItems) and returns
+    /// once all calls have completed. Must not be called concurrently or
+    /// recursively, i.e. only from the engine thread.
+    void run(int numItems, ItemFunction pFunction, void* pContext);
+
+    /// Convenience wrapper around run() for a callable taking the item index.
+    /// The callable is referenced, not copied, so no allocation takes place.
+    template<typename Func>
+    void parallelFor(int numItems, Func& func) {
+        run(
+                numItems,
+                [](void* pContext, int itemIndex) {
+                    (*static_cast<Func*>(pContext))(itemIndex);
+                },
+                &func);
+    }
+
+  private:
+    class Thread;
+
+    void runItems();
+    void join();
+    void workerLoop();
+
+    std::vector<std::unique_ptr<Thread>> m_threads;
+
+    ItemFunction m_pFunction;
+    void* m_pContext;
+    int m_numItems;
+    std::atomic<int> m_nextItem;
+    std::uint64_t m_fpControl;
+
+    QSemaphore m_semaStart;
+    // The number of woken workers that have not finished the current job
+    std::atomic<int> m_pendingWorkers;
+    std::atomic<bool> m_quit;
+};
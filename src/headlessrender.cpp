@@ -0,0 +1,289 @@
+#include "headlessrender.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+
+#include "control/controlindicatortimer.h"
+#include "control/controlobject.h"
+#include "effects/effectsmanager.h"
+#include "encoder/encoder.h"
+#include "engine/channels/enginedeck.h"
+#include "engine/engine.h"
+#include "engine/enginemixer.h"
+#include "engine/enginerenderer.h"
+#include "mixer/deck.h"
+#include "mixer/playerinfo.h"
+#include "mixer/playermanager.h"
+#include "soundio/soundmanagerutil.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/cmdlineargs.h"
+#include "util/defs.h"
+#include "util/duration.h"
+#include "util/logger.h"
+#include "util/logging.h"
+#include "util/sandbox.h"
+#ifdef __RUBBERBAND__
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("HeadlessRender");
+
+// Same as for a failed startup of the GUI
+constexpr int kFatalErrorExitCode = 1;
+
+const QString kAppGroup = QStringLiteral("[App]");
+const QString kMainGroup = QStringLiteral("[Master]");
+
+const auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+// Decoding a whole track into RAM may take a while
+constexpr qint64 kLoadTimeoutMillis = 60000;
+
+void print(const QString& line) {
+    kLogger.info() << line;
+    fputs(qPrintable(line + QChar('\n')), stdout);
+    fflush(stdout);
+}
+
+void printError(const QString& line) {
+    kLogger.warning() << line;
+    fputs(qPrintable(line + QChar('\n')), stderr);
+}
+
+std::optional<Encoder::Format> formatForFile(const QString& fileName) {
+    const QString extension = QFileInfo(fileName).suffix().toLower();
+    const auto formats = EncoderFactory::getFactory().getFormats();
+    for (const auto& format : formats) {
+        if (format.fileExtension == extension) {
+            return format;
+        }
+    }
+    return std::nullopt;
+}
+
+} // anonymous namespace
+
+namespace mixxx {
+
+HeadlessRender::HeadlessRender(const CmdlineArgs& args)
+        : m_cmdlineArgs(args) {
+}
+
+HeadlessRender::~HeadlessRender() {
+    DEBUG_ASSERT(!m_pEngineMixer);
+}
+
+bool HeadlessRender::initialize() {
+    m_pSettingsManager = std::make_shared<SettingsManager>(m_cmdlineArgs.getSettingsPath());
+    const UserSettingsPointer pConfig = m_pSettingsManager->settings();
+
+    LogFlags logFlags = LogFlag::LogToFile;
+    if (m_cmdlineArgs.getDebugAssertBreak()) {
+        logFlags.setFlag(LogFlag::DebugAssertBreak);
+    }
+    Logging::initialize(
+            pConfig->getSettingsPath(),
+            m_cmdlineArgs.getLogLevel(),
+            m_cmdlineArgs.getLogFlushLevel(),
+            logFlags);
+
+    if (!SoundSourceProxy::registerProviders()) {
+        printError(QStringLiteral("Failed to register any SoundSource providers"));
+        return false;
+    }
+
+    Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
+
+    m_pControlIndicatorTimer = std::make_unique<ControlIndicatorTimer>();
+    m_pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
+    // Usually created by PlayerManager
+    m_pNumDecks = std::make_unique<ControlObject>(
+            ConfigKey(kAppGroup, QStringLiteral("num_decks")));
+
+    m_pEffectsManager = std::make_unique<EffectsManager>(pConfig, m_pChannelHandleFactory);
+    m_pEngineMixer = std::make_unique<EngineMixer>(
+            pConfig,
+            kMainGroup,
+            m_pEffectsManager.get(),
+            m_pChannelHandleFactory,
+            false);
+    // Like a sound device with only the main output configured
+    m_pEngineMixer->onOutputConnected(AudioOutput(
+            AudioPathType::Main, 0, mixxx::audio::ChannelCount::stereo()));
+#ifdef __RUBBERBAND__
+    RubberBandWorkerPool::createInstance(pConfig);
+#endif
+    PlayerInfo::create();
+
+    // One deck for each track
+    const QList<QString>& files = m_cmdlineArgs.getMusicFiles();
+    for (int i = 0; i < files.size(); ++i) {
+        const QString group = PlayerManager::groupForDeck(i);
+        auto pDeck = std::make_unique<Deck>(nullptr,
+                pConfig,
+                m_pEngineMixer.get(),
+                m_pEffectsManager.get(),
+                EngineChannel::CENTER,
+                m_pEngineMixer->registerChannelGroup(group));
+        m_pEffectsManager->addDeck(ChannelHandleAndGroup(
+                pDeck->getEngineDeck()->getHandle(), group));
+        ControlObject::set(ConfigKey(group, QStringLiteral("main_mix")), 1.0);
+        m_pNumDecks->set(m_pNumDecks->get() + 1);
+        m_decks.push_back(std::move(pDeck));
+    }
+    // Loads the default EQ and QuickEffect of each deck
+    m_pEffectsManager->setup();
+    return true;
+}
+
+void HeadlessRender::shutdown() {
+    m_pRenderer.reset();
+    if (m_pEngineMixer) {
+        m_decks.clear();
+        // Deletes all EngineChannels added to it
+        m_pEngineMixer.reset();
+#ifdef __RUBBERBAND__
+        RubberBandWorkerPool::destroy();
+#endif
+        // Releases the tracks that were loaded in the decks
+        PlayerInfo::destroy();
+    }
+    m_pEffectsManager.reset();
+    m_pNumDecks.reset();
+    m_pChannelHandleFactory.reset();
+    m_pControlIndicatorTimer.reset();
+    // Tracks that have been unloaded by the decks are deleted later
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+
+    Sandbox::shutdown();
+
+    if (m_pSettingsManager) {
+        m_pSettingsManager->save();
+        m_pSettingsManager.reset();
+    }
+}
+
+int HeadlessRender::exec() {
+    const QString& fileName = m_cmdlineArgs.getRenderFile();
+    const auto format = formatForFile(fileName);
+    if (!format) {
+        printError(QStringLiteral("Unsupported file extension: %1").arg(fileName));
+        return kFatalErrorExitCode;
+    }
+    if (m_cmdlineArgs.getMusicFiles().isEmpty()) {
+        printError(QStringLiteral("No tracks to render"));
+        return kFatalErrorExitCode;
+    }
+    const int framesPerBuffer = m_cmdlineArgs.getRenderBufferFrames() > 0
+            ? m_cmdlineArgs.getRenderBufferFrames()
+            : kDefaultBufferFrames;
+    if (framesPerBuffer > static_cast<int>(kMaxEngineFrames)) {
+        printError(QStringLiteral("At most %1 frames per callback are supported")
+                        .arg(kMaxEngineFrames));
+        return kFatalErrorExitCode;
+    }
+
+    if (!initialize()) {
+        shutdown();
+        return kFatalErrorExitCode;
+    }
+    // Publishes the sample rate before the first callback
+    m_pRenderer = std::make_unique<EngineRenderer>(
+            m_pEngineMixer.get(), kSampleRate, framesPerBuffer);
+    if (!loadTracks()) {
+        shutdown();
+        return kFatalErrorExitCode;
+    }
+    QString errorMessage;
+    if (!m_pRenderer->openOutput(fileName,
+                *format,
+                m_pSettingsManager->settings(),
+                &errorMessage)) {
+        printError(QStringLiteral("Failed to write %1: %2").arg(fileName, errorMessage));
+        shutdown();
+        return kFatalErrorExitCode;
+    }
+
+    const double seconds = m_cmdlineArgs.getRenderSeconds() > 0
+            ? m_cmdlineArgs.getRenderSeconds()
+            : longestTrackSeconds();
+    print(QStringLiteral("Rendering %1 s of %2 tracks to %3 with %4 frames per callback")
+                    .arg(QString::number(seconds, 'f', 1),
+                            QString::number(m_decks.size()),
+                            fileName,
+                            QString::number(framesPerBuffer)));
+    for (const auto& pDeck : m_decks) {
+        ControlObject::set(ConfigKey(pDeck->getGroup(), QStringLiteral("play")), 1.0);
+    }
+    m_pRenderer->render(mixxx::Duration::fromSeconds(seconds));
+    m_pRenderer->closeOutput();
+
+    reportResults();
+    shutdown();
+    return EXIT_SUCCESS;
+}
+
+bool HeadlessRender::loadTracks() {
+    const QList<QString>& files = m_cmdlineArgs.getMusicFiles();
+    DEBUG_ASSERT(files.size() == static_cast<int>(m_decks.size()));
+    const int bufferSize = static_cast<int>(
+            m_pRenderer->framesPerBuffer() * mixxx::kEngineChannelCount);
+    for (std::size_t i = 0; i < m_decks.size(); ++i) {
+        const QString& file = files[static_cast<int>(i)];
+        if (!QFileInfo::exists(file)) {
+            printError(QStringLiteral("File not found: %1").arg(file));
+            return false;
+        }
+        const QString& group = m_decks[i]->getGroup();
+        // The CachingReaderWorkers must not fall behind an engine that runs
+        // many times faster than realtime
+        ControlObject::set(ConfigKey(group, QStringLiteral("load_into_ram")), 1.0);
+        m_decks[i]->slotLoadTrack(Track::newTemporary(file), false);
+
+        // The CachingReaderWorker is woken up at the end of each callback
+        QElapsedTimer timer;
+        timer.start();
+        while (ControlObject::get(ConfigKey(group, QStringLiteral("ram_buffered"))) <= 0) {
+            if (timer.hasExpired(kLoadTimeoutMillis)) {
+                printError(QStringLiteral("Failed to load %1").arg(file));
+                return false;
+            }
+            m_pEngineMixer->process(bufferSize);
+            QCoreApplication::processEvents();
+            QThread::msleep(1);
+        }
+    }
+    return true;
+}
+
+double HeadlessRender::longestTrackSeconds() const {
+    double seconds = 0;
+    for (const auto& pDeck : m_decks) {
+        seconds = std::max(seconds,
+                ControlObject::get(ConfigKey(pDeck->getGroup(), QStringLiteral("duration"))));
+    }
+    return seconds;
+}
+
+void HeadlessRender::reportResults() const {
+    const EngineRenderer::Stats& stats = m_pRenderer->totalStats();
+    print(QStringLiteral("Rendered %1 in %2 with %3 callbacks")
+                    .arg(stats.audioDuration.formatSecondsWithUnit(),
+                            stats.renderDuration.formatMillisWithUnit(),
+                            QString::number(stats.callbacks)));
+    print(QStringLiteral("%1 callbacks/s, %2x realtime")
+                    .arg(QString::number(stats.callbacksPerSecond(), 'f', 1),
+                            QString::number(stats.realtimeFactor(), 'f', 2)));
+}
+
+} // namespace mixxx
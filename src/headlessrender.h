@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "preferences/settingsmanager.h"
+
+class ChannelHandleFactory;
+class CmdlineArgs;
+class ControlObject;
+class Deck;
+class EffectsManager;
+class EngineMixer;
+class EngineRenderer;
+
+namespace mixxx {
+
+class ControlIndicatorTimer;
+
+/// Renders a mix without a sound device, see `mixxx --render`.
+///
+/// Only the settings, the effects and the audio engine are initialized,
+/// no library, controllers or skins. Each track given on the command line
+/// is loaded into RAM in a deck of its own, and all decks start playing at
+/// once. The main output is rendered by an EngineRenderer as fast as the
+/// CPU allows and written to a file with the encoder that matches its
+/// extension.
+///
+/// At the end the callbacks per second and the realtime factor are printed,
+/// which makes this a reproducible benchmark of the engine with real tracks.
+class HeadlessRender {
+  public:
+    static constexpr int kDefaultBufferFrames = 1024;
+
+    explicit HeadlessRender(const CmdlineArgs& args);
+    ~HeadlessRender();
+
+    /// Renders the tracks and returns the exit code of Mixxx
+    int exec();
+
+  private:
+    bool initialize();
+    void shutdown();
+
+    bool loadTracks();
+    double longestTrackSeconds() const;
+    void reportResults() const;
+
+    const CmdlineArgs& m_cmdlineArgs;
+
+    std::shared_ptr<SettingsManager> m_pSettingsManager;
+    std::unique_ptr<ControlIndicatorTimer> m_pControlIndicatorTimer;
+    std::shared_ptr<ChannelHandleFactory> m_pChannelHandleFactory;
+    std::unique_ptr<ControlObject> m_pNumDecks;
+    std::unique_ptr<EffectsManager> m_pEffectsManager;
+    std::unique_ptr<EngineMixer> m_pEngineMixer;
+    std::vector<std::unique_ptr<Deck>> m_decks;
+    std::unique_ptr<EngineRenderer> m_pRenderer;
+};
+
+} // namespace mixxx
@@ -50,6 +50,7 @@ AnalysisFeature::AnalysisFeature(
         : LibraryFeature(pLibrary, pConfig, QStringLiteral("prepare")),
           m_baseTitle(tr("Analyze")),
           m_pTrackAnalysisScheduler(TrackAnalysisScheduler::NullPointer()),
+          m_yieldAnalysis(false),
           m_pSidebarModel(make_parented<TreeItemModel>(this)),
           m_pAnalysisView(nullptr),
           m_title(m_baseTitle) {
@@ -156,6 +157,7 @@ void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks)
                 &TrackAnalysisScheduler::finished,
                 this,
                 &AnalysisFeature::onTrackAnalysisSchedulerFinished);
+        m_pTrackAnalysisScheduler->setYielding(m_yieldAnalysis);
 
         emit analysisActive(true);
     }
@@ -181,6 +183,14 @@ void AnalysisFeature::resumeAnalysis() {
     m_pTrackAnalysisScheduler->resume();
 }
 
+void AnalysisFeature::yieldAnalysis(bool yield) {
+    m_yieldAnalysis = yield;
+    if (!m_pTrackAnalysisScheduler) {
+        return; // inactive
+    }
+    m_pTrackAnalysisScheduler->setYielding(yield);
+}
+
 void AnalysisFeature::stopAnalysis() {
     if (!m_pTrackAnalysisScheduler) {
         return; // inactive
@@ -42,6 +42,9 @@ class AnalysisFeature : public LibraryFeature {
     void suspendAnalysis();
     void resumeAnalysis();
     void stopAnalysis();
+    // Suspends the batch analysis while tracks that have been loaded into
+    // players are analyzed, see TrackAnalysisScheduler::setYielding()
+    void yieldAnalysis(bool yield);
 
   private slots:
     void onTrackAnalysisSchedulerProgress(AnalyzerProgress currentTrackProgress, int currentTrackNumber, int totalTracksCount);
@@ -60,6 +63,8 @@ class AnalysisFeature : public LibraryFeature {
     const QString m_baseTitle;
 
     TrackAnalysisScheduler::Pointer m_pTrackAnalysisScheduler;
+    // Also applies to a batch analysis that is started while yielding
+    bool m_yieldAnalysis;
 
     parented_ptr<TreeItemModel> m_pSidebarModel;
     DlgAnalysis* m_pAnalysisView;
@@ -154,6 +154,8 @@ Library::Library(
     addFeature(m_pAnalysisFeature);
     // Suspend a batch analysis while an ad-hoc analysis of
     // loaded tracks is in progress and resume it afterwards.
+    // Resuming or starting the batch analysis in the meantime
+    // does not override this.
     connect(pPlayerManager,
             &PlayerManager::trackAnalyzerProgress,
             this,
@@ -518,13 +520,13 @@ void Library::addFeature(LibraryFeature* feature) {
 void Library::onPlayerManagerTrackAnalyzerProgress(
         TrackId /*trackId*/, AnalyzerProgress /*analyzerProgress*/) {
     if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->suspendAnalysis();
+        m_pAnalysisFeature->yieldAnalysis(true);
     }
 }
 
 void Library::onPlayerManagerTrackAnalyzerIdle() {
     if (m_pAnalysisFeature) {
-        m_pAnalysisFeature->resumeAnalysis();
+        m_pAnalysisFeature->yieldAnalysis(false);
     }
 }
 
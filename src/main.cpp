@@ -10,10 +10,12 @@
 #include <cstdio>
 #include <stdexcept>
 
+#include "batchanalysis.h"
 #include "config.h"
 #include "controllers/controllermanager.h"
 #include "coreservices.h"
 #include "errordialoghandler.h"
+#include "headlessrender.h"
 #include "mixxxapplication.h"
 #ifdef MIXXX_USE_QML
 #include "qml/qmlapplication.h"
@@ -31,11 +33,12 @@
 
 namespace {
 
-// Exit codes
+// Exit codes, see BatchAnalysis for those of --analyze
 constexpr int kFatalErrorOnStartupExitCode = 1;
 constexpr int kParseCmdlineArgsErrorExitCode = 2;
 
 constexpr char kScaleFactorEnvVar[] = "QT_SCALE_FACTOR";
+constexpr char kQpaPlatformEnvVar[] = "QT_QPA_PLATFORM";
 const QString kConfigGroup = QStringLiteral("[Config]");
 const QString kScaleFactorKey = QStringLiteral("ScaleFactor");
 
@@ -111,6 +114,20 @@ int runMixxx(MixxxApplication* pApp, const CmdlineArgs& args) {
     return exitCode;
 }
 
+int runBatchAnalysis(MixxxApplication* pApp, const CmdlineArgs& args) {
+    CmdlineArgs::Instance().parseForUserFeedback();
+
+    mixxx::BatchAnalysis batchAnalysis(args, pApp);
+    return batchAnalysis.exec();
+}
+
+int runHeadlessRender(const CmdlineArgs& args) {
+    CmdlineArgs::Instance().parseForUserFeedback();
+
+    mixxx::HeadlessRender headlessRender(args);
+    return headlessRender.exec();
+}
+
 void adjustScaleFactor(CmdlineArgs* pArgs) {
     if (qEnvironmentVariableIsSet(kScaleFactorEnvVar)) {
         bool ok;
@@ -204,7 +221,15 @@ int main(int argc, char * argv[]) {
     Sandbox::checkSandboxed();
 #endif
 
-    adjustScaleFactor(&args);
+    if (args.getAnalyze() || args.getRender()) {
+        // No windows are shown, so don't require a display server,
+        // e.g. when running on a build server
+        if (!qEnvironmentVariableIsSet(kQpaPlatformEnvVar)) {
+            qputenv(kQpaPlatformEnvVar, QByteArrayLiteral("offscreen"));
+        }
+    } else {
+        adjustScaleFactor(&args);
+    }
 
     MixxxApplication app(argc, argv);
 
@@ -240,7 +265,14 @@ int main(int argc, char * argv[]) {
     // When the last window is closed, terminate the Qt event loop.
     QObject::connect(&app, &MixxxApplication::lastWindowClosed, &app, &MixxxApplication::quit);
 
-    int exitCode = runMixxx(&app, args);
+    int exitCode;
+    if (args.getRender()) {
+        exitCode = runHeadlessRender(args);
+    } else if (args.getAnalyze()) {
+        exitCode = runBatchAnalysis(&app, args);
+    } else {
+        exitCode = runMixxx(&app, args);
+    }
 
     qDebug() << "Mixxx shutdown complete with code" << exitCode;
 
@@ -29,6 +29,16 @@ const QString kEffectGroupFormat = QStringLiteral("[EqualizerRack1_%1_Effect1]")
 inline double trackColorToDouble(mixxx::RgbColor::optional_t color) {
     return (color ? static_cast<double>(*color) : kNoTrackColor);
 }
+
+CachingReader::PlayerType cachingReaderPlayerType(const QString& group) {
+    if (PlayerManager::isSamplerGroup(group)) {
+        return CachingReader::PlayerType::Sampler;
+    } else if (PlayerManager::isPreviewDeckGroup(group)) {
+        return CachingReader::PlayerType::PreviewDeck;
+    }
+    return CachingReader::PlayerType::Deck;
+}
+
 } // namespace
 
 BaseTrackPlayer::BaseTrackPlayer(PlayerManager* pParent, const QString& group)
@@ -57,7 +67,8 @@ BaseTrackPlayerImpl::BaseTrackPlayerImpl(
             pMixingEngine,
             pEffectsManager,
             defaultOrientation,
-            primaryDeck);
+            primaryDeck,
+            cachingReaderPlayerType(handleGroup.name()));
 
     m_pInputConfigured = make_parented<ControlProxy>(getGroup(), "input_configured", this);
 #ifdef __VINYLCONTROL__
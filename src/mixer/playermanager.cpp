@@ -33,6 +33,11 @@ const QString kLegacyGroup = QStringLiteral("[Master]");
 // Utilize half of the available cores for adhoc analysis of tracks
 const int kNumberOfAnalyzerThreads = math_max(1, QThread::idealThreadCount() / 2);
 
+// A track that is loaded into a deck is analyzed by several threads at once,
+// so the waveform and the beatgrid of long tracks are available sooner.
+const ConfigKey kPipelinedAnalysisConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("PipelinedAnalysis"));
+
 const QRegularExpression kDeckRegex(QStringLiteral("^\\[Channel(\\d+)\\]$"));
 const QRegularExpression kSamplerRegex(QStringLiteral("^\\[Sampler(\\d+)\\]$"));
 const QRegularExpression kPreviewDeckRegex(QStringLiteral("^\\[PreviewDeck(\\d+)\\]$"));
@@ -182,9 +187,13 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
             &Library::slotLoadLocationToPlayer);
 
     DEBUG_ASSERT(!m_pTrackAnalysisScheduler);
+    int analyzerModeFlags = AnalyzerModeFlags::WithWaveform;
+    if (m_pConfig->getValue(kPipelinedAnalysisConfigKey, true)) {
+        analyzerModeFlags |= AnalyzerModeFlags::Pipelined;
+    }
     m_pTrackAnalysisScheduler = pLibrary->createTrackAnalysisScheduler(
             kNumberOfAnalyzerThreads,
-            AnalyzerModeFlags::WithWaveform);
+            static_cast<AnalyzerModeFlags>(analyzerModeFlags));
 
     connect(m_pTrackAnalysisScheduler.get(), &TrackAnalysisScheduler::trackProgress,
             this, &PlayerManager::onTrackAnalysisProgress);
@@ -195,12 +204,20 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
     // analyzed.
     foreach(Deck* pDeck, m_decks) {
         connect(pDeck, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeTrack);
+        connect(pDeck,
+                &BaseTrackPlayer::trackUnloaded,
+                this,
+                &PlayerManager::slotLowerTrackAnalysisPriority);
     }
 
     // Connect the player to the analyzer queue so that loaded tracks are
     // analyzed.
     foreach(Sampler* pSampler, m_samplers) {
         connect(pSampler, &BaseTrackPlayer::newTrackLoaded, this, &PlayerManager::slotAnalyzeTrack);
+        connect(pSampler,
+                &BaseTrackPlayer::trackUnloaded,
+                this,
+                &PlayerManager::slotLowerTrackAnalysisPriority);
     }
 
     // Connect the player to the analyzer queue so that loaded tracks are
@@ -209,7 +226,7 @@ void PlayerManager::bindToLibrary(Library* pLibrary) {
         connect(pPreviewDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzePreviewDeckTrack);
     }
 }
 
@@ -429,6 +446,10 @@ void PlayerManager::addDeckInner() {
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
                 &PlayerManager::slotAnalyzeTrack);
+        connect(pDeck,
+                &BaseTrackPlayer::trackUnloaded,
+                this,
+                &PlayerManager::slotLowerTrackAnalysisPriority);
     }
 
     m_players[handleGroup.handle()] = pDeck;
@@ -489,6 +510,10 @@ void PlayerManager::addSamplerInner() {
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
                 &PlayerManager::slotAnalyzeTrack);
+        connect(pSampler,
+                &BaseTrackPlayer::trackUnloaded,
+                this,
+                &PlayerManager::slotLowerTrackAnalysisPriority);
     }
     connect(pSampler,
             &BaseTrackPlayer::trackUnloaded,
@@ -525,7 +550,7 @@ void PlayerManager::addPreviewDeckInner() {
         connect(pPreviewDeck,
                 &BaseTrackPlayer::newTrackLoaded,
                 this,
-                &PlayerManager::slotAnalyzeTrack);
+                &PlayerManager::slotAnalyzePreviewDeckTrack);
     }
 
     m_players[handleGroup.handle()] = pPreviewDeck;
@@ -790,11 +815,26 @@ void PlayerManager::slotLoadTrackIntoNextAvailableSampler(TrackPointer pTrack) {
 }
 
 void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
+    analyzeTrack(track, AnalyzerScheduledTrack::Priority::Deck);
+}
+
+void PlayerManager::slotAnalyzePreviewDeckTrack(TrackPointer track) {
+    analyzeTrack(track, AnalyzerScheduledTrack::Priority::PreviewDeck);
+}
+
+void PlayerManager::analyzeTrack(
+        const TrackPointer& track,
+        AnalyzerScheduledTrack::Priority priority) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
     }
     if (m_pTrackAnalysisScheduler) {
-        if (m_pTrackAnalysisScheduler->scheduleTrack(track->getId())) {
+        AnalyzerTrack::Options options;
+        // Enable sync and quantize early with provisional beats
+        options.progressive = priority == AnalyzerScheduledTrack::Priority::Deck;
+        // Loading a previewed track into a deck raises its priority
+        if (m_pTrackAnalysisScheduler->scheduleTrack(AnalyzerScheduledTrack(
+                    track->getId(), options, priority))) {
             m_pTrackAnalysisScheduler->resume();
         }
         // The first progress signal will suspend a running batch analysis
@@ -804,6 +844,26 @@ void PlayerManager::slotAnalyzeTrack(TrackPointer track) {
     }
 }
 
+void PlayerManager::slotLowerTrackAnalysisPriority(TrackPointer track) {
+    VERIFY_OR_DEBUG_ASSERT(track) {
+        return;
+    }
+    if (!m_pTrackAnalysisScheduler) {
+        return;
+    }
+    const auto locker = lockMutex(&m_mutex);
+    for (const auto* pPlayer : std::as_const(m_players)) {
+        if (pPlayer->getLoadedTrack() == track) {
+            // Still loaded into another player, e.g. after cloning a deck
+            return;
+        }
+    }
+    // The analysis of the ejected or replaced track continues after the
+    // tracks that are still loaded, e.g. the track that replaced it
+    m_pTrackAnalysisScheduler->setTrackPriority(
+            track->getId(), AnalyzerScheduledTrack::Priority::Bulk);
+}
+
 void PlayerManager::slotSaveEjectedTrack(TrackPointer track) {
     VERIFY_OR_DEBUG_ASSERT(track) {
         return;
@@ -216,6 +216,8 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
 
   private slots:
     void slotAnalyzeTrack(TrackPointer track);
+    void slotAnalyzePreviewDeckTrack(TrackPointer track);
+    void slotLowerTrackAnalysisPriority(TrackPointer track);
 
     void onTrackAnalysisProgress(TrackId trackId, AnalyzerProgress analyzerProgress);
     void onTrackAnalysisFinished();
@@ -248,6 +250,7 @@ class PlayerManager : public QObject, public PlayerManagerInterface {
 
   private:
     TrackPointer lookupTrack(QString location);
+    void analyzeTrack(const TrackPointer& track, AnalyzerScheduledTrack::Priority priority);
     // Must hold m_mutex before calling this method. Internal method that
     // creates a new deck.
     void addDeckInner();
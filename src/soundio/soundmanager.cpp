@@ -9,6 +9,7 @@
 
 #include "control/controlobject.h"
 #include "engine/enginemixer.h"
+#include "engine/engineprofiler.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "moc_soundmanager.cpp"
 #include "soundio/sounddevice.h"
@@ -56,7 +57,9 @@ SoundManager::SoundManager(UserSettingsPointer pConfig,
           m_underflowHappened(0),
           m_underflowUpdateCount(0),
           m_audioLatencyOverloadCount(kAppGroup, QStringLiteral("audio_latency_overload_count")),
-          m_audioLatencyOverload(kAppGroup, QStringLiteral("audio_latency_overload")) {
+          m_audioLatencyOverload(kAppGroup, QStringLiteral("audio_latency_overload")),
+          m_profileOutputCallback(EngineProfiler::registerSection(
+                  QStringLiteral("SoundManager_OutputCallback"))) {
     // TODO(xxx) some of these ControlObject are not needed by soundmanager, or are unused here.
     // It is possible to take them out?
     m_pControlObjectSoundStatusCO = new ControlObject(
@@ -596,6 +599,7 @@ void SoundManager::checkConfig() {
 void SoundManager::onDeviceOutputCallback(const SINT iFramesPerBuffer) {
     // Produce a block of samples for output. EngineMixer expects stereo
     // samples so multiply iFramesPerBuffer by 2.
+    ScopedEngineProfile profile(m_profileOutputCallback);
     m_pEngineMixer->process(iFramesPerBuffer * 2);
 }
 
@@ -8,6 +8,7 @@
 
 #include "audio/types.h"
 #include "control/pollingcontrolproxy.h"
+#include "engine/engineprofiler.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "preferences/usersettings.h"
 #include "soundio/sounddevice.h"
@@ -148,4 +149,5 @@ class SoundManager : public QObject {
     int m_underflowUpdateCount;
     PollingControlProxy m_audioLatencyOverloadCount;
     PollingControlProxy m_audioLatencyOverload;
+    const EngineProfiler::SectionId m_profileOutputCallback;
 };
@@ -0,0 +1,139 @@
+#include "analyzer/analyzerbeats.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "test/mixxxtest.h"
+#include "track/beatfactory.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::ChannelCount kChannelCount = mixxx::kAnalysisChannels;
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr double kBpm = 120.0;
+constexpr SINT kTrackLengthFrames = 60 * 44100;
+constexpr SINT kClickLengthFrames = 200;
+
+class AnalyzerBeatsTest : public MixxxTest {
+  protected:
+    AnalyzerBeatsTest()
+            : analyzerBeats(config(), true) {
+    }
+
+    void SetUp() override {
+        pTrack = Track::newTemporary();
+        pTrack->setAudioProperties(
+                kChannelCount,
+                kSampleRate,
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(
+                        static_cast<double>(kTrackLengthFrames) / kSampleRate));
+
+        // Decaying clicks on every beat
+        const SINT framesPerBeat = static_cast<SINT>(kSampleRate * 60 / kBpm);
+        trackSampleData.assign(kChannelCount * kTrackLengthFrames, 0);
+        for (SINT frame = 0; frame < kTrackLengthFrames; frame += framesPerBeat) {
+            for (SINT i = 0; i < kClickLengthFrames && frame + i < kTrackLengthFrames; ++i) {
+                const CSAMPLE value = 1.0f - static_cast<CSAMPLE>(i) / kClickLengthFrames;
+                for (int channel = 0; channel < kChannelCount; ++channel) {
+                    trackSampleData[(frame + i) * kChannelCount + channel] = value;
+                }
+            }
+        }
+    }
+
+    bool initialize(bool progressive) {
+        AnalyzerTrack::Options options;
+        options.progressive = progressive;
+        return analyzerBeats.initialize(
+                AnalyzerTrack(pTrack, options), kSampleRate, kTrackLengthFrames);
+    }
+
+    // Processes the given number of frames in chunks like AnalyzerThread
+    void processFrames(SINT startFrame, SINT endFrame) {
+        for (SINT frame = startFrame; frame < endFrame;
+                frame += mixxx::kAnalysisFramesPerChunk) {
+            const SINT frames = math_min(mixxx::kAnalysisFramesPerChunk, endFrame - frame);
+            ASSERT_TRUE(analyzerBeats.processSamples(
+                    &trackSampleData[frame * kChannelCount],
+                    frames * kChannelCount));
+        }
+    }
+
+    void finish() {
+        analyzerBeats.storeResults(pTrack);
+        analyzerBeats.cleanup();
+    }
+
+    AnalyzerBeats analyzerBeats;
+    TrackPointer pTrack;
+    std::vector<CSAMPLE> trackSampleData;
+};
+
+TEST_F(AnalyzerBeatsTest, ProgressiveStoresProvisionalBeats) {
+    ASSERT_TRUE(initialize(true));
+
+    const SINT provisionalFrames =
+            mixxx::kProvisionalAnalysisSecondsToAnalyze * kSampleRate;
+    processFrames(0, provisionalFrames - mixxx::kAnalysisFramesPerChunk);
+    EXPECT_FALSE(pTrack->getBeats());
+
+    processFrames(provisionalFrames - mixxx::kAnalysisFramesPerChunk, provisionalFrames);
+    const auto pProvisionalBeats = pTrack->getBeats();
+    ASSERT_TRUE(pProvisionalBeats);
+    EXPECT_TRUE(BeatFactory::isProvisionalSubVersion(pProvisionalBeats->getSubVersion()));
+    EXPECT_NEAR(kBpm, pTrack->getBpm(), 1.0);
+
+    processFrames(provisionalFrames, kTrackLengthFrames);
+    finish();
+    const auto pBeats = pTrack->getBeats();
+    ASSERT_TRUE(pBeats);
+    EXPECT_NE(pProvisionalBeats, pBeats);
+    EXPECT_FALSE(BeatFactory::isProvisionalSubVersion(pBeats->getSubVersion()));
+    EXPECT_NEAR(kBpm, pTrack->getBpm(), 1.0);
+}
+
+TEST_F(AnalyzerBeatsTest, NoProvisionalBeatsByDefault) {
+    ASSERT_TRUE(initialize(false));
+
+    processFrames(0, kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk);
+    EXPECT_FALSE(pTrack->getBeats());
+
+    processFrames(kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk, kTrackLengthFrames);
+    finish();
+    ASSERT_TRUE(pTrack->getBeats());
+    EXPECT_FALSE(BeatFactory::isProvisionalSubVersion(pTrack->getBeats()->getSubVersion()));
+}
+
+TEST_F(AnalyzerBeatsTest, ExistingBeatsAreNotReplacedByProvisionalBeats) {
+    // Created from the BPM in the file metadata and therefore analyzed again
+    const auto pExistingBeats = mixxx::Beats::fromConstTempo(
+            kSampleRate, mixxx::audio::kStartFramePos, mixxx::Bpm(100));
+    ASSERT_TRUE(pTrack->trySetBeats(pExistingBeats));
+    ASSERT_TRUE(initialize(true));
+
+    processFrames(0, kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk);
+    EXPECT_EQ(pExistingBeats, pTrack->getBeats());
+
+    processFrames(kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk, kTrackLengthFrames);
+    finish();
+    EXPECT_NEAR(kBpm, pTrack->getBpm(), 1.0);
+}
+
+TEST_F(AnalyzerBeatsTest, ProvisionalBeatsAreAnalyzedAgain) {
+    ASSERT_TRUE(initialize(true));
+    processFrames(0, mixxx::kProvisionalAnalysisSecondsToAnalyze * kSampleRate);
+    // Interrupted
+    analyzerBeats.cleanup();
+    ASSERT_TRUE(BeatFactory::isProvisionalSubVersion(pTrack->getBeats()->getSubVersion()));
+
+    EXPECT_TRUE(initialize(false));
+    analyzerBeats.cleanup();
+}
+
+} // namespace
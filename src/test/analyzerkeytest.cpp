@@ -0,0 +1,146 @@
+#include "analyzer/analyzerkey.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "preferences/keydetectionsettings.h"
+#include "test/mixxxtest.h"
+#include "track/keyfactory.h"
+#include "track/track.h"
+#include "util/math.h"
+
+namespace {
+
+constexpr mixxx::audio::ChannelCount kChannelCount = mixxx::kAnalysisChannels;
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kTrackLengthFrames = 30 * 44100;
+// C4, E4 and G4
+constexpr double kChordFrequencies[] = {261.63, 329.63, 392.0};
+
+class AnalyzerKeyTest : public MixxxTest {
+  protected:
+    AnalyzerKeyTest()
+            : analyzerKey(KeyDetectionSettings(config())) {
+    }
+
+    void SetUp() override {
+        pTrack = Track::newTemporary();
+        pTrack->setAudioProperties(
+                kChannelCount,
+                kSampleRate,
+                mixxx::audio::Bitrate(),
+                mixxx::Duration::fromSeconds(
+                        static_cast<double>(kTrackLengthFrames) / kSampleRate));
+
+        // A sustained C major chord
+        trackSampleData.assign(kChannelCount * kTrackLengthFrames, 0);
+        for (SINT frame = 0; frame < kTrackLengthFrames; ++frame) {
+            double value = 0;
+            for (const double frequency : kChordFrequencies) {
+                value += 0.2 * std::sin(2 * M_PI * frequency * frame / kSampleRate);
+            }
+            for (int channel = 0; channel < kChannelCount; ++channel) {
+                trackSampleData[frame * kChannelCount + channel] =
+                        static_cast<CSAMPLE>(value);
+            }
+        }
+    }
+
+    bool initialize(bool progressive) {
+        AnalyzerTrack::Options options;
+        options.progressive = progressive;
+        return analyzerKey.initialize(
+                AnalyzerTrack(pTrack, options), kSampleRate, kTrackLengthFrames);
+    }
+
+    // Processes the given number of frames in chunks like AnalyzerThread
+    void processFrames(SINT startFrame, SINT endFrame) {
+        for (SINT frame = startFrame; frame < endFrame;
+                frame += mixxx::kAnalysisFramesPerChunk) {
+            const SINT frames = math_min(mixxx::kAnalysisFramesPerChunk, endFrame - frame);
+            ASSERT_TRUE(analyzerKey.processSamples(
+                    &trackSampleData[frame * kChannelCount],
+                    frames * kChannelCount));
+        }
+    }
+
+    void finish() {
+        analyzerKey.storeResults(pTrack);
+        analyzerKey.cleanup();
+    }
+
+    mixxx::track::io::key::ChromaticKey globalKey() const {
+        return pTrack->getKeys().getGlobalKey();
+    }
+
+    AnalyzerKey analyzerKey;
+    TrackPointer pTrack;
+    std::vector<CSAMPLE> trackSampleData;
+};
+
+TEST_F(AnalyzerKeyTest, ProgressiveStoresProvisionalKey) {
+    ASSERT_TRUE(initialize(true));
+
+    const SINT provisionalFrames =
+            mixxx::kProvisionalAnalysisSecondsToAnalyze * kSampleRate;
+    processFrames(0, provisionalFrames - mixxx::kAnalysisFramesPerChunk);
+    EXPECT_EQ(mixxx::track::io::key::INVALID, globalKey());
+
+    processFrames(provisionalFrames - mixxx::kAnalysisFramesPerChunk, provisionalFrames);
+    EXPECT_NE(mixxx::track::io::key::INVALID, globalKey());
+    EXPECT_TRUE(KeyFactory::isProvisionalSubVersion(pTrack->getKeys().getSubVersion()));
+
+    processFrames(provisionalFrames, kTrackLengthFrames);
+    finish();
+    EXPECT_NE(mixxx::track::io::key::INVALID, globalKey());
+    EXPECT_FALSE(KeyFactory::isProvisionalSubVersion(pTrack->getKeys().getSubVersion()));
+}
+
+TEST_F(AnalyzerKeyTest, NoProvisionalKeyByDefault) {
+    ASSERT_TRUE(initialize(false));
+
+    processFrames(0, kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk);
+    EXPECT_EQ(mixxx::track::io::key::INVALID, globalKey());
+
+    processFrames(kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk, kTrackLengthFrames);
+    finish();
+    EXPECT_NE(mixxx::track::io::key::INVALID, globalKey());
+    EXPECT_FALSE(KeyFactory::isProvisionalSubVersion(pTrack->getKeys().getSubVersion()));
+}
+
+TEST_F(AnalyzerKeyTest, ExistingKeyIsNotReplacedByProvisionalKey) {
+    // Analyzed again, because the key from the file metadata is not up to
+    // date with the settings
+    KeyDetectionSettings(config()).setReanalyzeWhenSettingsChange(true);
+    pTrack->setKeys(KeyFactory::makeBasicKeys(
+            mixxx::track::io::key::F_SHARP_MINOR,
+            mixxx::track::io::key::FILE_METADATA));
+    ASSERT_TRUE(initialize(true));
+
+    processFrames(0, kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk);
+    EXPECT_EQ(mixxx::track::io::key::F_SHARP_MINOR, globalKey());
+
+    processFrames(kTrackLengthFrames - mixxx::kAnalysisFramesPerChunk, kTrackLengthFrames);
+    finish();
+    EXPECT_FALSE(KeyFactory::isProvisionalSubVersion(pTrack->getKeys().getSubVersion()));
+}
+
+TEST_F(AnalyzerKeyTest, ProvisionalKeyIsAnalyzedAgain) {
+    ASSERT_TRUE(initialize(true));
+    processFrames(0, mixxx::kProvisionalAnalysisSecondsToAnalyze * kSampleRate);
+    // Interrupted
+    analyzerKey.cleanup();
+    ASSERT_TRUE(KeyFactory::isProvisionalSubVersion(pTrack->getKeys().getSubVersion()));
+
+    // Even though keys that are not up to date are not analyzed again by
+    // default
+    ASSERT_FALSE(KeyDetectionSettings(config()).getReanalyzeWhenSettingsChange());
+    EXPECT_TRUE(initialize(false));
+    analyzerKey.cleanup();
+}
+
+} // namespace
@@ -0,0 +1,209 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <QThread>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr int kNumChunks = 100;
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+/// Computes an order-sensitive hash of all samples.
+class HashAnalyzer : public Analyzer {
+  public:
+    explicit HashAnalyzer(int failAfterChunks = -1, unsigned long sleepMicros = 0)
+            : m_failAfterChunks(failAfterChunks),
+              m_sleepMicros(sleepMicros),
+              m_hash(0),
+              m_numSamples(0),
+              m_numChunks(0),
+              m_numCleanups(0),
+              m_pThread(nullptr) {
+    }
+
+    bool initialize(const AnalyzerTrack& track,
+            mixxx::audio::SampleRate sampleRate,
+            SINT frameLength) override {
+        Q_UNUSED(track);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(frameLength);
+        m_hash = 0;
+        m_numSamples = 0;
+        m_numChunks = 0;
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT count) override {
+        if (m_sleepMicros > 0) {
+            QThread::usleep(m_sleepMicros);
+        }
+        m_hash = hash(m_hash, pIn, count);
+        m_numSamples += count;
+        m_pThread = QThread::currentThread();
+        return m_failAfterChunks < 0 || ++m_numChunks < m_failAfterChunks;
+    }
+
+    void storeResults(TrackPointer pTrack) override {
+        Q_UNUSED(pTrack);
+    }
+
+    void cleanup() override {
+        ++m_numCleanups;
+    }
+
+    static std::uint64_t hash(std::uint64_t hash, const CSAMPLE* pIn, SINT count) {
+        for (SINT i = 0; i < count; ++i) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &pIn[i], sizeof(bits));
+            hash = (hash ^ bits) * 1099511628211u;
+        }
+        return hash;
+    }
+
+    const int m_failAfterChunks;
+    const unsigned long m_sleepMicros;
+    std::uint64_t m_hash;
+    SINT m_numSamples;
+    int m_numChunks;
+    int m_numCleanups;
+    QThread* m_pThread;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pTrack = Track::newTemporary();
+    }
+
+    void TearDown() override {
+        for (auto& analyzer : m_analyzers) {
+            analyzer.finish(AnalyzerTrack(m_pTrack));
+        }
+    }
+
+    HashAnalyzer* addAnalyzer(int failAfterChunks = -1, unsigned long sleepMicros = 0) {
+        auto pAnalyzer = std::make_unique<HashAnalyzer>(failAfterChunks, sleepMicros);
+        HashAnalyzer* pPlainAnalyzer = pAnalyzer.get();
+        m_analyzers.emplace_back(std::move(pAnalyzer));
+        m_analyzers.back().initialize(AnalyzerTrack(m_pTrack), kSampleRate, 0);
+        return pPlainAnalyzer;
+    }
+
+    static void fillChunk(CSAMPLE* pChunk, SINT numSamples, int chunkIndex) {
+        for (SINT i = 0; i < numSamples; ++i) {
+            pChunk[i] = static_cast<CSAMPLE>(chunkIndex) + static_cast<CSAMPLE>(i) * 1e-6f;
+        }
+    }
+
+    // Submits all chunks and returns the hash of the submitted samples
+    std::uint64_t submitChunks(AnalyzerPipeline* pPipeline) {
+        std::uint64_t expectedHash = 0;
+        for (int i = 0; i < kNumChunks; ++i) {
+            // The last chunk is shorter
+            const SINT numSamples = i == kNumChunks - 1
+                    ? mixxx::kAnalysisSamplesPerChunk / 2
+                    : mixxx::kAnalysisSamplesPerChunk;
+            const auto chunk = pPipeline->nextChunk();
+            EXPECT_EQ(mixxx::kAnalysisSamplesPerChunk, chunk.length());
+            fillChunk(chunk.data(), numSamples, i);
+            expectedHash = HashAnalyzer::hash(expectedHash, chunk.data(), numSamples);
+            pPipeline->submitChunk(chunk.data(), numSamples);
+        }
+        return expectedHash;
+    }
+
+    TrackPointer m_pTrack;
+    std::vector<AnalyzerWithState> m_analyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, AllAnalyzersSeeAllChunksInOrder) {
+    std::vector<HashAnalyzer*> analyzers;
+    analyzers.push_back(addAnalyzer());
+    // Much slower than the others, so the buffers are reused while
+    // chunks are still pending for this stage
+    analyzers.push_back(addAnalyzer(-1, 500));
+    analyzers.push_back(addAnalyzer());
+
+    AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+    const std::uint64_t expectedHash = submitChunks(&pipeline);
+    pipeline.waitUntilIdle();
+
+    for (const HashAnalyzer* pAnalyzer : analyzers) {
+        EXPECT_EQ(expectedHash, pAnalyzer->m_hash);
+        EXPECT_EQ((kNumChunks - 1) * mixxx::kAnalysisSamplesPerChunk +
+                        mixxx::kAnalysisSamplesPerChunk / 2,
+                pAnalyzer->m_numSamples);
+        EXPECT_NE(QThread::currentThread(), pAnalyzer->m_pThread);
+        EXPECT_EQ(0, pAnalyzer->m_numCleanups);
+    }
+    EXPECT_NE(analyzers[0]->m_pThread, analyzers[1]->m_pThread);
+}
+
+TEST_F(AnalyzerPipelineTest, CopiesExternalSamples) {
+    HashAnalyzer* pAnalyzer = addAnalyzer();
+    AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+
+    std::vector<CSAMPLE> samples(1000);
+    fillChunk(samples.data(), 1000, 1);
+    pipeline.nextChunk();
+    pipeline.submitChunk(samples.data(), 1000);
+    pipeline.waitUntilIdle();
+
+    EXPECT_EQ(HashAnalyzer::hash(0, samples.data(), 1000), pAnalyzer->m_hash);
+}
+
+TEST_F(AnalyzerPipelineTest, MovesSamplesDecodedAtAnOffset) {
+    HashAnalyzer* pAnalyzer = addAnalyzer();
+    AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+
+    // Like samples that have been decoded into the chunk, but not at its
+    // start, so the source and the destination overlap
+    const auto chunk = pipeline.nextChunk();
+    constexpr SINT kOffset = 100;
+    const SINT numSamples = chunk.length() - kOffset;
+    fillChunk(chunk.data() + kOffset, numSamples, 1);
+    const std::vector<CSAMPLE> expected(
+            chunk.data() + kOffset, chunk.data() + kOffset + numSamples);
+    pipeline.submitChunk(chunk.data() + kOffset, numSamples);
+    pipeline.waitUntilIdle();
+
+    EXPECT_EQ(HashAnalyzer::hash(0, expected.data(), numSamples), pAnalyzer->m_hash);
+}
+
+TEST_F(AnalyzerPipelineTest, FailedAnalyzerStopsEarly) {
+    HashAnalyzer* pFailing = addAnalyzer(3);
+    HashAnalyzer* pAnalyzer = addAnalyzer();
+
+    AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+    const std::uint64_t expectedHash = submitChunks(&pipeline);
+    pipeline.waitUntilIdle();
+
+    EXPECT_FALSE(m_analyzers[0].isActive());
+    EXPECT_EQ(3 * mixxx::kAnalysisSamplesPerChunk, pFailing->m_numSamples);
+    EXPECT_EQ(1, pFailing->m_numCleanups);
+    EXPECT_TRUE(m_analyzers[1].isActive());
+    EXPECT_EQ(expectedHash, pAnalyzer->m_hash);
+}
+
+TEST_F(AnalyzerPipelineTest, WaitsForPendingChunksWhenDestroyed) {
+    HashAnalyzer* pAnalyzer = addAnalyzer(-1, 100);
+    std::uint64_t expectedHash;
+    {
+        AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+        expectedHash = submitChunks(&pipeline);
+        // An acquired, but unused buffer is released
+        pipeline.nextChunk();
+    }
+    EXPECT_EQ(expectedHash, pAnalyzer->m_hash);
+}
+
+} // namespace
@@ -0,0 +1,67 @@
+#include "analyzer/analyzerstatistics.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(AnalyzerStatisticsTest, AccumulatesPerAnalyzer) {
+    AnalyzerStatistics statistics;
+    statistics.addTrack(QStringLiteral("Beats"),
+            mixxx::Duration::fromSeconds(300),
+            mixxx::Duration::fromSeconds(2));
+    statistics.addTrack(QStringLiteral("Key"),
+            mixxx::Duration::fromSeconds(300),
+            mixxx::Duration::fromSeconds(6));
+    statistics.addTrack(QStringLiteral("Beats"),
+            mixxx::Duration::fromSeconds(100),
+            mixxx::Duration::fromSeconds(2));
+
+    const auto entries = statistics.entries();
+    ASSERT_EQ(2, entries.size());
+    EXPECT_EQ(QStringLiteral("Beats"), entries[0].analyzerName);
+    EXPECT_EQ(2, entries[0].trackCount);
+    EXPECT_EQ(mixxx::Duration::fromSeconds(400), entries[0].audioDuration);
+    EXPECT_EQ(mixxx::Duration::fromSeconds(4), entries[0].processingDuration);
+    EXPECT_DOUBLE_EQ(100, entries[0].realtimeFactor());
+    EXPECT_EQ(QStringLiteral("Key"), entries[1].analyzerName);
+    EXPECT_EQ(1, entries[1].trackCount);
+    EXPECT_DOUBLE_EQ(50, entries[1].realtimeFactor());
+}
+
+TEST(AnalyzerStatisticsTest, UnknownRealtimeFactorWithoutProcessingTime) {
+    AnalyzerStatistics statistics;
+    statistics.addTrack(QStringLiteral("Silence"),
+            mixxx::Duration::fromSeconds(300),
+            mixxx::Duration::empty());
+    EXPECT_EQ(0, statistics.entries().first().realtimeFactor());
+}
+
+TEST(AnalyzerStatisticsTest, AddFromMultipleThreads) {
+    constexpr int kNumThreads = 4;
+    constexpr int kNumTracks = 1000;
+    AnalyzerStatistics statistics;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&statistics] {
+            for (int track = 0; track < kNumTracks; ++track) {
+                statistics.addTrack(QStringLiteral("Waveform"),
+                        mixxx::Duration::fromSeconds(1),
+                        mixxx::Duration::fromMillis(10));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto entries = statistics.entries();
+    ASSERT_EQ(1, entries.size());
+    EXPECT_EQ(kNumThreads * kNumTracks, entries[0].trackCount);
+    EXPECT_EQ(mixxx::Duration::fromSeconds(kNumThreads * kNumTracks),
+            entries[0].audioDuration);
+}
+
+} // namespace
@@ -0,0 +1,121 @@
+#include "analyzer/analyzertrackqueue.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+typedef AnalyzerScheduledTrack::Priority Priority;
+
+TrackId trackId(int id) {
+    return TrackId(QVariant(id));
+}
+
+AnalyzerScheduledTrack scheduledTrack(int id, Priority priority = Priority::Bulk) {
+    return AnalyzerScheduledTrack(trackId(id), AnalyzerTrack::Options(), priority);
+}
+
+std::vector<int> dequeueAll(AnalyzerTrackQueue* pQueue) {
+    std::vector<int> ids;
+    while (!pQueue->empty()) {
+        ids.push_back(pQueue->dequeue().trackId().toVariant().toInt());
+    }
+    return ids;
+}
+
+TEST(AnalyzerTrackQueueTest, HigherPriorityFirstThenInOrder) {
+    AnalyzerTrackQueue queue;
+    queue.enqueue(scheduledTrack(1));
+    queue.enqueue(scheduledTrack(2));
+    queue.enqueue(scheduledTrack(3, Priority::PreviewDeck));
+    queue.enqueue(scheduledTrack(4, Priority::Deck));
+    queue.enqueue(scheduledTrack(5, Priority::PreviewDeck));
+    queue.enqueue(scheduledTrack(6, Priority::SearchResults));
+
+    EXPECT_EQ(std::vector<int>({4, 3, 5, 6, 1, 2}), dequeueAll(&queue));
+}
+
+TEST(AnalyzerTrackQueueTest, EnqueueAgainOnlyRaisesPriority) {
+    AnalyzerTrackQueue queue;
+    EXPECT_TRUE(queue.enqueue(scheduledTrack(1)));
+    EXPECT_TRUE(queue.enqueue(scheduledTrack(2, Priority::AutoDJ)));
+    EXPECT_TRUE(queue.enqueue(scheduledTrack(3)));
+    EXPECT_FALSE(queue.enqueue(scheduledTrack(3, Priority::Deck)));
+    EXPECT_FALSE(queue.enqueue(scheduledTrack(2)));
+    EXPECT_EQ(3, queue.size());
+
+    EXPECT_EQ(std::vector<int>({3, 2, 1}), dequeueAll(&queue));
+}
+
+TEST(AnalyzerTrackQueueTest, EnqueueWithHigherPriorityReplacesOptions) {
+    AnalyzerTrackQueue queue;
+    queue.enqueue(scheduledTrack(1, Priority::PreviewDeck));
+    AnalyzerTrack::Options options;
+    options.progressive = true;
+    queue.enqueue(AnalyzerScheduledTrack(trackId(1), options, Priority::Bulk));
+    EXPECT_FALSE(queue.front().track.getOptions().progressive);
+    queue.enqueue(AnalyzerScheduledTrack(trackId(1), options, Priority::Deck));
+    EXPECT_TRUE(queue.front().track.getOptions().progressive);
+    EXPECT_EQ(Priority::Deck, queue.front().priority);
+}
+
+TEST(AnalyzerTrackQueueTest, SetPriority) {
+    AnalyzerTrackQueue queue;
+    queue.enqueue(scheduledTrack(1, Priority::Deck));
+    queue.enqueue(scheduledTrack(2, Priority::Deck));
+    queue.enqueue(scheduledTrack(3));
+
+    EXPECT_TRUE(queue.setPriority(trackId(1), Priority::Bulk));
+    EXPECT_TRUE(queue.setPriority(trackId(3), Priority::AutoDJ));
+    EXPECT_FALSE(queue.setPriority(trackId(4), Priority::Deck));
+
+    // Track 1 keeps its position among the tracks with the same priority
+    EXPECT_EQ(Priority::Deck, queue.front().priority);
+    EXPECT_EQ(std::vector<int>({2, 3, 1}), dequeueAll(&queue));
+}
+
+TEST(AnalyzerTrackQueueTest, RequeueAtOriginalPosition) {
+    AnalyzerTrackQueue queue;
+    const auto enqueuedAt = AnalyzerTrackQueue::Clock::now();
+    queue.enqueue(scheduledTrack(1), enqueuedAt);
+    queue.enqueue(scheduledTrack(2));
+    queue.enqueue(scheduledTrack(3));
+
+    auto entry = queue.dequeue();
+    EXPECT_EQ(trackId(1), entry.trackId());
+    queue.enqueue(scheduledTrack(4, Priority::Deck));
+    queue.requeue(std::move(entry));
+
+    EXPECT_EQ(trackId(4), queue.dequeue().trackId());
+    EXPECT_EQ(trackId(1), queue.front().trackId());
+    EXPECT_EQ(enqueuedAt, queue.front().enqueuedAt);
+    EXPECT_EQ(std::vector<int>({1, 2, 3}), dequeueAll(&queue));
+}
+
+TEST(AnalyzerTrackQueueTest, RequeueMergesWithEnqueuedAgain) {
+    AnalyzerTrackQueue queue;
+    queue.enqueue(scheduledTrack(1));
+    queue.enqueue(scheduledTrack(2));
+
+    auto entry = queue.dequeue();
+    // Loaded into a deck while being analyzed
+    queue.enqueue(scheduledTrack(1, Priority::Deck));
+    queue.enqueue(scheduledTrack(3, Priority::Deck));
+    queue.requeue(std::move(entry));
+
+    EXPECT_EQ(3, queue.size());
+    EXPECT_EQ(Priority::Deck, queue.front().priority);
+    EXPECT_EQ(std::vector<int>({1, 3, 2}), dequeueAll(&queue));
+}
+
+TEST(AnalyzerTrackQueueTest, Clear) {
+    AnalyzerTrackQueue queue;
+    queue.enqueue(scheduledTrack(1));
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.contains(trackId(1)));
+    EXPECT_TRUE(queue.enqueue(scheduledTrack(1)));
+}
+
+} // namespace
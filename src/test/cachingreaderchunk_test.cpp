@@ -0,0 +1,121 @@
+#include "engine/cachingreader/cachingreaderchunk.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <vector>
+
+#include "test/mixxxtest.h"
+
+namespace {
+
+// 60 minutes at 48 kHz
+constexpr SINT kLongTrackFrames = 60 * 60 * 48000;
+
+class CachingReaderChunkTest : public MixxxTest {
+};
+
+TEST_F(CachingReaderChunkTest, TableSizeCoversAllChunks) {
+    EXPECT_EQ(0,
+            CachingReaderChunkTable::sizeForFrameIndexRange(
+                    mixxx::IndexRange()));
+    EXPECT_EQ(1,
+            CachingReaderChunkTable::sizeForFrameIndexRange(
+                    mixxx::IndexRange::forward(0, CachingReaderChunk::kFrames)));
+    EXPECT_EQ(2,
+            CachingReaderChunkTable::sizeForFrameIndexRange(
+                    mixxx::IndexRange::forward(0, CachingReaderChunk::kFrames + 1)));
+    // The range does not need to start at 0
+    EXPECT_EQ(3,
+            CachingReaderChunkTable::sizeForFrameIndexRange(
+                    mixxx::IndexRange::forward(
+                            2 * CachingReaderChunk::kFrames, 1)));
+}
+
+TEST_F(CachingReaderChunkTest, TableInsertLookupRemove) {
+    CachingReaderChunkSlab slab(2);
+    CachingReaderChunkTable table(4);
+    EXPECT_EQ(nullptr, table.lookup(0));
+    EXPECT_EQ(nullptr, table.lookup(-1));
+    EXPECT_EQ(nullptr, table.lookup(4));
+
+    EXPECT_TRUE(table.insert(3, slab.chunk(0)));
+    EXPECT_EQ(slab.chunk(0), table.lookup(3));
+
+    // Entries of other chunks are not removed
+    table.remove(3, slab.chunk(1));
+    EXPECT_EQ(slab.chunk(0), table.lookup(3));
+    table.remove(3, slab.chunk(0));
+    EXPECT_EQ(nullptr, table.lookup(3));
+}
+
+TEST_F(CachingReaderChunkTest, FreeListIsLastInFirstOut) {
+    CachingReaderChunkSlab slab(3);
+    CachingReaderChunkForOwner* pHead = nullptr;
+    EXPECT_EQ(nullptr, CachingReaderChunkForOwner::popFromFreeList(&pHead));
+    for (SINT i = 0; i < slab.size(); ++i) {
+        slab.chunk(i)->pushOntoFreeList(&pHead);
+    }
+    EXPECT_EQ(slab.chunk(2), CachingReaderChunkForOwner::popFromFreeList(&pHead));
+    EXPECT_EQ(slab.chunk(1), CachingReaderChunkForOwner::popFromFreeList(&pHead));
+    // A popped chunk can be pushed again
+    slab.chunk(2)->pushOntoFreeList(&pHead);
+    EXPECT_EQ(slab.chunk(2), CachingReaderChunkForOwner::popFromFreeList(&pHead));
+    EXPECT_EQ(slab.chunk(0), CachingReaderChunkForOwner::popFromFreeList(&pHead));
+    EXPECT_EQ(nullptr, pHead);
+}
+
+// The chunk indices that hintAndMaybeWake() looks up in each callback for
+// the playhead and the given number of hotcues spread over a long track.
+std::vector<SINT> hintedChunkIndices(int numHotcues) {
+    const SINT numChunks = CachingReaderChunkTable::sizeForFrameIndexRange(
+            mixxx::IndexRange::forward(0, kLongTrackFrames));
+    std::vector<SINT> chunkIndices;
+    // Playhead
+    chunkIndices.push_back(numChunks / 3);
+    for (int i = 0; i < numHotcues; ++i) {
+        chunkIndices.push_back((i + 1) * numChunks / (numHotcues + 1));
+    }
+    return chunkIndices;
+}
+
+static void BM_ChunkIndexLookupHash(benchmark::State& state) {
+    const std::vector<SINT> chunkIndices = hintedChunkIndices(state.range(0));
+    CachingReaderChunkSlab slab(1);
+    QHash<int, CachingReaderChunkForOwner*> index;
+    index.reserve(80);
+    for (const auto chunkIndex : chunkIndices) {
+        index.insert(chunkIndex, slab.chunk(0));
+    }
+    for (auto _ : state) {
+        for (const auto chunkIndex : chunkIndices) {
+            benchmark::DoNotOptimize(index.value(chunkIndex, nullptr));
+            // The adjacent chunk is missing
+            benchmark::DoNotOptimize(index.value(chunkIndex + 1, nullptr));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * chunkIndices.size() * 2);
+}
+BENCHMARK(BM_ChunkIndexLookupHash)->Arg(0)->Arg(8)->Arg(36);
+
+static void BM_ChunkIndexLookupTable(benchmark::State& state) {
+    const std::vector<SINT> chunkIndices = hintedChunkIndices(state.range(0));
+    CachingReaderChunkSlab slab(1);
+    CachingReaderChunkTable index(CachingReaderChunkTable::sizeForFrameIndexRange(
+            mixxx::IndexRange::forward(0, kLongTrackFrames)));
+    for (const auto chunkIndex : chunkIndices) {
+        index.insert(chunkIndex, slab.chunk(0));
+    }
+    for (auto _ : state) {
+        for (const auto chunkIndex : chunkIndices) {
+            benchmark::DoNotOptimize(index.lookup(chunkIndex));
+            // The adjacent chunk is missing
+            benchmark::DoNotOptimize(index.lookup(chunkIndex + 1));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * chunkIndices.size() * 2);
+}
+BENCHMARK(BM_ChunkIndexLookupTable)->Arg(0)->Arg(8)->Arg(36);
+
+} // namespace
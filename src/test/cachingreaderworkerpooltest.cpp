@@ -0,0 +1,104 @@
+#include "engine/cachingreader/cachingreaderworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "engine/cachingreader/cachingreader.h"
+#include "engine/engineworkerscheduler.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[Channel1]");
+
+constexpr int kDecodeThreads = 4;
+constexpr SINT kHintedChunks = 64;
+constexpr int kTimeoutMillis = 10000;
+
+class CachingReaderWorkerPoolTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    void SetUp() override {
+        config()->set(ConfigKey(QStringLiteral("[CachingReader]"),
+                              QStringLiteral("decode_threads")),
+                ConfigValue(kDecodeThreads));
+        // Enough chunks to keep all hinted chunks in the cache
+        config()->set(ConfigKey(QStringLiteral("[CachingReader]"),
+                              QStringLiteral("deck_chunks")),
+                ConfigValue(static_cast<int>(2 * kHintedChunks)));
+        m_pScheduler = std::make_unique<EngineWorkerScheduler>();
+        m_pScheduler->start();
+        m_pReader = std::make_unique<CachingReader>(kGroup, config());
+        m_pReader->setScheduler(m_pScheduler.get());
+        QObject::connect(
+                m_pReader.get(),
+                &CachingReader::trackLoaded,
+                m_pReader.get(),
+                [this]() {
+                    m_trackLoaded.store(true);
+                },
+                Qt::DirectConnection);
+    }
+
+    void TearDown() override {
+        // Joins the scheduler thread before the worker is destroyed
+        m_pScheduler.reset();
+        m_pReader.reset();
+    }
+
+    // Runs the callbacks of the engine until all frames in the range
+    // have been read into the cache
+    bool readUntilAvailable(SINT startFrame, SINT frameCount) {
+        HintVector hints;
+        hints.append(Hint{startFrame, frameCount, Hint::Type::CurrentPosition});
+        std::vector<CSAMPLE> buffer(CachingReaderChunk::frames2samples(frameCount));
+        QElapsedTimer timer;
+        timer.start();
+        while (!timer.hasExpired(kTimeoutMillis)) {
+            m_pReader->process();
+            if (m_pReader->read(CachingReaderChunk::frames2samples(startFrame),
+                        static_cast<SINT>(buffer.size()),
+                        false,
+                        buffer.data()) == CachingReader::ReadResult::AVAILABLE) {
+                return true;
+            }
+            m_pReader->hintAndMaybeWake(hints);
+            m_pScheduler->runWorkers();
+            QThread::msleep(1);
+        }
+        return false;
+    }
+
+    std::unique_ptr<EngineWorkerScheduler> m_pScheduler;
+    std::unique_ptr<CachingReader> m_pReader;
+    std::atomic<bool> m_trackLoaded{false};
+};
+
+TEST_F(CachingReaderWorkerPoolTest, DecodeHintedChunksOfOneDeckInParallel) {
+    m_pReader->newTrack(Track::newTemporary(
+            getTestDir().filePath(QStringLiteral("sine-30.wav"))));
+    m_pScheduler->runWorkers();
+    QElapsedTimer timer;
+    timer.start();
+    while (!m_trackLoaded.load()) {
+        ASSERT_FALSE(timer.hasExpired(kTimeoutMillis));
+        QThread::msleep(1);
+    }
+
+    // A burst of hinted chunks, e.g. after jumping to a hotcue
+    ASSERT_TRUE(readUntilAvailable(0, kHintedChunks * CachingReaderChunk::kFrames));
+
+    // Concurrent reads of the same track can only happen on different
+    // threads. The metrics are updated with the next hints.
+    m_pReader->hintAndMaybeWake(HintVector());
+    EXPECT_LT(0.0, ControlObject::get(ConfigKey(kGroup, QStringLiteral("cache_parallel_reads"))));
+}
+
+} // namespace
@@ -0,0 +1,88 @@
+#include "control/controlchangejournal.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "control/controlobject.h"
+#include "control/controlproxy.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class ControlChangeJournalTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pControl = std::make_unique<ControlObject>(
+                ConfigKey(QStringLiteral("[Test]"), QStringLiteral("journal")));
+        ControlChangeJournal::setEnabled(true);
+    }
+
+    void TearDown() override {
+        ControlChangeJournal::drain();
+        ControlChangeJournal::setEnabled(false);
+    }
+
+    std::unique_ptr<ControlProxy> connectProxy() {
+        auto pProxy = std::make_unique<ControlProxy>(m_pControl->getKey());
+        pProxy->connectValueChangedCoalesced(&m_receiver, [this](double value) {
+            m_values.push_back(value);
+        });
+        return pProxy;
+    }
+
+    std::unique_ptr<ControlObject> m_pControl;
+    QObject m_receiver;
+    std::vector<double> m_values;
+};
+
+TEST_F(ControlChangeJournalTest, DeliversLatestValueOncePerDrain) {
+    const auto pProxy = connectProxy();
+    m_pControl->set(1.0);
+    m_pControl->set(2.0);
+    m_pControl->set(3.0);
+    EXPECT_TRUE(m_values.empty());
+
+    EXPECT_EQ(1, ControlChangeJournal::drain());
+    ASSERT_EQ(1u, m_values.size());
+    EXPECT_DOUBLE_EQ(3.0, m_values.back());
+
+    // Nothing changed since the last drain
+    EXPECT_EQ(0, ControlChangeJournal::drain());
+    EXPECT_EQ(1u, m_values.size());
+}
+
+TEST_F(ControlChangeJournalTest, SharesSlotBetweenProxies) {
+    const auto pProxy1 = connectProxy();
+    auto pProxy2 = connectProxy();
+    m_pControl->set(1.0);
+    EXPECT_EQ(1, ControlChangeJournal::drain());
+    EXPECT_EQ(2u, m_values.size());
+
+    pProxy2.reset();
+    m_pControl->set(2.0);
+    EXPECT_EQ(1, ControlChangeJournal::drain());
+    EXPECT_EQ(3u, m_values.size());
+}
+
+TEST_F(ControlChangeJournalTest, ReleasesSlotWithLastProxy) {
+    auto pProxy = connectProxy();
+    EXPECT_LE(0, ControlDoublePrivate::getControl(m_pControl->getKey())->journalIndex());
+    pProxy.reset();
+    EXPECT_EQ(-1, ControlDoublePrivate::getControl(m_pControl->getKey())->journalIndex());
+    m_pControl->set(1.0);
+    EXPECT_EQ(0, ControlChangeJournal::drain());
+}
+
+TEST_F(ControlChangeJournalTest, FallsBackToSignalsWhenDisabled) {
+    ControlChangeJournal::setEnabled(false);
+    const auto pProxy = connectProxy();
+    m_pControl->set(1.0);
+    // Same thread, so the auto connection is direct
+    ASSERT_EQ(1u, m_values.size());
+    EXPECT_DOUBLE_EQ(1.0, m_values.back());
+    EXPECT_EQ(0, ControlChangeJournal::drain());
+}
+
+} // namespace
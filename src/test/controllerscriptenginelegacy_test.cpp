@@ -147,6 +147,39 @@ TEST_F(ControllerScriptEngineLegacyTest, getSetValue) {
     EXPECT_DOUBLE_EQ(1.0, co->get());
 }
 
+TEST_F(ControllerScriptEngineLegacyTest, getSetValueByHandle) {
+    auto co = std::make_unique<ControlObject>(ConfigKey("[Test]", "co"));
+    EXPECT_TRUE(
+            evaluateAndAssert("var handle = engine.getControlHandle('[Test]', 'co');"
+                              "engine.setValueByHandle(handle, "
+                              "engine.getValueByHandle(handle) + 1);"));
+    EXPECT_DOUBLE_EQ(1.0, co->get());
+    // The same control resolves to the same handle
+    EXPECT_TRUE(evaluateAndAssert(
+            "if (engine.getControlHandle('[Test]', 'co') !== handle) {"
+            "  throw new Error('different handle');"
+            "}"));
+    EXPECT_TRUE(evaluateAndAssert("engine.setValueByHandle(handle, NaN);"));
+    EXPECT_DOUBLE_EQ(1.0, co->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, getSetParameterByHandle) {
+    auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
+            -10.0,
+            10.0);
+    EXPECT_TRUE(evaluateAndAssert(
+            "var handle = engine.getControlHandle('[Test]', 'co');"
+            "engine.setParameterByHandle(handle, "
+            "  engine.getParameterByHandle(handle) + 0.1);"));
+    EXPECT_DOUBLE_EQ(2.0, co->get());
+}
+
+TEST_F(ControllerScriptEngineLegacyTest, getValueByHandle_InvalidHandle) {
+    EXPECT_TRUE(evaluateAndAssert("engine.getControlHandle('[Nothing]', 'nothing');"));
+    EXPECT_TRUE(evaluateAndAssert("engine.getValueByHandle(-1);"));
+    EXPECT_TRUE(evaluateAndAssert("engine.setValueByHandle(1000, 1.0);"));
+}
+
 TEST_F(ControllerScriptEngineLegacyTest, setParameter) {
     auto co = std::make_unique<ControlPotmeter>(ConfigKey("[Test]", "co"),
             -10.0,
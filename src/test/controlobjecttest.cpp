@@ -1,7 +1,11 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QtDebug>
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "control/controlobject.h"
 #include "test/mixxxtest.h"
@@ -86,4 +90,54 @@ TEST_F(ControlObjectTest, Persistence_ValidValue) {
     EXPECT_DOUBLE_EQ(5.0, co.get());
 }
 
+TEST_F(ControlObjectTest, getControlConcurrently) {
+    std::vector<std::unique_ptr<ControlObject>> controls;
+    std::vector<ConfigKey> keys;
+    for (int i = 0; i < 64; ++i) {
+        keys.emplace_back(QStringLiteral("[Channel%1]").arg(i % 4 + 1),
+                QStringLiteral("concurrent%1").arg(i));
+        controls.push_back(std::make_unique<ControlObject>(keys.back()));
+    }
+
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int n = 0; n < 100; ++n) {
+                for (std::size_t i = 0; i < keys.size(); ++i) {
+                    if (ControlObject::getControl(keys[i]) != controls[i].get()) {
+                        ++mismatches;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(0, mismatches.load());
+}
+
+static void BM_GetControl(benchmark::State& state) {
+    static std::vector<std::unique_ptr<ControlObject>> s_controls;
+    static std::vector<ConfigKey> s_keys;
+    if (state.thread_index() == 0) {
+        for (int i = 0; i < 1000; ++i) {
+            s_keys.emplace_back(QStringLiteral("[Channel%1]").arg(i % 8 + 1),
+                    QStringLiteral("benchmark%1").arg(i));
+            s_controls.push_back(std::make_unique<ControlObject>(s_keys.back()));
+        }
+    }
+    std::size_t i = state.thread_index();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ControlObject::getControl(s_keys[i % s_keys.size()]));
+        i += 7;
+    }
+    if (state.thread_index() == 0) {
+        s_controls.clear();
+        s_keys.clear();
+    }
+}
+BENCHMARK(BM_GetControl)->ThreadRange(1, 8)->UseRealTime();
+
 } // namespace
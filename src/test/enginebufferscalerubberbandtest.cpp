@@ -0,0 +1,224 @@
+#include "engine/bufferscalers/enginebufferscalerubberband.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine/engineworkerscheduler.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr SINT kBufferFrames = 512;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+constexpr double kRate = 1.06;
+constexpr int kLookaheadMillis = 200;
+
+/// Plays a sine and jumps back to the start at a given frame, like a loop.
+/// Like ReadAheadManager, a loop end behind the read position is not taken.
+class ReadAheadManagerSine : public ReadAheadManager {
+  public:
+    ReadAheadManagerSine()
+            : m_frame(0),
+              m_loopEnd(-1),
+              m_loops(0) {
+    }
+
+    SINT getNextSamples(double dRate, CSAMPLE* buffer, SINT requested_samples) override {
+        Q_UNUSED(dRate);
+        SINT frames = requested_samples / mixxx::kEngineChannelCount;
+        if (m_loopEnd >= m_frame && m_frame + frames > m_loopEnd) {
+            frames = m_loopEnd - m_frame;
+        }
+        for (SINT i = 0; i < frames; ++i) {
+            const auto value = static_cast<CSAMPLE>(
+                    0.5 * std::sin(2 * M_PI * 0.01 * m_frame++));
+            buffer[2 * i] = value;
+            buffer[2 * i + 1] = value;
+        }
+        if (m_frame == m_loopEnd) {
+            m_frame = 0;
+            ++m_loops;
+        }
+        return frames * mixxx::kEngineChannelCount;
+    }
+
+    double getPlaypos() const override {
+        return static_cast<double>(m_frame * mixxx::kEngineChannelCount);
+    }
+
+    void notifySeek(double seekPosition) override {
+        m_frame = static_cast<SINT>(seekPosition) / mixxx::kEngineChannelCount;
+    }
+
+    SINT frame() const {
+        return m_frame;
+    }
+
+    void setLoopEnd(SINT loopEnd) {
+        m_loopEnd = loopEnd;
+    }
+
+    int loops() const {
+        return m_loops;
+    }
+
+  private:
+    SINT m_frame;
+    SINT m_loopEnd;
+    int m_loops;
+};
+
+class EngineBufferScaleRubberBandTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pScheduler = std::make_unique<EngineWorkerScheduler>();
+        m_pScheduler->start();
+        m_pScaler = std::make_unique<EngineBufferScaleRubberBand>(&m_readAheadManager);
+        m_pScaler->setLookahead(kLookaheadMillis);
+        m_pScaler->setScheduler(m_pScheduler.get());
+        m_pScaler->setSampleRate(mixxx::audio::SampleRate(44100));
+        setRate(kRate);
+        m_pScaler->clear();
+    }
+
+    void TearDown() override {
+        // Joins the scheduler thread before the worker is destroyed
+        m_pScheduler.reset();
+        m_pScaler.reset();
+    }
+
+    void setRate(double rate) {
+        double tempoRatio = rate;
+        double pitchRatio = 1.0;
+        m_pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    }
+
+    /// Plays one buffer like the engine callback and waits for the worker
+    /// to process the input that has been read ahead, so the results do not
+    /// depend on the scheduling of the worker thread.
+    double play() {
+        const double framesRead = m_pScaler->scaleBuffer(m_output.data(), kBufferSamples);
+        for (SINT i = 0; i < kBufferFrames; ++i) {
+            m_played.push_back(m_output[2 * i]);
+        }
+        m_pScheduler->runWorkers();
+        m_pScaler->waitUntilLookaheadProcessed();
+        return framesRead;
+    }
+
+    ReadAheadManagerSine m_readAheadManager;
+    std::unique_ptr<EngineWorkerScheduler> m_pScheduler;
+    std::unique_ptr<EngineBufferScaleRubberBand> m_pScaler;
+    mixxx::SampleBuffer m_output{kBufferSamples};
+    std::vector<CSAMPLE> m_played;
+};
+
+TEST_F(EngineBufferScaleRubberBandTest, LookaheadTakesOverSeamlessly) {
+    double framesRead = 0;
+    for (int i = 0; i < 32; ++i) {
+        framesRead += play();
+    }
+    EXPECT_TRUE(m_pScaler->hasLookahead());
+    for (int i = 0; i < 100; ++i) {
+        framesRead += play();
+        EXPECT_TRUE(m_pScaler->hasLookahead());
+    }
+    EXPECT_NEAR(132 * kBufferFrames * kRate, framesRead, 1e-6);
+    // The lookahead has been read, but not much more
+    EXPECT_GT(m_readAheadManager.frame(), framesRead + 44100 * kLookaheadMillis / 1000 / 2);
+    EXPECT_LT(m_readAheadManager.frame(), framesRead + 44100 * kLookaheadMillis / 1000 * 2);
+
+    // No gaps or jumps in the sine after the initial fade in
+    for (std::size_t i = 8 * kBufferFrames; i < m_played.size(); ++i) {
+        EXPECT_LT(std::abs(m_played[i] - m_played[i - 1]), 0.1f) << i;
+    }
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, ClearStopsLookahead) {
+    for (int i = 0; i < 40; ++i) {
+        play();
+    }
+    ASSERT_TRUE(m_pScaler->hasLookahead());
+    m_pScaler->clear();
+    EXPECT_FALSE(m_pScaler->hasLookahead());
+    play();
+    EXPECT_FALSE(m_pScaler->hasLookahead());
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, RateChangeStopsLookahead) {
+    for (int i = 0; i < 40; ++i) {
+        play();
+    }
+    ASSERT_TRUE(m_pScaler->hasLookahead());
+    setRate(0.9);
+    EXPECT_FALSE(m_pScaler->hasLookahead());
+    // Plays the remaining output and continues without gaps
+    for (int i = 0; i < 20; ++i) {
+        play();
+    }
+    for (std::size_t i = 8 * kBufferFrames; i < m_played.size(); ++i) {
+        EXPECT_LT(std::abs(m_played[i] - m_played[i - 1]), 0.1f) << i;
+    }
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, LoopStopsLookahead) {
+    for (int i = 0; i < 40; ++i) {
+        play();
+    }
+    ASSERT_TRUE(m_pScaler->hasLookahead());
+    m_readAheadManager.setLoopEnd(m_readAheadManager.frame() + kBufferFrames);
+    // Stops after the audio up to the loop end has been played
+    for (int i = 0; i < 40 && m_pScaler->hasLookahead(); ++i) {
+        play();
+    }
+    EXPECT_FALSE(m_pScaler->hasLookahead());
+}
+
+TEST_F(EngineBufferScaleRubberBandTest, LoopBehindReadAheadPosition) {
+    double framesRead = 0;
+    for (int i = 0; i < 40; ++i) {
+        framesRead += play();
+    }
+    ASSERT_TRUE(m_pScaler->hasLookahead());
+    // A loop that ends between the play position and the input that has
+    // been read ahead for the worker
+    const auto playedFrame = static_cast<SINT>(framesRead);
+    const SINT loopEnd = playedFrame + 6 * kBufferFrames;
+    ASSERT_LT(loopEnd, m_readAheadManager.frame());
+    m_readAheadManager.setLoopEnd(loopEnd);
+    for (int i = 0; i < 2; ++i) {
+        framesRead += play();
+    }
+    // Not taken by reading ahead
+    EXPECT_EQ(0, m_readAheadManager.loops());
+
+    // What EngineBuffer does when the ReadAheadManager has read past the loop
+    const SINT playPosition = static_cast<SINT>(framesRead);
+    play();
+    m_readAheadManager.notifySeek(static_cast<double>(
+            playPosition * mixxx::kEngineChannelCount));
+    m_pScaler->clear();
+    EXPECT_FALSE(m_pScaler->hasLookahead());
+
+    // Continues from the play position without waiting for the worker and
+    // takes the loop, no buffer is silent
+    const std::size_t playedBefore = m_played.size();
+    for (int i = 0; i < 8; ++i) {
+        play();
+    }
+    EXPECT_EQ(1, m_readAheadManager.loops());
+    for (std::size_t i = playedBefore + kBufferFrames; i < m_played.size(); i += kBufferFrames) {
+        const auto [min, max] = std::minmax_element(
+                m_played.begin() + i - kBufferFrames, m_played.begin() + i);
+        EXPECT_GT(*max - *min, 0.2f) << i;
+    }
+}
+
+} // namespace
@@ -0,0 +1,257 @@
+#include "engine/bufferscalers/enginebufferscalesinc.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "engine/bufferscalers/enginebufferscalelinear.h"
+#include "engine/bufferscalers/enginebufferscalest.h"
+#include "engine/readaheadmanager.h"
+#include "test/mixxxtest.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr SINT kBufferFrames = 512;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+
+/// Generates a signal as a function of the frame index and follows the
+/// direction of the rate like the real ReadAheadManager.
+class ReadAheadManagerSignal : public ReadAheadManager {
+  public:
+    explicit ReadAheadManagerSignal(std::function<CSAMPLE(SINT)> signal)
+            : m_signal(std::move(signal)),
+              m_frame(0) {
+    }
+
+    SINT getNextSamples(double dRate, CSAMPLE* buffer, SINT requested_samples) override {
+        const SINT frames = requested_samples / mixxx::kEngineChannelCount;
+        for (SINT i = 0; i < frames; ++i) {
+            const CSAMPLE value = m_signal(m_frame);
+            buffer[2 * i] = value;
+            buffer[2 * i + 1] = -value;
+            m_frame += dRate < 0 ? -1 : 1;
+        }
+        return frames * mixxx::kEngineChannelCount;
+    }
+
+    SINT frame() const {
+        return m_frame;
+    }
+
+  private:
+    std::function<CSAMPLE(SINT)> m_signal;
+    SINT m_frame;
+};
+
+CSAMPLE sine(double frame, double frequency) {
+    return static_cast<CSAMPLE>(std::sin(2 * M_PI * frequency * frame));
+}
+
+void setRateNoLerp(EngineBufferScale* pScaler, double rate) {
+    pScaler->setSampleRate(mixxx::audio::SampleRate(44100));
+    // Set it twice to prevent rate LERP'ing
+    for (int i = 0; i < 2; ++i) {
+        double tempoRatio = rate;
+        double pitchRatio = rate;
+        pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    }
+}
+
+class EngineBufferScaleSincTest : public MixxxTest,
+                                  public ::testing::WithParamInterface<
+                                          EngineBufferScaleSinc::Quality> {
+};
+
+TEST_P(EngineBufferScaleSincTest, ScaleConstant) {
+    ReadAheadManagerSignal readAheadManager([](SINT) { return 0.5f; });
+    EngineBufferScaleSinc scaler(&readAheadManager, GetParam());
+    setRateNoLerp(&scaler, 0.87);
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    for (int i = 0; i < 4; ++i) {
+        scaler.scaleBuffer(output.data(), kBufferSamples);
+    }
+    for (SINT i = 0; i < kBufferFrames; ++i) {
+        EXPECT_NEAR(0.5f, output[2 * i], 1e-5f);
+        EXPECT_NEAR(-0.5f, output[2 * i + 1], 1e-5f);
+    }
+}
+
+TEST_P(EngineBufferScaleSincTest, UnityRateIsSamplePerfect) {
+    ReadAheadManagerSignal readAheadManager([](SINT frame) {
+        return static_cast<CSAMPLE>(frame % 1000);
+    });
+    EngineBufferScaleSinc scaler(&readAheadManager, GetParam());
+    setRateNoLerp(&scaler, 1.0);
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    for (int buffer = 0; buffer < 4; ++buffer) {
+        EXPECT_DOUBLE_EQ(kBufferFrames,
+                scaler.scaleBuffer(output.data(), kBufferSamples));
+        for (SINT i = 0; i < kBufferFrames; ++i) {
+            EXPECT_FLOAT_EQ((buffer * kBufferFrames + i) % 1000, output[2 * i]);
+        }
+    }
+    // No read ahead at unity rate
+    EXPECT_EQ(4 * kBufferFrames, readAheadManager.frame());
+}
+
+TEST_P(EngineBufferScaleSincTest, InterpolatesSine) {
+    constexpr double kFrequency = 0.01;
+    for (const double rate : {0.7, 1.37}) {
+        ReadAheadManagerSignal readAheadManager([](SINT frame) {
+            return sine(frame, kFrequency);
+        });
+        EngineBufferScaleSinc scaler(&readAheadManager, GetParam());
+        setRateNoLerp(&scaler, rate);
+
+        mixxx::SampleBuffer output(kBufferSamples);
+        // The first buffer starts with the silence before the first frame
+        double position = scaler.scaleBuffer(output.data(), kBufferSamples);
+        for (int buffer = 0; buffer < 8; ++buffer) {
+            const double framesRead = scaler.scaleBuffer(output.data(), kBufferSamples);
+            EXPECT_NEAR(kBufferFrames * rate, framesRead, 1e-6);
+            for (SINT i = 0; i < kBufferFrames; ++i) {
+                EXPECT_NEAR(sine(position + i * rate, kFrequency), output[2 * i], 1e-3f);
+            }
+            position += framesRead;
+        }
+    }
+}
+
+TEST_P(EngineBufferScaleSincTest, SuppressesAliasing) {
+    // Close to the Nyquist frequency of the input, i.e. beyond the Nyquist
+    // frequency of the output at double speed
+    ReadAheadManagerSignal readAheadManager([](SINT frame) {
+        return sine(frame, 0.46);
+    });
+    EngineBufferScaleSinc scaler(&readAheadManager, GetParam());
+    setRateNoLerp(&scaler, 2.0);
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    for (int i = 0; i < 4; ++i) {
+        scaler.scaleBuffer(output.data(), kBufferSamples);
+    }
+    const CSAMPLE rms = std::sqrt(
+            SampleUtil::sumSquared(output.data(), kBufferSamples) / kBufferSamples);
+    // -50 dB relative to the RMS of the input
+    EXPECT_LT(rms, std::sqrt(0.5f) * 0.00316f);
+}
+
+TEST_P(EngineBufferScaleSincTest, DirectionChangeIsContinuous) {
+    ReadAheadManagerSignal readAheadManager([](SINT frame) {
+        return static_cast<CSAMPLE>(frame * 1e-4);
+    });
+    EngineBufferScaleSinc scaler(&readAheadManager, GetParam());
+    setRateNoLerp(&scaler, 1.3);
+
+    std::vector<CSAMPLE> played;
+    mixxx::SampleBuffer output(kBufferSamples);
+    const auto play = [&] {
+        scaler.scaleBuffer(output.data(), kBufferSamples);
+        for (SINT i = 0; i < kBufferFrames; ++i) {
+            played.push_back(output[2 * i]);
+        }
+    };
+    for (int i = 0; i < 4; ++i) {
+        play();
+    }
+    double tempoRatio = -0.9;
+    double pitchRatio = -0.9;
+    scaler.setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    play();
+    scaler.setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    for (int i = 0; i < 4; ++i) {
+        play();
+    }
+
+    // Skip the fade in from the silence before the first frame
+    for (std::size_t i = kBufferFrames; i < played.size(); ++i) {
+        EXPECT_LE(std::abs(played[i] - played[i - 1]), 1.3e-4 * 1.05) << i;
+    }
+    // The turning point after ramping down to zero within half a buffer
+    const double turningPosition = 4 * kBufferFrames * 1.3 +
+            (kBufferFrames / 2) * 1.3 - (kBufferFrames / 2 - 1) * 1.3 / 2;
+    EXPECT_NEAR(turningPosition * 1e-4,
+            *std::max_element(played.begin(), played.end()),
+            1e-4);
+}
+
+INSTANTIATE_TEST_SUITE_P(EngineBufferScaleSincQualities,
+        EngineBufferScaleSincTest,
+        ::testing::Values(EngineBufferScaleSinc::Quality::Short,
+                EngineBufferScaleSinc::Quality::Medium,
+                EngineBufferScaleSinc::Quality::Long));
+
+// The rates in per mille, i.e. unity, a semitone up, a bit slower, a fifth
+// up and double speed
+void rateArgs(benchmark::internal::Benchmark* pBenchmark) {
+    for (const int rate : {1000, 1059, 920, 1498, 2000}) {
+        pBenchmark->Arg(rate);
+    }
+}
+
+void runScaleBenchmark(benchmark::State& state, EngineBufferScale* pScaler) {
+    const double rate = state.range(0) / 1000.0;
+    double tempoRatio = rate;
+    double pitchRatio = rate;
+    pScaler->setSampleRate(mixxx::audio::SampleRate(44100));
+    pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    for (auto _ : state) {
+        pScaler->scaleBuffer(output.data(), kBufferSamples);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kBufferFrames);
+}
+
+CSAMPLE benchmarkSignal(SINT frame) {
+    return sine(frame, 0.013) * 0.5f + sine(frame, 0.31) * 0.25f;
+}
+
+static void BM_ScaleLinear(benchmark::State& state) {
+    ReadAheadManagerSignal readAheadManager(&benchmarkSignal);
+    EngineBufferScaleLinear scaler(&readAheadManager);
+    runScaleBenchmark(state, &scaler);
+}
+BENCHMARK(BM_ScaleLinear)->Apply(rateArgs);
+
+static void BM_ScaleSincShort(benchmark::State& state) {
+    ReadAheadManagerSignal readAheadManager(&benchmarkSignal);
+    EngineBufferScaleSinc scaler(&readAheadManager, EngineBufferScaleSinc::Quality::Short);
+    runScaleBenchmark(state, &scaler);
+}
+BENCHMARK(BM_ScaleSincShort)->Apply(rateArgs);
+
+static void BM_ScaleSincMedium(benchmark::State& state) {
+    ReadAheadManagerSignal readAheadManager(&benchmarkSignal);
+    EngineBufferScaleSinc scaler(&readAheadManager, EngineBufferScaleSinc::Quality::Medium);
+    runScaleBenchmark(state, &scaler);
+}
+BENCHMARK(BM_ScaleSincMedium)->Apply(rateArgs);
+
+static void BM_ScaleSincLong(benchmark::State& state) {
+    ReadAheadManagerSignal readAheadManager(&benchmarkSignal);
+    EngineBufferScaleSinc scaler(&readAheadManager, EngineBufferScaleSinc::Quality::Long);
+    runScaleBenchmark(state, &scaler);
+}
+BENCHMARK(BM_ScaleSincLong)->Apply(rateArgs);
+
+static void BM_ScaleSoundTouch(benchmark::State& state) {
+    ReadAheadManagerSignal readAheadManager(&benchmarkSignal);
+    EngineBufferScaleST scaler(&readAheadManager);
+    runScaleBenchmark(state, &scaler);
+}
+BENCHMARK(BM_ScaleSoundTouch)->Apply(rateArgs);
+
+} // namespace
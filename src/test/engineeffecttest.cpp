@@ -0,0 +1,145 @@
+#include "engine/effects/engineeffect.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "effects/backends/builtin/reverbeffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "engine/channelhandle.h"
+#include "engine/effects/groupfeaturestate.h"
+#include "engine/effects/message.h"
+#include "test/mixxxtest.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr SINT kBufferFrames = 1024;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+// Plenty of time for the default reverb to decay
+constexpr int kMaxSilentBuffers = 60 * kSampleRate / kBufferFrames;
+
+class EngineEffectTest : public MixxxTest {
+  protected:
+    EngineEffectTest()
+            : m_pBackendManager(new EffectsBackendManager()),
+              m_channel(m_factory.getOrCreateHandle(QStringLiteral("[Channel1]")),
+                      QStringLiteral("[Channel1]")),
+              m_main(m_factory.getOrCreateHandle(QStringLiteral("[Master]")),
+                      QStringLiteral("[Master]")),
+              m_input(kBufferSamples),
+              m_output(kBufferSamples) {
+        auto pipes = TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                16, 16);
+        m_pRequestPipe = std::move(pipes.first);
+        m_pResponsePipe = std::move(pipes.second);
+    }
+
+    std::unique_ptr<EngineEffect> createReverb(double tailLengthSeconds) {
+        EffectManifestPointer pManifest(new EffectManifest(*m_pBackendManager->getManifest(
+                ReverbEffect::getId(), EffectBackendType::BuiltIn)));
+        pManifest->setTailLengthSeconds(tailLengthSeconds);
+        const QSet<ChannelHandleAndGroup> inputChannels = {m_channel};
+        const QSet<ChannelHandleAndGroup> outputChannels = {m_main};
+        auto pEffect = std::make_unique<EngineEffect>(pManifest,
+                m_pBackendManager,
+                inputChannels,
+                inputChannels,
+                outputChannels);
+
+        EffectsRequest request;
+        request.type = EffectsRequest::SET_EFFECT_PARAMETERS;
+        request.SetEffectParameters.enabled = true;
+        pEffect->processEffectsRequest(request, m_pResponsePipe.get());
+        return pEffect;
+    }
+
+    void setInput(CSAMPLE value) {
+        for (SINT i = 0; i < kBufferSamples; ++i) {
+            // Alternate the sign to keep the reverb free of DC
+            m_input[i] = (i / 2) % 2 ? value : -value;
+        }
+    }
+
+    void process(EngineEffect* pEffect) {
+        pEffect->process(m_channel.handle(),
+                m_main.handle(),
+                m_input.data(),
+                m_output.data(),
+                kBufferSamples,
+                kSampleRate,
+                EffectEnableState::Enabled,
+                m_groupFeatures);
+    }
+
+    bool outputIsSilent() const {
+        return SampleUtil::maxAbsAmplitude(m_output.data(), kBufferSamples) == 0;
+    }
+
+    // Processes silence until the effect is sleeping and returns the number
+    // of buffers this took.
+    int processUntilSleeping(EngineEffect* pEffect) {
+        setInput(0);
+        for (int i = 0; i < kMaxSilentBuffers; ++i) {
+            process(pEffect);
+            if (pEffect->lastSavedNanos() > 0) {
+                return i;
+            }
+        }
+        return kMaxSilentBuffers;
+    }
+
+    ChannelHandleFactory m_factory;
+    EffectsBackendManagerPointer m_pBackendManager;
+    const ChannelHandleAndGroup m_channel;
+    const ChannelHandleAndGroup m_main;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    std::unique_ptr<EffectsResponsePipe> m_pResponsePipe;
+    GroupFeatureState m_groupFeatures;
+    mixxx::SampleBuffer m_input;
+    mixxx::SampleBuffer m_output;
+};
+
+TEST_F(EngineEffectTest, SleepsAfterTailAndWakesUpOnInput) {
+    constexpr double kTailLengthSeconds = 0.5;
+    auto pEffect = createReverb(kTailLengthSeconds);
+
+    setInput(0.5f);
+    for (int i = 0; i < 20; ++i) {
+        process(pEffect.get());
+        EXPECT_EQ(0, pEffect->lastSavedNanos());
+    }
+    EXPECT_FALSE(outputIsSilent());
+
+    // The tail has to be silent before the effect sleeps
+    const int silentBuffers = processUntilSleeping(pEffect.get());
+    ASSERT_LT(silentBuffers, kMaxSilentBuffers);
+    EXPECT_GT(silentBuffers, kTailLengthSeconds * kSampleRate / kBufferFrames);
+    EXPECT_TRUE(outputIsSilent());
+    for (int i = 0; i < 10; ++i) {
+        process(pEffect.get());
+        EXPECT_GT(pEffect->lastSavedNanos(), 0);
+        EXPECT_TRUE(outputIsSilent());
+    }
+
+    // Wakes up in the first buffer with input
+    setInput(0.5f);
+    process(pEffect.get());
+    EXPECT_EQ(0, pEffect->lastSavedNanos());
+    EXPECT_FALSE(outputIsSilent());
+}
+
+TEST_F(EngineEffectTest, NeverSleepsWithUnknownTail) {
+    auto pEffect = createReverb(EffectManifest::kUnknownTailLength);
+
+    setInput(0.5f);
+    for (int i = 0; i < 20; ++i) {
+        process(pEffect.get());
+    }
+    EXPECT_EQ(kMaxSilentBuffers, processUntilSleeping(pEffect.get()));
+}
+
+} // namespace
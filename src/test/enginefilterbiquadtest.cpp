@@ -1,9 +1,66 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
 #include "engine/filters/enginefilterbiquad1.h"
+#include "engine/filters/enginefilterlinkwitzriley2.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
 
 namespace {
 
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kBufferFrames = 1024;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+
+/// Fills the interleaved buffer with noise on the left and a sine on the
+/// right channel, so that both lanes see a different signal.
+void fillTestSignal(CSAMPLE* pBuffer, SINT numSamples, SINT firstFrame) {
+    for (SINT i = 0; i < numSamples; i += 2) {
+        pBuffer[i] = static_cast<CSAMPLE>(std::rand()) / RAND_MAX - 0.5f;
+        pBuffer[i + 1] = static_cast<CSAMPLE>(
+                0.5 * std::sin(2 * M_PI * 0.013 * (firstFrame + i / 2)));
+    }
+}
+
+/// Processes the test signal with the given filter and with the generic
+/// filter runner of fidlib for the same spec, and compares both channels.
+void expectMatchesFidlib(EngineFilterIIRBase* pFilter,
+        const char* spec,
+        double freq0,
+        double freq1 = 0) {
+    // The ramp from silence after construction is not part of the reference
+    pFilter->assumeSettled();
+
+    FidFilter* pFidFilter = fid_design(spec, kSampleRate, freq0, freq1, 0, nullptr);
+    double (*pRun)(void*, double) = nullptr;
+    void* pRunner = fid_run_new(pFidFilter, &pRun);
+    void* pLeftBuffer = fid_run_newbuf(pRunner);
+    void* pRightBuffer = fid_run_newbuf(pRunner);
+
+    mixxx::SampleBuffer input(kBufferSamples);
+    mixxx::SampleBuffer output(kBufferSamples);
+    std::srand(1);
+    for (int buffer = 0; buffer < 8; ++buffer) {
+        fillTestSignal(input.data(), kBufferSamples, buffer * kBufferFrames);
+        pFilter->process(input.data(), output.data(), kBufferSamples);
+        for (SINT i = 0; i < kBufferSamples; i += 2) {
+            EXPECT_NEAR(pRun(pLeftBuffer, input[i]), output[i], 1e-5) << spec << i;
+            EXPECT_NEAR(pRun(pRightBuffer, input[i + 1]), output[i + 1], 1e-5) << spec << i;
+        }
+    }
+
+    fid_run_freebuf(pLeftBuffer);
+    fid_run_freebuf(pRightBuffer);
+    fid_run_free(pRunner);
+    free(pFidFilter);
+}
+
 class EngineFilterBiquadTest : public testing::Test {
 };
 
@@ -52,4 +109,77 @@ TEST_F(EngineFilterBiquadTest, analysisLpBe4) {
     free(filt);
 }
 
+TEST_F(EngineFilterBiquadTest, stereoLanesMatchFidlib) {
+    EngineFilterBessel4Low bessel4Low(kSampleRate, 600);
+    expectMatchesFidlib(&bessel4Low, "LpBe4", 600);
+
+    EngineFilterBessel8Band bessel8Band(kSampleRate, 600, 2000);
+    expectMatchesFidlib(&bessel8Band, "BpBe8", 600, 2000);
+
+    EngineFilterBessel8High bessel8High(kSampleRate, 2000);
+    expectMatchesFidlib(&bessel8High, "HpBe8", 2000);
+
+    EngineFilterBiquad1Peaking peaking(kSampleRate, 1000, 1.75);
+    peaking.setFrequencyCorners(kSampleRate, 1000, 1.75, 6);
+    char spec[FIDSPEC_LENGTH];
+    format_fidspec(spec, sizeof(spec), "PkBq/%.10f/%.10f", 1.75, 6.0);
+    expectMatchesFidlib(&peaking, spec, 1000);
+}
+
+TEST_F(EngineFilterBiquadTest, stereoLanesAreIndependent) {
+    // Silence on one channel stays silent, whatever is on the other
+    EngineFilterLinkwitzRiley2Low filter(kSampleRate, 500);
+    mixxx::SampleBuffer buffer(kBufferSamples);
+    for (int i = 0; i < 4; ++i) {
+        fillTestSignal(buffer.data(), kBufferSamples, i * kBufferFrames);
+        for (SINT j = 0; j < kBufferSamples; j += 2) {
+            buffer[j] = 0;
+        }
+        filter.process(buffer.data(), buffer.data(), kBufferSamples);
+        for (SINT j = 0; j < kBufferSamples; j += 2) {
+            EXPECT_EQ(0, buffer[j]);
+        }
+        EXPECT_NE(0, buffer[kBufferSamples - 1]);
+    }
+}
+
+void runFilterBenchmark(benchmark::State& state,
+        const std::vector<EngineFilterIIRBase*>& filters) {
+    const SINT numSamples = state.range(0) * mixxx::kEngineChannelCount;
+    mixxx::SampleBuffer input(numSamples);
+    mixxx::SampleBuffer output(numSamples);
+    fillTestSignal(input.data(), numSamples, 0);
+    for (EngineFilterIIRBase* pFilter : filters) {
+        pFilter->assumeSettled();
+    }
+    for (auto _ : state) {
+        for (EngineFilterIIRBase* pFilter : filters) {
+            pFilter->process(input.data(), output.data(), numSamples);
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+/// The filters of one deck with the Bessel8 LV-Mix EQ
+static void BM_Bessel8LVMixEQFilters(benchmark::State& state) {
+    EngineFilterBessel8Low low(kSampleRate, 246);
+    EngineFilterBessel8Band band(kSampleRate, 246, 2484);
+    EngineFilterBessel8High high(kSampleRate, 2484);
+    runFilterBenchmark(state, {&low, &band, &high});
+}
+BENCHMARK(BM_Bessel8LVMixEQFilters)->Range(64, 4096);
+
+/// The filters of one deck with the Biquad Full Kill EQ
+static void BM_Biquad1EQFilters(benchmark::State& state) {
+    EngineFilterBiquad1LowShelving low(kSampleRate, 246, 0.7);
+    EngineFilterBiquad1Peaking mid(kSampleRate, 1100, 0.7);
+    EngineFilterBiquad1HighShelving high(kSampleRate, 2484, 0.7);
+    low.setFrequencyCorners(kSampleRate, 246, 0.7, -6);
+    mid.setFrequencyCorners(kSampleRate, 1100, 0.7, 3);
+    high.setFrequencyCorners(kSampleRate, 2484, 0.7, -3);
+    runFilterBenchmark(state, {&low, &mid, &high});
+}
+BENCHMARK(BM_Biquad1EQFilters)->Range(64, 4096);
+
 } // namespace
@@ -2,6 +2,9 @@
 #include <gtest/gtest.h>
 
 #include <QtDebug>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "control/controlproxy.h"
 #include "engine/channels/enginechannel.h"
@@ -482,4 +485,67 @@ TEST_F(EngineMixerTest, ThreeChannelPFLOutputWorks) {
     assertHeadphoneBufferMatchesGolden(testName);
 }
 
+// Renders the main output of three unsynchronized decks. The parameter is
+// the number of channel processing threads.
+class EngineMixerParallelTest : public SignalPathTest,
+                                public ::testing::WithParamInterface<int> {
+  protected:
+    // The tracks are reloaded and the decks are stopped afterwards until the
+    // gains have faded out, so each render starts from the same state.
+    std::vector<CSAMPLE> render(int numThreads, int numCallbacks) {
+        loadTrack(m_pMixerDeck1, m_pTrack);
+        loadTrack(m_pMixerDeck2, m_pTrack);
+        loadTrack(m_pMixerDeck3, m_pTrack);
+        m_pEngineMixer->setChannelProcessingThreads(numThreads);
+        ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+        ControlObject::set(ConfigKey(m_sGroup2, "play"), 1.0);
+        ControlObject::set(ConfigKey(m_sGroup3, "play"), 1.0);
+
+        std::vector<CSAMPLE> output;
+        output.reserve(numCallbacks * kProcessBufferSize);
+        for (int i = 0; i < numCallbacks; ++i) {
+            ProcessBuffer();
+            const CSAMPLE* pMain = m_pEngineMixer->getMainBuffer();
+            output.insert(output.end(), pMain, pMain + kProcessBufferSize);
+        }
+
+        ControlObject::set(ConfigKey(m_sGroup1, "play"), 0.0);
+        ControlObject::set(ConfigKey(m_sGroup2, "play"), 0.0);
+        ControlObject::set(ConfigKey(m_sGroup3, "play"), 0.0);
+        ProcessBuffer();
+        ProcessBuffer();
+        return output;
+    }
+
+    const TrackPointer m_pTrack = Track::newTemporary(
+            getTestDir().filePath(QStringLiteral("sine-30.wav")));
+};
+
+TEST_P(EngineMixerParallelTest, OutputIsBitIdenticalToSerial) {
+    constexpr int kNumCallbacks = 8;
+    ControlObject::set(ConfigKey(m_sGroup1, "rate"), 0.05);
+    ControlObject::set(ConfigKey(m_sGroup2, "rate"), -0.02);
+    ControlObject::set(ConfigKey(m_sGroup3, "volume"), 0.5);
+
+    // Both compared renders follow a previous render
+    render(0, kNumCallbacks);
+    const std::vector<CSAMPLE> serial = render(0, kNumCallbacks);
+    const std::vector<CSAMPLE> parallel = render(GetParam(), kNumCallbacks);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    // Make sure that the decks actually produced some audio.
+    EXPECT_NE(serial.end(), std::find_if(serial.begin(), serial.end(), [](CSAMPLE sample) {
+        return sample != 0;
+    }));
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        // Compare the bit patterns, not the values
+        ASSERT_EQ(0, std::memcmp(&serial[i], &parallel[i], sizeof(CSAMPLE)))
+                << "Sample " << i << " differs: " << serial[i] << " vs " << parallel[i];
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(EngineMixerParallelThreads,
+        EngineMixerParallelTest,
+        ::testing::Values(1, 2, 3));
+
 }  // namespace
@@ -0,0 +1,124 @@
+#include "engine/engineprofiler.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include "control/controlobject.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class EngineProfilerTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        EngineProfiler::reset();
+    }
+    void TearDown() override {
+        EngineProfiler::setEnabled(false);
+        EngineProfiler::reset();
+    }
+};
+
+TEST_F(EngineProfilerTest, RegisterSameNameReturnsSameSection) {
+    const auto id = EngineProfiler::registerSection(
+            QStringLiteral("EngineBuffer"), QStringLiteral("[Channel1]"));
+    EXPECT_NE(EngineProfiler::kInvalidSectionId, id);
+    EXPECT_EQ(id,
+            EngineProfiler::registerSection(
+                    QStringLiteral("EngineBuffer_Channel1")));
+    EXPECT_QSTRING_EQ(QStringLiteral("EngineBuffer_Channel1"),
+            EngineProfiler::snapshot(id).name);
+}
+
+TEST_F(EngineProfilerTest, DestroyingControlsRestoresPreviousState) {
+    EngineProfiler::setEnabled(true);
+    {
+        EngineProfilerControls controls;
+    }
+    EXPECT_TRUE(EngineProfiler::isEnabled());
+
+    EngineProfiler::setEnabled(false);
+    {
+        EngineProfilerControls controls;
+        ControlObject::set(ConfigKey(QStringLiteral("[EngineProfiler]"),
+                                   QStringLiteral("enabled")),
+                1.0);
+        EXPECT_TRUE(EngineProfiler::isEnabled());
+    }
+    EXPECT_FALSE(EngineProfiler::isEnabled());
+}
+
+TEST_F(EngineProfilerTest, RecordUpdatesStatistics) {
+    const auto id = EngineProfiler::registerSection(
+            QStringLiteral("EngineProfilerTest_Record"));
+    EngineProfiler::record(id, 500);
+    EngineProfiler::record(id, 3000);
+    EngineProfiler::record(id, 1000000);
+
+    const EngineProfiler::Snapshot stats = EngineProfiler::snapshot(id);
+    EXPECT_EQ(3u, stats.count);
+    EXPECT_EQ(1003500u, stats.totalNs);
+    EXPECT_EQ(1000000u, stats.maxNs);
+    EXPECT_EQ(1000000u, stats.lastNs);
+    // < 1024 ns
+    EXPECT_EQ(1u, stats.histogram[0]);
+    // [2048, 4096) ns
+    EXPECT_EQ(1u, stats.histogram[2]);
+    EXPECT_EQ(1024u, stats.percentileNs(0.3));
+    EXPECT_EQ(4096u, stats.percentileNs(0.6));
+    // The bin limit is clamped to the maximum
+    EXPECT_EQ(1000000u, stats.percentileNs(0.99));
+
+    EngineProfiler::reset();
+    EXPECT_EQ(0u, EngineProfiler::snapshot(id).count);
+    EXPECT_EQ(0u, EngineProfiler::snapshot(id).maxNs);
+}
+
+TEST_F(EngineProfilerTest, ScopeOnlyRecordsWhenEnabled) {
+    const auto id = EngineProfiler::registerSection(
+            QStringLiteral("EngineProfilerTest_Scope"));
+    EngineProfiler::setEnabled(false);
+    {
+        ScopedEngineProfile profile(id);
+    }
+    EXPECT_EQ(0u, EngineProfiler::snapshot(id).count);
+
+    EngineProfiler::setEnabled(true);
+    {
+        ScopedEngineProfile profile(id);
+    }
+    EXPECT_EQ(1u, EngineProfiler::snapshot(id).count);
+}
+
+TEST_F(EngineProfilerTest, ControlsPublishResults) {
+    const auto id = EngineProfiler::registerSection(
+            QStringLiteral("EngineProfilerTest_Controls"));
+    EngineProfilerControls controls;
+    const ConfigKey enabledKey(QStringLiteral("[EngineProfiler]"), QStringLiteral("enabled"));
+
+    ControlObject::set(enabledKey, 1.0);
+    EXPECT_TRUE(EngineProfiler::isEnabled());
+    EngineProfiler::record(id, 2000);
+
+    // Disabling publishes the final values
+    ControlObject::set(enabledKey, 0.0);
+    EXPECT_FALSE(EngineProfiler::isEnabled());
+    EXPECT_DOUBLE_EQ(2.0,
+            ControlObject::get(ConfigKey(QStringLiteral("[EngineProfiler]"),
+                    QStringLiteral("EngineProfilerTest_Controls_max_us"))));
+}
+
+static void BM_ScopedEngineProfile(benchmark::State& state) {
+    const auto id = EngineProfiler::registerSection(
+            QStringLiteral("EngineProfilerTest_Benchmark"));
+    EngineProfiler::setEnabled(state.range(0) != 0);
+    for (auto _ : state) {
+        ScopedEngineProfile profile(id);
+        benchmark::ClobberMemory();
+    }
+    EngineProfiler::setEnabled(false);
+    EngineProfiler::reset();
+}
+BENCHMARK(BM_ScopedEngineProfile)->Arg(0)->Arg(1);
+
+} // namespace
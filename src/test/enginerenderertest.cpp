@@ -0,0 +1,62 @@
+#include "engine/enginerenderer.h"
+
+#include <gtest/gtest.h>
+
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "recording/defs_recording.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+constexpr SINT kFramesPerBuffer = 512;
+
+class EngineRendererTest : public SignalPathTest {
+  protected:
+    void SetUp() override {
+        SignalPathTest::SetUp();
+        ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+        ControlObject::set(ConfigKey(m_sGroup2, "play"), 1.0);
+    }
+};
+
+TEST_F(EngineRendererTest, RenderCountsCallbacks) {
+    EngineRenderer renderer(m_pEngineMixer,
+            mixxx::audio::SampleRate(44100),
+            kFramesPerBuffer);
+    EXPECT_FALSE(renderer.isOutputOpen());
+
+    const EngineRenderer::Stats stats =
+            renderer.render(mixxx::Duration::fromSeconds(1));
+    // Rounded up to whole callbacks
+    EXPECT_EQ(87, stats.callbacks);
+    EXPECT_EQ(87 * kFramesPerBuffer, stats.frames);
+    EXPECT_GT(stats.callbacksPerSecond(), 0.0);
+
+    renderer.renderCallbacks(13);
+    EXPECT_EQ(100, renderer.totalStats().callbacks);
+    EXPECT_EQ(100 * kFramesPerBuffer, renderer.totalStats().frames);
+}
+
+TEST_F(EngineRendererTest, RenderMainOutputToWaveFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("render.wav"));
+    {
+        EngineRenderer renderer(m_pEngineMixer,
+                mixxx::audio::SampleRate(44100),
+                kFramesPerBuffer);
+        ASSERT_TRUE(renderer.openOutput(fileName,
+                EncoderFactory::getFactory().getFormatFor(ENCODING_WAVE),
+                config()));
+        EXPECT_TRUE(renderer.isOutputOpen());
+        renderer.renderCallbacks(100);
+        renderer.closeOutput();
+        EXPECT_FALSE(renderer.isOutputOpen());
+    }
+    // At least 16 bit stereo samples
+    EXPECT_GE(QFileInfo(fileName).size(), 100 * kFramesPerBuffer * 2 * 2);
+}
+
+} // namespace
@@ -0,0 +1,403 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include <cstring>
+
+#include "control/controlobject.h"
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/reverbeffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "effects/chains/equalizereffectchain.h"
+#include "effects/chains/quickeffectchain.h"
+#include "effects/effectslot.h"
+#include "engine/enginerenderer.h"
+#include "test/signalpathtest.h"
+#include "util/denormalsarezero.h"
+#include "util/duration.h"
+#include "util/performancetimer.h"
+#include "util/sample.h"
+
+namespace {
+
+const QString kGroup4 = QStringLiteral("[Channel4]");
+constexpr int kNumSamplers = 4;
+constexpr int kMaxDecks = 4;
+const auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+/// The features of a scenario, in addition to the playing decks
+enum ScenarioFeature {
+    kKeylock = 1 << 0,
+    kSync = 1 << 1,
+    kEffects = 1 << 2,
+    kSamplers = 1 << 3,
+    kHeadphoneSplit = 1 << 4,
+    kAllFeatures = kKeylock | kSync | kEffects | kSamplers | kHeadphoneSplit,
+    // A reverb and an echo in addition to the filter of each QuickEffect
+    kHeavyEffects = 1 << 5,
+};
+
+/// A live session with the given number of decks playing and the given
+/// features enabled, rendered callback by callback like a sound device
+/// would do it.
+///
+/// The tracks are loaded into RAM before rendering, so the CachingReader
+/// does not block or fall behind and each callback measures the engine only.
+class EngineScenario : public BaseSignalPathTest {
+  public:
+    EngineScenario(int numDecks, int features, int channelProcessingThreads = 0)
+            : m_numDecks(numDecks),
+              m_features(features),
+              m_channelProcessingThreads(channelProcessingThreads),
+              m_callbacks(0) {
+        DEBUG_ASSERT(numDecks > 0 && numDecks <= kMaxDecks);
+        m_decks = {m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3};
+        if (m_numDecks == kMaxDecks) {
+            m_pMixerDeck4 = std::make_unique<Deck>(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer,
+                    m_pEffectsManager,
+                    EngineChannel::CENTER,
+                    m_pEngineMixer->registerChannelGroup(kGroup4));
+            addDeck(m_pMixerDeck4->getEngineDeck());
+            m_decks.push_back(m_pMixerDeck4.get());
+        }
+        m_decks.resize(m_numDecks);
+        if (m_features & kSamplers) {
+            for (int i = 0; i < kNumSamplers; ++i) {
+                const QString group = QStringLiteral("[Sampler%1]").arg(i + 1);
+                m_samplers.push_back(std::make_unique<Sampler>(nullptr,
+                        m_pConfig,
+                        m_pEngineMixer,
+                        m_pEffectsManager,
+                        EngineChannel::CENTER,
+                        m_pEngineMixer->registerChannelGroup(group)));
+            }
+        }
+    }
+
+    ~EngineScenario() override {
+        // Before BaseSignalPathTest deletes the engine
+        m_samplers.clear();
+        m_pMixerDeck4.reset();
+    }
+
+    /// Loads the tracks, sets up the controls and plays the first second,
+    /// so that the sync, the keylock lookahead and the effects have settled
+    /// before the callbacks are measured.
+    void setUp(SINT framesPerBuffer) {
+        SetUp();
+        m_pEngineMixer->setChannelProcessingThreads(m_channelProcessingThreads);
+        m_pRenderer = std::make_unique<EngineRenderer>(
+                m_pEngineMixer, kSampleRate, framesPerBuffer);
+
+        if (m_features & (kEffects | kHeavyEffects)) {
+            for (const auto* pDeck : m_decks) {
+                m_pEffectsManager->addDeck(ChannelHandleAndGroup(
+                        pDeck->getEngineDeck()->getHandle(), pDeck->getGroup()));
+            }
+            // Loads the default EQ and QuickEffect of each deck
+            m_pEffectsManager->setup();
+        }
+        if (m_features & kHeavyEffects) {
+            const auto pBackendManager = m_pEffectsManager->getBackendManager();
+            const EffectManifestPointer manifests[] = {
+                    pBackendManager->getManifest(
+                            ReverbEffect::getId(), EffectBackendType::BuiltIn),
+                    pBackendManager->getManifest(
+                            EchoEffect::getId(), EffectBackendType::BuiltIn),
+            };
+            for (const auto* pDeck : m_decks) {
+                const auto pChain = m_pEffectsManager->getQuickEffectChain(pDeck->getGroup());
+                for (int i = 0; i < 2; ++i) {
+                    const auto pEffectSlot = pChain->getEffectSlot(i + 1);
+                    pEffectSlot->loadEffectWithDefaults(manifests[i]);
+                    ControlObject::set(ConfigKey(pEffectSlot->getGroup(), "enabled"), 1.0);
+                }
+            }
+        }
+
+        const QString trackLocation = getTestDir().filePath(QStringLiteral("sine-30.wav"));
+        for (int i = 0; i < m_numDecks; ++i) {
+            TrackPointer pTrack(Track::newTemporary(trackLocation));
+            // Slightly different tempos to give the sync something to do
+            pTrack->trySetBpm(120.0 + i);
+            loadIntoRam(m_decks[i], pTrack);
+        }
+        for (const auto& pSampler : m_samplers) {
+            loadIntoRam(pSampler.get(), Track::newTemporary(trackLocation));
+        }
+
+        for (int i = 0; i < m_numDecks; ++i) {
+            const QString& group = m_decks[i]->getGroup();
+            ControlObject::set(ConfigKey(group, "repeat"), 1.0);
+            if (m_features & kKeylock) {
+                ControlObject::set(ConfigKey(group, "keylock"), 1.0);
+                ControlObject::set(ConfigKey(group, "rate"),
+                        getRateSliderValue(1.0 + 0.02 * (i + 1)));
+            }
+            if (m_features & kSync) {
+                ControlObject::set(ConfigKey(group, "sync_enabled"), 1.0);
+            }
+            if (m_features & kEffects) {
+                ControlObject::set(ConfigKey(
+                                           EqualizerEffectChain::formatEffectSlotGroup(group),
+                                           "parameter1"),
+                        0.5);
+                ControlObject::set(ConfigKey(
+                                           QuickEffectChain::formatEffectChainGroup(group),
+                                           "super1"),
+                        0.3);
+            }
+            if (m_features & kHeadphoneSplit) {
+                ControlObject::set(ConfigKey(group, "pfl"), i % 2 == 0 ? 1.0 : 0.0);
+            }
+            ControlObject::set(ConfigKey(group, "play"), 1.0);
+        }
+        if (m_features & kHeadphoneSplit) {
+            ControlObject::set(ConfigKey(m_sMainGroup, "headSplit"), 1.0);
+        }
+
+        m_pRenderer->render(mixxx::Duration::fromSeconds(1));
+    }
+
+    void tearDown() {
+        m_pRenderer.reset();
+        TearDown();
+    }
+
+    /// Renders one callback and returns the time spent in the engine.
+    mixxx::Duration process() {
+        // Fire one of the samplers every 100 ms, like finger drumming
+        const int samplerInterval = static_cast<int>(
+                kSampleRate.toDouble() / 10 / m_pRenderer->framesPerBuffer());
+        if (!m_samplers.empty() && m_callbacks % std::max(samplerInterval, 1) == 0) {
+            const int sampler = (m_callbacks / std::max(samplerInterval, 1)) % kNumSamplers;
+            ControlObject::set(ConfigKey(m_samplers[sampler]->getGroup(), "cue_gotoandplay"),
+                    1.0);
+        }
+        ++m_callbacks;
+
+        const int bufferSize = static_cast<int>(
+                m_pRenderer->framesPerBuffer() * mixxx::kEngineChannelCount);
+        PerformanceTimer timer;
+        timer.start();
+        m_pEngineMixer->process(bufferSize);
+        return timer.elapsed();
+    }
+
+    const CSAMPLE* mainBuffer() const {
+        return m_pEngineMixer->getMainBuffer();
+    }
+
+    SINT framesPerBuffer() const {
+        return m_pRenderer->framesPerBuffer();
+    }
+
+  private:
+    void TestBody() override {
+    }
+
+    void loadIntoRam(BaseTrackPlayerImpl* pPlayer, TrackPointer pTrack) {
+        const QString& group = pPlayer->getGroup();
+        ControlObject::set(ConfigKey(group, "load_into_ram"), 1.0);
+        loadTrack(pPlayer, pTrack);
+        // The CachingReaderWorker is woken up at the end of each callback
+        for (int i = 0; i < 2000; ++i) {
+            if (ControlObject::get(ConfigKey(group, "ram_buffered")) > 0) {
+                break;
+            }
+            ProcessBuffer();
+            QTest::qSleep(1);
+        }
+        DEBUG_ASSERT(ControlObject::get(ConfigKey(group, "ram_buffered")) > 0);
+    }
+
+    const int m_numDecks;
+    const int m_features;
+    const int m_channelProcessingThreads;
+    int m_callbacks;
+    std::unique_ptr<Deck> m_pMixerDeck4;
+    std::vector<BaseTrackPlayerImpl*> m_decks;
+    std::vector<std::unique_ptr<Sampler>> m_samplers;
+    std::unique_ptr<EngineRenderer> m_pRenderer;
+};
+
+class EngineScenarioTest : public ::testing::TestWithParam<int> {
+};
+
+TEST_P(EngineScenarioTest, ProducesAudio) {
+    EngineScenario scenario(kMaxDecks, GetParam());
+    scenario.setUp(256);
+    for (int i = 0; i < 100; ++i) {
+        scenario.process();
+    }
+    EXPECT_GT(SampleUtil::sumSquared(scenario.mainBuffer(),
+                      scenario.framesPerBuffer() * mixxx::kEngineChannelCount),
+            0.0f);
+    scenario.tearDown();
+}
+
+INSTANTIATE_TEST_SUITE_P(EngineScenarioFeatures,
+        EngineScenarioTest,
+        ::testing::Values(0,
+                kKeylock,
+                kSync,
+                kEffects,
+                kSamplers,
+                kHeadphoneSplit,
+                kAllFeatures,
+                kHeavyEffects));
+
+std::vector<CSAMPLE> renderHeavyEffects(int channelProcessingThreads) {
+    constexpr int kCallbacks = 50;
+    EngineScenario scenario(kMaxDecks, kHeavyEffects, channelProcessingThreads);
+    scenario.setUp(256);
+    const SINT bufferSize = scenario.framesPerBuffer() * mixxx::kEngineChannelCount;
+    std::vector<CSAMPLE> output;
+    output.reserve(kCallbacks * bufferSize);
+    for (int i = 0; i < kCallbacks; ++i) {
+        scenario.process();
+        output.insert(output.end(), scenario.mainBuffer(), scenario.mainBuffer() + bufferSize);
+    }
+    scenario.tearDown();
+    return output;
+}
+
+// Every deck has its own QuickEffect chain, so their effects are processed
+// in parallel.
+TEST(EngineScenarioParallelTest, ParallelEffectsAreBitIdenticalToSerial) {
+    const std::vector<CSAMPLE> serial = renderHeavyEffects(0);
+    const std::vector<CSAMPLE> parallel = renderHeavyEffects(3);
+    ASSERT_EQ(serial.size(), parallel.size());
+    EXPECT_GT(SampleUtil::sumSquared(serial.data(), static_cast<SINT>(serial.size())), 0.0f);
+    for (std::size_t i = 0; i < serial.size(); ++i) {
+        // Compare the bit patterns, not the values
+        ASSERT_EQ(0, std::memcmp(&serial[i], &parallel[i], sizeof(CSAMPLE)))
+                << "Sample " << i << " differs: " << serial[i] << " vs " << parallel[i];
+    }
+}
+
+// The buffer sizes in frames
+void bufferArgs(benchmark::internal::Benchmark* pBenchmark) {
+    for (const int frames : {64, 128, 256, 512}) {
+        pBenchmark->Arg(frames);
+    }
+}
+
+/// Reports the mean, the 99th percentile and the maximum of the callback
+/// time in microseconds. The time of the benchmark is the mean callback time
+/// as well, without the time spent to trigger the samplers. Returns the mean
+/// callback time in microseconds.
+double runScenario(benchmark::State& state,
+        int numDecks,
+        int features,
+        int channelProcessingThreads) {
+    EngineScenario scenario(numDecks, features, channelProcessingThreads);
+    scenario.setUp(static_cast<SINT>(state.range(0)));
+
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    // Like in the audio threads of the sound devices
+    const unsigned int savedCsr = _mm_getcsr();
+    _MM_SET_DENORMALS_ZERO_MODE(_MM_DENORMALS_ZERO_ON);
+    _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
+#endif
+
+    std::vector<double> callbackMicros;
+    for (auto _ : state) {
+        const mixxx::Duration callbackTime = scenario.process();
+        state.SetIterationTime(callbackTime.toDoubleSeconds());
+        callbackMicros.push_back(callbackTime.toDoubleMicros());
+    }
+
+#if defined(__SSE__) && !defined(__EMSCRIPTEN__)
+    _mm_setcsr(savedCsr);
+#endif
+    scenario.tearDown();
+
+    if (callbackMicros.empty()) {
+        return 0.0;
+    }
+    std::sort(callbackMicros.begin(), callbackMicros.end());
+    const auto p99 = callbackMicros.begin() +
+            static_cast<std::ptrdiff_t>((callbackMicros.size() - 1) * 99 / 100);
+    const double meanMicros = std::accumulate(callbackMicros.begin(),
+                                      callbackMicros.end(),
+                                      0.0) /
+            callbackMicros.size();
+    state.counters["mean_us"] = meanMicros;
+    state.counters["p99_us"] = *p99;
+    state.counters["max_us"] = callbackMicros.back();
+    // The share of the buffer period the engine needs at worst
+    state.counters["max_load"] = callbackMicros.back() /
+            (1000000.0 * state.range(0) / kSampleRate.toDouble());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    return meanMicros;
+}
+
+static void BM_EngineScenario(benchmark::State& state, int numDecks, int features) {
+    runScenario(state, numDecks, features, 0);
+}
+
+/// The second argument is the number of worker threads for the channels and
+/// their effects, see [App],channel_processing_threads. The runs with worker
+/// threads report the speedup of the mean callback time over the serial run
+/// with the same buffer size, which threadArgs() registers first.
+static void BM_EngineScenarioThreads(benchmark::State& state, int numDecks, int features) {
+    // The serial mean callback time by scenario and buffer size
+    static std::map<std::tuple<int, int, int64_t>, double> s_serialMeanMicros;
+    const int channelProcessingThreads = static_cast<int>(state.range(1));
+    const double meanMicros = runScenario(
+            state, numDecks, features, channelProcessingThreads);
+    const auto key = std::make_tuple(numDecks, features, state.range(0));
+    if (channelProcessingThreads == 0) {
+        s_serialMeanMicros[key] = meanMicros;
+        return;
+    }
+    const auto it = s_serialMeanMicros.find(key);
+    if (it != s_serialMeanMicros.end() && meanMicros > 0) {
+        state.counters["speedup"] = it->second / meanMicros;
+    }
+}
+
+BENCHMARK_CAPTURE(BM_EngineScenario, TwoDecks, 2, 0)->Apply(bufferArgs)->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, FourDecks, 4, 0)->Apply(bufferArgs)->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, FourDecksKeylock, 4, kKeylock)
+        ->Apply(bufferArgs)
+        ->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, FourDecksSync, 4, kSync)
+        ->Apply(bufferArgs)
+        ->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, FourDecksEffects, 4, kEffects)
+        ->Apply(bufferArgs)
+        ->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, TwoDecksSamplers, 2, kSamplers)
+        ->Apply(bufferArgs)
+        ->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, TwoDecksHeadphoneSplit, 2, kHeadphoneSplit)
+        ->Apply(bufferArgs)
+        ->UseManualTime();
+BENCHMARK_CAPTURE(BM_EngineScenario, FourDecksAllFeatures, 4, kAllFeatures)
+        ->Apply(bufferArgs)
+        ->UseManualTime();
+
+// The buffer sizes in frames and the number of worker threads
+void threadArgs(benchmark::internal::Benchmark* pBenchmark) {
+    for (const int frames : {64, 256}) {
+        for (const int threads : {0, 1, 3}) {
+            pBenchmark->Args({frames, threads});
+        }
+    }
+}
+
+BENCHMARK_CAPTURE(BM_EngineScenarioThreads, FourDecksHeavyEffects, 4, kHeavyEffects)
+        ->Apply(threadArgs)
+        ->UseManualTime();
+
+} // namespace
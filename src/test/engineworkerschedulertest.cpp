@@ -0,0 +1,92 @@
+#include "engine/engineworkerscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <QSemaphore>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine/engineworker.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+constexpr int kWakeTimeoutMillis = 5000;
+
+class CountingWorker : public EngineWorker {
+  public:
+    explicit CountingWorker(QSemaphore* pWoken)
+            : m_pWoken(pWoken),
+              m_wakeCount(0) {
+    }
+
+    int wakeCount() const {
+        return m_wakeCount.load();
+    }
+
+  protected:
+    void wake() override {
+        m_wakeCount.fetch_add(1);
+        m_pWoken->release();
+    }
+
+  private:
+    QSemaphore* m_pWoken;
+    std::atomic<int> m_wakeCount;
+};
+
+class EngineWorkerSchedulerTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        m_pScheduler = std::make_unique<EngineWorkerScheduler>();
+        // More than 64 workers to cover several words of the bitmap
+        for (int i = 0; i < 100; ++i) {
+            m_workers.push_back(std::make_unique<CountingWorker>(&m_woken));
+            m_workers.back()->setScheduler(m_pScheduler.get());
+        }
+        m_pScheduler->start();
+    }
+
+    void TearDown() override {
+        // Joins the scheduler thread before the workers are destroyed
+        m_pScheduler.reset();
+        m_workers.clear();
+    }
+
+    QSemaphore m_woken;
+    std::unique_ptr<EngineWorkerScheduler> m_pScheduler;
+    std::vector<std::unique_ptr<CountingWorker>> m_workers;
+};
+
+TEST_F(EngineWorkerSchedulerTest, WakesOnlyReadyWorkers) {
+    m_workers[3]->workReady();
+    m_workers[70]->workReady();
+    // Reporting the same worker twice within a callback wakes it once
+    m_workers[70]->workReady();
+    m_pScheduler->runWorkers();
+
+    ASSERT_TRUE(m_woken.tryAcquire(2, kWakeTimeoutMillis));
+    EXPECT_FALSE(m_woken.tryAcquire(1, 100));
+    for (int i = 0; i < static_cast<int>(m_workers.size()); ++i) {
+        EXPECT_EQ(i == 3 || i == 70 ? 1 : 0, m_workers[i]->wakeCount()) << i;
+    }
+}
+
+TEST_F(EngineWorkerSchedulerTest, WakesAgainAfterEveryCallback) {
+    for (int callback = 0; callback < 100; ++callback) {
+        m_workers[callback]->workReady();
+        m_pScheduler->runWorkers();
+    }
+    ASSERT_TRUE(m_woken.tryAcquire(100, kWakeTimeoutMillis));
+    for (const auto& pWorker : m_workers) {
+        EXPECT_EQ(1, pWorker->wakeCount());
+    }
+}
+
+TEST_F(EngineWorkerSchedulerTest, NoWakeupWithoutReadyWorkers) {
+    m_pScheduler->runWorkers();
+    EXPECT_FALSE(m_woken.tryAcquire(1, 100));
+}
+
+} // namespace
@@ -140,3 +140,24 @@ TEST_F(ReadAheadManagerTest, FractionalFrameLoop) {
     // The rounding error must not exceed a half frame (one samples in stereo)
     EXPECT_NEAR(16, m_pReadAheadManager->getPlaypos(), 1);
 }
+
+TEST_F(ReadAheadManagerTest, LoopBehindReadAheadPosition) {
+    // Read ahead up to frame 30 before the loop has been set
+    m_pReadAheadManager->notifySeek(mixxx::audio::FramePos(30));
+    m_pLoopControl->setLoop(mixxx::audio::FramePos(10), mixxx::audio::FramePos(20), true);
+
+    EXPECT_TRUE(m_pReadAheadManager->hasReadPastLoop(false, mixxx::audio::FramePos(5)));
+    EXPECT_TRUE(m_pReadAheadManager->hasReadPastLoop(false, mixxx::audio::FramePos(15)));
+    // Already played past the loop end
+    EXPECT_FALSE(m_pReadAheadManager->hasReadPastLoop(false, mixxx::audio::FramePos(25)));
+    // In reverse the loop start comes first
+    EXPECT_FALSE(m_pReadAheadManager->hasReadPastLoop(true, mixxx::audio::FramePos(35)));
+
+    // Not read past the loop end yet
+    m_pReadAheadManager->notifySeek(mixxx::audio::FramePos(18));
+    EXPECT_FALSE(m_pReadAheadManager->hasReadPastLoop(false, mixxx::audio::FramePos(15)));
+
+    // Read backwards past the loop start
+    m_pReadAheadManager->notifySeek(mixxx::audio::FramePos(5));
+    EXPECT_TRUE(m_pReadAheadManager->hasReadPastLoop(true, mixxx::audio::FramePos(15)));
+}
@@ -0,0 +1,90 @@
+#include "util/realtimesafety.h"
+
+#include <gtest/gtest.h>
+
+#include <QMutex>
+#include <cstdlib>
+#include <new>
+
+#include "util/compatibility/qmutex.h"
+
+namespace {
+
+class RealtimeSafetyTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        RealtimeSafety::reset();
+    }
+    void TearDown() override {
+        RealtimeSafety::reset();
+    }
+};
+
+TEST_F(RealtimeSafetyTest, LockOutsideRealtimeSectionIsAllowed) {
+    QMutex mutex;
+    {
+        const auto locker = lockMutex(&mutex);
+    }
+    EXPECT_FALSE(RealtimeSafety::isRealtimeThread());
+    EXPECT_EQ(0, RealtimeSafety::violationCount());
+}
+
+TEST_F(RealtimeSafetyTest, LockInRealtimeSectionIsReported) {
+    if (!RealtimeSafety::kEnabled) {
+        GTEST_SKIP() << "Requires REALTIME_SAFETY_CHECKS";
+    }
+    QMutex mutex;
+    {
+        ScopedRealtimeSection realtimeSection;
+        EXPECT_TRUE(RealtimeSafety::isRealtimeThread());
+        {
+            const auto locker = lockMutex(&mutex);
+        }
+        {
+            ScopedRealtimeSafetySuspension suspension;
+            const auto locker = lockMutex(&mutex);
+        }
+    }
+    EXPECT_FALSE(RealtimeSafety::isRealtimeThread());
+    // Only the lock without the suspension
+    ASSERT_EQ(1, RealtimeSafety::violationCount());
+    const QStringList violations = RealtimeSafety::violations();
+    ASSERT_EQ(1, violations.size());
+    EXPECT_TRUE(violations.first().startsWith(QStringLiteral("lockMutex")));
+}
+
+TEST_F(RealtimeSafetyTest, AllocationInRealtimeSectionIsReported) {
+    if (!RealtimeSafety::kEnabled) {
+        GTEST_SKIP() << "Requires REALTIME_SAFETY_CHECKS";
+    }
+    {
+        ScopedRealtimeSection realtimeSection;
+        // volatile prevents the compiler from eliding the allocation
+        int* volatile pValue = new int(1);
+        delete pValue;
+    }
+    // new and delete
+    EXPECT_EQ(2, RealtimeSafety::violationCount());
+}
+
+TEST_F(RealtimeSafetyTest, AlignedAllocationInRealtimeSectionIsReported) {
+    if (!RealtimeSafety::kEnabled) {
+        GTEST_SKIP() << "Requires REALTIME_SAFETY_CHECKS";
+    }
+    void* volatile pAlignedAlloc = nullptr;
+    void* pPosixMemalign = nullptr;
+    {
+        ScopedRealtimeSection realtimeSection;
+        pAlignedAlloc = std::aligned_alloc(64, 256);
+        EXPECT_EQ(0, posix_memalign(&pPosixMemalign, 64, 256));
+        // Allocated with aligned_alloc() by libstdc++
+        void* volatile pNew = ::operator new(256, std::align_val_t(64));
+        ::operator delete(pNew, std::align_val_t(64));
+    }
+    std::free(pAlignedAlloc);
+    std::free(pPosixMemalign);
+    // aligned_alloc, posix_memalign, the aligned new and its delete
+    EXPECT_EQ(4, RealtimeSafety::violationCount());
+}
+
+} // namespace
@@ -0,0 +1,255 @@
+#include "engine/bufferscalers/rubberbandbatch.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "engine/bufferscalers/enginebufferscalerubberband.h"
+#include "engine/bufferscalers/rubberbandtask.h"
+#include "engine/bufferscalers/rubberbandworkerpool.h"
+#include "engine/bufferscalers/rubberbandwrapper.h"
+#include "engine/readaheadmanager.h"
+#include "engine/realtimeworkerpool.h"
+#include "test/mixxxtest.h"
+#include "util/performancetimer.h"
+#include "util/realtimesafety.h"
+#include "util/sample.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+namespace {
+
+constexpr SINT kBufferFrames = 512;
+constexpr SINT kBufferSamples = kBufferFrames * mixxx::kEngineChannelCount;
+constexpr double kRate = 1.06;
+
+/// Plays a sine that is slightly different for each deck.
+class ReadAheadManagerSine : public ReadAheadManager {
+  public:
+    explicit ReadAheadManagerSine(double frequency = 0.01)
+            : m_frequency(frequency),
+              m_frame(0) {
+    }
+
+    SINT getNextSamples(double dRate, CSAMPLE* buffer, SINT requested_samples) override {
+        Q_UNUSED(dRate);
+        const SINT frames = requested_samples / mixxx::kEngineChannelCount;
+        for (SINT i = 0; i < frames; ++i) {
+            const auto value = static_cast<CSAMPLE>(
+                    0.5 * std::sin(2 * M_PI * m_frequency * m_frame++));
+            buffer[2 * i] = value;
+            buffer[2 * i + 1] = value;
+        }
+        return frames * mixxx::kEngineChannelCount;
+    }
+
+    SINT frame() const {
+        return m_frame;
+    }
+
+  private:
+    const double m_frequency;
+    SINT m_frame;
+};
+
+void setUpScaler(EngineBufferScaleRubberBand* pScaler, RubberBandBatch* pBatch) {
+    pScaler->setSampleRate(mixxx::audio::SampleRate(44100));
+    pScaler->setBatch(pBatch);
+    double tempoRatio = kRate;
+    double pitchRatio = 1.0;
+    pScaler->setScaleParameters(1.0, &tempoRatio, &pitchRatio);
+    pScaler->clear();
+}
+
+class RubberBandBatchTest : public MixxxTest {
+  protected:
+    RubberBandBatchTest()
+            : m_input(kBufferSamples),
+              m_inputPtrs{m_input.data(), m_input.data() + kBufferFrames} {
+        m_batch.setEnabled(true);
+        m_timer.start();
+    }
+
+    std::unique_ptr<RubberBandTask> makePendingTask() {
+        auto pTask = std::make_unique<RubberBandTask>(
+                44100, 2, RubberBandStretcher::OptionProcessRealTime);
+        pTask->set(m_inputPtrs.data(), kBufferFrames, false);
+        pTask->setPending();
+        return pTask;
+    }
+
+    mixxx::SampleBuffer m_input;
+    std::array<const float*, 2> m_inputPtrs;
+    RubberBandBatch m_batch;
+    PerformanceTimer m_timer;
+};
+
+TEST_F(RubberBandBatchTest, ProcessesAllJobs) {
+    std::vector<std::unique_ptr<RubberBandTask>> tasks;
+    for (int i = 0; i < 8; ++i) {
+        tasks.push_back(makePendingTask());
+        EXPECT_TRUE(m_batch.submit(tasks.back().get()));
+    }
+    EXPECT_EQ(8, m_batch.numJobs());
+
+    RealtimeWorkerPool pool(3, false);
+    m_batch.process(&pool, m_timer, mixxx::Duration::fromSeconds(10));
+
+    EXPECT_EQ(0, m_batch.numJobs());
+    EXPECT_EQ(0, m_batch.takeMissedDeadlines());
+    for (const auto& pTask : tasks) {
+        EXPECT_FALSE(pTask->isPending());
+        EXPECT_FALSE(pTask->runPending());
+    }
+}
+
+TEST_F(RubberBandBatchTest, RejectsJobsWhenFull) {
+    std::vector<std::unique_ptr<RubberBandTask>> tasks;
+    for (int i = 0; i < RubberBandBatch::kMaxJobs; ++i) {
+        tasks.push_back(makePendingTask());
+        EXPECT_TRUE(m_batch.submit(tasks.back().get()));
+    }
+    tasks.push_back(makePendingTask());
+    EXPECT_FALSE(m_batch.submit(tasks.back().get()));
+    EXPECT_EQ(RubberBandBatch::kMaxJobs, m_batch.numJobs());
+
+    m_batch.process(nullptr, m_timer, mixxx::Duration::fromSeconds(10));
+    EXPECT_EQ(0, m_batch.numJobs());
+    // The rejected job is left to the caller
+    EXPECT_TRUE(tasks.back()->isPending());
+}
+
+TEST_F(RubberBandBatchTest, CountsMissedDeadlines) {
+    std::vector<std::unique_ptr<RubberBandTask>> tasks;
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back(makePendingTask());
+        m_batch.submit(tasks.back().get());
+    }
+    m_batch.process(nullptr, m_timer, mixxx::Duration::fromNanos(0));
+    EXPECT_EQ(4, m_batch.takeMissedDeadlines());
+    EXPECT_EQ(0, m_batch.takeMissedDeadlines());
+}
+
+TEST_F(RubberBandBatchTest, BatchedScalerKeepsUp) {
+    ReadAheadManagerSine readAheadManager;
+    EngineBufferScaleRubberBand scaler(&readAheadManager);
+    setUpScaler(&scaler, &m_batch);
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    double framesRead = 0;
+    for (int i = 0; i < 100; ++i) {
+        framesRead += scaler.scaleBuffer(output.data(), kBufferSamples);
+        m_batch.process(nullptr, m_timer, mixxx::Duration::fromSeconds(10));
+    }
+    EXPECT_NEAR(100 * kBufferFrames * kRate, framesRead, kBufferFrames * kRate);
+    // The last output is not silent
+    EXPECT_GT(SampleUtil::sumSquared(output.data(), kBufferSamples), 0.05f * kBufferSamples);
+    // The input for the next buffer was read ahead, but not more
+    EXPECT_LT(readAheadManager.frame(), framesRead + 16 * kBufferFrames);
+}
+
+TEST_F(RubberBandBatchTest, ScalerProcessesQueuedInputWithoutBatch) {
+    ReadAheadManagerSine readAheadManager;
+    EngineBufferScaleRubberBand scaler(&readAheadManager);
+    setUpScaler(&scaler, &m_batch);
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    for (int i = 0; i < 20; ++i) {
+        // The batch is never processed, so the next call has to
+        scaler.scaleBuffer(output.data(), kBufferSamples);
+    }
+    EXPECT_GT(SampleUtil::sumSquared(output.data(), kBufferSamples), 0.05f * kBufferSamples);
+}
+
+class RubberBandWrapperTest : public RubberBandBatchTest {};
+
+TEST_F(RubberBandWrapperTest, JoiningWorkersIsReported) {
+    if (!RealtimeSafety::kEnabled) {
+        GTEST_SKIP() << "Requires REALTIME_SAFETY_CHECKS";
+    }
+    // One worker per channel, the first job is always started on the pool
+    config()->set(ConfigKey(QStringLiteral("[App]"),
+                          QStringLiteral("keylock_multithreading")),
+            ConfigValue(1));
+    RubberBandWorkerPool::createInstance(config());
+    {
+        RubberBandWrapper wrapper;
+        wrapper.setup(mixxx::audio::SampleRate(44100),
+                mixxx::audio::ChannelCount::stereo(),
+                RubberBandStretcher::OptionProcessRealTime);
+        RealtimeSafety::reset();
+        {
+            ScopedRealtimeSection realtimeSection;
+            wrapper.process(m_inputPtrs.data(), kBufferFrames, false);
+        }
+        // The join is a known violation that must stay visible
+        const QStringList violations = RealtimeSafety::violations();
+        EXPECT_TRUE(std::any_of(violations.begin(),
+                violations.end(),
+                [](const QString& violation) {
+                    return violation.startsWith(
+                            QStringLiteral("RubberBandWrapper joining workers"));
+                }))
+                << violations.join(QChar('\n')).toStdString();
+        EXPECT_LT(0, RealtimeSafety::violationCount());
+        RealtimeSafety::reset();
+    }
+    RubberBandWorkerPool::destroy();
+}
+
+// The number of decks and worker threads
+void deckArgs(benchmark::internal::Benchmark* pBenchmark) {
+    for (const int decks : {2, 4, 8}) {
+        for (const int threads : {0, 1, 3, 7}) {
+            pBenchmark->Args({decks, threads});
+        }
+    }
+}
+
+/// Stretches the given number of keylocked decks per callback, either each
+/// deck on its own (0 threads) or all of them as a batch with the given
+/// number of worker threads. Stem decks are mixed down before they are
+/// time stretched, so they are equivalent to a regular deck here.
+static void BM_KeylockDecks(benchmark::State& state) {
+    const int numDecks = static_cast<int>(state.range(0));
+    const int numThreads = static_cast<int>(state.range(1));
+
+    RubberBandBatch batch;
+    batch.setEnabled(numThreads > 0);
+    std::unique_ptr<RealtimeWorkerPool> pPool;
+    if (numThreads > 0) {
+        pPool = std::make_unique<RealtimeWorkerPool>(numThreads, false);
+    }
+
+    std::vector<std::unique_ptr<ReadAheadManagerSine>> readAheadManagers;
+    std::vector<std::unique_ptr<EngineBufferScaleRubberBand>> scalers;
+    for (int i = 0; i < numDecks; ++i) {
+        readAheadManagers.push_back(std::make_unique<ReadAheadManagerSine>(0.01 + 0.001 * i));
+        scalers.push_back(std::make_unique<EngineBufferScaleRubberBand>(
+                readAheadManagers.back().get()));
+        setUpScaler(scalers.back().get(), &batch);
+    }
+
+    mixxx::SampleBuffer output(kBufferSamples);
+    PerformanceTimer callbackTimer;
+    const auto deadline = mixxx::Duration::fromNanos(
+            static_cast<qint64>(kBufferFrames) * 1000000000 / 44100);
+    for (auto _ : state) {
+        callbackTimer.start();
+        for (const auto& pScaler : scalers) {
+            pScaler->scaleBuffer(output.data(), kBufferSamples);
+        }
+        batch.process(pPool.get(), callbackTimer, deadline);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.counters["missed_deadlines"] = batch.takeMissedDeadlines();
+    state.SetItemsProcessed(state.iterations() * numDecks * kBufferFrames);
+}
+BENCHMARK(BM_KeylockDecks)->Apply(deckArgs)->UseRealTime();
+
+} // namespace
@@ -583,4 +583,151 @@ static void BM_Copy2WithRampingGain(benchmark::State& state) {
 }
 BENCHMARK(BM_Copy2WithRampingGain)->Range(64, 4096);
 
+const SampleUtil::InstructionSet kInstructionSets[] = {
+        SampleUtil::InstructionSet::Baseline,
+        SampleUtil::InstructionSet::Avx2,
+        SampleUtil::InstructionSet::Avx512,
+};
+
+TEST_F(SampleUtilTest, instructionSetsProduceSameResults) {
+    const SampleUtil::InstructionSet detected = SampleUtil::instructionSet();
+    // Odd size to cover the remainder loops
+    constexpr int kSize = 1030 + 7;
+    std::vector<CSAMPLE> source(kSize);
+    for (int i = 0; i < kSize; ++i) {
+        source[i] = static_cast<CSAMPLE>((i % 37) - 18) / 10.0f;
+    }
+
+    std::vector<CSAMPLE> expected;
+    CSAMPLE expectedSumSquared = 0;
+    CSAMPLE expectedMaxAbs = 0;
+    for (const auto instructionSet : kInstructionSets) {
+        if (!SampleUtil::setInstructionSet(instructionSet)) {
+            continue;
+        }
+        std::vector<CSAMPLE> result(source);
+        SampleUtil::applyRampingGain(result.data(), 0.5f, 1.5f, kSize - 1);
+        SampleUtil::addWithGain(result.data(), source.data(), 0.25f, kSize);
+        std::vector<CSAMPLE> clamped(kSize);
+        SampleUtil::copyClampBuffer(clamped.data(), result.data(), kSize);
+        const CSAMPLE sumSquared = SampleUtil::sumSquared(clamped.data(), kSize);
+        const CSAMPLE maxAbs = SampleUtil::maxAbsAmplitude(result.data(), kSize);
+        if (expected.empty()) {
+            expected = clamped;
+            expectedSumSquared = sumSquared;
+            expectedMaxAbs = maxAbs;
+            continue;
+        }
+        SCOPED_TRACE(SampleUtil::instructionSetName(instructionSet));
+        for (int i = 0; i < kSize; ++i) {
+            EXPECT_FLOAT_EQ(expected[i], clamped[i]);
+        }
+        // The order of the summation depends on the vector width
+        EXPECT_NEAR(expectedSumSquared, sumSquared, expectedSumSquared * 1e-5f);
+        EXPECT_FLOAT_EQ(expectedMaxAbs, maxAbs);
+    }
+
+    ASSERT_TRUE(SampleUtil::setInstructionSet(detected));
+}
+
+// Reports ns/frame for a kernel with all instruction sets supported by
+// the CPU, e.g. BM_ApplyGain/1/1024 is AVX2 with 1024 stereo frames.
+template<typename Kernel>
+void benchmarkKernel(benchmark::State& state, Kernel kernel) {
+    const auto instructionSet =
+            static_cast<SampleUtil::InstructionSet>(state.range(0));
+    const SampleUtil::InstructionSet detected = SampleUtil::instructionSet();
+    if (!SampleUtil::setInstructionSet(instructionSet)) {
+        state.SkipWithError("Instruction set not supported");
+        return;
+    }
+    const SINT numFrames = static_cast<SINT>(state.range(1));
+    const SINT numSamples = numFrames * 2;
+    CSAMPLE* pDest = SampleUtil::alloc(numSamples * 2);
+    CSAMPLE* pSrc = SampleUtil::alloc(numSamples * 2);
+    SampleUtil::fill(pDest, 0.5f, numSamples * 2);
+    SampleUtil::fill(pSrc, 0.25f, numSamples * 2);
+
+    for (auto _ : state) {
+        kernel(pDest, pSrc, numSamples);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(SampleUtil::instructionSetName(instructionSet));
+    state.counters["ns/frame"] = benchmark::Counter(
+            static_cast<double>(numFrames) * 1e-9,
+            benchmark::Counter::kIsIterationInvariantRate |
+                    benchmark::Counter::kInvert);
+    SampleUtil::free(pDest);
+    SampleUtil::free(pSrc);
+    SampleUtil::setInstructionSet(detected);
+}
+
+void instructionSetArgs(benchmark::internal::Benchmark* pBenchmark) {
+    for (const auto instructionSet : kInstructionSets) {
+        for (const int numFrames : {64, 1024}) {
+            pBenchmark->Args({static_cast<int>(instructionSet), numFrames});
+        }
+    }
+}
+
+static void BM_ApplyGain(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE* pDest, const CSAMPLE*, SINT numSamples) {
+        SampleUtil::applyGain(pDest, 0.99f, numSamples);
+    });
+}
+BENCHMARK(BM_ApplyGain)->Apply(instructionSetArgs);
+
+static void BM_CopyWithRampingGain(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+        SampleUtil::copyWithRampingGain(pDest, pSrc, 0.5f, 0.75f, numSamples);
+    });
+}
+BENCHMARK(BM_CopyWithRampingGain)->Apply(instructionSetArgs);
+
+static void BM_AddWithRampingGain(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+        SampleUtil::addWithRampingGain(pDest, pSrc, 0.5f, 0.75f, numSamples);
+    });
+}
+BENCHMARK(BM_AddWithRampingGain)->Apply(instructionSetArgs);
+
+static void BM_CopyClampBuffer(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+        SampleUtil::copyClampBuffer(pDest, pSrc, numSamples);
+    });
+}
+BENCHMARK(BM_CopyClampBuffer)->Apply(instructionSetArgs);
+
+static void BM_InterleaveBuffer(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+        SampleUtil::interleaveBuffer(pDest, pSrc, pSrc + numSamples / 2, numSamples / 2);
+    });
+}
+BENCHMARK(BM_InterleaveBuffer)->Apply(instructionSetArgs);
+
+static void BM_DeinterleaveBuffer(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE* pDest, const CSAMPLE* pSrc, SINT numSamples) {
+        SampleUtil::deinterleaveBuffer(pDest, pDest + numSamples / 2, pSrc, numSamples / 2);
+    });
+}
+BENCHMARK(BM_DeinterleaveBuffer)->Apply(instructionSetArgs);
+
+static void BM_SumAbsPerChannel(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE*, const CSAMPLE* pSrc, SINT numSamples) {
+        CSAMPLE absL;
+        CSAMPLE absR;
+        benchmark::DoNotOptimize(
+                SampleUtil::sumAbsPerChannel(&absL, &absR, pSrc, numSamples));
+    });
+}
+BENCHMARK(BM_SumAbsPerChannel)->Apply(instructionSetArgs);
+
+static void BM_Rms(benchmark::State& state) {
+    benchmarkKernel(state, [](CSAMPLE*, const CSAMPLE* pSrc, SINT numSamples) {
+        benchmark::DoNotOptimize(SampleUtil::rms(pSrc, numSamples));
+    });
+}
+BENCHMARK(BM_Rms)->Apply(instructionSetArgs);
+
 }  // namespace
@@ -26,6 +26,7 @@
 #include "test/soundsourceproviderregistration.h"
 #include "track/track.h"
 #include "util/defs.h"
+#include "util/realtimesafety.h"
 #include "util/sample.h"
 #include "util/types.h"
 #ifdef __RUBBERBAND__
@@ -149,9 +150,13 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
 #ifdef __RUBBERBAND__
         RubberBandWorkerPool::createInstance();
 #endif
+        RealtimeSafety::reset();
     }
 
     void TearDown() override {
+        // Only detects violations in REALTIME_SAFETY_CHECKS builds
+        EXPECT_EQ(0, RealtimeSafety::violationCount())
+                << RealtimeSafety::violations().join(QChar('\n')).toStdString();
 #ifdef __RUBBERBAND__
         RubberBandWorkerPool::destroy();
 #endif
@@ -164,7 +169,7 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
         m_pNumDecks->set(m_pNumDecks->get() + 1);
     }
 
-    void loadTrack(Deck* pDeck, TrackPointer pTrack) {
+    void loadTrack(BaseTrackPlayerImpl* pDeck, TrackPointer pTrack) {
         EngineDeck* pEngineDeck = pDeck->getEngineDeck();
         if (pEngineDeck->getEngineBuffer()->isTrackLoaded()) {
             pEngineDeck->getEngineBuffer()->ejectTrack();
@@ -3,12 +3,15 @@
 #include <QtDebug>
 
 #include "analyzer/analyzersilence.h"
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreadertrackbuffer.h"
 #include "sources/audiosourcestereoproxy.h"
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
 #include "track/track.h"
 #include "track/trackmetadata.h"
+#include "util/sample.h"
 #include "util/samplebuffer.h"
 
 namespace {
@@ -752,6 +755,86 @@ TEST_F(SoundSourceProxyTest, regressionTestCachingReaderChunkJumpForward) {
     }
 }
 
+TEST_F(SoundSourceProxyTest, cachingReaderTrackBuffer) {
+    const QStringList filePaths = getFilePaths();
+    for (const auto& filePath : filePaths) {
+        ASSERT_TRUE(SoundSourceProxy::isFileNameSupported(filePath));
+
+        const auto fileUrl = QUrl::fromLocalFile(filePath);
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(fileUrl);
+        for (const auto& providerRegistration : providerRegistrations) {
+            mixxx::AudioSourcePointer pBufferSource = openAudioSource(
+                    filePath,
+                    providerRegistration.getProvider());
+            // Obtaining an AudioSource may fail for unsupported file formats,
+            // even if the corresponding file extension is supported, e.g.
+            // AAC vs. ALAC in .m4a files
+            if (!pBufferSource) {
+                // skip test file
+                continue;
+            }
+            mixxx::AudioSourcePointer pContReadSource = openAudioSource(
+                    filePath,
+                    providerRegistration.getProvider());
+            ASSERT_TRUE(pContReadSource);
+
+            // Decode the whole file in chunk sized steps
+            CachingReaderTrackBuffer trackBuffer(pBufferSource->frameIndexRange());
+            ASSERT_TRUE(trackBuffer.isValid());
+            mixxx::SampleBuffer tempReadBuffer(
+                    pBufferSource->getSignalInfo().frames2samples(
+                            CachingReaderChunk::kFrames));
+            while (!trackBuffer.isComplete()) {
+                trackBuffer.bufferNextSampleFrames(pBufferSource,
+                        mixxx::SampleBuffer::WritableSlice(tempReadBuffer),
+                        CachingReaderChunk::kFrames);
+            }
+            EXPECT_DOUBLE_EQ(1.0, trackBuffer.progress());
+            EXPECT_EQ(pBufferSource->frameIndexRange(),
+                    trackBuffer.bufferedFrameIndexRange());
+
+            // Compare a range across a chunk boundary with a continuous read
+            const auto readRange = intersect(
+                    mixxx::IndexRange::forward(
+                            pContReadSource->frameIndexMin() +
+                                    CachingReaderChunk::kFrames - kMaxReadFrameCount / 2,
+                            kMaxReadFrameCount),
+                    pContReadSource->frameIndexRange());
+            ASSERT_FALSE(readRange.empty());
+            const SINT readSamples =
+                    pContReadSource->getSignalInfo().frames2samples(readRange.length());
+            mixxx::SampleBuffer contReadData(readSamples);
+            const auto contSampleFrames = pContReadSource->readSampleFrames(
+                    mixxx::WritableSampleFrames(
+                            readRange,
+                            mixxx::SampleBuffer::WritableSlice(contReadData)));
+            ASSERT_EQ(readRange, contSampleFrames.frameIndexRange());
+
+            mixxx::SampleBuffer bufferedReadData(readSamples);
+            EXPECT_EQ(readRange,
+                    trackBuffer.readBufferedSampleFrames(
+                            bufferedReadData.data(), readRange));
+            expectDecodedSamplesEqual(readSamples,
+                    contSampleFrames.readableData(),
+                    bufferedReadData.data(),
+                    "Whole-track buffer differs from continuous read");
+
+            // The reverse read copies the frames in reverse order into the
+            // buffer, which is passed by its end.
+            mixxx::SampleBuffer reverseReadData(readSamples);
+            EXPECT_EQ(readRange,
+                    trackBuffer.readBufferedSampleFramesReverse(
+                            reverseReadData.data() + readSamples, readRange));
+            SampleUtil::reverse(reverseReadData.data(), readSamples);
+            expectDecodedSamplesEqual(readSamples,
+                    contSampleFrames.readableData(),
+                    reverseReadData.data(),
+                    "Reverse read from whole-track buffer differs");
+        }
+    }
+}
+
 TEST_F(SoundSourceProxyTest, firstSoundTest) {
     constexpr SINT kReadFrameCount = 2000;
 
@@ -0,0 +1,175 @@
+#include "analyzer/trackanalysisscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QThread>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+namespace {
+
+typedef AnalyzerScheduledTrack::Priority Priority;
+
+constexpr int kTimeoutMillis = 30000;
+
+class TestEnvironment final : public TrackAnalysisSchedulerEnvironment {
+  public:
+    explicit TestEnvironment(std::map<TrackId, TrackPointer> tracks)
+            : m_tracks(std::move(tracks)) {
+    }
+
+    TrackPointer loadTrackById(TrackId trackId) const override {
+        const auto track = m_tracks.find(trackId);
+        if (track == m_tracks.end()) {
+            return TrackPointer();
+        }
+        return track->second;
+    }
+
+  private:
+    const std::map<TrackId, TrackPointer> m_tracks;
+};
+
+class TrackAnalysisSchedulerTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    TrackAnalysisSchedulerTest()
+            : m_trackIdA(QVariant(1)),
+              m_trackIdB(QVariant(2)),
+              m_pScheduler(TrackAnalysisScheduler::NullPointer()),
+              m_finishedCount(0) {
+        const QString location = getTestDir().filePath(QStringLiteral("sine-30.wav"));
+        std::map<TrackId, TrackPointer> tracks;
+        tracks.emplace(m_trackIdA, Track::newDummy(location, m_trackIdA));
+        tracks.emplace(m_trackIdB, Track::newDummy(location, m_trackIdB));
+        // A single worker thread that is created suspended
+        m_pScheduler = TrackAnalysisScheduler::createInstance(
+                std::make_unique<TestEnvironment>(std::move(tracks)),
+                1,
+                mixxx::DbConnectionPoolPtr(),
+                config(),
+                AnalyzerModeFlags::WithBeats);
+        QObject::connect(m_pScheduler.get(),
+                &TrackAnalysisScheduler::trackProgress,
+                [this](TrackId trackId, AnalyzerProgress analyzerProgress) {
+                    if (analyzerProgress == kAnalyzerProgressDone ||
+                            analyzerProgress == kAnalyzerProgressUnknown) {
+                        m_doneTracks.emplace_back(trackId, analyzerProgress);
+                    } else {
+                        m_busyTracks.push_back(trackId);
+                    }
+                });
+        QObject::connect(m_pScheduler.get(),
+                &TrackAnalysisScheduler::finished,
+                [this]() {
+                    ++m_finishedCount;
+                });
+    }
+
+    // Returns false if the timeout expired before the condition became true
+    template<typename Condition>
+    bool processEventsUntil(Condition condition, int timeoutMillis = kTimeoutMillis) {
+        QElapsedTimer timer;
+        timer.start();
+        while (!condition()) {
+            if (timer.hasExpired(timeoutMillis)) {
+                return false;
+            }
+            application()->processEvents();
+            QThread::msleep(1);
+        }
+        return true;
+    }
+
+    bool isBusy(TrackId trackId) const {
+        return std::find(m_busyTracks.begin(), m_busyTracks.end(), trackId) !=
+                m_busyTracks.end();
+    }
+
+    const TrackId m_trackIdA;
+    const TrackId m_trackIdB;
+    TrackAnalysisScheduler::Pointer m_pScheduler;
+    std::vector<TrackId> m_busyTracks;
+    std::vector<std::pair<TrackId, AnalyzerProgress>> m_doneTracks;
+    int m_finishedCount;
+};
+
+TEST_F(TrackAnalysisSchedulerTest, PreemptAndRequeueLowerPriorityTrack) {
+    ASSERT_TRUE(m_pScheduler->scheduleTrack(
+            AnalyzerScheduledTrack(m_trackIdA, AnalyzerTrack::Options(), Priority::Bulk)));
+    // The suspended worker fetches the track and reports that the analysis
+    // has started before it falls asleep on the first chunk
+    ASSERT_TRUE(processEventsUntil([this]() { return isBusy(m_trackIdA); }));
+
+    ASSERT_TRUE(m_pScheduler->scheduleTrack(
+            AnalyzerScheduledTrack(m_trackIdB, AnalyzerTrack::Options(), Priority::Deck)));
+    m_pScheduler->resume();
+    ASSERT_TRUE(processEventsUntil([this]() { return m_finishedCount > 0; }));
+
+    // The preempted track is not reported as failed, but analyzed again
+    // after the track with the higher priority
+    const std::vector<std::pair<TrackId, AnalyzerProgress>> expectedDoneTracks = {
+            {m_trackIdB, kAnalyzerProgressDone},
+            {m_trackIdA, kAnalyzerProgressDone},
+    };
+    EXPECT_EQ(expectedDoneTracks, m_doneTracks);
+}
+
+TEST_F(TrackAnalysisSchedulerTest, PreemptTrackWithLoweredPriority) {
+    ASSERT_TRUE(m_pScheduler->scheduleTrack(
+            AnalyzerScheduledTrack(m_trackIdA, AnalyzerTrack::Options(), Priority::Deck)));
+    ASSERT_TRUE(processEventsUntil([this]() { return isBusy(m_trackIdA); }));
+    ASSERT_TRUE(m_pScheduler->scheduleTrack(
+            AnalyzerScheduledTrack(m_trackIdB, AnalyzerTrack::Options(), Priority::Deck)));
+
+    // Like PlayerManager, when the deck has been loaded with another track
+    EXPECT_TRUE(m_pScheduler->setTrackPriority(m_trackIdA, Priority::Bulk));
+    m_pScheduler->resume();
+    ASSERT_TRUE(processEventsUntil([this]() { return m_finishedCount > 0; }));
+
+    const std::vector<std::pair<TrackId, AnalyzerProgress>> expectedDoneTracks = {
+            {m_trackIdB, kAnalyzerProgressDone},
+            {m_trackIdA, kAnalyzerProgressDone},
+    };
+    EXPECT_EQ(expectedDoneTracks, m_doneTracks);
+}
+
+TEST_F(TrackAnalysisSchedulerTest, StaySuspendedWhileYielding) {
+    m_pScheduler->setYielding(true);
+    ASSERT_TRUE(m_pScheduler->scheduleTrack(
+            AnalyzerScheduledTrack(m_trackIdA, AnalyzerTrack::Options(), Priority::Bulk)));
+    m_pScheduler->resume();
+    ASSERT_TRUE(processEventsUntil([this]() { return isBusy(m_trackIdA); }));
+    EXPECT_FALSE(processEventsUntil([this]() { return m_finishedCount > 0; }, 500));
+    EXPECT_TRUE(m_doneTracks.empty());
+
+    m_pScheduler->setYielding(false);
+    ASSERT_TRUE(processEventsUntil([this]() { return m_finishedCount > 0; }));
+    const std::vector<std::pair<TrackId, AnalyzerProgress>> expectedDoneTracks = {
+            {m_trackIdA, kAnalyzerProgressDone},
+    };
+    EXPECT_EQ(expectedDoneTracks, m_doneTracks);
+}
+
+TEST_F(TrackAnalysisSchedulerTest, StaySuspendedAfterYielding) {
+    ASSERT_TRUE(m_pScheduler->scheduleTrack(
+            AnalyzerScheduledTrack(m_trackIdA, AnalyzerTrack::Options(), Priority::Bulk)));
+    m_pScheduler->setYielding(true);
+    m_pScheduler->setYielding(false);
+    ASSERT_TRUE(processEventsUntil([this]() { return isBusy(m_trackIdA); }));
+    // Not resumed yet
+    EXPECT_FALSE(processEventsUntil([this]() { return m_finishedCount > 0; }, 500));
+
+    m_pScheduler->resume();
+    ASSERT_TRUE(processEventsUntil([this]() { return m_finishedCount > 0; }));
+    EXPECT_EQ(1, static_cast<int>(m_doneTracks.size()));
+}
+
+} // namespace
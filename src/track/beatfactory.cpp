@@ -8,6 +8,9 @@ namespace {
 
 const QString kRoundingVersion = QStringLiteral("V4");
 
+// Marks the sub-version of provisional beats in progressive mode
+const QString kProvisionalVersionInfoKey = QStringLiteral("provisional");
+
 } // namespace
 
 // static
@@ -48,6 +51,17 @@ QString BeatFactory::getPreferredSubVersion(
                                   : "";
 }
 
+// static
+void BeatFactory::setProvisional(QHash<QString, QString>* pExtraVersionInfo) {
+    (*pExtraVersionInfo)[kProvisionalVersionInfoKey] = "1";
+}
+
+// static
+bool BeatFactory::isProvisionalSubVersion(const QString& subVersion) {
+    return subVersion.split('|').contains(
+            QStringLiteral("%1=1").arg(kProvisionalVersionInfoKey));
+}
+
 mixxx::BeatsPointer BeatFactory::makePreferredBeats(
         const QVector<mixxx::audio::FramePos>& beats,
         const QHash<QString, QString>& extraVersionInfo,
@@ -16,6 +16,12 @@ class BeatFactory {
     static QString getPreferredSubVersion(
             const QHash<QString, QString>& extraVersionInfo);
 
+    // Marks the extra version info of provisional beats that are stored
+    // during a progressive analysis
+    static void setProvisional(QHash<QString, QString>* pExtraVersionInfo);
+    // Checks the sub-version of beats for the provisional mark
+    static bool isProvisionalSubVersion(const QString& subVersion);
+
     static mixxx::BeatsPointer makePreferredBeats(
             const QVector<mixxx::audio::FramePos>& beats,
             const QHash<QString, QString>& extraVersionInfo,
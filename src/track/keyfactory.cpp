@@ -7,6 +7,13 @@
 
 using mixxx::track::io::key::KeyMap;
 
+namespace {
+
+// Marks the sub-version of provisional keys in progressive mode
+const QString kProvisionalVersionInfoKey = QStringLiteral("provisional");
+
+} // namespace
+
 // static
 Keys KeyFactory::loadKeysFromByteArray(const QString& keysVersion,
                                        const QString& keysSubVersion,
@@ -84,6 +91,17 @@ QString KeyFactory::getPreferredSubVersion(
     return (fragments.size() > 0) ? fragments.join(kSubVersionFragmentSeparator) : "";
 }
 
+// static
+void KeyFactory::setProvisional(QHash<QString, QString>* pExtraVersionInfo) {
+    (*pExtraVersionInfo)[kProvisionalVersionInfoKey] = "1";
+}
+
+// static
+bool KeyFactory::isProvisionalSubVersion(const QString& subVersion) {
+    return subVersion.split('|').contains(
+            QStringLiteral("%1=1").arg(kProvisionalVersionInfoKey));
+}
+
 // static
 Keys KeyFactory::makePreferredKeys(
         const KeyChangeList& key_changes,
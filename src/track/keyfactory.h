@@ -36,6 +36,12 @@ class KeyFactory {
     static QString getPreferredSubVersion(
             const QHash<QString, QString>& extraVersionInfo);
 
+    /// Marks the extra version info of provisional keys that are stored
+    /// during a progressive analysis
+    static void setProvisional(QHash<QString, QString>* pExtraVersionInfo);
+    /// Checks the sub-version of keys for the provisional mark
+    static bool isProvisionalSubVersion(const QString& subVersion);
+
     static Keys makePreferredKeys(
             const KeyChangeList& key_changes,
             const QHash<QString, QString>& extraVersionInfo,
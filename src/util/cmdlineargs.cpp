@@ -46,6 +46,11 @@ CmdlineArgs::CmdlineArgs()
           m_controllerDebug(false),
           m_controllerAbortOnWarning(false),
           m_developer(false),
+          m_analyze(false),
+          m_analyzeThreads(0),
+          m_analyzeRestart(false),
+          m_renderSeconds(0.0),
+          m_renderBufferFrames(0),
 #ifdef MIXXX_USE_QML
           m_qml(false),
 #endif
@@ -264,6 +269,68 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(developer);
 
+    const QCommandLineOption analyze(QStringLiteral("analyze"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyzes tracks without starting the GUI and exits "
+                                      "afterwards. The files and folders given as [file] "
+                                      "are added to the library and analyzed. Without any "
+                                      "files or playlists all tracks of the library are "
+                                      "analyzed. An interrupted analysis resumes where it "
+                                      "stopped when started again with the same arguments.")
+                            : QString());
+    parser.addOption(analyze);
+
+    const QCommandLineOption analyzePlaylist(QStringLiteral("analyze-playlist"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Analyzes the tracks of the playlist with the given "
+                                      "name. Can be specified multiple times. Implies "
+                                      "--analyze.")
+                            : QString(),
+            QStringLiteral("name"));
+    parser.addOption(analyzePlaylist);
+
+    const QCommandLineOption analyzeThreads(QStringLiteral("analyze-threads"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Number of tracks that are analyzed in parallel with "
+                                      "--analyze. Default is the number of CPU cores.")
+                            : QString(),
+            QStringLiteral("count"));
+    parser.addOption(analyzeThreads);
+
+    const QCommandLineOption analyzeRestart(QStringLiteral("analyze-restart"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Discards the progress of an interrupted analysis "
+                                      "instead of resuming it.")
+                            : QString());
+    parser.addOption(analyzeRestart);
+
+    const QCommandLineOption render(QStringLiteral("render"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Plays the files given as [file] in one deck each "
+                                      "without a sound device and writes the main output to "
+                                      "the given file, encoded according to its extension "
+                                      "(e.g. wav, flac, mp3). Exits afterwards and prints "
+                                      "how many times faster than realtime the engine ran.")
+                            : QString(),
+            QStringLiteral("file"));
+    parser.addOption(render);
+
+    const QCommandLineOption renderDuration(QStringLiteral("render-duration"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Duration of the audio rendered with --render. Default "
+                                      "is the duration of the longest track.")
+                            : QString(),
+            QStringLiteral("seconds"));
+    parser.addOption(renderDuration);
+
+    const QCommandLineOption renderBuffer(QStringLiteral("render-buffer"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Frames per engine callback with --render. Default "
+                                      "is 1024.")
+                            : QString(),
+            QStringLiteral("frames"));
+    parser.addOption(renderBuffer);
+
 #ifdef MIXXX_USE_QML
     const QCommandLineOption qml(QStringLiteral("qml"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
@@ -417,6 +484,40 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     m_controllerPreviewScreens = parser.isSet(controllerPreviewScreens);
     m_controllerAbortOnWarning = parser.isSet(controllerAbortOnWarning);
     m_developer = parser.isSet(developer);
+    m_analyzePlaylists = parser.values(analyzePlaylist);
+    m_analyze = parser.isSet(analyze) || !m_analyzePlaylists.isEmpty();
+    if (parser.isSet(analyzeThreads)) {
+        bool ok = false;
+        m_analyzeThreads = parser.value(analyzeThreads).toInt(&ok);
+        if (!ok || m_analyzeThreads < 1) {
+            fputs("\nanalyze-threads must be a positive number!\n"
+                  "Mixxx will use one thread per CPU core.\n",
+                    stdout);
+            m_analyzeThreads = 0;
+        }
+    }
+    m_analyzeRestart = parser.isSet(analyzeRestart);
+    m_renderFile = parser.value(render);
+    if (parser.isSet(renderDuration)) {
+        bool ok = false;
+        m_renderSeconds = parser.value(renderDuration).toDouble(&ok);
+        if (!ok || m_renderSeconds <= 0) {
+            fputs("\nrender-duration must be a positive number!\n"
+                  "Mixxx will render the longest track.\n",
+                    stdout);
+            m_renderSeconds = 0.0;
+        }
+    }
+    if (parser.isSet(renderBuffer)) {
+        bool ok = false;
+        m_renderBufferFrames = parser.value(renderBuffer).toInt(&ok);
+        if (!ok || m_renderBufferFrames < 1) {
+            fputs("\nrender-buffer must be a positive number!\n"
+                  "Mixxx will use the default.\n",
+                    stdout);
+            m_renderBufferFrames = 0;
+        }
+    }
 #ifdef MIXXX_USE_QML
     m_qml = parser.isSet(qml);
 #endif
@@ -4,6 +4,7 @@
 #include <QDir>
 #include <QList>
 #include <QString>
+#include <QStringList>
 
 #include "util/logging.h"
 
@@ -43,6 +44,36 @@ class CmdlineArgs final {
         return m_controllerAbortOnWarning;
     }
     bool getDeveloper() const { return m_developer; }
+    /// Analyze tracks without the GUI and exit, see BatchAnalysis
+    bool getAnalyze() const {
+        return m_analyze;
+    }
+    const QStringList& getAnalyzePlaylists() const {
+        return m_analyzePlaylists;
+    }
+    /// 0 if unspecified
+    int getAnalyzeThreads() const {
+        return m_analyzeThreads;
+    }
+    bool getAnalyzeRestart() const {
+        return m_analyzeRestart;
+    }
+    /// Render the tracks to a file without a sound device and exit,
+    /// see HeadlessRender
+    bool getRender() const {
+        return !m_renderFile.isEmpty();
+    }
+    const QString& getRenderFile() const {
+        return m_renderFile;
+    }
+    /// 0 if unspecified
+    double getRenderSeconds() const {
+        return m_renderSeconds;
+    }
+    /// 0 if unspecified
+    int getRenderBufferFrames() const {
+        return m_renderBufferFrames;
+    }
 #ifdef MIXXX_USE_QML
     bool isQml() const {
         return m_qml;
@@ -93,6 +124,13 @@ class CmdlineArgs final {
     bool m_controllerPreviewScreens;
     bool m_controllerAbortOnWarning; // Controller Engine will be stricter
     bool m_developer; // Developer Mode
+    bool m_analyze;
+    QStringList m_analyzePlaylists;
+    int m_analyzeThreads;
+    bool m_analyzeRestart;
+    QString m_renderFile;
+    double m_renderSeconds;
+    int m_renderBufferFrames;
 #ifdef MIXXX_USE_QML
     bool m_qml;
 #endif
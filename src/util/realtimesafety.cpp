@@ -0,0 +1,102 @@
+#include "util/realtimesafety.h"
+
+#include <QString>
+#include <algorithm>
+#include <atomic>
+
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+#include <execinfo.h>
+
+#include <cstdlib>
+#endif
+
+namespace {
+
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+
+constexpr int kMaxRecordedViolations = 16;
+constexpr int kMaxStackDepth = 32;
+
+struct Violation {
+    const char* pName;
+    int stackDepth;
+    void* stack[kMaxStackDepth];
+};
+
+// Recording happens on the audio thread, so all slots are allocated
+// statically. Only the first violations are recorded, the counter
+// covers all of them.
+Violation s_violations[kMaxRecordedViolations];
+std::atomic<int> s_violationCount(0);
+
+// The first call of backtrace() loads the unwinder, which allocates.
+// Do it at startup instead of in the middle of the first violation.
+[[maybe_unused]] const bool s_backtracePrimed = [] {
+    void* stack[1];
+    backtrace(stack, 1);
+    return true;
+}();
+
+#endif
+
+} // namespace
+
+// static
+void RealtimeSafety::reportViolation(const char* pName) {
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+    // backtrace() itself must not report any violations
+    ScopedRealtimeSafetySuspension suspension;
+    const int index = s_violationCount.fetch_add(1, std::memory_order_relaxed);
+    if (index >= kMaxRecordedViolations) {
+        return;
+    }
+    Violation& violation = s_violations[index];
+    violation.pName = pName;
+    violation.stackDepth = backtrace(violation.stack, kMaxStackDepth);
+#else
+    Q_UNUSED(pName);
+#endif
+}
+
+// static
+int RealtimeSafety::violationCount() {
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+    return s_violationCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+// static
+QStringList RealtimeSafety::violations() {
+    QStringList result;
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+    const int count = std::min(violationCount(), kMaxRecordedViolations);
+    for (int i = 0; i < count; ++i) {
+        const Violation& violation = s_violations[i];
+        QString description = QStringLiteral("%1 called in the audio callback")
+                                      .arg(QString::fromLatin1(violation.pName));
+        char** pSymbols = backtrace_symbols(violation.stack, violation.stackDepth);
+        if (pSymbols) {
+            // Skip the frames of reportViolation() and the interceptor
+            for (int frame = 2; frame < violation.stackDepth; ++frame) {
+                description += QStringLiteral("\n    ") + QString::fromLocal8Bit(pSymbols[frame]);
+            }
+            free(pSymbols);
+        }
+        result.append(description);
+    }
+    if (violationCount() > count) {
+        result.append(QStringLiteral("... and %1 more")
+                              .arg(violationCount() - count));
+    }
+#endif
+    return result;
+}
+
+// static
+void RealtimeSafety::reset() {
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+    s_violationCount.store(0, std::memory_order_relaxed);
+#endif
+}
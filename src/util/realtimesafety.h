@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QStringList>
+
+/// RealtimeSafety detects memory allocations, mutex locks and blocking system
+/// calls in the audio callback, which must neither allocate nor wait.
+///
+/// The engine marks the threads that are processing the audio callback with
+/// ScopedRealtimeSection. If Mixxx is built with REALTIME_SAFETY_CHECKS
+/// (Linux only, for debugging and CI) malloc() and the aligned allocations,
+/// free(), pthread and futex waits, sleeps and the locks of lockMutex()
+/// report a violation when they are called within such a section. Each violation increments a counter
+/// and the call stack of the first violations is recorded, so tests can
+/// fail with a meaningful message instead of the callback just silently
+/// missing its deadline.
+///
+/// Without REALTIME_SAFETY_CHECKS all functions compile to no-ops.
+class RealtimeSafety {
+  public:
+#ifdef MIXXX_REALTIME_SAFETY_CHECKS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    /// Called by the interceptors. Records a violation if the calling
+    /// thread is processing the audio callback. The name must be a string
+    /// literal.
+    static void checkCall(const char* pName) {
+        if constexpr (kEnabled) {
+            if (t_realtimeDepth > 0 && t_suspendDepth == 0) {
+                reportViolation(pName);
+            }
+        }
+    }
+
+    static bool isRealtimeThread() {
+        return t_realtimeDepth > 0;
+    }
+
+    /// The number of violations since the last reset()
+    static int violationCount();
+    /// Human readable descriptions of the recorded violations, including the
+    /// symbolized call stacks. Must not be called from the audio callback.
+    static QStringList violations();
+    static void reset();
+
+  private:
+    friend class ScopedRealtimeSection;
+    friend class ScopedRealtimeSafetySuspension;
+
+    static void reportViolation(const char* pName);
+
+    static inline thread_local int t_realtimeDepth = 0;
+    // Suspends the checks, e.g. while recording a violation
+    static inline thread_local int t_suspendDepth = 0;
+};
+
+/// Marks the calling thread as processing the audio callback for the
+/// lifetime of the scope. Sections may nest.
+class ScopedRealtimeSection {
+  public:
+    ScopedRealtimeSection() {
+        if constexpr (RealtimeSafety::kEnabled) {
+            ++RealtimeSafety::t_realtimeDepth;
+        }
+    }
+    ~ScopedRealtimeSection() {
+        if constexpr (RealtimeSafety::kEnabled) {
+            --RealtimeSafety::t_realtimeDepth;
+        }
+    }
+
+    ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+    ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+};
+
+/// Allows calls that would be violations for the lifetime of the scope,
+/// for code paths that are known to block on purpose, e.g. a debugging aid
+/// that logs from the audio callback.
+class ScopedRealtimeSafetySuspension {
+  public:
+    ScopedRealtimeSafetySuspension() {
+        if constexpr (RealtimeSafety::kEnabled) {
+            ++RealtimeSafety::t_suspendDepth;
+        }
+    }
+    ~ScopedRealtimeSafetySuspension() {
+        if constexpr (RealtimeSafety::kEnabled) {
+            --RealtimeSafety::t_suspendDepth;
+        }
+    }
+
+    ScopedRealtimeSafetySuspension(const ScopedRealtimeSafetySuspension&) = delete;
+    ScopedRealtimeSafetySuspension& operator=(const ScopedRealtimeSafetySuspension&) = delete;
+};
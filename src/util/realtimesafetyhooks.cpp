@@ -0,0 +1,165 @@
+// Interceptors for REALTIME_SAFETY_CHECKS builds. This file is only linked
+// into the executables, because the definitions replace the functions of
+// the C library for the whole process.
+
+#include <dlfcn.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdlib>
+
+#include "util/realtimesafety.h"
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+namespace {
+
+template<typename Function>
+Function resolveNext(const char* pName) {
+    return reinterpret_cast<Function>(dlsym(RTLD_NEXT, pName));
+}
+
+// Resolved eagerly at startup. dlsym() must not be called for the
+// first time while the audio callback is running.
+const auto s_pthreadMutexLock =
+        resolveNext<int (*)(pthread_mutex_t*)>("pthread_mutex_lock");
+const auto s_pthreadCondWait =
+        resolveNext<int (*)(pthread_cond_t*, pthread_mutex_t*)>("pthread_cond_wait");
+const auto s_pthreadCondTimedWait =
+        resolveNext<int (*)(pthread_cond_t*, pthread_mutex_t*, const timespec*)>(
+                "pthread_cond_timedwait");
+const auto s_semWait = resolveNext<int (*)(sem_t*)>("sem_wait");
+const auto s_nanosleep = resolveNext<int (*)(const timespec*, timespec*)>("nanosleep");
+const auto s_usleep = resolveNext<int (*)(useconds_t)>("usleep");
+const auto s_syscall = resolveNext<long (*)(long, ...)>("syscall");
+
+bool isValidPosixMemalignAlignment(size_t alignment) {
+    return alignment % sizeof(void*) == 0 && (alignment & (alignment - 1)) == 0;
+}
+
+bool isFutexWait(long number, long op) {
+    if (number != SYS_futex) {
+        return false;
+    }
+    switch (op & FUTEX_CMD_MASK) {
+    case FUTEX_WAIT:
+    case FUTEX_WAIT_BITSET:
+    case FUTEX_LOCK_PI:
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    RealtimeSafety::checkCall("malloc");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    RealtimeSafety::checkCall("calloc");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    RealtimeSafety::checkCall("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+// Aligned allocations, e.g. by the aligned operator new or by SIMD code
+// in the time stretchers. glibc only exports __libc_memalign, which also
+// backs aligned_alloc() and posix_memalign().
+void* aligned_alloc(size_t alignment, size_t size) {
+    RealtimeSafety::checkCall("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** pPtr, size_t alignment, size_t size) {
+    RealtimeSafety::checkCall("posix_memalign");
+    if (!isValidPosixMemalignAlignment(alignment)) {
+        return EINVAL;
+    }
+    void* ptr = __libc_memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *pPtr = ptr;
+    return 0;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    RealtimeSafety::checkCall("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        RealtimeSafety::checkCall("free");
+    }
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* pMutex) {
+    RealtimeSafety::checkCall("pthread_mutex_lock");
+    return s_pthreadMutexLock(pMutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* pCond, pthread_mutex_t* pMutex) {
+    RealtimeSafety::checkCall("pthread_cond_wait");
+    return s_pthreadCondWait(pCond, pMutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* pCond,
+        pthread_mutex_t* pMutex,
+        const timespec* pTimeout) {
+    RealtimeSafety::checkCall("pthread_cond_timedwait");
+    return s_pthreadCondTimedWait(pCond, pMutex, pTimeout);
+}
+
+int sem_wait(sem_t* pSemaphore) {
+    RealtimeSafety::checkCall("sem_wait");
+    return s_semWait(pSemaphore);
+}
+
+int nanosleep(const timespec* pDuration, timespec* pRemaining) {
+    RealtimeSafety::checkCall("nanosleep");
+    return s_nanosleep(pDuration, pRemaining);
+}
+
+int usleep(useconds_t microseconds) {
+    RealtimeSafety::checkCall("usleep");
+    return s_usleep(microseconds);
+}
+
+// QMutex, QSemaphore and QWaitCondition wait on futexes directly
+long syscall(long number, ...) {
+    va_list args;
+    va_start(args, number);
+    long arg[6];
+    for (auto& value : arg) {
+        value = va_arg(args, long);
+    }
+    va_end(args);
+    if (isFutexWait(number, arg[1])) {
+        RealtimeSafety::checkCall("futex wait");
+    }
+    return s_syscall(number, arg[0], arg[1], arg[2], arg[3], arg[4], arg[5]);
+}
+
+} // extern "C"
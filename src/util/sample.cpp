@@ -110,14 +110,40 @@ void SampleUtil::free(CSAMPLE* pBuffer) {
     }
 }
 
-// static
-void SampleUtil::applyGain(CSAMPLE* pBuffer, CSAMPLE_GAIN gain,
+namespace {
+
+// The hot loops are compiled for several instruction sets and the best
+// variant for the CPU is selected at runtime. Distribution builds only
+// target the baseline (SSE2 on x86-64) where the auto-vectorized loops use
+// 128 bit registers. Each kernel is inlined into one function per
+// instruction set, so the compiler vectorizes every copy of the loop for
+// the respective register width.
+//
+// ARM builds always target NEON (mandatory on aarch64, -mfpu=neon on armv7)
+// and MSVC does not support per-function targets, so both only use the
+// baseline kernels.
+#if defined(__GNUC__)
+#define SAMPLE_UTIL_KERNEL inline __attribute__((always_inline))
+#elif defined(_MSC_VER)
+#define SAMPLE_UTIL_KERNEL __forceinline
+#else
+#define SAMPLE_UTIL_KERNEL inline
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+        !defined(__EMSCRIPTEN__)
+#define SAMPLE_UTIL_X86_DISPATCH
+#endif
+
+namespace kernels {
+
+SAMPLE_UTIL_KERNEL void applyGain(CSAMPLE* pBuffer, CSAMPLE_GAIN gain,
         SINT numSamples) {
     if (gain == CSAMPLE_GAIN_ONE) {
         return;
     }
     if (gain == CSAMPLE_GAIN_ZERO) {
-        clear(pBuffer, numSamples);
+        SampleUtil::clear(pBuffer, numSamples);
         return;
     }
 
@@ -127,14 +153,13 @@ void SampleUtil::applyGain(CSAMPLE* pBuffer, CSAMPLE_GAIN gain,
     }
 }
 
-// static
-void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
+SAMPLE_UTIL_KERNEL void applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
         CSAMPLE_GAIN new_gain, SINT numSamples) {
     if (old_gain == CSAMPLE_GAIN_ONE && new_gain == CSAMPLE_GAIN_ONE) {
         return;
     }
     if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
-        clear(pBuffer, numSamples);
+        SampleUtil::clear(pBuffer, numSamples);
         return;
     }
 
@@ -157,6 +182,336 @@ void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
     }
 }
 
+SAMPLE_UTIL_KERNEL void copyWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain, SINT numSamples) {
+    if (gain == CSAMPLE_GAIN_ONE) {
+        SampleUtil::copy(pDest, pSrc, numSamples);
+        return;
+    }
+    if (gain == CSAMPLE_GAIN_ZERO) {
+        SampleUtil::clear(pDest, numSamples);
+        return;
+    }
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] = pSrc[i] * gain;
+    }
+
+    // OR! need to test which fares better
+    // SampleUtil::copy(pDest, pSrc, iNumSamples);
+    // applyGain(pDest, gain);
+}
+
+SAMPLE_UTIL_KERNEL void copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    if (old_gain == CSAMPLE_GAIN_ONE && new_gain == CSAMPLE_GAIN_ONE) {
+        SampleUtil::copy(pDest, pSrc, numSamples);
+        return;
+    }
+    if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
+        SampleUtil::clear(pDest, numSamples);
+        return;
+    }
+
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (gain_delta != 0) {
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        // note: LOOP VECTORIZED only with "int i" (not SINT i)
+        for (int i = 0; i < numSamples / 2; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+            pDest[i * 2] = pSrc[i * 2] * gain;
+            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+        }
+    } else {
+        // note: LOOP VECTORIZED.
+        for (SINT i = 0; i < numSamples; ++i) {
+            pDest[i] = pSrc[i] * old_gain;
+        }
+    }
+
+    // OR! need to test which fares better
+    // SampleUtil::copy(pDest, pSrc, iNumSamples);
+    // applyRampingGain(pDest, gain);
+}
+
+SAMPLE_UTIL_KERNEL void addWithGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN gain, SINT numSamples) {
+    if (gain == CSAMPLE_GAIN_ZERO) {
+        return;
+    }
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples; ++i) {
+        pDest[i] += pSrc[i] * gain;
+    }
+}
+
+SAMPLE_UTIL_KERNEL void addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc,
+        CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
+        SINT numSamples) {
+    if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
+        return;
+    }
+
+    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
+            / CSAMPLE_GAIN(numSamples / 2);
+    if (gain_delta != 0) {
+        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples / 2; ++i) {
+            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
+            pDest[i * 2] += pSrc[i * 2] * gain;
+            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+        }
+    } else {
+        // note: LOOP VECTORIZED.
+        for (int i = 0; i < numSamples; ++i) {
+            pDest[i] += pSrc[i] * old_gain;
+        }
+    }
+}
+
+SAMPLE_UTIL_KERNEL SampleUtil::CLIP_STATUS sumAbsPerChannel(CSAMPLE* pfAbsL,
+        CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
+    CSAMPLE fAbsL = CSAMPLE_ZERO;
+    CSAMPLE fAbsR = CSAMPLE_ZERO;
+    CSAMPLE clippedL = 0;
+    CSAMPLE clippedR = 0;
+
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numSamples / 2; ++i) {
+        CSAMPLE absl = fabs(pBuffer[i * 2]);
+        fAbsL += absl;
+        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
+        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
+        fAbsR += absr;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
+    }
+
+    *pfAbsL = fAbsL;
+    *pfAbsR = fAbsR;
+    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
+    if (clippedL > 0) {
+        clipping |= SampleUtil::CLIPPING_LEFT;
+    }
+    if (clippedR > 0) {
+        clipping |= SampleUtil::CLIPPING_RIGHT;
+    }
+    return clipping;
+}
+
+SAMPLE_UTIL_KERNEL CSAMPLE sumSquared(const CSAMPLE* pBuffer, SINT numSamples) {
+    CSAMPLE sumSq = CSAMPLE_ZERO;
+
+    for (SINT i = 0; i < numSamples; ++i) {
+        sumSq += pBuffer[i] * pBuffer[i];
+    }
+
+    return sumSq;
+}
+
+SAMPLE_UTIL_KERNEL CSAMPLE maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
+    CSAMPLE max = pBuffer[0];
+    for (SINT i = 1; i < numSamples; ++i) {
+        CSAMPLE absValue = abs(pBuffer[i]);
+        if (absValue > max) {
+            max = absValue;
+        }
+    }
+    return max;
+}
+
+SAMPLE_UTIL_KERNEL void copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < iNumSamples; ++i) {
+        pDest[i] = SampleUtil::clampSample(pSrc[i]);
+    }
+}
+
+SAMPLE_UTIL_KERNEL void interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
+        const CSAMPLE* M_RESTRICT pSrc1,
+        const CSAMPLE* M_RESTRICT pSrc2,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+SAMPLE_UTIL_KERNEL void deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
+        CSAMPLE* M_RESTRICT pDest2,
+        const CSAMPLE* M_RESTRICT pSrc,
+        SINT numFrames) {
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+} // namespace kernels
+
+struct Kernels {
+    decltype(&kernels::applyGain) applyGain;
+    decltype(&kernels::applyRampingGain) applyRampingGain;
+    decltype(&kernels::copyWithGain) copyWithGain;
+    decltype(&kernels::copyWithRampingGain) copyWithRampingGain;
+    decltype(&kernels::addWithGain) addWithGain;
+    decltype(&kernels::addWithRampingGain) addWithRampingGain;
+    decltype(&kernels::sumAbsPerChannel) sumAbsPerChannel;
+    decltype(&kernels::sumSquared) sumSquared;
+    decltype(&kernels::maxAbsAmplitude) maxAbsAmplitude;
+    decltype(&kernels::copyClampBuffer) copyClampBuffer;
+    decltype(&kernels::interleaveBuffer) interleaveBuffer;
+    decltype(&kernels::deinterleaveBuffer) deinterleaveBuffer;
+};
+
+template<typename Signature, Signature* kKernel>
+struct Target;
+
+// The instantiations of a kernel for all instruction sets
+template<typename R, typename... Args, R (*kKernel)(Args...)>
+struct Target<R(Args...), kKernel> {
+    static R baseline(Args... args) {
+        return kKernel(args...);
+    }
+#ifdef SAMPLE_UTIL_X86_DISPATCH
+    __attribute__((target("avx2,fma"))) static R avx2(Args... args) {
+        return kKernel(args...);
+    }
+    __attribute__((target("avx512f"))) static R avx512(Args... args) {
+        return kKernel(args...);
+    }
+#endif
+};
+
+#define SAMPLE_UTIL_KERNEL_TARGET(name, isa) \
+    &Target<decltype(kernels::name), &kernels::name>::isa
+#define SAMPLE_UTIL_KERNELS(isa) \
+    Kernels { \
+            SAMPLE_UTIL_KERNEL_TARGET(applyGain, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(applyRampingGain, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(copyWithGain, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(copyWithRampingGain, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(addWithGain, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(addWithRampingGain, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(sumAbsPerChannel, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(sumSquared, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(maxAbsAmplitude, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(copyClampBuffer, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(interleaveBuffer, isa), \
+            SAMPLE_UTIL_KERNEL_TARGET(deinterleaveBuffer, isa) \
+    }
+
+constexpr Kernels kBaselineKernels = SAMPLE_UTIL_KERNELS(baseline);
+#ifdef SAMPLE_UTIL_X86_DISPATCH
+constexpr Kernels kAvx2Kernels = SAMPLE_UTIL_KERNELS(avx2);
+constexpr Kernels kAvx512Kernels = SAMPLE_UTIL_KERNELS(avx512);
+#endif
+
+// Returns nullptr if the instruction set is not supported by the CPU or
+// the build.
+const Kernels* kernelsForInstructionSet(SampleUtil::InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case SampleUtil::InstructionSet::Baseline:
+        return &kBaselineKernels;
+#ifdef SAMPLE_UTIL_X86_DISPATCH
+    case SampleUtil::InstructionSet::Avx2:
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return &kAvx2Kernels;
+        }
+        return nullptr;
+    case SampleUtil::InstructionSet::Avx512:
+        if (__builtin_cpu_supports("avx512f")) {
+            return &kAvx512Kernels;
+        }
+        return nullptr;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+// Constant initialized, i.e. valid even before the dynamic initialization
+// below has selected the kernels for the CPU.
+const Kernels* s_pKernels = &kBaselineKernels;
+SampleUtil::InstructionSet s_instructionSet = SampleUtil::InstructionSet::Baseline;
+
+SampleUtil::InstructionSet bestInstructionSet() {
+    for (const auto instructionSet : {
+                 SampleUtil::InstructionSet::Avx512,
+                 SampleUtil::InstructionSet::Avx2,
+         }) {
+        if (kernelsForInstructionSet(instructionSet)) {
+            return instructionSet;
+        }
+    }
+    return SampleUtil::InstructionSet::Baseline;
+}
+
+[[maybe_unused]] const bool s_kernelsSelected =
+        SampleUtil::setInstructionSet(bestInstructionSet());
+
+} // anonymous namespace
+
+// static
+SampleUtil::InstructionSet SampleUtil::instructionSet() {
+    return s_instructionSet;
+}
+
+// static
+bool SampleUtil::setInstructionSet(InstructionSet instructionSet) {
+    const Kernels* pKernels = kernelsForInstructionSet(instructionSet);
+    if (!pKernels) {
+        return false;
+    }
+    s_pKernels = pKernels;
+    s_instructionSet = instructionSet;
+    return true;
+}
+
+// static
+const char* SampleUtil::instructionSetName(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::Baseline:
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return "SSE2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+        return "NEON";
+#else
+        return "Generic";
+#endif
+    case InstructionSet::Avx2:
+        return "AVX2";
+    case InstructionSet::Avx512:
+        return "AVX-512";
+    }
+    return "Unknown";
+}
+
+// static
+void SampleUtil::applyGain(CSAMPLE* pBuffer, CSAMPLE_GAIN gain,
+        SINT numSamples) {
+    s_pKernels->applyGain(pBuffer, gain, numSamples);
+}
+
+// static
+void SampleUtil::applyRampingGain(CSAMPLE* pBuffer, CSAMPLE_GAIN old_gain,
+        CSAMPLE_GAIN new_gain, SINT numSamples) {
+    s_pKernels->applyRampingGain(pBuffer, old_gain, new_gain, numSamples);
+}
+
 CSAMPLE SampleUtil::copyWithRampingNormalization(CSAMPLE* pDest,
         const CSAMPLE* pSrc,
         CSAMPLE_GAIN old_gain,
@@ -246,40 +601,15 @@ void SampleUtil::add(CSAMPLE* M_RESTRICT pDest,
 void SampleUtil::addWithGain(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc,
         CSAMPLE_GAIN gain, SINT numSamples) {
-    if (gain == CSAMPLE_GAIN_ZERO) {
-        return;
-    }
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] += pSrc[i] * gain;
-    }
+    s_pKernels->addWithGain(pDest, pSrc, gain, numSamples);
 }
 
+// static
 void SampleUtil::addWithRampingGain(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc,
         CSAMPLE_GAIN old_gain, CSAMPLE_GAIN new_gain,
         SINT numSamples) {
-    if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
-        return;
-    }
-
-    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
-            / CSAMPLE_GAIN(numSamples / 2);
-    if (gain_delta != 0) {
-        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] += pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
-        }
-    } else {
-        // note: LOOP VECTORIZED.
-        for (int i = 0; i < numSamples; ++i) {
-            pDest[i] += pSrc[i] * old_gain;
-        }
-    }
+    s_pKernels->addWithRampingGain(pDest, pSrc, old_gain, new_gain, numSamples);
 }
 
 // static
@@ -328,23 +658,7 @@ void SampleUtil::add3WithGain(CSAMPLE* pDest,
 void SampleUtil::copyWithGain(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc,
         CSAMPLE_GAIN gain, SINT numSamples) {
-    if (gain == CSAMPLE_GAIN_ONE) {
-        copy(pDest, pSrc, numSamples);
-        return;
-    }
-    if (gain == CSAMPLE_GAIN_ZERO) {
-        clear(pDest, numSamples);
-        return;
-    }
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples; ++i) {
-        pDest[i] = pSrc[i] * gain;
-    }
-
-    // OR! need to test which fares better
-    // copy(pDest, pSrc, iNumSamples);
-    // applyGain(pDest, gain);
+    s_pKernels->copyWithGain(pDest, pSrc, gain, numSamples);
 }
 
 // static
@@ -353,35 +667,7 @@ void SampleUtil::copyWithRampingGain(CSAMPLE* M_RESTRICT pDest,
         CSAMPLE_GAIN old_gain,
         CSAMPLE_GAIN new_gain,
         SINT numSamples) {
-    if (old_gain == CSAMPLE_GAIN_ONE && new_gain == CSAMPLE_GAIN_ONE) {
-        copy(pDest, pSrc, numSamples);
-        return;
-    }
-    if (old_gain == CSAMPLE_GAIN_ZERO && new_gain == CSAMPLE_GAIN_ZERO) {
-        clear(pDest, numSamples);
-        return;
-    }
-
-    const CSAMPLE_GAIN gain_delta = (new_gain - old_gain)
-            / CSAMPLE_GAIN(numSamples / 2);
-    if (gain_delta != 0) {
-        const CSAMPLE_GAIN start_gain = old_gain + gain_delta;
-        // note: LOOP VECTORIZED only with "int i" (not SINT i)
-        for (int i = 0; i < numSamples / 2; ++i) {
-            const CSAMPLE_GAIN gain = start_gain + gain_delta * i;
-            pDest[i * 2] = pSrc[i * 2] * gain;
-            pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
-        }
-    } else {
-        // note: LOOP VECTORIZED.
-        for (SINT i = 0; i < numSamples; ++i) {
-            pDest[i] = pSrc[i] * old_gain;
-        }
-    }
-
-    // OR! need to test which fares better
-    // copy(pDest, pSrc, iNumSamples);
-    // applyRampingGain(pDest, gain);
+    s_pKernels->copyWithRampingGain(pDest, pSrc, old_gain, new_gain, numSamples);
 }
 
 // static
@@ -416,43 +702,12 @@ void SampleUtil::convertFloat32ToS16(SAMPLE* pDest, const CSAMPLE* pSrc,
 // static
 SampleUtil::CLIP_STATUS SampleUtil::sumAbsPerChannel(CSAMPLE* pfAbsL,
         CSAMPLE* pfAbsR, const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE fAbsL = CSAMPLE_ZERO;
-    CSAMPLE fAbsR = CSAMPLE_ZERO;
-    CSAMPLE clippedL = 0;
-    CSAMPLE clippedR = 0;
-
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numSamples / 2; ++i) {
-        CSAMPLE absl = fabs(pBuffer[i * 2]);
-        fAbsL += absl;
-        clippedL += absl > CSAMPLE_PEAK ? 1 : 0;
-        CSAMPLE absr = fabs(pBuffer[i * 2 + 1]);
-        fAbsR += absr;
-        // Replacing the code with a bool clipped will prevent vetorizing
-        clippedR += absr > CSAMPLE_PEAK ? 1 : 0;
-    }
-
-    *pfAbsL = fAbsL;
-    *pfAbsR = fAbsR;
-    SampleUtil::CLIP_STATUS clipping = SampleUtil::NO_CLIPPING;
-    if (clippedL > 0) {
-        clipping |= SampleUtil::CLIPPING_LEFT;
-    }
-    if (clippedR > 0) {
-        clipping |= SampleUtil::CLIPPING_RIGHT;
-    }
-    return clipping;
+    return s_pKernels->sumAbsPerChannel(pfAbsL, pfAbsR, pBuffer, numSamples);
 }
 
 // static
 CSAMPLE SampleUtil::sumSquared(const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE sumSq = CSAMPLE_ZERO;
-
-    for (SINT i = 0; i < numSamples; ++i) {
-        sumSq += pBuffer[i] * pBuffer[i];
-    }
-
-    return sumSq;
+    return s_pKernels->sumSquared(pBuffer, numSamples);
 }
 
 // static
@@ -460,24 +715,15 @@ CSAMPLE SampleUtil::rms(const CSAMPLE* pBuffer, SINT numSamples) {
     return sqrtf(sumSquared(pBuffer, numSamples) / numSamples);
 }
 
+// static
 CSAMPLE SampleUtil::maxAbsAmplitude(const CSAMPLE* pBuffer, SINT numSamples) {
-    CSAMPLE max = pBuffer[0];
-    for (SINT i = 1; i < numSamples; ++i) {
-        CSAMPLE absValue = abs(pBuffer[i]);
-        if (absValue > max) {
-            max = absValue;
-        }
-    }
-    return max;
+    return s_pKernels->maxAbsAmplitude(pBuffer, numSamples);
 }
 
 // static
 void SampleUtil::copyClampBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc, SINT iNumSamples) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < iNumSamples; ++i) {
-        pDest[i] = clampSample(pSrc[i]);
-    }
+    s_pKernels->copyClampBuffer(pDest, pSrc, iNumSamples);
 }
 
 // static
@@ -485,11 +731,7 @@ void SampleUtil::interleaveBuffer(CSAMPLE* M_RESTRICT pDest,
         const CSAMPLE* M_RESTRICT pSrc1,
         const CSAMPLE* M_RESTRICT pSrc2,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest[2 * i] = pSrc1[i];
-        pDest[2 * i + 1] = pSrc2[i];
-    }
+    s_pKernels->interleaveBuffer(pDest, pSrc1, pSrc2, numFrames);
 }
 
 // static
@@ -497,11 +739,7 @@ void SampleUtil::deinterleaveBuffer(CSAMPLE* M_RESTRICT pDest1,
         CSAMPLE* M_RESTRICT pDest2,
         const CSAMPLE* M_RESTRICT pSrc,
         SINT numFrames) {
-    // note: LOOP VECTORIZED.
-    for (SINT i = 0; i < numFrames; ++i) {
-        pDest1[i] = pSrc[i * 2];
-        pDest2[i] = pSrc[i * 2 + 1];
-    }
+    s_pKernels->deinterleaveBuffer(pDest1, pDest2, pSrc, numFrames);
 }
 
 // static
@@ -25,6 +25,22 @@ class SampleUtil {
     // This is some legacy, we cannot easily revert.
     static constexpr double kPlayPositionChannels = 2.0;
 
+    // The instruction sets of the hot loops (gain, mixing, clamping,
+    // interleaving, peak and RMS), which are selected for the CPU at
+    // runtime. Baseline is SSE2 on x86 and NEON on ARM.
+    enum class InstructionSet {
+        Baseline,
+        Avx2,
+        Avx512,
+    };
+
+    static InstructionSet instructionSet();
+    // Overrides the detected instruction set, e.g. for comparing them in
+    // benchmarks. Returns false if the CPU or the build does not support
+    // it. Not thread-safe, must not be called while the engine is running.
+    static bool setInstructionSet(InstructionSet instructionSet);
+    static const char* instructionSetName(InstructionSet instructionSet);
+
     // Allocated a buffer of CSAMPLE's with length size. Ensures that the buffer
     // is 16-byte aligned for SSE enhancement.
     [[nodiscard]] static CSAMPLE* alloc(SINT size);
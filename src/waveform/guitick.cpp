@@ -1,5 +1,6 @@
 #include "waveform/guitick.h"
 
+#include "control/controlchangejournal.h"
 #include "control/controlobject.h"
 
 namespace {
@@ -15,11 +16,19 @@ GuiTick::GuiTick() {
             ConfigKey(kAppGroup, QStringLiteral("gui_tick_50ms_period_s")));
     m_pCOGuiTick50ms->addAlias(ConfigKey(kLegacyGroup, QStringLiteral("guiTick50ms")));
     m_cpuTimer.start();
+    ControlChangeJournal::setEnabled(true);
+}
+
+GuiTick::~GuiTick() {
+    ControlChangeJournal::setEnabled(false);
 }
 
 // this is called from WaveformWidgetFactory::render in the main thread with the
 // configured waveform frame rate
 void GuiTick::process() {
+    // Deliver the control changes of the last frame to the widgets
+    ControlChangeJournal::drain();
+
     m_cpuTimeLastTick += m_cpuTimer.restart();
     double cpuTimeLastTickSeconds = m_cpuTimeLastTick.toDoubleSeconds();
     m_pCOGuiTickTime->set(cpuTimeLastTickSeconds);
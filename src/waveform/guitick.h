@@ -12,6 +12,7 @@
 class GuiTick {
   public:
     GuiTick();
+    ~GuiTick();
     void process();
 
   private:
@@ -37,7 +37,9 @@ ControlWidgetConnection::ControlWidgetConnection(
         : m_pWidget(pBaseWidget),
           m_pValueTransformer(pTransformer) {
     m_pControl = new ControlProxy(key, this, ControlFlag::NoAssertIfMissing);
-    m_pControl->connectValueChanged(this, &ControlWidgetConnection::slotControlValueChanged);
+    // Widgets only need to show the latest value once per frame
+    m_pControl->connectValueChangedCoalesced(
+            this, &ControlWidgetConnection::slotControlValueChanged);
 }
 
 void ControlWidgetConnection::setControlParameter(double parameter) {